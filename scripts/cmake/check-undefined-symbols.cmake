@@ -0,0 +1,23 @@
+# SPDX-License-Identifier: BSD-3-Clause
+
+# Fails if the shared library LIB takes any of the comma separated SYMBOLS
+# from another library. Run as a post-build step with:
+# cmake -DNM=<nm> -DLIB=<library> -DSYMBOLS=<symbols> -P check-undefined-symbols.cmake
+
+execute_process(
+	COMMAND ${NM} -D --undefined-only ${LIB}
+	OUTPUT_VARIABLE undefined
+	RESULT_VARIABLE ret
+)
+
+if(NOT ret EQUAL 0)
+	message(FATAL_ERROR "${NM} failed on ${LIB}")
+endif()
+
+string(REPLACE "," ";" SYMBOLS "${SYMBOLS}")
+
+foreach(symbol ${SYMBOLS})
+	if(undefined MATCHES " U ${symbol}\n")
+		message(FATAL_ERROR "${LIB} must not take ${symbol} from another library")
+	endif()
+endforeach()
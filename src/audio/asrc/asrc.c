@@ -385,12 +385,14 @@ static int asrc_initialize_buffers(struct asrc_farrow *src_obj)
 	int ch;
 	size_t buffer_size;
 
-	/* Set buffer_length to filter_length * 2 to compensate for
+	/* Set buffer_length to twice the history to compensate for
 	 * missing element wise wrap around while loading but allowing
-	 * aligned loads.
+	 * aligned loads. The history is filter_length plus the input
+	 * frames that can be written while output frames are queued
+	 * for block processing.
 	 */
-	src_obj->buffer_length = src_obj->filter_length * 2;
-	src_obj->buffer_write_position = src_obj->filter_length;
+	src_obj->buffer_length = (src_obj->filter_length + ASRC_BLOCK_FRAMES) * 2;
+	src_obj->buffer_write_position = src_obj->filter_length + ASRC_BLOCK_FRAMES;
 
 	if (src_obj->bit_depth == 32) {
 		buffer_size = src_obj->buffer_length * sizeof(int32_t);
@@ -209,14 +209,18 @@ static enum asrc_error_code initialise_filter(struct comp_dev *dev,
  * ------------------------------|-------------------------------------|
  * 0x0000                        |asrc_farrow src_obj                  |
  * ------------------------------|-------------------------------------|
- * &src_obj + 1                  |int32 impulse_response[filter_length]|
+ * &src_obj + 1                  |int32 impulse_response[block_length] |
  * ------------------------------|-------------------------------------|
  * &impulse_response[0] +        |int_x *buffer_pointer[num_channels]  |
- * filter_length                 |                                     |
+ * block_length                  |                                     |
  * ------------------------------|-------------------------------------|
  *
  * Info:
  *
+ * impulse_response[block_length]:
+ * The impulse responses of a block of output frames, block_length is
+ * ASRC_BLOCK_FRAMES * filter_length.
+ *
  * buffer_pointer[num_channels]:
  * Pointers to each channels data. Buffers are allocated externally.
  */
@@ -261,8 +265,8 @@ enum asrc_error_code asrc_get_required_size(struct comp_dev *dev,
 	/* accumulate the size */
 	size = sizeof(struct asrc_farrow);
 
-	/* size of the impulse response */
-	size += ASRC_MAX_FILTER_LENGTH * sizeof(int32_t);
+	/* size of the impulse responses for a block of frames */
+	size += ASRC_BLOCK_FRAMES * ASRC_MAX_FILTER_LENGTH * sizeof(int32_t);
 
 	/* size of pointers to the buffers */
 	size += sizeof(int32_t *) * num_channels;
@@ -379,11 +383,11 @@ enum asrc_error_code asrc_initialise(struct comp_dev *dev,
 	if (src_obj->bit_depth == 32) {
 		src_obj->ring_buffers16 = NULL;
 		src_obj->ring_buffers32 = (int32_t **)(src_obj->impulse_response +
-			src_obj->filter_length);
+			ASRC_BLOCK_FRAMES * src_obj->filter_length);
 	} else if (src_obj->bit_depth == 16) {
 		src_obj->ring_buffers32 = NULL;
 		src_obj->ring_buffers16 = (int16_t **)(src_obj->impulse_response +
-			src_obj->filter_length);
+			ASRC_BLOCK_FRAMES * src_obj->filter_length);
 	}
 
 	/* return ok, if everything worked out */
@@ -457,11 +461,11 @@ enum asrc_error_code asrc_set_fs_ratio(struct comp_dev *dev,
 	if (src_obj->bit_depth == 32) {
 		src_obj->ring_buffers16 = NULL;
 		src_obj->ring_buffers32 = (int32_t **)(src_obj->impulse_response +
-			src_obj->filter_length);
+			ASRC_BLOCK_FRAMES * src_obj->filter_length);
 	} else if (src_obj->bit_depth == 16) {
 		src_obj->ring_buffers32 = NULL;
 		src_obj->ring_buffers16 = (int16_t **)(src_obj->impulse_response +
-			src_obj->filter_length);
+			ASRC_BLOCK_FRAMES * src_obj->filter_length);
 	}
 
 	return ASRC_EC_OK;
@@ -885,6 +889,59 @@ void asrc_write_to_ring_buffer32(struct asrc_farrow  *src_obj,
 	}
 }
 
+/*
+ * Start an empty block of output frames.
+ */
+static void asrc_block_reset(struct asrc_block *block)
+{
+	block->num_frames = 0;
+	block->num_inputs = 0;
+	block->constant_step = true;
+}
+
+/*
+ * Queue an output frame to the block. The frame is filtered later with
+ * the current ring buffer position and the given time value.
+ */
+static void asrc_block_add(struct asrc_farrow *src_obj,
+			   struct asrc_block *block, uint32_t time_value,
+			   int output_frame)
+{
+	int frame = block->num_frames;
+
+	/* An input frame was written since the first frame */
+	if (block->num_inputs)
+		block->constant_step = false;
+
+	block->time_value[frame] = time_value;
+	block->write_position[frame] = src_obj->buffer_write_position;
+	block->output_frame[frame] = output_frame;
+	block->num_frames++;
+}
+
+static void asrc_block_filter16(struct asrc_farrow *src_obj,
+				struct asrc_block *block,
+				int16_t **output_buffers)
+{
+	/* Calculate the impulse responses */
+	(*src_obj->calc_ir)(src_obj, block);
+
+	/* Filter and write one output sample for each frame and
+	 * channel to the output_buffer
+	 */
+	asrc_fir_filter16(src_obj, output_buffers, block);
+	asrc_block_reset(block);
+}
+
+static void asrc_block_filter32(struct asrc_farrow *src_obj,
+				struct asrc_block *block,
+				int32_t **output_buffers)
+{
+	(*src_obj->calc_ir)(src_obj, block);
+	asrc_fir_filter32(src_obj, output_buffers, block);
+	asrc_block_reset(block);
+}
+
 enum asrc_error_code asrc_process_push16(struct comp_dev *dev,
 					 struct asrc_farrow *src_obj,
 					 int16_t **__restrict input_buffers,
@@ -894,6 +951,7 @@ enum asrc_error_code asrc_process_push16(struct comp_dev *dev,
 					 int *write_index,
 					 int read_index)
 {
+	struct asrc_block block;
 	int index_input_frame;
 	int max_num_free_frames;
 
@@ -924,6 +982,7 @@ enum asrc_error_code asrc_process_push16(struct comp_dev *dev,
 
 	*output_num_frames = 0;
 	index_input_frame = 0;
+	asrc_block_reset(&block);
 
 	/* Run the state machine until all input samples are read */
 	while (index_input_frame < *input_num_frames) {
@@ -931,14 +990,15 @@ enum asrc_error_code asrc_process_push16(struct comp_dev *dev,
 			if (*output_num_frames == max_num_free_frames)
 				break;
 
-			/* Calculate impulse response */
-			(*src_obj->calc_ir)(src_obj);
-
-			/* Filter and write one output sample for each
-			 * channel to the output_buffer
+			/* Queue the output frame, the impulse responses
+			 * are calculated and filtered for a block of
+			 * frames at once.
 			 */
-			asrc_fir_filter16(src_obj, output_buffers,
-					  src_obj->io_buffer_idx);
+			asrc_block_add(src_obj, &block, src_obj->time_value,
+				       src_obj->io_buffer_idx);
+			if (block.num_frames == ASRC_BLOCK_FRAMES)
+				asrc_block_filter16(src_obj, &block,
+						    output_buffers);
 
 			/* Update time and buffer index */
 			src_obj->time_value += src_obj->fs_ratio;
@@ -951,15 +1011,29 @@ enum asrc_error_code asrc_process_push16(struct comp_dev *dev,
 
 			(*output_num_frames)++;
 		} else {
+			/* The ring buffers keep ASRC_BLOCK_FRAMES input
+			 * frames of history for the queued output frames.
+			 */
+			if (block.num_inputs == ASRC_BLOCK_FRAMES)
+				asrc_block_filter16(src_obj, &block,
+						    output_buffers);
+
 			/* Consume one input sample */
 			asrc_write_to_ring_buffer16(src_obj, input_buffers,
 						    index_input_frame);
 			index_input_frame++;
+			if (block.num_frames)
+				block.num_inputs++;
 
 			/* Update time */
 			src_obj->time_value -= TIME_VALUE_ONE;
 		}
 	}
+
+	/* Filter the remaining queued frames */
+	if (block.num_frames)
+		asrc_block_filter16(src_obj, &block, output_buffers);
+
 	*write_index = src_obj->io_buffer_idx;
 	*input_num_frames = index_input_frame;
 
@@ -1007,6 +1081,7 @@ enum asrc_error_code asrc_process_push32(struct comp_dev *dev,
 	/* See 'process_push16' for a more detailed description of the
 	 * algorithm
 	 */
+	struct asrc_block block;
 	int index_input_frame;
 	int max_num_free_frames;
 
@@ -1034,19 +1109,18 @@ enum asrc_error_code asrc_process_push32(struct comp_dev *dev,
 
 	*output_num_frames = 0;
 	index_input_frame = 0;
+	asrc_block_reset(&block);
 	while (index_input_frame < *input_num_frames) {
 		if (src_obj->time_value < TIME_VALUE_ONE) {
 			if (*output_num_frames == max_num_free_frames)
 				break;
 
-			/* Calculate impulse response */
-			(*src_obj->calc_ir)(src_obj);
-
-			/* Filter and write output sample to
-			 * output_buffer
-			 */
-			asrc_fir_filter32(src_obj, output_buffers,
-					  src_obj->io_buffer_idx);
+			/* Queue the output frame */
+			asrc_block_add(src_obj, &block, src_obj->time_value,
+				       src_obj->io_buffer_idx);
+			if (block.num_frames == ASRC_BLOCK_FRAMES)
+				asrc_block_filter32(src_obj, &block,
+						    output_buffers);
 
 			/* Update time and index */
 			src_obj->time_value += src_obj->fs_ratio;
@@ -1059,15 +1133,27 @@ enum asrc_error_code asrc_process_push32(struct comp_dev *dev,
 
 			(*output_num_frames)++;
 		} else {
+			/* Keep the history of the queued frames */
+			if (block.num_inputs == ASRC_BLOCK_FRAMES)
+				asrc_block_filter32(src_obj, &block,
+						    output_buffers);
+
 			/* Consume input sample */
 			asrc_write_to_ring_buffer32(src_obj, input_buffers,
 						    index_input_frame);
 			index_input_frame++;
+			if (block.num_frames)
+				block.num_inputs++;
 
 			/* Update time */
 			src_obj->time_value -= TIME_VALUE_ONE;
 		}
 	}
+
+	/* Filter the remaining queued frames */
+	if (block.num_frames)
+		asrc_block_filter32(src_obj, &block, output_buffers);
+
 	*write_index = src_obj->io_buffer_idx;
 	*input_num_frames = index_input_frame;
 
@@ -1112,6 +1198,7 @@ enum asrc_error_code asrc_process_pull16(struct comp_dev *dev,
 					 int write_index,
 					 int *read_index)
 {
+	struct asrc_block block;
 	int index_output_frame = 0;
 
 	/* parameter error handling */
@@ -1132,6 +1219,7 @@ enum asrc_error_code asrc_process_pull16(struct comp_dev *dev,
 		src_obj->io_buffer_idx = 0;
 
 	*input_num_frames = 0;
+	asrc_block_reset(&block);
 
 	/* Run state machine until number of output samples are written */
 	while (index_output_frame < *output_num_frames) {
@@ -1140,6 +1228,11 @@ enum asrc_error_code asrc_process_pull16(struct comp_dev *dev,
 			if (src_obj->io_buffer_idx == write_index)
 				break;
 
+			/* Keep the history of the queued frames */
+			if (block.num_inputs == ASRC_BLOCK_FRAMES)
+				asrc_block_filter16(src_obj, &block,
+						    output_buffers);
+
 			asrc_write_to_ring_buffer16(src_obj,
 						    input_buffers,
 						    src_obj->io_buffer_idx);
@@ -1151,6 +1244,8 @@ enum asrc_error_code asrc_process_pull16(struct comp_dev *dev,
 				src_obj->io_buffer_idx = 0;
 
 			(*input_num_frames)++;
+			if (block.num_frames)
+				block.num_inputs++;
 
 			/* Update time as Q5.27 */
 			src_obj->time_value = (((int64_t)TIME_VALUE_ONE -
@@ -1158,12 +1253,12 @@ enum asrc_error_code asrc_process_pull16(struct comp_dev *dev,
 					       src_obj->fs_ratio_inv) >> 27;
 			src_obj->time_value_pull += src_obj->fs_ratio;
 		} else {
-			/* Calculate impulse response */
-			(*src_obj->calc_ir)(src_obj);
-
-			/* Filter and write output sample to output_buffer */
-			asrc_fir_filter16(src_obj, output_buffers,
-					  index_output_frame);
+			/* Queue the output frame */
+			asrc_block_add(src_obj, &block, src_obj->time_value,
+				       index_output_frame);
+			if (block.num_frames == ASRC_BLOCK_FRAMES)
+				asrc_block_filter16(src_obj, &block,
+						    output_buffers);
 
 			/* Update time and index */
 			src_obj->time_value += src_obj->fs_ratio_inv;
@@ -1171,6 +1266,11 @@ enum asrc_error_code asrc_process_pull16(struct comp_dev *dev,
 			index_output_frame++;
 		}
 	}
+
+	/* Filter the remaining queued frames */
+	if (block.num_frames)
+		asrc_block_filter16(src_obj, &block, output_buffers);
+
 	*read_index = src_obj->io_buffer_idx;
 	*output_num_frames = index_output_frame;
 
@@ -1215,6 +1315,7 @@ enum asrc_error_code asrc_process_pull32(struct comp_dev *dev,
 					 int write_index,
 					 int *read_index)
 {
+	struct asrc_block block;
 	int index_output_frame = 0;
 
 	/* parameter error handling */
@@ -1238,12 +1339,18 @@ enum asrc_error_code asrc_process_pull32(struct comp_dev *dev,
 		src_obj->io_buffer_idx = 0;
 
 	*input_num_frames = 0;
+	asrc_block_reset(&block);
 	while (index_output_frame < *output_num_frames) {
 		if (src_obj->time_value_pull < TIME_VALUE_ONE) {
 			/* Consume input sample */
 			if (src_obj->io_buffer_idx == write_index)
 				break;
 
+			/* Keep the history of the queued frames */
+			if (block.num_inputs == ASRC_BLOCK_FRAMES)
+				asrc_block_filter32(src_obj, &block,
+						    output_buffers);
+
 			asrc_write_to_ring_buffer32(src_obj,
 						    input_buffers,
 						    src_obj->io_buffer_idx);
@@ -1255,6 +1362,8 @@ enum asrc_error_code asrc_process_pull32(struct comp_dev *dev,
 				src_obj->io_buffer_idx = 0;
 
 			(*input_num_frames)++;
+			if (block.num_frames)
+				block.num_inputs++;
 
 			/* Update time as Q5.27 */
 			src_obj->time_value = (((int64_t)TIME_VALUE_ONE -
@@ -1262,12 +1371,12 @@ enum asrc_error_code asrc_process_pull32(struct comp_dev *dev,
 					       src_obj->fs_ratio_inv) >> 27;
 			src_obj->time_value_pull += src_obj->fs_ratio;
 		} else {
-			/* Calculate impulse response */
-			(*src_obj->calc_ir)(src_obj);
-
-			/* Filter and write output sample to output_buffer */
-			asrc_fir_filter32(src_obj, output_buffers,
-					  index_output_frame);
+			/* Queue the output frame */
+			asrc_block_add(src_obj, &block, src_obj->time_value,
+				       index_output_frame);
+			if (block.num_frames == ASRC_BLOCK_FRAMES)
+				asrc_block_filter32(src_obj, &block,
+						    output_buffers);
 
 			/* Update time and index */
 			src_obj->time_value += src_obj->fs_ratio_inv;
@@ -1275,6 +1384,11 @@ enum asrc_error_code asrc_process_pull32(struct comp_dev *dev,
 			index_output_frame++;
 		}
 	}
+
+	/* Filter the remaining queued frames */
+	if (block.num_frames)
+		asrc_block_filter32(src_obj, &block, output_buffers);
+
 	*read_index = src_obj->io_buffer_idx;
 	*output_num_frames = index_output_frame;
 
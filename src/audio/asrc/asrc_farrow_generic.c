@@ -12,81 +12,117 @@
 LOG_MODULE_DECLARE(asrc, CONFIG_SOF_LOG_LEVEL);
 
 void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
-		       int index_output_frame)
+		       const struct asrc_block *block)
 {
-	int64_t prod;
+	int64_t prod[ASRC_BLOCK_FRAMES];
+	int64_t prod0;
+	int64_t prod1;
 	int32_t prod32;
 	int16_t prod16;
 	int32_t *filter_p;
+	int32_t *filter1_p;
 	int16_t *buffer_p;
+	int16_t sample;
+	int num_frames = block->num_frames;
+	int stride;
+	int frame;
 	int ch;
 	int n;
-	int i;
 
 	if (src_obj->output_format == ASRC_IOF_INTERLEAVED)
-		i = src_obj->num_channels * index_output_frame;
+		stride = src_obj->num_channels;
 	else
-		i = index_output_frame;
+		stride = 1;
 
 	/* Iterate over each channel */
 	for (ch = 0; ch < src_obj->num_channels; ch++) {
-		/* Pointer to the beginning of the impulse response */
-		filter_p = &src_obj->impulse_response[0];
-
-		/* Pointer to the buffered input data */
-		buffer_p = &src_obj->ring_buffers16[ch]
-			[src_obj->buffer_write_position];
-
-		/* Initialise the accumulator */
-		prod = 0;
+		frame = 0;
 
 		/* Iterate over the filter bins.
 		 * Data is Q1.15, coefficients are Q1.30. Prod will be Qx.45.
 		 */
-		for (n = 0; n < src_obj->filter_length; n++)
-			prod += (int64_t)(*buffer_p--) * (*filter_p++);
-
-		/* Shift left after accumulation, because interim
-		 * results might saturate during filtering prod = prod
-		 * << 1; will shift after last addition
-		 */
-		prod32 = sat_int32(Q_SHIFT(prod, 45, 31));
-
-		/* Round 'prod' to 16 bit and store it in
-		 * (de-)interleaved format in the output buffers
-		 */
-		prod16 = sat_int16(Q_SHIFT_RND(prod32, 31, 15));
-		output_buffers[ch][i] = prod16;
+		if (block->constant_step) {
+			/* The frames share the buffered data, two frames
+			 * are filtered per iteration and each sample is
+			 * loaded once for both of them.
+			 */
+			buffer_p = &src_obj->ring_buffers16[ch]
+				[block->write_position[0]];
+			for (; frame < num_frames - 1; frame += 2) {
+				filter_p = &src_obj->impulse_response
+					[frame * src_obj->filter_length];
+				filter1_p = filter_p + src_obj->filter_length;
+				prod0 = 0;
+				prod1 = 0;
+				for (n = 0; n < src_obj->filter_length; n++) {
+					sample = buffer_p[-n];
+					prod0 += (int64_t)sample * filter_p[n];
+					prod1 += (int64_t)sample * filter1_p[n];
+				}
+
+				prod[frame] = prod0;
+				prod[frame + 1] = prod1;
+			}
+		}
+
+		for (; frame < num_frames; frame++) {
+			/* Pointer to the impulse response of the frame */
+			filter_p = &src_obj->impulse_response
+				[frame * src_obj->filter_length];
+
+			/* Pointer to the buffered input data */
+			buffer_p = &src_obj->ring_buffers16[ch]
+				[block->write_position[frame]];
+
+			/* Initialise the accumulator */
+			prod0 = 0;
+			for (n = 0; n < src_obj->filter_length; n++)
+				prod0 += (int64_t)(*buffer_p--) * (*filter_p++);
+
+			prod[frame] = prod0;
+		}
+
+		for (frame = 0; frame < num_frames; frame++) {
+			/* Shift left after accumulation, because interim
+			 * results might saturate during filtering prod = prod
+			 * << 1; will shift after last addition
+			 */
+			prod32 = sat_int32(Q_SHIFT(prod[frame], 45, 31));
+
+			/* Round 'prod' to 16 bit and store it in
+			 * (de-)interleaved format in the output buffers
+			 */
+			prod16 = sat_int16(Q_SHIFT_RND(prod32, 31, 15));
+			output_buffers[ch][stride * block->output_frame[frame]] = prod16;
+		}
 	}
 }
 
 void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
-		       int index_output_frame)
+		       const struct asrc_block *block)
 {
-	int64_t prod;
+	int64_t prod[ASRC_BLOCK_FRAMES];
+	int64_t prod0;
+	int64_t prod1;
 	int32_t prod32;
 	const int32_t *filter_p;
+	const int32_t *filter1_p;
 	int32_t *buffer_p;
+	int32_t sample;
+	int num_frames = block->num_frames;
+	int stride;
+	int frame;
 	int ch;
 	int n;
-	int i;
 
 	if (src_obj->output_format == ASRC_IOF_INTERLEAVED)
-		i = src_obj->num_channels * index_output_frame;
+		stride = src_obj->num_channels;
 	else
-		i = index_output_frame;
+		stride = 1;
 
 	/* Iterate over each channel */
 	for (ch = 0; ch < src_obj->num_channels; ch++) {
-		/* Pointer to the beginning of the impulse response */
-		filter_p = &src_obj->impulse_response[0];
-
-		/* Pointer to the buffered input data */
-		buffer_p = &src_obj->ring_buffers32[ch]
-			[src_obj->buffer_write_position];
-
-		/* Initialise the accumulator */
-		prod = 0;
+		frame = 0;
 
 		/* Iterate over the filter bins. Data is Q1.31, coefficients
 		 * are Q1.22. They are down scaled by 1 shift. In addition
@@ -95,25 +131,67 @@ void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
 		 * of 24 bits of 32 bits is not a practical limitation for
 		 * quality. The product is Qx.54.
 		 */
-		for (n = 0; n < src_obj->filter_length; n++)
-			prod += (int64_t)(*buffer_p--) * (*filter_p++ >> 8);
-
-		/* Shift left after accumulation, because interim
-		 * results might saturate during filtering prod = prod
-		 * << 1; will shift after last addition
-		 */
-		prod32 = sat_int32(Q_SHIFT(prod, 53, 31));
-
-		/* Store 'prod' in (de-)interleaved format in the output
-		 * buffers
-		 */
-		output_buffers[ch][i] = prod32;
+		if (block->constant_step) {
+			/* The frames share the buffered data, two frames
+			 * are filtered per iteration and each sample is
+			 * loaded once for both of them.
+			 */
+			buffer_p = &src_obj->ring_buffers32[ch]
+				[block->write_position[0]];
+			for (; frame < num_frames - 1; frame += 2) {
+				filter_p = &src_obj->impulse_response
+					[frame * src_obj->filter_length];
+				filter1_p = filter_p + src_obj->filter_length;
+				prod0 = 0;
+				prod1 = 0;
+				for (n = 0; n < src_obj->filter_length; n++) {
+					sample = buffer_p[-n];
+					prod0 += (int64_t)sample * (filter_p[n] >> 8);
+					prod1 += (int64_t)sample * (filter1_p[n] >> 8);
+				}
+
+				prod[frame] = prod0;
+				prod[frame + 1] = prod1;
+			}
+		}
+
+		for (; frame < num_frames; frame++) {
+			/* Pointer to the impulse response of the frame */
+			filter_p = &src_obj->impulse_response
+				[frame * src_obj->filter_length];
+
+			/* Pointer to the buffered input data */
+			buffer_p = &src_obj->ring_buffers32[ch]
+				[block->write_position[frame]];
+
+			/* Initialise the accumulator */
+			prod0 = 0;
+			for (n = 0; n < src_obj->filter_length; n++)
+				prod0 += (int64_t)(*buffer_p--) * (*filter_p++ >> 8);
+
+			prod[frame] = prod0;
+		}
+
+		for (frame = 0; frame < num_frames; frame++) {
+			/* Shift left after accumulation, because interim
+			 * results might saturate during filtering prod = prod
+			 * << 1; will shift after last addition
+			 */
+			prod32 = sat_int32(Q_SHIFT(prod[frame], 53, 31));
+
+			/* Store 'prod' in (de-)interleaved format in the output
+			 * buffers
+			 */
+			output_buffers[ch][stride * block->output_frame[frame]] = prod32;
+		}
 	}
 }
 
 /* + ALGORITHM SPECIFIC FUNCTIONS */
 
-void asrc_calc_impulse_response_n4(struct asrc_farrow *src_obj)
+static void calc_impulse_response_n4(struct asrc_farrow *src_obj,
+				     uint32_t time_value,
+				     int32_t *impulse_response)
 {
 	int32_t time;
 	int32_t accum20l; /* Coefficient for ^2 and ^0, l matches HiFi3 ver */
@@ -132,10 +210,10 @@ void asrc_calc_impulse_response_n4(struct asrc_farrow *src_obj)
 	 * Set the pointer to the impulse response.
 	 * This is where the result is stored.
 	 */
-	result_P = &src_obj->impulse_response[0];
+	result_P = impulse_response;
 
 	/* Get the current fractional time */
-	time = sat_int32(((int64_t)src_obj->time_value) << 4);
+	time = sat_int32(((int64_t)time_value) << 4);
 
 	/*
 	 * Generates two impulse response bins per iterations.
@@ -198,7 +276,9 @@ void asrc_calc_impulse_response_n4(struct asrc_farrow *src_obj)
 	}
 }
 
-void asrc_calc_impulse_response_n5(struct asrc_farrow *src_obj)
+static void calc_impulse_response_n5(struct asrc_farrow *src_obj,
+				     uint32_t time_value,
+				     int32_t *impulse_response)
 {
 	/*
 	 * See 'calc_impulse_response_n4' for a detailed description
@@ -215,8 +295,8 @@ void asrc_calc_impulse_response_n5(struct asrc_farrow *src_obj)
 	int index_limit;
 
 	filter_P = &src_obj->polyphase_filters[0];
-	result_P = &src_obj->impulse_response[0];
-	time = sat_int32(((int64_t)src_obj->time_value) << 4);
+	result_P = impulse_response;
+	time = sat_int32(((int64_t)time_value) << 4);
 
 	index_limit = src_obj->filter_length >> 1;
 	for (index_filter = 0; index_filter < index_limit; index_filter++) {
@@ -247,7 +327,9 @@ void asrc_calc_impulse_response_n5(struct asrc_farrow *src_obj)
 	}
 }
 
-void asrc_calc_impulse_response_n6(struct asrc_farrow *src_obj)
+static void calc_impulse_response_n6(struct asrc_farrow *src_obj,
+				     uint32_t time_value,
+				     int32_t *impulse_response)
 {
 	/*
 	 * See 'calc_impulse_response_n4' for a detailed description
@@ -264,8 +346,8 @@ void asrc_calc_impulse_response_n6(struct asrc_farrow *src_obj)
 	int index_limit;
 
 	filter_P = &src_obj->polyphase_filters[0];
-	result_P = &src_obj->impulse_response[0];
-	time = sat_int32(((int64_t)src_obj->time_value) << 4);
+	result_P = impulse_response;
+	time = sat_int32(((int64_t)time_value) << 4);
 
 	index_limit = src_obj->filter_length >> 1;
 	for (index_filter = 0; index_filter < index_limit; index_filter++) {
@@ -301,7 +383,9 @@ void asrc_calc_impulse_response_n6(struct asrc_farrow *src_obj)
 	}
 }
 
-void asrc_calc_impulse_response_n7(struct asrc_farrow *src_obj)
+static void calc_impulse_response_n7(struct asrc_farrow *src_obj,
+				     uint32_t time_value,
+				     int32_t *impulse_response)
 {
 	/*
 	 * See 'calc_impulse_response_n4' for a detailed description
@@ -318,8 +402,8 @@ void asrc_calc_impulse_response_n7(struct asrc_farrow *src_obj)
 	int index_limit;
 
 	filter_P = &src_obj->polyphase_filters[0];
-	result_P = &src_obj->impulse_response[0];
-	time = sat_int32(((int64_t)src_obj->time_value) << 4);
+	result_P = impulse_response;
+	time = sat_int32(((int64_t)time_value) << 4);
 
 	index_limit = src_obj->filter_length >> 1;
 	for (index_filter = 0; index_filter < index_limit; index_filter++) {
@@ -360,4 +444,48 @@ void asrc_calc_impulse_response_n7(struct asrc_farrow *src_obj)
 	}
 }
 
+void asrc_calc_impulse_response_n4(struct asrc_farrow *src_obj,
+				   const struct asrc_block *block)
+{
+	int frame;
+
+	for (frame = 0; frame < block->num_frames; frame++)
+		calc_impulse_response_n4(src_obj, block->time_value[frame],
+					 &src_obj->impulse_response
+					 [frame * src_obj->filter_length]);
+}
+
+void asrc_calc_impulse_response_n5(struct asrc_farrow *src_obj,
+				   const struct asrc_block *block)
+{
+	int frame;
+
+	for (frame = 0; frame < block->num_frames; frame++)
+		calc_impulse_response_n5(src_obj, block->time_value[frame],
+					 &src_obj->impulse_response
+					 [frame * src_obj->filter_length]);
+}
+
+void asrc_calc_impulse_response_n6(struct asrc_farrow *src_obj,
+				   const struct asrc_block *block)
+{
+	int frame;
+
+	for (frame = 0; frame < block->num_frames; frame++)
+		calc_impulse_response_n6(src_obj, block->time_value[frame],
+					 &src_obj->impulse_response
+					 [frame * src_obj->filter_length]);
+}
+
+void asrc_calc_impulse_response_n7(struct asrc_farrow *src_obj,
+				   const struct asrc_block *block)
+{
+	int frame;
+
+	for (frame = 0; frame < block->num_frames; frame++)
+		calc_impulse_response_n7(src_obj, block->time_value[frame],
+					 &src_obj->impulse_response
+					 [frame * src_obj->filter_length]);
+}
+
 #endif /* ASRC_GENERIC */
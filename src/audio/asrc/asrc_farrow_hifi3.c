@@ -12,7 +12,7 @@
 LOG_MODULE_DECLARE(asrc, CONFIG_SOF_LOG_LEVEL);
 
 void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
-		       int index_output_frame)
+		       const struct asrc_block *block)
 {
 	ae_f32x2 prod;
 	ae_f32x2 filter01 = AE_ZERO32(); /* Note: Init is not needed */
@@ -21,6 +21,8 @@ void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
 	ae_f32x2 *filter_p;
 	ae_f16x4 *buffer_p;
 	int n_limit;
+	int stride;
+	int frame;
 	int ch;
 	int n;
 	int i;
@@ -32,73 +34,79 @@ void asrc_fir_filter16(struct asrc_farrow *src_obj, int16_t **output_buffers,
 	 */
 	n_limit = src_obj->filter_length >> 2;
 	if (src_obj->output_format == ASRC_IOF_INTERLEAVED)
-		i = src_obj->num_channels * index_output_frame;
+		stride = src_obj->num_channels;
 	else
-		i = index_output_frame;
+		stride = 1;
 
 	/* Iterate over each channel */
 	for (ch = 0; ch < src_obj->num_channels; ch++) {
-		/* Pointer to the beginning of the impulse response */
-		filter_p = (ae_f32x2 *)&src_obj->impulse_response[0];
-
-		/* Pointer to the buffered input data */
-		buffer_p =
-			(ae_f16x4 *)&src_obj->ring_buffers16[ch]
-			[src_obj->buffer_write_position];
-
-		/* Allows unaligned load of 64 bit per cycle */
-		ae_valign align_filter = AE_LA64_PP(filter_p);
-		ae_valign align_buffer = AE_LA64_PP(buffer_p);
+		/* Filter each frame of the block */
+		for (frame = 0; frame < block->num_frames; frame++) {
+			i = stride * block->output_frame[frame];
+
+			/* Pointer to the impulse response of the frame */
+			filter_p = (ae_f32x2 *)&src_obj->impulse_response
+				[frame * src_obj->filter_length];
+
+			/* Pointer to the buffered input data */
+			buffer_p =
+				(ae_f16x4 *)&src_obj->ring_buffers16[ch]
+				[block->write_position[frame]];
+
+			/* Allows unaligned load of 64 bit per cycle */
+			ae_valign align_filter = AE_LA64_PP(filter_p);
+			ae_valign align_buffer = AE_LA64_PP(buffer_p);
+
+			/* Initialise the accumulator */
+			prod = AE_ZERO32();
+
+			/* Iterate over the filter bins */
+			for (n = 0; n < n_limit; n++) {
+				/* Read four buffered samples at once */
+				AE_LA16X4_RIP(buffer0123, align_buffer, buffer_p);
+
+				/* Store four bins of the impulse response */
+				AE_LA32X2_IP(filter01, align_filter, filter_p);
+				AE_LA32X2_IP(filter23, align_filter, filter_p);
+
+				/* Multiply and accumulate
+				 * the lower half bits in 'buffer0123' are used
+				 */
+				AE_MULAFP32X16X2RS_L(prod, filter23, buffer0123);
+				/* the upper half bits in 'buffer0123' are used */
+				AE_MULAFP32X16X2RS_H(prod, filter01, buffer0123);
+			}
+
+			/* Shift left after accumulation, because interim
+			 * results might saturate during filtering prod = prod
+			 * << 1; will shift after last addition
+			 */
 
-		/* Initialise the accumulator */
-		prod = AE_ZERO32();
+			/* swap LL and HH reusing filter01 to perform
+			 * saturated addition of both halves
+			 */
+			filter01 = AE_SEL32_LH(prod, prod);
 
-		/* Iterate over the filter bins */
-		for (n = 0; n < n_limit; n++) {
-			/* Read four buffered samples at once */
-			AE_LA16X4_RIP(buffer0123, align_buffer, buffer_p);
+			/* Add up the lower and upper 32 bit data of the
+			 * 'prod' prod = AE_ADD32_HL_LH(prod, prod); fix using
+			 * saturated addition
+			 */
+			prod = AE_ADD32S(prod, filter01);
 
-			/* Store four bins of the impulse response */
-			AE_LA32X2_IP(filter01, align_filter, filter_p);
-			AE_LA32X2_IP(filter23, align_filter, filter_p);
+			/* Shift with saturation */
+			prod = AE_SLAI32S(prod, 1);
 
-			/* Multiply and accumulate
-			 * the lower half bits in 'buffer0123' are used
+			/* Round 'prod' to 16 bit and store it in
+			 * (de-)interleaved format in the output buffers
 			 */
-			AE_MULAFP32X16X2RS_L(prod, filter23, buffer0123);
-			/* the upper half bits in 'buffer0123' are used */
-			AE_MULAFP32X16X2RS_H(prod, filter01, buffer0123);
+			AE_S16_0_X(AE_ROUND16X4F32SSYM(prod, prod),
+				   (ae_f16 *)&output_buffers[ch][i], 0);
 		}
-
-		/* Shift left after accumulation, because interim
-		 * results might saturate during filtering prod = prod
-		 * << 1; will shift after last addition
-		 */
-
-		/* swap LL and HH reusing filter01 to perform
-		 * saturated addition of both halves
-		 */
-		filter01 = AE_SEL32_LH(prod, prod);
-
-		/* Add up the lower and upper 32 bit data of the
-		 * 'prod' prod = AE_ADD32_HL_LH(prod, prod); fix using
-		 * saturated addition
-		 */
-		prod = AE_ADD32S(prod, filter01);
-
-		/* Shift with saturation */
-		prod = AE_SLAI32S(prod, 1);
-
-		/* Round 'prod' to 16 bit and store it in
-		 * (de-)interleaved format in the output buffers
-		 */
-		AE_S16_0_X(AE_ROUND16X4F32SSYM(prod, prod),
-			   (ae_f16 *)&output_buffers[ch][i], 0);
 	}
 }
 
 void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
-		       int index_output_frame)
+		       const struct asrc_block *block)
 {
 	ae_f32x2 prod;
 	ae_f32x2 buffer01 = AE_ZERO32(); /* Note: Init is not needed */
@@ -106,6 +114,8 @@ void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
 	ae_f32x2 *filter_p;
 	ae_f32x2 *buffer_p;
 	int n_limit;
+	int stride;
+	int frame;
 	int ch;
 	int n;
 	int i;
@@ -117,68 +127,76 @@ void asrc_fir_filter32(struct asrc_farrow *src_obj, int32_t **output_buffers,
 	 */
 	n_limit = src_obj->filter_length >> 1;
 	if (src_obj->output_format == ASRC_IOF_INTERLEAVED)
-		i = src_obj->num_channels * index_output_frame;
+		stride = src_obj->num_channels;
 	else
-		i = index_output_frame;
+		stride = 1;
 
 	/* Iterate over each channel */
 	for (ch = 0; ch < src_obj->num_channels; ch++) {
-		/* Pointer to the beginning of the impulse response */
-		filter_p = (ae_f32x2 *)&src_obj->impulse_response[0];
+		/* Filter each frame of the block */
+		for (frame = 0; frame < block->num_frames; frame++) {
+			i = stride * block->output_frame[frame];
 
-		/* Pointer to the buffered input data */
-		buffer_p =
-			(ae_f32x2 *)&src_obj->ring_buffers32[ch]
-			[src_obj->buffer_write_position];
+			/* Pointer to the impulse response of the frame */
+			filter_p = (ae_f32x2 *)&src_obj->impulse_response
+				[frame * src_obj->filter_length];
 
-		/* Allows unaligned load of 64 bit per cycle */
-		ae_valign align_filter = AE_LA64_PP(filter_p);
-		ae_valign align_buffer = AE_LA64_PP(buffer_p);
+			/* Pointer to the buffered input data */
+			buffer_p =
+				(ae_f32x2 *)&src_obj->ring_buffers32[ch]
+				[block->write_position[frame]];
 
-		/* Initialise the accumulator */
-		prod = AE_ZERO32();
+			/* Allows unaligned load of 64 bit per cycle */
+			ae_valign align_filter = AE_LA64_PP(filter_p);
+			ae_valign align_buffer = AE_LA64_PP(buffer_p);
 
-		/* Iterate over the filter bins */
-		for (n = 0; n < n_limit; n++) {
-			/* Read two buffered samples at once */
-			AE_LA32X2_RIP(buffer01, align_buffer, buffer_p);
+			/* Initialise the accumulator */
+			prod = AE_ZERO32();
 
-			/* Store two bins of the impulse response */
-			AE_LA32X2_IP(filter01, align_filter, filter_p);
+			/* Iterate over the filter bins */
+			for (n = 0; n < n_limit; n++) {
+				/* Read two buffered samples at once */
+				AE_LA32X2_RIP(buffer01, align_buffer, buffer_p);
 
-			/* Multiply and accumulate */
-			AE_MULAFP32X2RS(prod, buffer01, filter01);
-		}
+				/* Store two bins of the impulse response */
+				AE_LA32X2_IP(filter01, align_filter, filter_p);
 
-		/* Shift left after accumulation, because interim
-		 * results might saturate during filtering prod = prod
-		 * << 1; will shift after last addition
-		 */
+				/* Multiply and accumulate */
+				AE_MULAFP32X2RS(prod, buffer01, filter01);
+			}
 
-		/* swap LL and HH reusing filter01 to perform
-		 * saturated addition of both halves
-		 */
-		filter01 = AE_SEL32_LH(prod, prod);
+			/* Shift left after accumulation, because interim
+			 * results might saturate during filtering prod = prod
+			 * << 1; will shift after last addition
+			 */
 
-		/* Add up the lower and upper 32 bit data of the
-		 * 'prod' prod = AE_ADD32_HL_LH(prod, prod); fix using
-		 * saturated addition
-		 */
-		prod = AE_ADD32S(prod, filter01);
+			/* swap LL and HH reusing filter01 to perform
+			 * saturated addition of both halves
+			 */
+			filter01 = AE_SEL32_LH(prod, prod);
 
-		/* Shift with saturation */
-		prod = AE_SLAI32S(prod, 1);
+			/* Add up the lower and upper 32 bit data of the
+			 * 'prod' prod = AE_ADD32_HL_LH(prod, prod); fix using
+			 * saturated addition
+			 */
+			prod = AE_ADD32S(prod, filter01);
 
-		/* Store 'prod' in (de-)interleaved format in the output
-		 * buffers
-		 */
-		AE_S32_L_X(prod, (ae_f32 *)&output_buffers[ch][i], 0);
+			/* Shift with saturation */
+			prod = AE_SLAI32S(prod, 1);
+
+			/* Store 'prod' in (de-)interleaved format in the output
+			 * buffers
+			 */
+			AE_S32_L_X(prod, (ae_f32 *)&output_buffers[ch][i], 0);
+		}
 	}
 }
 
 /* + ALGORITHM SPECIFIC FUNCTIONS */
 
-void asrc_calc_impulse_response_n4(struct asrc_farrow *src_obj)
+static void calc_impulse_response_n4(struct asrc_farrow *src_obj,
+				     uint32_t time_value,
+				     int32_t *impulse_response)
 {
 	ae_f32x2 time_x2;
 	ae_f32x2 accum20 = AE_ZERO32(); /* Note: Init is not needed */
@@ -197,14 +215,14 @@ void asrc_calc_impulse_response_n4(struct asrc_farrow *src_obj)
 	 * Set the pointer to the impulse response.
 	 * This is where the result is stored.
 	 */
-	result_P = (ae_f32x2 *)&src_obj->impulse_response[0];
+	result_P = (ae_f32x2 *)impulse_response;
 
 	/* allow unaligned load of 64 bit of polyphase filter coefficients */
 	align_f = AE_LA64_PP(filter_P);
 	align_out = AE_ZALIGN64();
 
 	/* Get the current fractional time */
-	time_x2 = AE_L32_X((ae_f32 *)&src_obj->time_value, 0);
+	time_x2 = AE_L32_X((ae_f32 *)&time_value, 0);
 	time_x2 = AE_SLAI32S(time_x2, 4);
 
 	/*
@@ -257,7 +275,9 @@ void asrc_calc_impulse_response_n4(struct asrc_farrow *src_obj)
 	AE_SA64POS_FP(align_out, result_P);
 }
 
-void asrc_calc_impulse_response_n5(struct asrc_farrow *src_obj)
+static void calc_impulse_response_n5(struct asrc_farrow *src_obj,
+				     uint32_t time_value,
+				     int32_t *impulse_response)
 {
 	/*
 	 * See 'calc_impulse_response_n4' for a detailed description
@@ -274,12 +294,12 @@ void asrc_calc_impulse_response_n5(struct asrc_farrow *src_obj)
 	int index_limit;
 
 	filter_P = (ae_f32x2 *)&src_obj->polyphase_filters[0];
-	result_P = (ae_f32x2 *)&src_obj->impulse_response[0];
+	result_P = (ae_f32x2 *)impulse_response;
 
 	align_f = AE_LA64_PP(filter_P);
 	align_out = AE_ZALIGN64();
 
-	time_x2 = AE_L32_X((ae_f32 *)&src_obj->time_value, 0);
+	time_x2 = AE_L32_X((ae_f32 *)&time_value, 0);
 	time_x2 = AE_SLAI32S(time_x2, 4);
 
 	index_limit = src_obj->filter_length >> 1;
@@ -302,7 +322,9 @@ void asrc_calc_impulse_response_n5(struct asrc_farrow *src_obj)
 	AE_SA64POS_FP(align_out, result_P);
 }
 
-void asrc_calc_impulse_response_n6(struct asrc_farrow *src_obj)
+static void calc_impulse_response_n6(struct asrc_farrow *src_obj,
+				     uint32_t time_value,
+				     int32_t *impulse_response)
 {
 	/*
 	 * See 'calc_impulse_response_n4' for a detailed description
@@ -319,12 +341,12 @@ void asrc_calc_impulse_response_n6(struct asrc_farrow *src_obj)
 	int index_limit;
 
 	filter_P = (ae_f32x2 *)&src_obj->polyphase_filters[0];
-	result_P = (ae_f32x2 *)&src_obj->impulse_response[0];
+	result_P = (ae_f32x2 *)impulse_response;
 
 	align_f = AE_LA64_PP(filter_P);
 	align_out = AE_ZALIGN64();
 
-	time_x2 = AE_L32_X((ae_f32 *)&src_obj->time_value, 0);
+	time_x2 = AE_L32_X((ae_f32 *)&time_value, 0);
 	time_x2 = AE_SLAI32S(time_x2, 4);
 
 	index_limit = src_obj->filter_length >> 1;
@@ -350,7 +372,9 @@ void asrc_calc_impulse_response_n6(struct asrc_farrow *src_obj)
 	AE_SA64POS_FP(align_out, result_P);
 }
 
-void asrc_calc_impulse_response_n7(struct asrc_farrow *src_obj)
+static void calc_impulse_response_n7(struct asrc_farrow *src_obj,
+				     uint32_t time_value,
+				     int32_t *impulse_response)
 {
 	/*
 	 * See 'calc_impulse_response_n4' for a detailed description
@@ -367,12 +391,12 @@ void asrc_calc_impulse_response_n7(struct asrc_farrow *src_obj)
 	int index_limit;
 
 	filter_P = (ae_f32x2 *)&src_obj->polyphase_filters[0];
-	result_P = (ae_f32x2 *)&src_obj->impulse_response[0];
+	result_P = (ae_f32x2 *)impulse_response;
 
 	align_f = AE_LA64_PP(filter_P);
 	align_out = AE_ZALIGN64();
 
-	time_x2 = AE_L32_X((ae_f32 *)&src_obj->time_value, 0);
+	time_x2 = AE_L32_X((ae_f32 *)&time_value, 0);
 	time_x2 = AE_SLAI32S(time_x2, 4);
 
 	index_limit = src_obj->filter_length >> 1;
@@ -401,4 +425,48 @@ void asrc_calc_impulse_response_n7(struct asrc_farrow *src_obj)
 	AE_SA64POS_FP(align_out, result_P);
 }
 
+void asrc_calc_impulse_response_n4(struct asrc_farrow *src_obj,
+				   const struct asrc_block *block)
+{
+	int frame;
+
+	for (frame = 0; frame < block->num_frames; frame++)
+		calc_impulse_response_n4(src_obj, block->time_value[frame],
+					 &src_obj->impulse_response
+					 [frame * src_obj->filter_length]);
+}
+
+void asrc_calc_impulse_response_n5(struct asrc_farrow *src_obj,
+				   const struct asrc_block *block)
+{
+	int frame;
+
+	for (frame = 0; frame < block->num_frames; frame++)
+		calc_impulse_response_n5(src_obj, block->time_value[frame],
+					 &src_obj->impulse_response
+					 [frame * src_obj->filter_length]);
+}
+
+void asrc_calc_impulse_response_n6(struct asrc_farrow *src_obj,
+				   const struct asrc_block *block)
+{
+	int frame;
+
+	for (frame = 0; frame < block->num_frames; frame++)
+		calc_impulse_response_n6(src_obj, block->time_value[frame],
+					 &src_obj->impulse_response
+					 [frame * src_obj->filter_length]);
+}
+
+void asrc_calc_impulse_response_n7(struct asrc_farrow *src_obj,
+				   const struct asrc_block *block)
+{
+	int frame;
+
+	for (frame = 0; frame < block->num_frames; frame++)
+		calc_impulse_response_n7(src_obj, block->time_value[frame],
+					 &src_obj->impulse_response
+					 [frame * src_obj->filter_length]);
+}
+
 #endif /* ASRC Hifi3 */
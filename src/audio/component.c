@@ -21,6 +21,13 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#if CONFIG_LIBRARY
+#include <time.h>
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+#endif
+
 #if defined(__XCC__)
 #include <xtensa/config/core-isa.h>
 #if XCHAL_HAVE_HIFI3 || XCHAL_HAVE_HIFI4
@@ -295,10 +302,45 @@ void audio_stream_copy_to_linear(const struct audio_stream __sparse_cache *sourc
 	}
 }
 
+#if CONFIG_LIBRARY
+static inline uint64_t comp_copy_time_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* Time stamp counter on x86, elsewhere nanoseconds i.e. 1 GHz cycles */
+static inline uint64_t comp_copy_cycles(void)
+{
+#if defined(__i386__) || defined(__x86_64__)
+	return __rdtsc();
+#else
+	return comp_copy_time_ns();
+#endif
+}
+
+static void comp_copy_stats_update(struct comp_copy_stats *stats, uint64_t ns0,
+				   uint64_t cycles0)
+{
+	uint64_t ns = comp_copy_time_ns() - ns0;
+
+	stats->cycles += comp_copy_cycles() - cycles0;
+	stats->time_ns += ns;
+	stats->peak_ns = MAX(stats->peak_ns, ns);
+	stats->copies++;
+}
+#endif
+
 /** See comp_ops::copy */
 int comp_copy(struct comp_dev *dev)
 {
 	int ret = 0;
+#if CONFIG_LIBRARY
+	uint64_t cycles;
+	uint64_t ns;
+#endif
 
 	assert(dev->drv->ops.copy);
 
@@ -307,9 +349,16 @@ int comp_copy(struct comp_dev *dev)
 #if CONFIG_PERFORMANCE_COUNTERS
 		perf_cnt_init(&dev->pcd);
 #endif
+#if CONFIG_LIBRARY
+		ns = comp_copy_time_ns();
+		cycles = comp_copy_cycles();
+#endif
 
 		ret = dev->drv->ops.copy(dev);
 
+#if CONFIG_LIBRARY
+		comp_copy_stats_update(&dev->copy_stats, ns, cycles);
+#endif
 #if CONFIG_PERFORMANCE_COUNTERS
 		perf_cnt_stamp(&dev->pcd, perf_trace_null, dev);
 		perf_cnt_average(&dev->pcd, comp_perf_avg_info, dev);
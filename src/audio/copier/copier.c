@@ -646,84 +646,6 @@ static pcm_converter_func get_converter_func(const struct ipc4_audio_format *in_
 		return pcm_get_conversion_vc_function(in, in_valid, out, out_valid, type, dir);
 }
 
-static void copy_single_channel_c16(struct audio_stream __sparse_cache *dst,
-				    int dst_channel,
-				    const struct audio_stream __sparse_cache *src,
-				    int src_channel, int frame_count)
-{
-	int16_t *r_ptr = (int16_t *)src->r_ptr + src_channel;
-	int16_t *w_ptr = (int16_t *)dst->w_ptr + dst_channel;
-
-	/* We have to iterate over frames here. However, tracking frames requires using
-	 * of expensive division operations (e.g., inside audio_stream_frames_without_wrap()).
-	 * So let's track samples instead. Since we only copy one channel, src_stream_sample_count
-	 * is NOT number of samples we need to copy but total samples for all channels. We just
-	 * track them to know when to stop.
-	 */
-	int src_stream_sample_count = frame_count * src->channels;
-
-	while (src_stream_sample_count) {
-		int src_samples_without_wrap;
-		int16_t *r_end_ptr, *r_ptr_before_loop;
-
-		r_ptr = audio_stream_wrap(src, r_ptr);
-		w_ptr = audio_stream_wrap(dst, w_ptr);
-
-		src_samples_without_wrap = audio_stream_samples_without_wrap_s16(src, r_ptr);
-		r_end_ptr = src_stream_sample_count < src_samples_without_wrap ?
-			r_ptr + src_stream_sample_count : (int16_t *)src->end_addr;
-
-		r_ptr_before_loop = r_ptr;
-
-		do {
-			*w_ptr = *r_ptr;
-			r_ptr += src->channels;
-			w_ptr += dst->channels;
-		} while (r_ptr < r_end_ptr && w_ptr < (int16_t *)dst->end_addr);
-
-		src_stream_sample_count -= r_ptr - r_ptr_before_loop;
-	}
-}
-
-static void copy_single_channel_c32(struct audio_stream __sparse_cache *dst,
-				    int dst_channel,
-				    const struct audio_stream __sparse_cache *src,
-				    int src_channel, int frame_count)
-{
-	int32_t *r_ptr = (int32_t *)src->r_ptr + src_channel;
-	int32_t *w_ptr = (int32_t *)dst->w_ptr + dst_channel;
-
-	/* We have to iterate over frames here. However, tracking frames requires using
-	 * of expensive division operations (e.g., inside audio_stream_frames_without_wrap()).
-	 * So let's track samples instead. Since we only copy one channel, src_stream_sample_count
-	 * is NOT number of samples we need to copy but total samples for all channels. We just
-	 * track them to know when to stop.
-	 */
-	int src_stream_sample_count = frame_count * src->channels;
-
-	while (src_stream_sample_count) {
-		int src_samples_without_wrap;
-		int32_t *r_end_ptr, *r_ptr_before_loop;
-
-		r_ptr = audio_stream_wrap(src, r_ptr);
-		w_ptr = audio_stream_wrap(dst, w_ptr);
-
-		src_samples_without_wrap = audio_stream_samples_without_wrap_s32(src, r_ptr);
-		r_end_ptr = src_stream_sample_count < src_samples_without_wrap ?
-			r_ptr + src_stream_sample_count : (int32_t *)src->end_addr;
-
-		r_ptr_before_loop = r_ptr;
-
-		do {
-			*w_ptr = *r_ptr;
-			r_ptr += src->channels;
-			w_ptr += dst->channels;
-		} while (r_ptr < r_end_ptr && w_ptr < (int32_t *)dst->end_addr);
-
-		src_stream_sample_count -= r_ptr - r_ptr_before_loop;
-	}
-}
-
 static int copier_prepare(struct comp_dev *dev)
 {
 	struct copier_data *cd = comp_get_drvdata(dev);
@@ -775,15 +697,20 @@ static int copier_prepare(struct comp_dev *dev)
 
 		switch (container_size) {
 		case 2:
-			cd->copy_single_channel = copy_single_channel_c16;
+			cd->mux = mux_c16;
+			cd->demux = demux_c16;
 			break;
 		case 4:
-			cd->copy_single_channel = copy_single_channel_c32;
+			cd->mux = mux_c32;
+			cd->demux = demux_c32;
 			break;
 		default:
 			comp_err(dev, "Unexpected container size: %d", container_size);
 			return -EINVAL;
 		}
+
+		cd->demux_copy = cd->bsource_buffer &&
+			cd->converter[IPC4_COPIER_GATEWAY_PIN] == audio_stream_copy;
 	}
 
 	return 0;
@@ -940,87 +867,75 @@ static inline struct comp_buffer *get_endpoint_buffer(struct copier_data *cd)
 		cd->endpoint_buffer[IPC4_COPIER_GATEWAY_PIN];
 }
 
-static int demux_from_multi_endpoint_buffer(struct copier_data *cd)
+/* Demux multi-channel stream from source buffer into endpoint buffers. The source is
+ * multi_endpoint_buffer or, when the gateway conversion is a plain copy, the copier
+ * source buffer itself. Returns number of bytes consumed from the source.
+ */
+static uint32_t demux_from_multi_endpoint_buffer(struct copier_data *cd,
+						 struct comp_buffer __sparse_cache *multi_buf_c)
 {
-	struct comp_buffer __sparse_cache *multi_buf_c, *endp_buf_c;
-	int endp_idx, endp_channel;
+	struct comp_buffer __sparse_cache *endp_buf_c[IPC4_COPIER_MODULE_OUTPUT_PINS_COUNT];
+	struct audio_stream __sparse_cache *endp[IPC4_COPIER_MODULE_OUTPUT_PINS_COUNT];
+	const uint16_t *chmap[IPC4_COPIER_MODULE_OUTPUT_PINS_COUNT];
 	uint32_t frame_count, byte_count;
-
-	multi_buf_c = buffer_acquire(cd->multi_endpoint_buffer);
+	int endp_idx;
 
 	frame_count = audio_stream_get_avail_frames(&multi_buf_c->stream);
 
 	for (endp_idx = 0; endp_idx < cd->endpoint_num; endp_idx++) {
-		endp_buf_c = buffer_acquire(cd->endpoint_buffer[endp_idx]);
-		frame_count = MIN(frame_count, audio_stream_get_free_frames(&endp_buf_c->stream));
-		buffer_release(endp_buf_c);
+		endp_buf_c[endp_idx] = buffer_acquire(cd->endpoint_buffer[endp_idx]);
+		endp[endp_idx] = &endp_buf_c[endp_idx]->stream;
+		chmap[endp_idx] = endp_buf_c[endp_idx]->chmap;
+		frame_count = MIN(frame_count, audio_stream_get_free_frames(endp[endp_idx]));
 	}
 
 	byte_count = frame_count * audio_stream_frame_bytes(&multi_buf_c->stream);
 	buffer_stream_invalidate(multi_buf_c, byte_count);
 
-	for (endp_idx = 0; endp_idx < cd->endpoint_num; endp_idx++) {
-		uint32_t bytes_produced;
-
-		endp_buf_c = buffer_acquire(cd->endpoint_buffer[endp_idx]);
+	cd->demux(&multi_buf_c->stream, endp, chmap, cd->endpoint_num, frame_count);
 
-		for (endp_channel = 0; endp_channel < endp_buf_c->stream.channels;
-				endp_channel++) {
-			int multi_buf_channel = endp_buf_c->chmap[endp_channel];
-
-			cd->copy_single_channel(&endp_buf_c->stream, endp_channel,
-						&multi_buf_c->stream, multi_buf_channel,
-						frame_count);
-		}
+	for (endp_idx = 0; endp_idx < cd->endpoint_num; endp_idx++) {
+		uint32_t bytes_produced = frame_count * audio_stream_frame_bytes(endp[endp_idx]);
 
-		bytes_produced = frame_count * audio_stream_frame_bytes(&endp_buf_c->stream);
-		buffer_stream_writeback(endp_buf_c, bytes_produced);
-		comp_update_buffer_produce(endp_buf_c, bytes_produced);
-		buffer_release(endp_buf_c);
+		buffer_stream_writeback(endp_buf_c[endp_idx], bytes_produced);
+		comp_update_buffer_produce(endp_buf_c[endp_idx], bytes_produced);
+		buffer_release(endp_buf_c[endp_idx]);
 	}
 
-	comp_update_buffer_consume(multi_buf_c, byte_count);
-	buffer_release(multi_buf_c);
-
-	return 0;
+	return byte_count;
 }
 
 static int mux_into_multi_endpoint_buffer(struct copier_data *cd)
 {
-	struct comp_buffer __sparse_cache *multi_buf_c, *endp_buf_c;
-	int endp_idx, endp_channel;
+	struct comp_buffer __sparse_cache *endp_buf_c[IPC4_COPIER_MODULE_OUTPUT_PINS_COUNT];
+	struct audio_stream __sparse_cache *endp[IPC4_COPIER_MODULE_OUTPUT_PINS_COUNT];
+	const uint16_t *chmap[IPC4_COPIER_MODULE_OUTPUT_PINS_COUNT];
+	struct comp_buffer __sparse_cache *multi_buf_c;
 	uint32_t frame_count = UINT32_MAX;
 	uint32_t bytes_produced;
+	int endp_idx;
 
 	for (endp_idx = 0; endp_idx < cd->endpoint_num; endp_idx++) {
-		endp_buf_c = buffer_acquire(cd->endpoint_buffer[endp_idx]);
-		frame_count = MIN(frame_count, audio_stream_get_avail_frames(&endp_buf_c->stream));
-		buffer_release(endp_buf_c);
+		endp_buf_c[endp_idx] = buffer_acquire(cd->endpoint_buffer[endp_idx]);
+		endp[endp_idx] = &endp_buf_c[endp_idx]->stream;
+		chmap[endp_idx] = endp_buf_c[endp_idx]->chmap;
+		frame_count = MIN(frame_count, audio_stream_get_avail_frames(endp[endp_idx]));
 	}
 
 	multi_buf_c = buffer_acquire(cd->multi_endpoint_buffer);
 
 	frame_count = MIN(frame_count, audio_stream_get_free_frames(&multi_buf_c->stream));
 
-	for (endp_idx = 0; endp_idx < cd->endpoint_num; endp_idx++) {
-		uint32_t endp_buf_byte_count;
-
-		endp_buf_c = buffer_acquire(cd->endpoint_buffer[endp_idx]);
+	for (endp_idx = 0; endp_idx < cd->endpoint_num; endp_idx++)
+		buffer_stream_invalidate(endp_buf_c[endp_idx],
+					 frame_count * audio_stream_frame_bytes(endp[endp_idx]));
 
-		endp_buf_byte_count = frame_count * audio_stream_frame_bytes(&endp_buf_c->stream);
-		buffer_stream_invalidate(endp_buf_c, endp_buf_byte_count);
+	cd->mux(&multi_buf_c->stream, endp, chmap, cd->endpoint_num, frame_count);
 
-		for (endp_channel = 0; endp_channel < endp_buf_c->stream.channels;
-				endp_channel++) {
-			int multi_buf_channel = endp_buf_c->chmap[endp_channel];
-
-			cd->copy_single_channel(&multi_buf_c->stream, multi_buf_channel,
-						&endp_buf_c->stream, endp_channel,
-						frame_count);
-		}
-
-		comp_update_buffer_consume(endp_buf_c, endp_buf_byte_count);
-		buffer_release(endp_buf_c);
+	for (endp_idx = 0; endp_idx < cd->endpoint_num; endp_idx++) {
+		comp_update_buffer_consume(endp_buf_c[endp_idx],
+					   frame_count * audio_stream_frame_bytes(endp[endp_idx]));
+		buffer_release(endp_buf_c[endp_idx]);
 	}
 
 	bytes_produced = frame_count * audio_stream_frame_bytes(&multi_buf_c->stream);
@@ -1032,18 +947,40 @@ static int mux_into_multi_endpoint_buffer(struct copier_data *cd)
 	return 0;
 }
 
-static int do_endpoint_copy(struct copier_data *cd)
+/* When the gateway conversion is a plain copy there is no need to stage the data in
+ * multi_endpoint_buffer, the endpoints can be demuxed straight from the source buffer
+ * so each sample is touched once. The source buffer must not be shared with other
+ * sinks as they consume it with their own limits. Sinks can be bound and attenuation
+ * set after prepare, so this is checked on each copy.
+ */
+static bool copier_demux_from_source(struct comp_dev *dev, struct copier_data *cd)
+{
+	return cd->demux_copy && !cd->attenuation && list_is_empty(&dev->bsink_list);
+}
+
+/* Demux the data staged in multi_endpoint_buffer into endpoint buffers */
+static void demux_multi_endpoint_buffer(struct copier_data *cd)
+{
+	struct comp_buffer __sparse_cache *multi_buf_c;
+	uint32_t bytes_consumed;
+
+	multi_buf_c = buffer_acquire(cd->multi_endpoint_buffer);
+	if (audio_stream_get_avail_bytes(&multi_buf_c->stream)) {
+		bytes_consumed = demux_from_multi_endpoint_buffer(cd, multi_buf_c);
+		comp_update_buffer_consume(multi_buf_c, bytes_consumed);
+	}
+	buffer_release(multi_buf_c);
+}
+
+static int do_endpoint_copy(struct comp_dev *dev, struct copier_data *cd)
 {
 	if (cd->multi_endpoint_buffer) {
 		int i;
 		int ret = 0;
 
 		/* multiple gateways on output */
-		if (cd->bsource_buffer) {
-			ret = demux_from_multi_endpoint_buffer(cd);
-			if (ret < 0)
-				return ret;
-		}
+		if (cd->bsource_buffer && !copier_demux_from_source(dev, cd))
+			demux_multi_endpoint_buffer(cd);
 
 		for (i = 0; i < cd->endpoint_num; i++) {
 			ret = cd->endpoint[i]->drv->ops.copy(cd->endpoint[i]);
@@ -1081,13 +1018,18 @@ static int do_conversion_copy(struct comp_dev *dev,
 		return -EINVAL;
 	buffer_stream_invalidate(src, processed_data->source_bytes);
 
-	cd->converter[i](&src->stream, 0, &sink->stream, 0,
-			 processed_data->frames * sink->stream.channels);
-
 	if (cd->attenuation) {
-		ret = apply_attenuation(dev, cd, sink, processed_data->frames);
-		if (ret < 0)
+		ret = pcm_convert_attenuated(&src->stream, 0, &sink->stream, 0,
+					     processed_data->frames * sink->stream.channels,
+					     cd->converter[i], cd->attenuation);
+		if (ret < 0) {
+			comp_err(dev, "attenuation unsupported for sink format %d",
+				 sink->stream.frame_fmt);
 			return ret;
+		}
+	} else {
+		cd->converter[i](&src->stream, 0, &sink->stream, 0,
+				 processed_data->frames * sink->stream.channels);
 	}
 
 	buffer_stream_writeback(sink, processed_data->sink_bytes);
@@ -1122,7 +1064,7 @@ static int copier_copy(struct comp_dev *dev)
 
 	if (cd->endpoint_num && !cd->bsource_buffer) {
 		/* gateway(s) as input */
-		ret = do_endpoint_copy(cd);
+		ret = do_endpoint_copy(dev, cd);
 		if (ret < 0)
 			return ret;
 
@@ -1137,7 +1079,16 @@ static int copier_copy(struct comp_dev *dev)
 		src = list_first_item(&dev->bsource_list, struct comp_buffer, sink_list);
 		src_c = buffer_acquire(src);
 
-		if (cd->endpoint_num) {
+		if (copier_demux_from_source(dev, cd)) {
+			/* multiple gateways on output demuxed straight from source, the
+			 * consumed bytes are accounted for below. Data staged before
+			 * the switch to this path goes out first.
+			 */
+			demux_multi_endpoint_buffer(cd);
+			if (src_c->hw_params_configured)
+				processed_data.source_bytes =
+					demux_from_multi_endpoint_buffer(cd, src_c);
+		} else if (cd->endpoint_num) {
 			/* gateway(s) on output */
 			sink_c = buffer_acquire(get_endpoint_buffer(cd));
 			ret = do_conversion_copy(dev, cd, src_c, sink_c, &processed_data);
@@ -1147,8 +1098,10 @@ static int copier_copy(struct comp_dev *dev)
 				buffer_release(src_c);
 				return ret;
 			}
+		}
 
-			ret = do_endpoint_copy(cd);
+		if (cd->endpoint_num) {
+			ret = do_endpoint_copy(dev, cd);
 			if (ret < 0) {
 				buffer_release(src_c);
 				return ret;
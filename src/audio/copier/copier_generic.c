@@ -1,57 +1,158 @@
 // SPDX-License-Identifier: BSD-3-Clause
 //
 // Copyright(c) 2022 Intel Corporation. All rights reserved.
-//
-// Author: Andrula Song <xiaoyuan.song@intel.com>
 
+#include <sof/audio/audio_stream.h>
+#include <sof/common.h>
 #include <ipc4/copier.h>
 
-#ifdef COPIER_GENERIC
-
-#include <sof/audio/buffer.h>
-#include <sof/audio/component_ext.h>
-#include <sof/audio/format.h>
-#include <sof/audio/pipeline.h>
-#include <sof/audio/component.h>
-#include <sof/common.h>
-#include <stddef.h>
-#include <errno.h>
 #include <stdint.h>
 
-LOG_MODULE_REGISTER(copier_generic, CONFIG_SOF_LOG_LEVEL);
-
-int apply_attenuation(struct comp_dev *dev, struct copier_data *cd,
-		      struct comp_buffer __sparse_cache *sink, int frame)
+/* Number of frames that can be processed before any of the multi-endpoint
+ * or endpoint pointers reaches its buffer end.
+ */
+static uint32_t multi_endpoint_block(const struct audio_stream __sparse_cache *multi,
+				     const void *multi_ptr,
+				     struct audio_stream __sparse_cache **endp,
+				     void **endp_ptr, int endp_num, uint32_t frames)
 {
 	int i;
-	int n;
-	int nmax;
-	int remaining_samples = frame * sink->stream.channels;
-	int32_t *dst = sink->stream.r_ptr;
-
-	/* only support attenuation in format of 32bit */
-	switch (sink->stream.frame_fmt) {
-	case SOF_IPC_FRAME_S16_LE:
-		comp_err(dev, "16bit sample isn't supported by attenuation");
-		return -EINVAL;
-	case SOF_IPC_FRAME_S24_4LE:
-	case SOF_IPC_FRAME_S32_LE:
-		while (remaining_samples) {
-			nmax = audio_stream_samples_without_wrap_s32(&sink->stream, dst);
-			n = MIN(remaining_samples, nmax);
-			for (i = 0; i < n; i++) {
-				*dst >>= cd->attenuation;
-				dst++;
+
+	frames = MIN(frames, audio_stream_frames_without_wrap(multi, multi_ptr));
+	for (i = 0; i < endp_num; i++)
+		frames = MIN(frames, audio_stream_frames_without_wrap(endp[i], endp_ptr[i]));
+
+	return frames;
+}
+
+/* The mux/demux kernels walk the multi-endpoint stream once, frame by frame, and
+ * gather/scatter the channels of all endpoints in that frame, instead of walking the
+ * multi-endpoint stream once per endpoint channel.
+ */
+void demux_c16(struct audio_stream __sparse_cache *multi,
+	       struct audio_stream __sparse_cache **endp,
+	       const uint16_t **chmap, int endp_num, uint32_t frames)
+{
+	void *w_ptr[IPC4_COPIER_MODULE_OUTPUT_PINS_COUNT];
+	int16_t *r_ptr = multi->r_ptr;
+	int16_t *dst;
+	uint32_t n, frame;
+	int i, ch;
+
+	for (i = 0; i < endp_num; i++)
+		w_ptr[i] = endp[i]->w_ptr;
+
+	while (frames) {
+		n = multi_endpoint_block(multi, r_ptr, endp, w_ptr, endp_num, frames);
+		for (frame = 0; frame < n; frame++) {
+			for (i = 0; i < endp_num; i++) {
+				dst = w_ptr[i];
+				for (ch = 0; ch < endp[i]->channels; ch++)
+					dst[ch] = r_ptr[chmap[i][ch]];
+				w_ptr[i] = dst + endp[i]->channels;
+			}
+			r_ptr += multi->channels;
+		}
+
+		frames -= n;
+		r_ptr = audio_stream_wrap(multi, r_ptr);
+		for (i = 0; i < endp_num; i++)
+			w_ptr[i] = audio_stream_wrap(endp[i], w_ptr[i]);
+	}
+}
+
+void demux_c32(struct audio_stream __sparse_cache *multi,
+	       struct audio_stream __sparse_cache **endp,
+	       const uint16_t **chmap, int endp_num, uint32_t frames)
+{
+	void *w_ptr[IPC4_COPIER_MODULE_OUTPUT_PINS_COUNT];
+	int32_t *r_ptr = multi->r_ptr;
+	int32_t *dst;
+	uint32_t n, frame;
+	int i, ch;
+
+	for (i = 0; i < endp_num; i++)
+		w_ptr[i] = endp[i]->w_ptr;
+
+	while (frames) {
+		n = multi_endpoint_block(multi, r_ptr, endp, w_ptr, endp_num, frames);
+		for (frame = 0; frame < n; frame++) {
+			for (i = 0; i < endp_num; i++) {
+				dst = w_ptr[i];
+				for (ch = 0; ch < endp[i]->channels; ch++)
+					dst[ch] = r_ptr[chmap[i][ch]];
+				w_ptr[i] = dst + endp[i]->channels;
 			}
-			remaining_samples -= n;
-			dst = audio_stream_wrap(&sink->stream, dst);
+			r_ptr += multi->channels;
 		}
 
-		return 0;
-	default:
-		comp_err(dev, "unsupported format %d for attenuation", sink->stream.frame_fmt);
-		return -EINVAL;
+		frames -= n;
+		r_ptr = audio_stream_wrap(multi, r_ptr);
+		for (i = 0; i < endp_num; i++)
+			w_ptr[i] = audio_stream_wrap(endp[i], w_ptr[i]);
 	}
 }
 
-#endif
+void mux_c16(struct audio_stream __sparse_cache *multi,
+	     struct audio_stream __sparse_cache **endp,
+	     const uint16_t **chmap, int endp_num, uint32_t frames)
+{
+	void *r_ptr[IPC4_COPIER_MODULE_OUTPUT_PINS_COUNT];
+	int16_t *w_ptr = multi->w_ptr;
+	int16_t *src;
+	uint32_t n, frame;
+	int i, ch;
+
+	for (i = 0; i < endp_num; i++)
+		r_ptr[i] = endp[i]->r_ptr;
+
+	while (frames) {
+		n = multi_endpoint_block(multi, w_ptr, endp, r_ptr, endp_num, frames);
+		for (frame = 0; frame < n; frame++) {
+			for (i = 0; i < endp_num; i++) {
+				src = r_ptr[i];
+				for (ch = 0; ch < endp[i]->channels; ch++)
+					w_ptr[chmap[i][ch]] = src[ch];
+				r_ptr[i] = src + endp[i]->channels;
+			}
+			w_ptr += multi->channels;
+		}
+
+		frames -= n;
+		w_ptr = audio_stream_wrap(multi, w_ptr);
+		for (i = 0; i < endp_num; i++)
+			r_ptr[i] = audio_stream_wrap(endp[i], r_ptr[i]);
+	}
+}
+
+void mux_c32(struct audio_stream __sparse_cache *multi,
+	     struct audio_stream __sparse_cache **endp,
+	     const uint16_t **chmap, int endp_num, uint32_t frames)
+{
+	void *r_ptr[IPC4_COPIER_MODULE_OUTPUT_PINS_COUNT];
+	int32_t *w_ptr = multi->w_ptr;
+	int32_t *src;
+	uint32_t n, frame;
+	int i, ch;
+
+	for (i = 0; i < endp_num; i++)
+		r_ptr[i] = endp[i]->r_ptr;
+
+	while (frames) {
+		n = multi_endpoint_block(multi, w_ptr, endp, r_ptr, endp_num, frames);
+		for (frame = 0; frame < n; frame++) {
+			for (i = 0; i < endp_num; i++) {
+				src = r_ptr[i];
+				for (ch = 0; ch < endp[i]->channels; ch++)
+					w_ptr[chmap[i][ch]] = src[ch];
+				r_ptr[i] = src + endp[i]->channels;
+			}
+			w_ptr += multi->channels;
+		}
+
+		frames -= n;
+		w_ptr = audio_stream_wrap(multi, w_ptr);
+		for (i = 0; i < endp_num; i++)
+			r_ptr[i] = audio_stream_wrap(endp[i], r_ptr[i]);
+	}
+}
@@ -85,6 +85,9 @@ static inline void crossover_reset_state(struct comp_data *cd)
 
 	for (i = 0; i < PLATFORM_MAX_CHANNELS; i++)
 		crossover_reset_state_ch(&cd->state[i]);
+
+	rfree(cd->multich_data);
+	cd->multich_data = NULL;
 }
 
 /**
@@ -300,6 +303,66 @@ static int crossover_init_coef(struct comp_data *cd, int nch)
 	return 0;
 }
 
+/**
+ * \brief Initializes the state for filtering all channels together.
+ *
+ * The LR4 filters of the channels are interleaved from the per channel
+ * states into one allocated block that also holds the input and output
+ * blocks of frames.
+ *
+ * \param nch number of channels in the audio stream.
+ */
+static int crossover_init_multich(struct comp_data *cd, int nch)
+{
+	struct iir_state_df2t lr4[PLATFORM_MAX_CHANNELS];
+	struct crossover_multich_state *mc = &cd->multich;
+	size_t block_size = nch * CROSSOVER_MULTICH_FRAMES * sizeof(int32_t);
+	size_t size;
+	uint8_t *data;
+	int num_lr4s = cd->config->num_sinks == CROSSOVER_2WAY_NUM_SINKS ? 1 : 3;
+	int lr4_size;
+	int ch, i;
+
+	/* All LR4 filters have the same sections layout */
+	for (ch = 0; ch < nch; ch++)
+		lr4[ch] = cd->state[ch].lowpass[0];
+
+	lr4_size = iir_multich_size_df2t(lr4, nch);
+	if (lr4_size < 0)
+		return lr4_size;
+
+	/* Keep the 64 bit delays of every filter aligned */
+	lr4_size = ALIGN_UP(lr4_size, sizeof(int64_t));
+	size = 2 * num_lr4s * lr4_size + (1 + CROSSOVER_4WAY_NUM_SINKS) * block_size;
+	cd->multich_data = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, size);
+	if (!cd->multich_data)
+		return -ENOMEM;
+
+	data = cd->multich_data;
+	for (i = 0; i < num_lr4s; i++) {
+		for (ch = 0; ch < nch; ch++)
+			lr4[ch] = cd->state[ch].lowpass[i];
+
+		iir_init_multich_df2t(&mc->lowpass[i], lr4, nch, data);
+		data += lr4_size;
+
+		for (ch = 0; ch < nch; ch++)
+			lr4[ch] = cd->state[ch].highpass[i];
+
+		iir_init_multich_df2t(&mc->highpass[i], lr4, nch, data);
+		data += lr4_size;
+	}
+
+	mc->in = (int32_t *)data;
+	data += block_size;
+	for (i = 0; i < CROSSOVER_4WAY_NUM_SINKS; i++) {
+		mc->out[i] = (int32_t *)data;
+		data += block_size;
+	}
+
+	return 0;
+}
+
 /**
  * \brief Setup the state, coefficients and processing functions for crossover.
  */
@@ -312,6 +375,14 @@ static int crossover_setup(struct comp_data *cd, int nch)
 
 	/* Assign LR4 coefficients from config */
 	ret = crossover_init_coef(cd, nch);
+	if (ret < 0)
+		return ret;
+
+	ret = crossover_init_multich(cd, nch);
+	if (ret < 0) {
+		comp_cl_err(&comp_crossover, "crossover_setup(), all channels state init failed");
+		crossover_reset_state(cd);
+	}
 
 	return ret;
 }
@@ -356,6 +427,7 @@ static struct comp_dev *crossover_new(const struct comp_driver *drv,
 	cd->crossover_process = NULL;
 	cd->crossover_split = NULL;
 	cd->config = NULL;
+	cd->multich_data = NULL;
 
 	/* Handler for configuration data */
 	cd->model_handler = comp_data_blob_handler_new(dev);
@@ -774,7 +846,7 @@ static int crossover_prepare(struct comp_dev *dev)
 		}
 
 		cd->crossover_split =
-			crossover_find_split_func(cd->config->num_sinks);
+			crossover_find_split_multich_func(cd->config->num_sinks);
 		if (!cd->crossover_split) {
 			comp_err(dev, "crossover_prepare(), No split function matching num_sinks %i",
 				 cd->config->num_sinks);
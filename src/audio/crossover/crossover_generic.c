@@ -85,6 +85,65 @@ static void crossover_generic_split_4way(int32_t in,
 				    z2, &out[2], &out[3]);
 }
 
+/*
+ * \brief Splits a block of frames of all channels into two outputs the
+ *        same way as crossover_generic_split_2way() does for one sample.
+ */
+static void crossover_generic_split_2way_multich(struct crossover_multich_state *state,
+						 int frames)
+{
+	iir_df2t_multich(&state->lowpass[0], state->in, state->out[0], frames);
+	iir_df2t_multich(&state->highpass[0], state->in, state->out[1], frames);
+}
+
+/*
+ * \brief Splits a block of frames of all channels into three outputs the
+ *        same way as crossover_generic_split_3way() does for one sample.
+ *
+ * The order of filtering lets the intermediate signals use the output
+ * blocks that are not yet written and the input block as scratch.
+ */
+static void crossover_generic_split_3way_multich(struct crossover_multich_state *state,
+						 int frames)
+{
+	int32_t *in = state->in;
+	int32_t *z1 = state->out[1];
+	int32_t *z2 = state->out[2];
+	int32_t *y = state->out[0];
+	int samples = frames * state->lowpass[0].channels;
+	int i;
+
+	iir_df2t_multich(&state->lowpass[0], in, z1, frames);
+	iir_df2t_multich(&state->highpass[0], in, z2, frames);
+
+	/* Realign the phase of z1 */
+	iir_df2t_multich(&state->lowpass[1], z1, y, frames);
+	iir_df2t_multich(&state->highpass[1], z1, in, frames);
+	for (i = 0; i < samples; i++)
+		y[i] = sat_int32((int64_t)y[i] + in[i]);
+
+	iir_df2t_multich(&state->lowpass[2], z2, state->out[1], frames);
+	iir_df2t_multich(&state->highpass[2], z2, state->out[2], frames);
+}
+
+/*
+ * \brief Splits a block of frames of all channels into four outputs the
+ *        same way as crossover_generic_split_4way() does for one sample.
+ */
+static void crossover_generic_split_4way_multich(struct crossover_multich_state *state,
+						 int frames)
+{
+	int32_t *z1 = state->out[0];
+	int32_t *z2 = state->out[2];
+
+	iir_df2t_multich(&state->lowpass[1], state->in, z1, frames);
+	iir_df2t_multich(&state->highpass[1], state->in, z2, frames);
+	iir_df2t_multich(&state->highpass[0], z1, state->out[1], frames);
+	iir_df2t_multich(&state->lowpass[0], z1, state->out[0], frames);
+	iir_df2t_multich(&state->highpass[2], z2, state->out[3], frames);
+	iir_df2t_multich(&state->lowpass[2], z2, state->out[2], frames);
+}
+
 #if CONFIG_FORMAT_S16LE
 static void crossover_s16_default_pass(const struct comp_dev *dev,
 				       const struct comp_buffer __sparse_cache *source,
@@ -142,33 +201,39 @@ static void crossover_s16_default(const struct comp_dev *dev,
 				  uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct crossover_state *state;
+	struct crossover_multich_state *state = &cd->multich;
 	const struct audio_stream __sparse_cache *source_stream = &source->stream;
 	struct audio_stream __sparse_cache *sink_stream;
 	int16_t *x, *y;
-	int ch, i, j;
-	int idx;
+	int32_t *out;
+	int i, j, n;
+	int idx = 0;
+	int samples;
 	int nch = source_stream->channels;
-	int32_t out[num_sinks];
-
-	for (ch = 0; ch < nch; ch++) {
-		idx = ch;
-		state = &cd->state[ch];
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s16(source_stream, idx);
-			cd->crossover_split(*x << 16, out, state);
-
-			for (j = 0; j < num_sinks; j++) {
-				if (!sinks[j])
-					continue;
-				sink_stream = &sinks[j]->stream;
-				y = audio_stream_write_frag_s16(sink_stream,
-								idx);
-				*y = sat_int16(Q_SHIFT_RND(out[j], 31, 15));
-			}
 
-			idx += nch;
+	while (frames) {
+		n = MIN(frames, CROSSOVER_MULTICH_FRAMES);
+		samples = n * nch;
+		for (i = 0; i < samples; i++) {
+			x = audio_stream_read_frag_s16(source_stream, idx + i);
+			state->in[i] = *x << 16;
 		}
+
+		cd->crossover_split(state, n);
+
+		for (j = 0; j < num_sinks; j++) {
+			if (!sinks[j])
+				continue;
+			sink_stream = &sinks[j]->stream;
+			out = state->out[j];
+			for (i = 0; i < samples; i++) {
+				y = audio_stream_write_frag_s16(sink_stream, idx + i);
+				*y = sat_int16(Q_SHIFT_RND(out[i], 31, 15));
+			}
+		}
+
+		idx += samples;
+		frames -= n;
 	}
 }
 #endif /* CONFIG_FORMAT_S16LE */
@@ -181,33 +246,39 @@ static void crossover_s24_default(const struct comp_dev *dev,
 				  uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct crossover_state *state;
+	struct crossover_multich_state *state = &cd->multich;
 	const struct audio_stream __sparse_cache *source_stream = &source->stream;
 	struct audio_stream __sparse_cache *sink_stream;
 	int32_t *x, *y;
-	int ch, i, j;
-	int idx;
+	int32_t *out;
+	int i, j, n;
+	int idx = 0;
+	int samples;
 	int nch = source_stream->channels;
-	int32_t out[num_sinks];
-
-	for (ch = 0; ch < nch; ch++) {
-		idx = ch;
-		state = &cd->state[ch];
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source_stream, idx);
-			cd->crossover_split(*x << 8, out, state);
-
-			for (j = 0; j < num_sinks; j++) {
-				if (!sinks[j])
-					continue;
-				sink_stream = &sinks[j]->stream;
-				y = audio_stream_write_frag_s32(sink_stream,
-								idx);
-				*y = sat_int24(Q_SHIFT_RND(out[j], 31, 23));
-			}
 
-			idx += nch;
+	while (frames) {
+		n = MIN(frames, CROSSOVER_MULTICH_FRAMES);
+		samples = n * nch;
+		for (i = 0; i < samples; i++) {
+			x = audio_stream_read_frag_s32(source_stream, idx + i);
+			state->in[i] = *x << 8;
+		}
+
+		cd->crossover_split(state, n);
+
+		for (j = 0; j < num_sinks; j++) {
+			if (!sinks[j])
+				continue;
+			sink_stream = &sinks[j]->stream;
+			out = state->out[j];
+			for (i = 0; i < samples; i++) {
+				y = audio_stream_write_frag_s32(sink_stream, idx + i);
+				*y = sat_int24(Q_SHIFT_RND(out[i], 31, 23));
+			}
 		}
+
+		idx += samples;
+		frames -= n;
 	}
 }
 #endif /* CONFIG_FORMAT_S24LE */
@@ -220,33 +291,39 @@ static void crossover_s32_default(const struct comp_dev *dev,
 				  uint32_t frames)
 {
 	struct comp_data *cd = comp_get_drvdata(dev);
-	struct crossover_state *state;
+	struct crossover_multich_state *state = &cd->multich;
 	const struct audio_stream __sparse_cache *source_stream = &source->stream;
 	struct audio_stream __sparse_cache *sink_stream;
 	int32_t *x, *y;
-	int ch, i, j;
-	int idx;
+	int32_t *out;
+	int i, j, n;
+	int idx = 0;
+	int samples;
 	int nch = source_stream->channels;
-	int32_t out[num_sinks];
-
-	for (ch = 0; ch < nch; ch++) {
-		idx = ch;
-		state = &cd->state[0];
-		for (i = 0; i < frames; i++) {
-			x = audio_stream_read_frag_s32(source_stream, idx);
-			cd->crossover_split(*x, out, state);
-
-			for (j = 0; j < num_sinks; j++) {
-				if (!sinks[j])
-					continue;
-				sink_stream = &sinks[j]->stream;
-				y = audio_stream_write_frag_s32(sink_stream,
-								idx);
-				*y = out[j];
-			}
 
-			idx += nch;
+	while (frames) {
+		n = MIN(frames, CROSSOVER_MULTICH_FRAMES);
+		samples = n * nch;
+		for (i = 0; i < samples; i++) {
+			x = audio_stream_read_frag_s32(source_stream, idx + i);
+			state->in[i] = *x;
+		}
+
+		cd->crossover_split(state, n);
+
+		for (j = 0; j < num_sinks; j++) {
+			if (!sinks[j])
+				continue;
+			sink_stream = &sinks[j]->stream;
+			out = state->out[j];
+			for (i = 0; i < samples; i++) {
+				y = audio_stream_write_frag_s32(sink_stream, idx + i);
+				*y = out[i];
+			}
 		}
+
+		idx += samples;
+		frames -= n;
 	}
 }
 #endif /* CONFIG_FORMAT_S32LE */
@@ -290,3 +367,9 @@ const crossover_split crossover_split_fnmap[] = {
 };
 
 const size_t crossover_split_fncount = ARRAY_SIZE(crossover_split_fnmap);
+
+const crossover_split_multich crossover_split_multich_fnmap[] = {
+	crossover_generic_split_2way_multich,
+	crossover_generic_split_3way_multich,
+	crossover_generic_split_4way_multich,
+};
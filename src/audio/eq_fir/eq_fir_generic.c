@@ -19,6 +19,9 @@
 
 LOG_MODULE_DECLARE(eq_fir, CONFIG_SOF_LOG_LEVEL);
 
+/* Number of samples per channel gathered for one block FIR call */
+#define EQ_FIR_BLOCK_SAMPLES 32
+
 #if CONFIG_FORMAT_S16LE
 void eq_fir_s16(struct fir_state_32x16 fir[], struct input_stream_buffer *bsource,
 		struct output_stream_buffer *bsink,
@@ -27,11 +30,11 @@ void eq_fir_s16(struct fir_state_32x16 fir[], struct input_stream_buffer *bsourc
 	struct audio_stream __sparse_cache *source = bsource->data;
 	struct audio_stream __sparse_cache *sink = bsink->data;
 	struct fir_state_32x16 *filter;
-	int32_t z;
+	int32_t buf[EQ_FIR_BLOCK_SAMPLES];
 	int16_t *x0, *y0;
 	int16_t *x = source->r_ptr;
 	int16_t *y = sink->w_ptr;
-	int nmax, n, i, j;
+	int nmax, n, m, i, j, k, b;
 	int remaining_samples = frames * nch;
 
 	while (remaining_samples) {
@@ -39,15 +42,24 @@ void eq_fir_s16(struct fir_state_32x16 fir[], struct input_stream_buffer *bsourc
 		n = MIN(remaining_samples, nmax);
 		nmax = EQ_FIR_BYTES_TO_S16_SAMPLES(audio_stream_bytes_without_wrap(sink, y));
 		n = MIN(n, nmax);
+		/* Samples per channel in this part, filtered in blocks */
+		m = (n + nch - 1) / nch;
 		for (j = 0; j < nch; j++) {
 			x0 = x + j;
 			y0 = y + j;
 			filter = &fir[j];
-			for (i = 0; i < n; i += nch) {
-				z = fir_32x16(filter, *x0 << 16);
-				*y0 = sat_int16(Q_SHIFT_RND(z, 31, 15));
-				x0 += nch;
-				y0 += nch;
+			for (i = 0; i < m; i += b) {
+				b = MIN(m - i, EQ_FIR_BLOCK_SAMPLES);
+				for (k = 0; k < b; k++) {
+					buf[k] = *x0 << 16;
+					x0 += nch;
+				}
+
+				fir_32x16_block(filter, buf, buf, b);
+				for (k = 0; k < b; k++) {
+					*y0 = sat_int16(Q_SHIFT_RND(buf[k], 31, 15));
+					y0 += nch;
+				}
 			}
 		}
 		remaining_samples -= n;
@@ -67,11 +79,11 @@ void eq_fir_s24(struct fir_state_32x16 fir[], struct input_stream_buffer *bsourc
 	struct audio_stream __sparse_cache *source = bsource->data;
 	struct audio_stream __sparse_cache *sink = bsink->data;
 	struct fir_state_32x16 *filter;
-	int32_t z;
+	int32_t buf[EQ_FIR_BLOCK_SAMPLES];
 	int32_t *x0, *y0;
 	int32_t *x = source->r_ptr;
 	int32_t *y = sink->w_ptr;
-	int nmax, n, i, j;
+	int nmax, n, m, i, j, k, b;
 	int remaining_samples = frames * nch;
 
 	while (remaining_samples) {
@@ -79,15 +91,24 @@ void eq_fir_s24(struct fir_state_32x16 fir[], struct input_stream_buffer *bsourc
 		n = MIN(remaining_samples, nmax);
 		nmax = EQ_FIR_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(sink, y));
 		n = MIN(n, nmax);
+		/* Samples per channel in this part, filtered in blocks */
+		m = (n + nch - 1) / nch;
 		for (j = 0; j < nch; j++) {
 			x0 = x + j;
 			y0 = y + j;
 			filter = &fir[j];
-			for (i = 0; i < n; i += nch) {
-				z = fir_32x16(filter, *x0 << 8);
-				*y0 = sat_int24(Q_SHIFT_RND(z, 31, 23));
-				x0 += nch;
-				y0 += nch;
+			for (i = 0; i < m; i += b) {
+				b = MIN(m - i, EQ_FIR_BLOCK_SAMPLES);
+				for (k = 0; k < b; k++) {
+					buf[k] = *x0 << 8;
+					x0 += nch;
+				}
+
+				fir_32x16_block(filter, buf, buf, b);
+				for (k = 0; k < b; k++) {
+					*y0 = sat_int24(Q_SHIFT_RND(buf[k], 31, 23));
+					y0 += nch;
+				}
 			}
 		}
 		remaining_samples -= n;
@@ -107,10 +128,11 @@ void eq_fir_s32(struct fir_state_32x16 fir[], struct input_stream_buffer *bsourc
 	struct audio_stream __sparse_cache *source = bsource->data;
 	struct audio_stream __sparse_cache *sink = bsink->data;
 	struct fir_state_32x16 *filter;
+	int32_t buf[EQ_FIR_BLOCK_SAMPLES];
 	int32_t *x0, *y0;
 	int32_t *x = source->r_ptr;
 	int32_t *y = sink->w_ptr;
-	int nmax, n, i, j;
+	int nmax, n, m, i, j, k, b;
 	int remaining_samples = frames * nch;
 
 	while (remaining_samples) {
@@ -118,14 +140,24 @@ void eq_fir_s32(struct fir_state_32x16 fir[], struct input_stream_buffer *bsourc
 		n = MIN(remaining_samples, nmax);
 		nmax = EQ_FIR_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(sink, y));
 		n = MIN(n, nmax);
+		/* Samples per channel in this part, filtered in blocks */
+		m = (n + nch - 1) / nch;
 		for (j = 0; j < nch; j++) {
 			x0 = x + j;
 			y0 = y + j;
 			filter = &fir[j];
-			for (i = 0; i < n; i += nch) {
-				*y0 = fir_32x16(filter, *x0);
-				x0 += nch;
-				y0 += nch;
+			for (i = 0; i < m; i += b) {
+				b = MIN(m - i, EQ_FIR_BLOCK_SAMPLES);
+				for (k = 0; k < b; k++) {
+					buf[k] = *x0;
+					x0 += nch;
+				}
+
+				fir_32x16_block(filter, buf, buf, b);
+				for (k = 0; k < b; k++) {
+					*y0 = buf[k];
+					y0 += nch;
+				}
 			}
 		}
 		remaining_samples -= n;
@@ -51,9 +51,15 @@ struct comp_data {
 	struct sof_eq_iir_config *config;
 	int32_t *iir_delay;			/**< pointer to allocated RAM */
 	size_t iir_delay_size;			/**< allocated size */
+	struct iir_state_df1_multich iir_multich; /**< all channels state */
+	void *iir_multich_data;			/**< pointer to allocated RAM */
+	int32_t *iir_multich_buf;		/**< block of Q1.31 samples */
 	eq_iir_func eq_iir_func;		/**< processing function */
 };
 
+/* Frames per block in the all channels processing */
+#define EQ_IIR_MULTICH_FRAMES	16
+
 #if CONFIG_FORMAT_S16LE
 
 /*
@@ -291,6 +297,165 @@ static void eq_iir_s32_24_default(const struct comp_dev *dev,
 }
 #endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S24LE */
 
+#if IIR_DF1_GENERIC
+
+/*
+ * The functions below are used when all channels have the same sections
+ * layout. The channels are filtered together in blocks of frames in the
+ * interleaved order of the stream. The output is bit exact with the per
+ * channel functions above.
+ */
+
+#if CONFIG_FORMAT_S16LE
+static void eq_iir_s16_multich(const struct comp_dev *dev,
+			       const struct audio_stream __sparse_cache *source,
+			       struct audio_stream __sparse_cache *sink, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t *buf = cd->iir_multich_buf;
+	int16_t *x = source->r_ptr;
+	int16_t *y = sink->w_ptr;
+	int samples;
+	int n;
+	int i;
+	const int nch = source->channels;
+
+	while (frames) {
+		n = MIN(frames, EQ_IIR_MULTICH_FRAMES);
+		n = MIN(n, audio_stream_frames_without_wrap(source, x));
+		n = MIN(n, audio_stream_frames_without_wrap(sink, y));
+		samples = n * nch;
+		for (i = 0; i < samples; i++)
+			buf[i] = (int32_t)x[i] << 16;
+
+		iir_df1_multich(&cd->iir_multich, buf, buf, n);
+		for (i = 0; i < samples; i++)
+			y[i] = sat_int16(Q_SHIFT_RND(buf[i], 31, 15));
+
+		frames -= n;
+		x = audio_stream_wrap(source, x + samples);
+		y = audio_stream_wrap(sink, y + samples);
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static void eq_iir_s24_multich(const struct comp_dev *dev,
+			       const struct audio_stream __sparse_cache *source,
+			       struct audio_stream __sparse_cache *sink, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t *buf = cd->iir_multich_buf;
+	int32_t *x = source->r_ptr;
+	int32_t *y = sink->w_ptr;
+	int samples;
+	int n;
+	int i;
+	const int nch = source->channels;
+
+	while (frames) {
+		n = MIN(frames, EQ_IIR_MULTICH_FRAMES);
+		n = MIN(n, audio_stream_frames_without_wrap(source, x));
+		n = MIN(n, audio_stream_frames_without_wrap(sink, y));
+		samples = n * nch;
+		for (i = 0; i < samples; i++)
+			buf[i] = x[i] << 8;
+
+		iir_df1_multich(&cd->iir_multich, buf, buf, n);
+		for (i = 0; i < samples; i++)
+			y[i] = sat_int24(Q_SHIFT_RND(buf[i], 31, 23));
+
+		frames -= n;
+		x = audio_stream_wrap(source, x + samples);
+		y = audio_stream_wrap(sink, y + samples);
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void eq_iir_s32_multich(const struct comp_dev *dev,
+			       const struct audio_stream __sparse_cache *source,
+			       struct audio_stream __sparse_cache *sink, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t *x = source->r_ptr;
+	int32_t *y = sink->w_ptr;
+	int n;
+	const int nch = source->channels;
+
+	/* No conversions, filter directly from source to sink */
+	while (frames) {
+		n = MIN(frames, audio_stream_frames_without_wrap(source, x));
+		n = MIN(n, audio_stream_frames_without_wrap(sink, y));
+		iir_df1_multich(&cd->iir_multich, x, y, n);
+		frames -= n;
+		x = audio_stream_wrap(source, x + n * nch);
+		y = audio_stream_wrap(sink, y + n * nch);
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+#if CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S16LE
+static void eq_iir_s32_16_multich(const struct comp_dev *dev,
+				  const struct audio_stream __sparse_cache *source,
+				  struct audio_stream __sparse_cache *sink, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t *buf = cd->iir_multich_buf;
+	int32_t *x = source->r_ptr;
+	int16_t *y = sink->w_ptr;
+	int samples;
+	int n;
+	int i;
+	const int nch = source->channels;
+
+	while (frames) {
+		n = MIN(frames, EQ_IIR_MULTICH_FRAMES);
+		n = MIN(n, audio_stream_frames_without_wrap(source, x));
+		n = MIN(n, audio_stream_frames_without_wrap(sink, y));
+		samples = n * nch;
+		iir_df1_multich(&cd->iir_multich, x, buf, n);
+		for (i = 0; i < samples; i++)
+			y[i] = sat_int16(Q_SHIFT_RND(buf[i], 31, 15));
+
+		frames -= n;
+		x = audio_stream_wrap(source, x + samples);
+		y = audio_stream_wrap(sink, y + samples);
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S24LE
+static void eq_iir_s32_24_multich(const struct comp_dev *dev,
+				  const struct audio_stream __sparse_cache *source,
+				  struct audio_stream __sparse_cache *sink, uint32_t frames)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+	int32_t *x = source->r_ptr;
+	int32_t *y = sink->w_ptr;
+	int samples;
+	int n;
+	int i;
+	const int nch = source->channels;
+
+	/* Filter to sink and convert there in place */
+	while (frames) {
+		n = MIN(frames, audio_stream_frames_without_wrap(source, x));
+		n = MIN(n, audio_stream_frames_without_wrap(sink, y));
+		samples = n * nch;
+		iir_df1_multich(&cd->iir_multich, x, y, n);
+		for (i = 0; i < samples; i++)
+			y[i] = sat_int24(Q_SHIFT_RND(y[i], 31, 23));
+
+		frames -= n;
+		x = audio_stream_wrap(source, x + samples);
+		y = audio_stream_wrap(sink, y + samples);
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE && CONFIG_FORMAT_S24LE */
+
+#endif /* IIR_DF1_GENERIC */
+
 static void eq_iir_pass(const struct comp_dev *dev,
 			const struct audio_stream __sparse_cache *source,
 			struct audio_stream __sparse_cache *sink,
@@ -409,6 +574,26 @@ const struct eq_iir_func_map fm_passthrough[] = {
 #endif /* CONFIG_FORMAT_S32LE */
 };
 
+#if IIR_DF1_GENERIC
+const struct eq_iir_func_map fm_multich[] = {
+#if CONFIG_FORMAT_S16LE
+	{SOF_IPC_FRAME_S16_LE,  SOF_IPC_FRAME_S16_LE,  eq_iir_s16_multich},
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S32LE
+	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S16_LE,  eq_iir_s32_16_multich},
+#endif /* CONFIG_FORMAT_S16LE && CONFIG_FORMAT_S32LE */
+#if CONFIG_FORMAT_S24LE
+	{SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S24_4LE, eq_iir_s24_multich},
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S24LE && CONFIG_FORMAT_S32LE
+	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S24_4LE, eq_iir_s32_24_multich},
+#endif /* CONFIG_FORMAT_S24LE && CONFIG_FORMAT_S32LE */
+#if CONFIG_FORMAT_S32LE
+	{SOF_IPC_FRAME_S32_LE,  SOF_IPC_FRAME_S32_LE,  eq_iir_s32_multich},
+#endif /* CONFIG_FORMAT_S32LE */
+};
+#endif /* IIR_DF1_GENERIC */
+
 static eq_iir_func eq_iir_find_func(enum sof_ipc_frame source_format,
 				    enum sof_ipc_frame sink_format,
 				    const struct eq_iir_func_map *map,
@@ -429,11 +614,36 @@ static eq_iir_func eq_iir_find_func(enum sof_ipc_frame source_format,
 	return NULL;
 }
 
+static eq_iir_func eq_iir_find_configured_func(struct comp_data *cd,
+					       enum sof_ipc_frame source_format,
+					       enum sof_ipc_frame sink_format)
+{
+#if IIR_DF1_GENERIC
+	eq_iir_func func;
+
+	/* Prefer processing all channels together when it is set up */
+	if (cd->iir_multich_data) {
+		func = eq_iir_find_func(source_format, sink_format, fm_multich,
+					ARRAY_SIZE(fm_multich));
+		if (func)
+			return func;
+	}
+#endif
+
+	return eq_iir_find_func(source_format, sink_format, fm_configured,
+				ARRAY_SIZE(fm_configured));
+}
+
 static void eq_iir_free_delaylines(struct comp_data *cd)
 {
 	struct iir_state_df1 *iir = cd->iir;
 	int i = 0;
 
+	/* Free the all channels state copy */
+	rfree(cd->iir_multich_data);
+	cd->iir_multich_data = NULL;
+	cd->iir_multich_buf = NULL;
+
 	/* Free the common buffer for all EQs and point then
 	 * each IIR channel delay line to NULL.
 	 */
@@ -550,6 +760,32 @@ static void eq_iir_init_delay(struct iir_state_df1 *iir,
 	}
 }
 
+#if IIR_DF1_GENERIC
+static void eq_iir_setup_multich(struct comp_data *cd, int nch)
+{
+	size_t buf_size = nch * EQ_IIR_MULTICH_FRAMES * sizeof(int32_t);
+	int size;
+
+	/* The channels can be filtered together only if all of them have
+	 * the same sections layout. Otherwise keep using the per channel
+	 * processing.
+	 */
+	size = iir_multich_size_df1(cd->iir, nch);
+	if (size <= 0)
+		return;
+
+	cd->iir_multich_data = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+				       size + buf_size);
+	if (!cd->iir_multich_data) {
+		comp_cl_warn(&comp_eq_iir, "eq_iir_setup_multich(), allocation fail, using per channel processing");
+		return;
+	}
+
+	cd->iir_multich_buf = (int32_t *)((uint8_t *)cd->iir_multich_data + size);
+	iir_init_multich_df1(&cd->iir_multich, cd->iir, nch, cd->iir_multich_data);
+}
+#endif /* IIR_DF1_GENERIC */
+
 static int eq_iir_setup(struct comp_data *cd, int nch)
 {
 	int delay_size;
@@ -581,6 +817,9 @@ static int eq_iir_setup(struct comp_data *cd, int nch)
 
 	/* Assign delay line to each channel EQ */
 	eq_iir_init_delay(cd->iir, cd->iir_delay, nch);
+#if IIR_DF1_GENERIC
+	eq_iir_setup_multich(cd, nch);
+#endif
 	return 0;
 }
 
@@ -624,6 +863,7 @@ static struct comp_dev *eq_iir_new(const struct comp_driver *drv,
 	cd->eq_iir_func = NULL;
 	cd->iir_delay = NULL;
 	cd->iir_delay_size = 0;
+	cd->iir_multich_data = NULL;
 
 	/* component model data handler */
 	cd->model_handler = comp_data_blob_handler_new(dev);
@@ -835,35 +1075,45 @@ static int eq_iir_copy(struct comp_dev *dev)
 
 	sourceb = list_first_item(&dev->bsource_list, struct comp_buffer,
 				  sink_list);
+	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
+				source_list);
 	source_c = buffer_acquire(sourceb);
+	sink_c = buffer_acquire(sinkb);
 
-	/* Check for changed configuration */
+	/* Check for changed configuration. The processing function is
+	 * selected again since the new sections layout may allow or
+	 * prevent processing all channels together.
+	 */
 	if (comp_is_new_data_blob_available(cd->model_handler)) {
 		cd->config = comp_get_data_blob(cd->model_handler, NULL, NULL);
 		ret = eq_iir_setup(cd, source_c->stream.channels);
 		if (ret < 0) {
 			comp_err(dev, "eq_iir_copy(), failed IIR setup");
-			buffer_release(source_c);
+			goto out;
+		}
 
-			return ret;
+		cd->eq_iir_func = eq_iir_find_configured_func(cd, source_c->stream.frame_fmt,
+							      sink_c->stream.frame_fmt);
+		if (!cd->eq_iir_func) {
+			comp_err(dev, "eq_iir_copy(), No proc func");
+			ret = -EINVAL;
+			goto out;
 		}
 	}
 
-	sinkb = list_first_item(&dev->bsink_list, struct comp_buffer,
-				source_list);
-	sink_c = buffer_acquire(sinkb);
-
 	/* Get source, sink, number of frames etc. to process. */
 	comp_get_copy_limits(source_c, sink_c, &cl);
 
 	/* Run EQ function */
 	eq_iir_process(dev, source_c, sink_c, cl.frames, cl.source_bytes,
 		       cl.sink_bytes);
+	ret = 0;
 
+out:
 	buffer_release(sink_c);
 	buffer_release(source_c);
 
-	return 0;
+	return ret;
 }
 
 static int eq_iir_prepare(struct comp_dev *dev)
@@ -920,8 +1170,7 @@ static int eq_iir_prepare(struct comp_dev *dev)
 			comp_err(dev, "eq_iir_prepare(), setup failed.");
 			goto out;
 		}
-		cd->eq_iir_func = eq_iir_find_func(source_format, sink_format, fm_configured,
-						   ARRAY_SIZE(fm_configured));
+		cd->eq_iir_func = eq_iir_find_configured_func(cd, source_format, sink_format);
 		if (!cd->eq_iir_func) {
 			comp_err(dev, "eq_iir_prepare(), No proc func");
 			ret = -EINVAL;
@@ -16,6 +16,7 @@
 
 #include <sof/audio/buffer.h>
 #include <sof/audio/component_ext.h>
+#include <sof/audio/format.h>
 #include <sof/audio/pipeline.h>
 #include <sof/audio/kpb.h>
 #include <sof/audio/ipc-config.h>
@@ -108,9 +109,9 @@ static void kpb_copy_samples(struct comp_buffer __sparse_cache *sink,
 			     struct comp_buffer __sparse_cache *source, size_t size,
 			     size_t sample_width);
 static void kpb_drain_samples(void *source, struct audio_stream __sparse_cache *sink,
-			      size_t size, size_t sample_width);
+			      unsigned int samples, size_t sample_width);
 static void kpb_buffer_samples(const struct audio_stream __sparse_cache *source,
-			       int offset, void *sink, size_t size,
+			       int samples_offset, void *sink, unsigned int samples,
 			       size_t sample_width);
 static void kpb_reset_history_buffer(struct history_buffer *buff);
 static inline bool validate_host_params(struct comp_dev *dev,
@@ -120,6 +121,21 @@ static inline bool validate_host_params(struct comp_dev *dev,
 static inline void kpb_change_state(struct comp_data *kpb,
 				    enum kpb_state state);
 
+/* History buffer accounting is in bytes stored in the history buffer,
+ * these convert it from and to bytes of the audio stream.
+ */
+static inline size_t kpb_stream_to_hb_bytes(const struct comp_data *kpb, size_t bytes)
+{
+	return bytes / (KPB_SAMPLE_CONTAINER_SIZE(kpb->config.sampling_width) / 8) *
+		kpb->hd.sample_bytes;
+}
+
+static inline size_t kpb_hb_to_stream_bytes(const struct comp_data *kpb, size_t bytes)
+{
+	return bytes / kpb->hd.sample_bytes *
+		(KPB_SAMPLE_CONTAINER_SIZE(kpb->config.sampling_width) / 8);
+}
+
 static uint64_t kpb_task_deadline(void *data)
 {
 	return SOF_TASK_DEADLINE_ALMOST_IDLE;
@@ -556,6 +572,8 @@ static size_t kpb_allocate_history_buffer(struct comp_data *kpb,
 			 */
 			temp_ca_size = ca_size - KPB_ALLOCATION_STEP;
 			ca_size = (ca_size < temp_ca_size) ? 0 : temp_ca_size;
+			/* samples must not be split between blocks */
+			ca_size -= ca_size % kpb->hd.sample_bytes;
 			if (ca_size == 0) {
 				ca_size = hb_size;
 				i++;
@@ -703,7 +721,7 @@ static int kpb_prepare(struct comp_dev *dev)
 	struct comp_data *kpb = comp_get_drvdata(dev);
 	int ret = 0;
 	int i;
-	size_t hb_size_req = KPB_MAX_BUFFER_SIZE(kpb->config.sampling_width);
+	size_t hb_size_req;
 
 	comp_dbg(dev, "kpb_prepare()");
 
@@ -721,19 +739,26 @@ static int kpb_prepare(struct comp_dev *dev)
 	if (ret == COMP_STATUS_STATE_ALREADY_SET)
 		return PPL_STATUS_PATH_STOP;
 
-	if (!validate_host_params(dev, kpb->host_period_size,
-				  kpb->host_buffer_size, hb_size_req)) {
+	if (!validate_host_params(dev, kpb->host_period_size, kpb->host_buffer_size,
+				  KPB_MAX_BUFFER_SIZE(kpb->config.sampling_width))) {
 		return -EINVAL;
 	}
 
+	/* history buffer size for the stream size, packed samples take less */
+	kpb->hd.sample_bytes = KPB_HISTORY_SAMPLE_BYTES(kpb->config.sampling_width);
+	hb_size_req = kpb_stream_to_hb_bytes(kpb,
+					     KPB_MAX_BUFFER_SIZE(kpb->config.sampling_width));
+
 	kpb_change_state(kpb, KPB_STATE_PREPARING);
 
 	/* Init private data */
 	kpb->kpb_no_of_clients = 0;
 	kpb->hd.buffered = 0;
 
-	if (kpb->hd.c_hb && kpb->hd.buffer_size < hb_size_req) {
-		/* Host params has changed, we need to allocate new buffer */
+	if (kpb->hd.c_hb && kpb->hd.buffer_size != hb_size_req) {
+		/* Host params or sample size has changed, we need to allocate
+		 * new buffer with blocks holding whole samples.
+		 */
 		kpb_free_history_buffer(kpb->hd.c_hb);
 		kpb->hd.c_hb = NULL;
 	}
@@ -970,7 +995,8 @@ static int kpb_copy(struct comp_dev *dev)
 		/* Buffer source data internally in history buffer for future
 		 * use by clients.
 		 */
-		if (audio_stream_get_avail_bytes(&source_c->stream) <= kpb->hd.buffer_size) {
+		if (kpb_stream_to_hb_bytes(kpb, audio_stream_get_avail_bytes(&source_c->stream)) <=
+		    kpb->hd.buffer_size) {
 			ret = kpb_buffer_data(dev, source_c, copy_bytes);
 			if (ret) {
 				comp_err(dev, "kpb_copy(): internal buffering failed.");
@@ -984,7 +1010,7 @@ static int kpb_copy(struct comp_dev *dev)
 			 */
 			kpb->hd.buffered += MIN(kpb->hd.buffer_size -
 						kpb->hd.buffered,
-						copy_bytes);
+						kpb_stream_to_hb_bytes(kpb, copy_bytes));
 		} else {
 			comp_err(dev, "kpb_copy(): too much data to buffer.");
 		}
@@ -1037,13 +1063,13 @@ static int kpb_copy(struct comp_dev *dev)
 		 * the internal history buffer.
 		 */
 		avail_bytes = audio_stream_get_avail_bytes(&source_c->stream);
-		copy_bytes = MIN(avail_bytes, kpb->hd.free);
+		copy_bytes = MIN(avail_bytes, kpb_hb_to_stream_bytes(kpb, kpb->hd.free));
 		ret = PPL_STATUS_PATH_STOP;
 		if (copy_bytes) {
 			buffer_stream_invalidate(source_c, copy_bytes);
 			ret = kpb_buffer_data(dev, source_c, copy_bytes);
-			dd->buffered_while_draining += copy_bytes;
-			kpb->hd.free -= copy_bytes;
+			dd->buffered_while_draining += kpb_stream_to_hb_bytes(kpb, copy_bytes);
+			kpb->hd.free -= kpb_stream_to_hb_bytes(kpb, copy_bytes);
 
 			if (ret) {
 				comp_err(dev, "kpb_copy(): internal buffering failed.");
@@ -1085,9 +1111,9 @@ static int kpb_buffer_data(struct comp_dev *dev,
 			   const struct comp_buffer __sparse_cache *source, size_t size)
 {
 	int ret = 0;
-	size_t size_to_copy = size;
-	size_t space_avail;
 	struct comp_data *kpb = comp_get_drvdata(dev);
+	size_t size_to_copy = kpb_stream_to_hb_bytes(kpb, size);
+	size_t space_avail;
 	struct history_buffer *buff = kpb->hd.c_hb;
 	uint32_t offset = 0;
 	uint64_t timeout = 0;
@@ -1148,8 +1174,9 @@ static int kpb_buffer_data(struct comp_dev *dev,
 			 * in this buffer, copy what's available and continue
 			 * with next buffer.
 			 */
-			kpb_buffer_samples(&source->stream, offset, buff->w_ptr,
-					   space_avail, sample_width);
+			kpb_buffer_samples(&source->stream, offset / kpb->hd.sample_bytes,
+					   buff->w_ptr, space_avail / kpb->hd.sample_bytes,
+					   sample_width);
 			/* Update write pointer & requested copy size */
 			buff->w_ptr = (char *)buff->w_ptr + space_avail;
 			size_to_copy = size_to_copy - space_avail;
@@ -1162,8 +1189,9 @@ static int kpb_buffer_data(struct comp_dev *dev,
 			 * available in this buffer. In this scenario simply
 			 * copy what was requested.
 			 */
-			kpb_buffer_samples(&source->stream, offset, buff->w_ptr,
-					   size_to_copy, sample_width);
+			kpb_buffer_samples(&source->stream, offset / kpb->hd.sample_bytes,
+					   buff->w_ptr, size_to_copy / kpb->hd.sample_bytes,
+					   sample_width);
 			/* Update write pointer & requested copy size */
 			buff->w_ptr = (char *)buff->w_ptr + size_to_copy;
 			/* Reset requested copy size */
@@ -1292,8 +1320,7 @@ static void kpb_init_draining(struct comp_dev *dev, struct kpb_client *cli)
 	bool is_sink_ready = (kpb->host_sink->sink->state == COMP_STATE_ACTIVE);
 	size_t sample_width = kpb->config.sampling_width;
 	size_t drain_req = cli->drain_req * kpb->config.channels *
-			       (kpb->config.sampling_freq / 1000) *
-			       (KPB_SAMPLE_CONTAINER_SIZE(sample_width) / 8);
+			       (kpb->config.sampling_freq / 1000) * kpb->hd.sample_bytes;
 	struct history_buffer *buff = kpb->hd.c_hb;
 	struct history_buffer *first_buff = buff;
 	size_t buffered = 0;
@@ -1450,6 +1477,7 @@ static enum task_state kpb_draining_task(void *arg)
 	size_t sample_width = draining_data->sample_width;
 	size_t size_to_read;
 	size_t size_to_copy;
+	size_t sink_free;
 	bool move_buffer = false;
 	uint32_t drained = 0;
 	uint64_t draining_time_start;
@@ -1499,12 +1527,14 @@ static enum task_state kpb_draining_task(void *arg)
 		}
 
 		size_to_read = (uintptr_t)buff->end_addr - (uintptr_t)buff->r_ptr;
+		/* sink space in the history buffer sample size */
+		sink_free = kpb_stream_to_hb_bytes(kpb, audio_stream_get_free_bytes(&sink->stream));
 
-		if (size_to_read > audio_stream_get_free_bytes(&sink->stream)) {
-			if (audio_stream_get_free_bytes(&sink->stream) >= drain_req)
+		if (size_to_read > sink_free) {
+			if (sink_free >= drain_req)
 				size_to_copy = drain_req;
 			else
-				size_to_copy = audio_stream_get_free_bytes(&sink->stream);
+				size_to_copy = sink_free;
 		} else {
 			if (size_to_read > drain_req) {
 				size_to_copy = drain_req;
@@ -1514,15 +1544,17 @@ static enum task_state kpb_draining_task(void *arg)
 			}
 		}
 
-		kpb_drain_samples(buff->r_ptr, &sink->stream, size_to_copy,
-				  sample_width);
+		kpb_drain_samples(buff->r_ptr, &sink->stream,
+				  size_to_copy / kpb->hd.sample_bytes, sample_width);
 
 		buff->r_ptr = (char *)buff->r_ptr + (uint32_t)size_to_copy;
 		drain_req -= size_to_copy;
-		drained += size_to_copy;
-		period_bytes += size_to_copy;
 		kpb->hd.free += MIN(kpb->hd.buffer_size -
 				    kpb->hd.free, size_to_copy);
+		/* from here on size_to_copy is in the stream sample size */
+		size_to_copy = kpb_hb_to_stream_bytes(kpb, size_to_copy);
+		drained += size_to_copy;
+		period_bytes += size_to_copy;
 
 		if (move_buffer) {
 			buff->r_ptr = buff->start_addr;
@@ -1593,32 +1625,118 @@ out:
 	return SOF_TASK_STATE_COMPLETED;
 }
 
+#if CONFIG_KPB_HISTORY_PACK_S24 || CONFIG_KPB_HISTORY_PACK_S16
+/**
+ * \brief Packs samples in 32 bit containers to the history buffer.
+ * \param[in] source Pointer to source buffer.
+ * \param[in] samples_offset Start offset of source buffer in samples.
+ * \param[out] sink Pointer to history buffer.
+ * \param[in] samples Number of samples to pack.
+ * \param[in] sample_width Sample size.
+ */
+static void kpb_pack_samples(const struct audio_stream __sparse_cache *source,
+			     int samples_offset, void *sink, unsigned int samples,
+			     size_t sample_width)
+{
+	int32_t *src = audio_stream_wrap(source, (int32_t *)source->r_ptr + samples_offset);
+#if CONFIG_KPB_HISTORY_PACK_S24
+	uint8_t *dst = sink;
+	int shift = sample_width - 24;
+	int32_t x;
+#else
+	int16_t *dst = sink;
+	int shift = 32 - sample_width;
+	int32_t x;
+#endif
+	unsigned int n;
+	unsigned int i;
+
+	while (samples) {
+		n = MIN(samples, audio_stream_samples_without_wrap_s32(source, src));
+		for (i = 0; i < n; i++) {
+#if CONFIG_KPB_HISTORY_PACK_S24
+			/* s24 is stored as it is, s32 loses the 8 LSBs */
+			x = src[i] >> shift;
+			*dst++ = x;
+			*dst++ = x >> 8;
+			*dst++ = x >> 16;
+#else
+			/* align to s32 (sign extends s24) and round to s16 */
+			x = (int32_t)((uint32_t)src[i] << shift) >> shift;
+			*dst++ = sat_int16(Q_SHIFT_RND(x, sample_width - 1, 15));
+#endif
+		}
+		src = audio_stream_wrap(source, src + n);
+		samples -= n;
+	}
+}
+
+/**
+ * \brief Unpacks samples from the history buffer to 32 bit containers.
+ * \param[in] source Pointer to history buffer.
+ * \param[out] sink Pointer to sink buffer.
+ * \param[in] samples Number of samples to unpack.
+ * \param[in] sample_width Sample size.
+ */
+static void kpb_unpack_samples(const void *source, struct audio_stream __sparse_cache *sink,
+			       unsigned int samples, size_t sample_width)
+{
+	int32_t *dst = sink->w_ptr;
+#if CONFIG_KPB_HISTORY_PACK_S24
+	const uint8_t *src = source;
+	int shift = 32 - sample_width;
+	uint32_t x;
+#else
+	const int16_t *src = source;
+	int shift = sample_width - 16;
+#endif
+	unsigned int n;
+	unsigned int i;
+
+	while (samples) {
+		n = MIN(samples, audio_stream_samples_without_wrap_s32(sink, dst));
+		for (i = 0; i < n; i++) {
+#if CONFIG_KPB_HISTORY_PACK_S24
+			x = src[0] | (src[1] << 8) | ((uint32_t)src[2] << 16);
+			src += 3;
+			/* sign extended s24 or s32 with zero LSBs */
+			dst[i] = (int32_t)(x << 8) >> shift;
+#else
+			dst[i] = (int32_t)((uint32_t)*src++ << shift);
+#endif
+		}
+		dst = audio_stream_wrap(sink, dst + n);
+		samples -= n;
+	}
+}
+#endif /* CONFIG_KPB_HISTORY_PACK_S24 || CONFIG_KPB_HISTORY_PACK_S16 */
+
 /**
  * \brief Drain data samples safe, according to configuration.
  *
  * \param[in] sink - pointer to sink buffer.
  * \param[in] source - pointer to source buffer.
- * \param[in] size - requested copy size in bytes.
+ * \param[in] samples - requested copy size in samples.
  *
  * \return none.
  */
 static void kpb_drain_samples(void *source, struct audio_stream __sparse_cache *sink,
-			      size_t size, size_t sample_width)
+			      unsigned int samples, size_t sample_width)
 {
-	unsigned int samples;
-
 	switch (sample_width) {
 #if CONFIG_FORMAT_S16LE
 	case 16:
-		samples = KPB_BYTES_TO_S16_SAMPLES(size);
 		audio_stream_copy_from_linear(source, 0, sink, 0, samples);
 		break;
 #endif /* CONFIG_FORMAT_S16LE */
 #if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
 	case 24:
 	case 32:
-		samples = KPB_BYTES_TO_S32_SAMPLES(size);
+#if CONFIG_KPB_HISTORY_PACK_S24 || CONFIG_KPB_HISTORY_PACK_S16
+		kpb_unpack_samples(source, sink, samples, sample_width);
+#else
 		audio_stream_copy_from_linear(source, 0, sink, 0, samples);
+#endif
 		break;
 #endif /* CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE */
 	default:
@@ -1630,34 +1748,31 @@ static void kpb_drain_samples(void *source, struct audio_stream __sparse_cache *
 /**
  * \brief Buffers data samples safe, according to configuration.
  * \param[in,out] source Pointer to source buffer.
- * \param[in] offset Start offset of source buffer in bytes.
+ * \param[in] samples_offset Start offset of source buffer in samples.
  * \param[in,out] sink Pointer to sink buffer.
- * \param[in] size Requested copy size in bytes.
+ * \param[in] samples Requested copy size in samples.
  * \param[in] sample_width Sample size.
  */
 static void kpb_buffer_samples(const struct audio_stream __sparse_cache *source,
-			       int offset, void *sink, size_t size,
+			       int samples_offset, void *sink, unsigned int samples,
 			       size_t sample_width)
 {
-	unsigned int samples_count;
-	int samples_offset;
-
 	switch (sample_width) {
 #if CONFIG_FORMAT_S16LE
 	case 16:
-		samples_count = KPB_BYTES_TO_S16_SAMPLES(size);
-		samples_offset = KPB_BYTES_TO_S16_SAMPLES(offset);
 		audio_stream_copy_to_linear(source, samples_offset,
-					    sink, 0, samples_count);
+					    sink, 0, samples);
 		break;
 #endif
 #if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
 	case 24:
 	case 32:
-		samples_count = KPB_BYTES_TO_S32_SAMPLES(size);
-		samples_offset = KPB_BYTES_TO_S32_SAMPLES(offset);
+#if CONFIG_KPB_HISTORY_PACK_S24 || CONFIG_KPB_HISTORY_PACK_S16
+		kpb_pack_samples(source, samples_offset, sink, samples, sample_width);
+#else
 		audio_stream_copy_to_linear(source, samples_offset,
-					    sink, 0, samples_count);
+					    sink, 0, samples);
+#endif
 		break;
 #endif
 	default:
@@ -170,11 +170,9 @@ static void mfcc_fill_fft_buffer(struct mfcc_state *state)
 	int j;
 	int n;
 
-	/* Copy overlapped samples from state buffer. Imaginary part of input
-	 * remains zero.
-	 */
+	/* Copy overlapped samples from state buffer */
 	for (j = 0; j < state->prev_data_size; j++)
-		fft->fft_buf[idx + j].real = state->prev_data[j];
+		fft->fft_real[idx + j] = state->prev_data[j];
 
 	/* Copy hop size of new data from circular buffer */
 	idx += state->prev_data_size;
@@ -183,7 +181,7 @@ static void mfcc_fill_fft_buffer(struct mfcc_state *state)
 		n = mfcc_buffer_samples_without_wrap(buf, r);
 		n = MIN(n, nmax);
 		for (j = 0; j < n; j++) {
-			fft->fft_buf[idx].real = *r;
+			fft->fft_real[idx] = *r;
 			r++;
 			idx++;
 		}
@@ -197,7 +195,7 @@ static void mfcc_fill_fft_buffer(struct mfcc_state *state)
 	/* Copy for next time data back to overlap buffer */
 	idx = fft->fft_fill_start_idx + fft->fft_hop_size;
 	for (j = 0; j < state->prev_data_size; j++)
-		state->prev_data[j] = fft->fft_buf[idx + j].real;
+		state->prev_data[j] = fft->fft_real[idx + j];
 }
 
 #ifdef MFCC_NORMALIZE_FFT
@@ -212,7 +210,7 @@ static int mfcc_normalize_fft_buffer(struct mfcc_state *state)
 	int i = fft->fft_fill_start_idx;
 
 	for (j = 0; j < fft->fft_size; j++) {
-		x = fft->fft_buf[i + j].real;
+		x = fft->fft_real[i + j];
 		absx = (x < 0) ? -x : x;
 		if (smax < absx)
 			smax = absx;
@@ -237,15 +235,15 @@ static void mfcc_apply_window(struct mfcc_state *state, int input_shift)
 	int s = 14 - input_shift; /* Q1.15 x Q1.15 -> Q30 -> Q15, shift by 15 - 1 for round */
 
 	for (j = 0; j < fft->fft_size; j++) {
-		x = (int32_t)fft->fft_buf[i + j].real * state->window[j];
-		fft->fft_buf[i + j].real = ((x >> s) + 1) >> 1;
+		x = (int32_t)fft->fft_real[i + j] * state->window[j];
+		fft->fft_real[i + j] = ((x >> s) + 1) >> 1;
 	}
 #else
 	/* TODO: Use proper multiply and saturate function to make sure no overflows */
 	int s = input_shift + 1; /* To convert 16 -> 32 with Q1.15 x Q1.15 -> Q30 -> Q31 */
 
 	for (j = 0; j < fft->fft_size; j++)
-		fft->fft_buf[i + j].real = (fft->fft_buf[i + j].real * state->window[j]) << s;
+		fft->fft_real[i + j] = (fft->fft_real[i + j] * state->window[j]) << s;
 #endif
 }
 
@@ -313,7 +311,7 @@ static int mfcc_stft_process(const struct comp_dev *dev, struct mfcc_state *stat
 
 #ifdef DEBUGFILES
 		for (j = 0; j < fft->fft_padded_size; j++)
-			fprintf(fh_fft_in, "%d %d\n", fft->fft_buf[j].real, fft->fft_buf[j].imag);
+			fprintf(fh_fft_in, "%d %d\n", fft->fft_real[j], 0);
 #endif
 
 		/* The FFT out buffer needs to be cleared to avoid to corrupt
@@ -321,11 +319,11 @@ static int mfcc_stft_process(const struct comp_dev *dev, struct mfcc_state *stat
 		 */
 		bzero(fft->fft_out, fft->fft_buffer_size);
 
-		/* Compute FFT */
+		/* Compute FFT, the input is real so only the half size complex FFT is needed */
 #if MFCC_FFT_BITS == 16
-		fft_execute_16(fft->fft_plan, false);
+		fft_execute_real_16(fft->fft_plan, false);
 #else
-		fft_execute_32(fft->fft_plan, false);
+		fft_execute_real_32(fft->fft_plan, false);
 #endif
 
 #ifdef DEBUGFILES_READ_FFT
@@ -350,10 +348,10 @@ static int mfcc_stft_process(const struct comp_dev *dev, struct mfcc_state *stat
 		mat_init_16b(state->mel_spectra, 1, state->dct.num_in, 7); /* Q8.7 */
 
 		/* Compensate FFT lib scaling to Mel log values, e.g. for 512 long FFT
-		 * the fft_plan->len is 9. The scaling is 1/512. Subtract from input_shift it
-		 * to add the missing "gain".
+		 * the half size fft_plan->len is 8. The scaling is 1/512. Subtract from
+		 * input_shift it to add the missing "gain".
 		 */
-		mel_scale_shift = input_shift - fft->fft_plan->len;
+		mel_scale_shift = input_shift - fft->fft_plan->len - 1;
 #if MFCC_FFT_BITS == 16
 		psy_apply_mel_filterbank_16(&state->melfb, fft->fft_out, state->power_spectra,
 					    state->mel_spectra->data, mel_scale_shift);
@@ -240,8 +240,13 @@ int mfcc_setup(struct processing_module *mod, int max_frames, int sample_rate, i
 
 	fft->fft_fill_start_idx = 0; /* From config pad_type */
 
-	/* Setup FFT */
-	fft->fft_plan = fft_plan_new(fft->fft_buf, fft->fft_out, fft->fft_padded_size,
+	/* Setup FFT, the real input transform is done with half size complex FFT */
+#if MFCC_FFT_BITS == 16
+	fft->fft_real = (int16_t *)fft->fft_buf;
+#else
+	fft->fft_real = (int32_t *)fft->fft_buf;
+#endif
+	fft->fft_plan = fft_plan_new(fft->fft_buf, fft->fft_out, fft->fft_padded_size >> 1,
 				     MFCC_FFT_BITS);
 	if (!fft->fft_plan) {
 		comp_err(dev, "mfcc_setup(): Failed FFT init");
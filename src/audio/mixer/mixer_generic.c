@@ -4,23 +4,25 @@
 //
 // Author: Andrula Song <xiaoyuan.song@intel.com>
 
+#include <sof/audio/mix_acc.h>
 #include <sof/audio/mixer.h>
 #include <sof/common.h>
 
 #ifdef MIXER_GENERIC
 
 #if CONFIG_FORMAT_S16LE
-/* Mix n 16 bit PCM source streams to one sink stream */
+/* Mix n 16 bit PCM source streams to one sink stream, the sources are
+ * accumulated one by one over blocks and the sum is saturated once
+ */
 static void mix_n_s16(struct comp_dev *dev, struct audio_stream __sparse_cache *sink,
 		      const struct audio_stream __sparse_cache **sources, uint32_t num_sources,
 		      uint32_t frames)
 {
+	int32_t acc[MIX_ACC_BLOCK_SAMPLES];
 	int16_t *src[PLATFORM_MAX_CHANNELS];
 	int16_t *dest;
-	int32_t val;
-	int nmax;
-	int i, j, n, ns;
-	int processed = 0;
+	int i, j, n, m;
+	int processed;
 	int nch = sink->channels;
 	int samples = frames * nch;
 
@@ -28,46 +30,44 @@ static void mix_n_s16(struct comp_dev *dev, struct audio_stream __sparse_cache *
 	for (j = 0; j < num_sources; j++)
 		src[j] = sources[j]->r_ptr;
 
-	while (processed < samples) {
-		nmax = samples - processed;
-		n = audio_stream_samples_without_wrap_s16(sink, dest);
-		n = MIN(n, nmax);
-		for (i = 0; i < num_sources; i++) {
-			ns = audio_stream_samples_without_wrap_s16(sources[i], src[i]);
-			n = MIN(n, ns);
-		}
-		for (i = 0; i < n; i++) {
-			val = 0;
-			for (j = 0; j < num_sources; j++) {
-				val += *src[j];
-				src[j]++;
+	for (processed = 0; processed < samples; processed += n) {
+		n = MIN(samples - processed, MIX_ACC_BLOCK_SAMPLES);
+
+		for (j = 0; j < num_sources; j++) {
+			for (i = 0; i < n; i += m) {
+				m = audio_stream_samples_without_wrap_s16(sources[j], src[j]);
+				m = MIN(m, n - i);
+				if (j)
+					mix_acc_add_s16(acc + i, src[j], m);
+				else
+					mix_acc_set_s16(acc + i, src[j], m);
+				src[j] = audio_stream_wrap(sources[j], src[j] + m);
 			}
+		}
 
-			/* Saturate to 16 bits */
-			*dest = sat_int16(val);
-			dest++;
+		for (i = 0; i < n; i += m) {
+			m = audio_stream_samples_without_wrap_s16(sink, dest);
+			m = MIN(m, n - i);
+			mix_acc_store_s16(dest, acc + i, m);
+			dest = audio_stream_wrap(sink, dest + m);
 		}
-		processed += n;
-		dest = audio_stream_wrap(sink, dest);
-		for (i = 0; i < num_sources; i++)
-			src[i] = audio_stream_wrap(sources[i], src[i]);
 	}
 }
 #endif /* CONFIG_FORMAT_S16LE */
 
 #if CONFIG_FORMAT_S24LE
-/* Mix n 24 bit PCM source streams to one sink stream */
+/* Mix n 24 bit PCM source streams to one sink stream, the sources are
+ * accumulated one by one over blocks and the sum is saturated once
+ */
 static void mix_n_s24(struct comp_dev *dev, struct audio_stream __sparse_cache *sink,
 		      const struct audio_stream __sparse_cache **sources, uint32_t num_sources,
 		      uint32_t frames)
 {
+	int32_t acc[MIX_ACC_BLOCK_SAMPLES];
 	int32_t *src[PLATFORM_MAX_CHANNELS];
 	int32_t *dest;
-	int32_t val;
-	int32_t x;
-	int nmax;
-	int i, j, n, ns;
-	int processed = 0;
+	int i, j, n, m;
+	int processed;
 	int nch = sink->channels;
 	int samples = frames * nch;
 
@@ -75,46 +75,44 @@ static void mix_n_s24(struct comp_dev *dev, struct audio_stream __sparse_cache *
 	for (j = 0; j < num_sources; j++)
 		src[j] = sources[j]->r_ptr;
 
-	while (processed < samples) {
-		nmax = samples - processed;
-		n = audio_stream_samples_without_wrap_s24(sink, dest);
-		n = MIN(n, nmax);
-		for (i = 0; i < num_sources; i++) {
-			ns = audio_stream_samples_without_wrap_s24(sources[i], src[i]);
-			n = MIN(n, ns);
-		}
-		for (i = 0; i < n; i++) {
-			val = 0;
-			for (j = 0; j < num_sources; j++) {
-				x = *src[j] << 8;
-				val += x >> 8; /* Sign extend */
-				src[j]++;
+	for (processed = 0; processed < samples; processed += n) {
+		n = MIN(samples - processed, MIX_ACC_BLOCK_SAMPLES);
+
+		for (j = 0; j < num_sources; j++) {
+			for (i = 0; i < n; i += m) {
+				m = audio_stream_samples_without_wrap_s24(sources[j], src[j]);
+				m = MIN(m, n - i);
+				if (j)
+					mix_acc_add_s24(acc + i, src[j], m);
+				else
+					mix_acc_set_s24(acc + i, src[j], m);
+				src[j] = audio_stream_wrap(sources[j], src[j] + m);
 			}
+		}
 
-			/* Saturate to 24 bits */
-			*dest = sat_int24(val);
-			dest++;
+		for (i = 0; i < n; i += m) {
+			m = audio_stream_samples_without_wrap_s24(sink, dest);
+			m = MIN(m, n - i);
+			mix_acc_store_s24(dest, acc + i, m);
+			dest = audio_stream_wrap(sink, dest + m);
 		}
-		processed += n;
-		dest = audio_stream_wrap(sink, dest);
-		for (i = 0; i < num_sources; i++)
-			src[i] = audio_stream_wrap(sources[i], src[i]);
 	}
 }
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
-/* Mix n 32 bit PCM source streams to one sink stream */
+/* Mix n 32 bit PCM source streams to one sink stream, the sources are
+ * accumulated one by one over blocks and the sum is saturated once
+ */
 static void mix_n_s32(struct comp_dev *dev, struct audio_stream __sparse_cache *sink,
 		      const struct audio_stream __sparse_cache **sources, uint32_t num_sources,
 		      uint32_t frames)
 {
+	int64_t acc[MIX_ACC_BLOCK_SAMPLES];
 	int32_t *src[PLATFORM_MAX_CHANNELS];
 	int32_t *dest;
-	int64_t val;
-	int nmax;
-	int i, j, n, ns;
-	int processed = 0;
+	int i, j, n, m;
+	int processed;
 	int nch = sink->channels;
 	int samples = frames * nch;
 
@@ -122,29 +120,27 @@ static void mix_n_s32(struct comp_dev *dev, struct audio_stream __sparse_cache *
 	for (j = 0; j < num_sources; j++)
 		src[j] = sources[j]->r_ptr;
 
-	while (processed < samples) {
-		nmax = samples - processed;
-		n = audio_stream_samples_without_wrap_s32(sink, dest);
-		n = MIN(n, nmax);
-		for (i = 0; i < num_sources; i++) {
-			ns = audio_stream_samples_without_wrap_s32(sources[i], src[i]);
-			n = MIN(n, ns);
-		}
-		for (i = 0; i < n; i++) {
-			val = 0;
-			for (j = 0; j < num_sources; j++) {
-				val += *src[j];
-				src[j]++;
+	for (processed = 0; processed < samples; processed += n) {
+		n = MIN(samples - processed, MIX_ACC_BLOCK_SAMPLES);
+
+		for (j = 0; j < num_sources; j++) {
+			for (i = 0; i < n; i += m) {
+				m = audio_stream_samples_without_wrap_s32(sources[j], src[j]);
+				m = MIN(m, n - i);
+				if (j)
+					mix_acc_add_s32(acc + i, src[j], m);
+				else
+					mix_acc_set_s32(acc + i, src[j], m);
+				src[j] = audio_stream_wrap(sources[j], src[j] + m);
 			}
+		}
 
-			/* Saturate to 32 bits */
-			*dest = sat_int32(val);
-			dest++;
+		for (i = 0; i < n; i += m) {
+			m = audio_stream_samples_without_wrap_s32(sink, dest);
+			m = MIN(m, n - i);
+			mix_acc_store_s32(dest, acc + i, m);
+			dest = audio_stream_wrap(sink, dest + m);
 		}
-		processed += n;
-		dest = audio_stream_wrap(sink, dest);
-		for (i = 0; i < num_sources; i++)
-			src[i] = audio_stream_wrap(sources[i], src[i]);
 	}
 }
 #endif /* CONFIG_FORMAT_S32LE */
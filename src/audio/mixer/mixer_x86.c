@@ -0,0 +1,228 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <sof/audio/mixer.h>
+#include <sof/common.h>
+
+#ifdef MIXER_X86
+
+#include <immintrin.h>
+
+#if CONFIG_FORMAT_S16LE
+/* Mix n 16 bit PCM source streams to one sink stream */
+static void mix_n_s16(struct comp_dev *dev, struct audio_stream __sparse_cache *sink,
+		      const struct audio_stream __sparse_cache **sources, uint32_t num_sources,
+		      uint32_t frames)
+{
+	int16_t *src[PLATFORM_MAX_CHANNELS];
+	int16_t *dest;
+	__m128i acc_lo;
+	__m128i acc_hi;
+	__m128i x;
+	int32_t val;
+	int nmax;
+	int i, j, n, ns;
+	int processed = 0;
+	int nch = sink->channels;
+	int samples = frames * nch;
+
+	dest = sink->w_ptr;
+	for (j = 0; j < num_sources; j++)
+		src[j] = sources[j]->r_ptr;
+
+	while (processed < samples) {
+		nmax = samples - processed;
+		n = audio_stream_samples_without_wrap_s16(sink, dest);
+		n = MIN(n, nmax);
+		for (i = 0; i < num_sources; i++) {
+			ns = audio_stream_samples_without_wrap_s16(sources[i], src[i]);
+			n = MIN(n, ns);
+		}
+
+		/* Eight samples per iteration, sum in 32 bits and saturate with pack */
+		for (i = 0; i <= n - 8; i += 8) {
+			acc_lo = _mm_setzero_si128();
+			acc_hi = _mm_setzero_si128();
+			for (j = 0; j < num_sources; j++) {
+				x = _mm_loadu_si128((__m128i *)(src[j] + i));
+				acc_lo = _mm_add_epi32(acc_lo, _mm_cvtepi16_epi32(x));
+				x = _mm_srli_si128(x, 8);
+				acc_hi = _mm_add_epi32(acc_hi, _mm_cvtepi16_epi32(x));
+			}
+
+			_mm_storeu_si128((__m128i *)(dest + i), _mm_packs_epi32(acc_lo, acc_hi));
+		}
+
+		for (; i < n; i++) {
+			val = 0;
+			for (j = 0; j < num_sources; j++)
+				val += src[j][i];
+
+			/* Saturate to 16 bits */
+			dest[i] = sat_int16(val);
+		}
+
+		processed += n;
+		dest = audio_stream_wrap(sink, dest + n);
+		for (i = 0; i < num_sources; i++)
+			src[i] = audio_stream_wrap(sources[i], src[i] + n);
+	}
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+/* Mix n 24 bit PCM source streams to one sink stream */
+static void mix_n_s24(struct comp_dev *dev, struct audio_stream __sparse_cache *sink,
+		      const struct audio_stream __sparse_cache **sources, uint32_t num_sources,
+		      uint32_t frames)
+{
+	int32_t *src[PLATFORM_MAX_CHANNELS];
+	int32_t *dest;
+	const __m128i max = _mm_set1_epi32(INT24_MAXVALUE);
+	const __m128i min = _mm_set1_epi32(INT24_MINVALUE);
+	__m128i acc;
+	__m128i x;
+	int32_t val;
+	int nmax;
+	int i, j, n, ns;
+	int processed = 0;
+	int nch = sink->channels;
+	int samples = frames * nch;
+
+	dest = sink->w_ptr;
+	for (j = 0; j < num_sources; j++)
+		src[j] = sources[j]->r_ptr;
+
+	while (processed < samples) {
+		nmax = samples - processed;
+		n = audio_stream_samples_without_wrap_s24(sink, dest);
+		n = MIN(n, nmax);
+		for (i = 0; i < num_sources; i++) {
+			ns = audio_stream_samples_without_wrap_s24(sources[i], src[i]);
+			n = MIN(n, ns);
+		}
+
+		/* Four samples per iteration, sign extend from 24 bits and sum */
+		for (i = 0; i <= n - 4; i += 4) {
+			acc = _mm_setzero_si128();
+			for (j = 0; j < num_sources; j++) {
+				x = _mm_loadu_si128((__m128i *)(src[j] + i));
+				x = _mm_srai_epi32(_mm_slli_epi32(x, 8), 8);
+				acc = _mm_add_epi32(acc, x);
+			}
+
+			/* Saturate to 24 bits */
+			acc = _mm_max_epi32(_mm_min_epi32(acc, max), min);
+			_mm_storeu_si128((__m128i *)(dest + i), acc);
+		}
+
+		for (; i < n; i++) {
+			val = 0;
+			for (j = 0; j < num_sources; j++)
+				val += sign_extend_s24(src[j][i]);
+
+			/* Saturate to 24 bits */
+			dest[i] = sat_int24(val);
+		}
+
+		processed += n;
+		dest = audio_stream_wrap(sink, dest + n);
+		for (i = 0; i < num_sources; i++)
+			src[i] = audio_stream_wrap(sources[i], src[i] + n);
+	}
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+/* Saturate two 64 bit lanes to 32 bits, the result is in the low 32 bits of the lanes */
+static inline __m128i mix_sat_int32x2(__m128i acc)
+{
+	const __m128i max = _mm_set1_epi64x(INT32_MAX);
+	const __m128i min = _mm_set1_epi64x(INT32_MIN);
+
+	acc = _mm_blendv_epi8(acc, max, _mm_cmpgt_epi64(acc, max));
+	return _mm_blendv_epi8(acc, min, _mm_cmpgt_epi64(min, acc));
+}
+
+/* Mix n 32 bit PCM source streams to one sink stream */
+static void mix_n_s32(struct comp_dev *dev, struct audio_stream __sparse_cache *sink,
+		      const struct audio_stream __sparse_cache **sources, uint32_t num_sources,
+		      uint32_t frames)
+{
+	int32_t *src[PLATFORM_MAX_CHANNELS];
+	int32_t *dest;
+	__m128i acc_lo;
+	__m128i acc_hi;
+	__m128i x;
+	int64_t val;
+	int nmax;
+	int i, j, n, ns;
+	int processed = 0;
+	int nch = sink->channels;
+	int samples = frames * nch;
+
+	dest = sink->w_ptr;
+	for (j = 0; j < num_sources; j++)
+		src[j] = sources[j]->r_ptr;
+
+	while (processed < samples) {
+		nmax = samples - processed;
+		n = audio_stream_samples_without_wrap_s32(sink, dest);
+		n = MIN(n, nmax);
+		for (i = 0; i < num_sources; i++) {
+			ns = audio_stream_samples_without_wrap_s32(sources[i], src[i]);
+			n = MIN(n, ns);
+		}
+
+		/* Four samples per iteration, sum in 64 bits */
+		for (i = 0; i <= n - 4; i += 4) {
+			acc_lo = _mm_setzero_si128();
+			acc_hi = _mm_setzero_si128();
+			for (j = 0; j < num_sources; j++) {
+				x = _mm_loadu_si128((__m128i *)(src[j] + i));
+				acc_lo = _mm_add_epi64(acc_lo, _mm_cvtepi32_epi64(x));
+				x = _mm_srli_si128(x, 8);
+				acc_hi = _mm_add_epi64(acc_hi, _mm_cvtepi32_epi64(x));
+			}
+
+			/* Saturate to 32 bits and gather the low words of the lanes */
+			acc_lo = mix_sat_int32x2(acc_lo);
+			acc_hi = mix_sat_int32x2(acc_hi);
+			acc_lo = _mm_shuffle_epi32(acc_lo, _MM_SHUFFLE(3, 1, 2, 0));
+			acc_hi = _mm_shuffle_epi32(acc_hi, _MM_SHUFFLE(3, 1, 2, 0));
+			_mm_storeu_si128((__m128i *)(dest + i), _mm_unpacklo_epi64(acc_lo, acc_hi));
+		}
+
+		for (; i < n; i++) {
+			val = 0;
+			for (j = 0; j < num_sources; j++)
+				val += src[j][i];
+
+			/* Saturate to 32 bits */
+			dest[i] = sat_int32(val);
+		}
+
+		processed += n;
+		dest = audio_stream_wrap(sink, dest + n);
+		for (i = 0; i < num_sources; i++)
+			src[i] = audio_stream_wrap(sources[i], src[i] + n);
+	}
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+const struct mixer_func_map mixer_func_map[] = {
+#if CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, mix_n_s16 },
+#endif
+#if CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, mix_n_s24 },
+#endif
+#if CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, mix_n_s32 },
+#endif
+};
+
+const size_t mixer_func_count = ARRAY_SIZE(mixer_func_map);
+
+#endif
@@ -5,6 +5,7 @@
 // Author: Andrula Song <xiaoyuan.song@intel.com>
 
 #include <ipc4/mixin_mixout.h>
+#include <sof/audio/mix_acc.h>
 #include <sof/common.h>
 #include <rtos/string.h>
 
@@ -23,7 +24,7 @@ static void normal_mix_channel_s16(struct audio_stream __sparse_cache *sink, int
 				   int32_t frame_count, uint16_t gain)
 {
 	int32_t frames_to_mix, frames_to_copy, left_frames;
-	int32_t n, nmax, i;
+	int32_t n, nmax;
 
 	/* audio_stream_wrap() is required and is done below in a loop */
 	int16_t *dst = (int16_t *)sink->w_ptr + start_frame;
@@ -42,10 +43,9 @@ static void normal_mix_channel_s16(struct audio_stream __sparse_cache *sink, int
 		n = MIN(left_frames, nmax);
 		nmax = audio_stream_samples_without_wrap_s16(sink, dst);
 		n = MIN(n, nmax);
-		for (i = 0; i < n; i++) {
-			*dst = sat_int16(*dst + *src++);
-			dst++;
-		}
+		mix_acc_add_sat_s16(dst, src, n);
+		src += n;
+		dst += n;
 	}
 
 	for (left_frames = frames_to_copy; left_frames > 0; left_frames -= n) {
@@ -56,6 +56,8 @@ static void normal_mix_channel_s16(struct audio_stream __sparse_cache *sink, int
 		nmax = audio_stream_samples_without_wrap_s16(sink, dst);
 		n = MIN(n, nmax);
 		memcpy_s(dst, n * sizeof(int16_t), src, n * sizeof(int16_t));
+		src += n;
+		dst += n;
 	}
 }
 
@@ -161,7 +163,7 @@ static void normal_mix_channel_s24(struct audio_stream __sparse_cache *sink, int
 				   int32_t frame_count, uint16_t gain)
 {
 	int32_t frames_to_mix, frames_to_copy, left_frames;
-	int32_t n, nmax, i;
+	int32_t n, nmax;
 	/* audio_stream_wrap() is required and is done below in a loop */
 	int32_t *dst = (int32_t *)sink->w_ptr + start_frame;
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -179,10 +181,9 @@ static void normal_mix_channel_s24(struct audio_stream __sparse_cache *sink, int
 		n = MIN(left_frames, nmax);
 		nmax = audio_stream_samples_without_wrap_s24(sink, dst);
 		n = MIN(n, nmax);
-		for (i = 0; i < n; i++) {
-			*dst = sat_int24(sign_extend_s24(*dst) + sign_extend_s24(*src++));
-			dst++;
-		}
+		mix_acc_add_sat_s24(dst, src, n);
+		src += n;
+		dst += n;
 	}
 
 	for (left_frames = frames_to_copy; left_frames > 0; left_frames -= n) {
@@ -193,6 +194,8 @@ static void normal_mix_channel_s24(struct audio_stream __sparse_cache *sink, int
 		nmax = audio_stream_samples_without_wrap_s24(sink, dst);
 		n = MIN(n, nmax);
 		memcpy_s(dst, n * sizeof(int32_t), src, n * sizeof(int32_t));
+		src += n;
+		dst += n;
 	}
 }
 
@@ -271,7 +274,7 @@ static void normal_mix_channel_s32(struct audio_stream __sparse_cache *sink, int
 				   int32_t frame_count, uint16_t gain)
 {
 	int32_t frames_to_mix, frames_to_copy, left_frames;
-	int32_t n, nmax, i;
+	int32_t n, nmax;
 	int32_t *dst = (int32_t *)sink->w_ptr + start_frame;
 	int32_t *src = (int32_t *)source->r_ptr;
 
@@ -288,10 +291,9 @@ static void normal_mix_channel_s32(struct audio_stream __sparse_cache *sink, int
 		n = MIN(left_frames, nmax);
 		nmax = audio_stream_samples_without_wrap_s32(sink, dst);
 		n = MIN(n, nmax);
-		for (i = 0; i < n; i++) {
-			*dst = sat_int32((int64_t)*dst + (int64_t)*src++);
-			dst++;
-		}
+		mix_acc_add_sat_s32(dst, src, n);
+		src += n;
+		dst += n;
 	}
 
 	for (left_frames = frames_to_copy; left_frames > 0; left_frames -= n) {
@@ -302,6 +304,8 @@ static void normal_mix_channel_s32(struct audio_stream __sparse_cache *sink, int
 		nmax = audio_stream_samples_without_wrap_s32(sink, dst);
 		n = MIN(n, nmax);
 		memcpy_s(dst, n * sizeof(int32_t), src, n * sizeof(int32_t));
+		src += n;
+		dst += n;
 	}
 }
 
@@ -16,31 +16,15 @@ DECLARE_TR_CTX(passthrough_tr, SOF_UUID(passthrough_uuid), LOG_LEVEL_INFO);
 static int passthrough_codec_init(struct processing_module *mod)
 {
 	comp_info(mod->dev, "passthrough_codec_init() start");
+
+	/* copy straight from the source to the sink buffer, no intermediate buffers needed */
+	mod->stream_copy = true;
 	return 0;
 }
 
 static int passthrough_codec_prepare(struct processing_module *mod)
 {
-	struct comp_dev *dev = mod->dev;
-	struct module_data *codec = &mod->priv;
-
-	comp_info(dev, "passthrough_codec_prepare()");
-
-	codec->mpd.in_buff = rballoc(0, SOF_MEM_CAPS_RAM, mod->period_bytes);
-	if (!codec->mpd.in_buff) {
-		comp_err(dev, "passthrough_codec_prepare(): Failed to alloc in_buff");
-		return -ENOMEM;
-	}
-	codec->mpd.in_buff_size = mod->period_bytes;
-
-	codec->mpd.out_buff = rballoc(0, SOF_MEM_CAPS_RAM, mod->period_bytes);
-	if (!codec->mpd.out_buff) {
-		comp_err(dev, "passthrough_codec_prepare(): Failed to alloc out_buff");
-		rfree(codec->mpd.in_buff);
-		return -ENOMEM;
-	}
-	codec->mpd.out_buff_size = mod->period_bytes;
-
+	comp_info(mod->dev, "passthrough_codec_prepare()");
 	return 0;
 }
 
@@ -65,43 +49,35 @@ passthrough_codec_process(struct processing_module *mod,
 {
 	struct comp_dev *dev = mod->dev;
 	struct module_data *codec = &mod->priv;
+	struct audio_stream __sparse_cache *source = input_buffers[0].data;
+	struct audio_stream __sparse_cache *sink = output_buffers[0].data;
+	uint32_t bytes = input_buffers[0].size;
 
-	/* Proceed only if we have enough data to fill the module buffer completely */
-	if (input_buffers[0].size < codec->mpd.in_buff_size) {
-		comp_dbg(dev, "passthrough_codec_process(): not enough data to process");
+	if (!bytes) {
+		comp_dbg(dev, "passthrough_codec_process(): no data to process");
 		return -ENODATA;
 	}
 
 	if (!codec->mpd.init_done)
 		passthrough_codec_init_process(mod);
 
-	memcpy_s(codec->mpd.in_buff, codec->mpd.in_buff_size,
-		 input_buffers[0].data, codec->mpd.in_buff_size);
-
 	comp_dbg(dev, "passthrough_codec_process()");
 
-	memcpy_s(codec->mpd.out_buff, codec->mpd.out_buff_size,
-		 codec->mpd.in_buff, codec->mpd.in_buff_size);
-	codec->mpd.produced = mod->period_bytes;
-	codec->mpd.consumed = mod->period_bytes;
-	input_buffers[0].consumed = codec->mpd.consumed;
-
-	/* copy the produced samples into the output buffer */
-	memcpy_s(output_buffers[0].data, codec->mpd.produced, codec->mpd.out_buff,
-		 codec->mpd.produced);
-	output_buffers[0].size = codec->mpd.produced;
+	/* the module adapter limits the input to the free space in the sink */
+	audio_stream_copy(source, 0, sink, 0, bytes / audio_stream_sample_bytes(source));
+	codec->mpd.produced = bytes;
+	codec->mpd.consumed = bytes;
+	input_buffers[0].consumed = bytes;
+	output_buffers[0].size = bytes;
 
 	return 0;
 }
 
 static int passthrough_codec_reset(struct processing_module *mod)
 {
-	struct module_data *codec = &mod->priv;
-
 	comp_info(mod->dev, "passthrough_codec_reset()");
 
-	rfree(codec->mpd.in_buff);
-	rfree(codec->mpd.out_buff);
+	/* Nothing to do */
 	return 0;
 }
 
@@ -70,23 +70,26 @@ DECLARE_TR_CTX(volume_tr, SOF_UUID(volume_uuid), LOG_LEVEL_INFO);
 #if CONFIG_FORMAT_S16LE
 /**
  * \brief Used to find nearest zero crossing frame for 16 bit format.
- * \param[in,out] source Source buffer.
+ * \param[in] bsource Source buffer, frames start after the consumed data.
  * \param[in] frames Number of frames.
  * \param[in,out] prev_sum Previous sum of channel samples.
  */
-static uint32_t vol_zc_get_s16(const struct audio_stream __sparse_cache *source,
+static uint32_t vol_zc_get_s16(const struct input_stream_buffer *bsource,
 			       uint32_t frames, int64_t *prev_sum)
 {
+	const struct audio_stream __sparse_cache *source = bsource->data;
 	uint32_t curr_frames = frames;
 	int32_t sum;
-	int16_t *x = source->r_ptr;
+	int16_t *x;
 	int bytes;
 	int nmax;
 	int i, j, n;
 	const int nch = source->channels;
 	int remaining_samples = frames * nch;
 
-	x = audio_stream_wrap(source, x + remaining_samples - 1); /* Go to last channel */
+	/* go to last channel of the last frame after the consumed data */
+	x = audio_stream_wrap(source, (char *)source->r_ptr + bsource->consumed);
+	x = audio_stream_wrap(source, x + remaining_samples - 1);
 	while (remaining_samples) {
 		bytes = audio_stream_rewind_bytes_without_wrap(source, x);
 		nmax = VOL_BYTES_TO_S16_SAMPLES(bytes) + 1;
@@ -118,23 +121,26 @@ static uint32_t vol_zc_get_s16(const struct audio_stream __sparse_cache *source,
 #if CONFIG_FORMAT_S24LE
 /**
  * \brief Used to find nearest zero crossing frame for 24 in 32 bit format.
- * \param[in,out] source Source buffer.
+ * \param[in] bsource Source buffer, frames start after the consumed data.
  * \param[in] frames Number of frames.
  * \param[in,out] prev_sum Previous sum of channel samples.
  */
-static uint32_t vol_zc_get_s24(const struct audio_stream __sparse_cache *source,
+static uint32_t vol_zc_get_s24(const struct input_stream_buffer *bsource,
 			       uint32_t frames, int64_t *prev_sum)
 {
+	const struct audio_stream __sparse_cache *source = bsource->data;
 	int64_t sum;
 	uint32_t curr_frames = frames;
-	int32_t *x = source->r_ptr;
+	int32_t *x;
 	int bytes;
 	int nmax;
 	int i, j, n;
 	const int nch = source->channels;
 	int remaining_samples = frames * nch;
 
-	x = audio_stream_wrap(source, x + remaining_samples - 1); /* Go to last channel */
+	/* go to last channel of the last frame after the consumed data */
+	x = audio_stream_wrap(source, (char *)source->r_ptr + bsource->consumed);
+	x = audio_stream_wrap(source, x + remaining_samples - 1);
 	while (remaining_samples) {
 		bytes = audio_stream_rewind_bytes_without_wrap(source, x);
 		nmax = VOL_BYTES_TO_S32_SAMPLES(bytes) + 1;
@@ -166,23 +172,26 @@ static uint32_t vol_zc_get_s24(const struct audio_stream __sparse_cache *source,
 #if CONFIG_FORMAT_S32LE
 /**
  * \brief Used to find nearest zero crossing frame for 32 bit format.
- * \param[in,out] source Source buffer.
+ * \param[in] bsource Source buffer, frames start after the consumed data.
  * \param[in] frames Number of frames.
  * \param[in,out] prev_sum Previous sum of channel samples.
  */
-static uint32_t vol_zc_get_s32(const struct audio_stream __sparse_cache *source,
+static uint32_t vol_zc_get_s32(const struct input_stream_buffer *bsource,
 			       uint32_t frames, int64_t *prev_sum)
 {
+	const struct audio_stream __sparse_cache *source = bsource->data;
 	int64_t sum;
 	uint32_t curr_frames = frames;
-	int32_t *x = source->r_ptr;
+	int32_t *x;
 	int bytes;
 	int nmax;
 	int i, j, n;
 	const int nch = source->channels;
 	int remaining_samples = frames * nch;
 
-	x = audio_stream_wrap(source, x + remaining_samples - 1); /* Go to last channel */
+	/* go to last channel of the last frame after the consumed data */
+	x = audio_stream_wrap(source, (char *)source->r_ptr + bsource->consumed);
+	x = audio_stream_wrap(source, x + remaining_samples - 1);
 	while (remaining_samples) {
 		bytes = audio_stream_rewind_bytes_without_wrap(source, x);
 		nmax = VOL_BYTES_TO_S32_SAMPLES(bytes) + 1;
@@ -212,7 +221,7 @@ static uint32_t vol_zc_get_s32(const struct audio_stream __sparse_cache *source,
 #endif /* CONFIG_FORMAT_S32LE */
 
 /** \brief Map of formats with dedicated zc functions. */
-static const struct comp_zc_func_map zc_func_map[] = {
+const struct comp_zc_func_map volume_zc_func_map[] = {
 #if CONFIG_FORMAT_S16LE
 	{ SOF_IPC_FRAME_S16_LE, vol_zc_get_s16 },
 #endif /* CONFIG_FORMAT_S16LE */
@@ -224,6 +233,8 @@ static const struct comp_zc_func_map zc_func_map[] = {
 #endif /* CONFIG_FORMAT_S32LE */
 };
 
+const size_t volume_zc_func_count = ARRAY_SIZE(volume_zc_func_map);
+
 #if CONFIG_COMP_VOLUME_LINEAR_RAMP
 /**
  * \brief Calculate linear ramp function
@@ -252,12 +263,17 @@ static int32_t volume_windows_fade_ramp(struct processing_module *mod, int32_t r
 {
 	struct vol_data *cd = module_get_private_data(mod);
 	int32_t time_ratio; /* Q2.30 */
-	int32_t pow_value; /* Q2.30 */
 	int32_t volume_delta = cd->tvolume[channel] - cd->rvolume[channel]; /* Q16.16 */
 
-	time_ratio = (((int64_t)ramp_time) << 30) / (cd->initial_ramp << 3);
-	pow_value = volume_pow_175(time_ratio);
-	return cd->rvolume[channel] + Q_MULTSR_32X32((int64_t)volume_delta, pow_value, 16, 30, 16);
+	/* The shape depends only on time, compute it once for all channels */
+	if (ramp_time != cd->fade_ramp_time) {
+		time_ratio = (((int64_t)ramp_time) << 30) / (cd->initial_ramp << 3);
+		cd->fade_pow = volume_pow_175(time_ratio);
+		cd->fade_ramp_time = ramp_time;
+	}
+
+	return cd->rvolume[channel] + Q_MULTSR_32X32((int64_t)volume_delta, cd->fade_pow,
+						     16, 30, 16);
 }
 #endif
 
@@ -363,6 +379,9 @@ static void reset_state(struct vol_data *cd)
 	cd->vol_ramp_elapsed_frames = 0;
 	cd->sample_rate = 0;
 	cd->copy_gain = true;
+#if CONFIG_COMP_VOLUME_WINDOWS_FADE
+	cd->fade_ramp_time = -1;
+#endif
 }
 
 #if CONFIG_IPC_MAJOR_3
@@ -699,6 +718,9 @@ static inline int volume_set_chan(struct processing_module *mod, int chan,
 	cd->tvolume[chan] = v;
 	cd->rvolume[chan] = cd->volume[chan];
 	cd->vol_ramp_elapsed_frames = 0;
+#if CONFIG_COMP_VOLUME_WINDOWS_FADE
+	cd->fade_ramp_time = -1;
+#endif
 
 	/* Check ramp type */
 	if (cd->ramp_type == SOF_VOLUME_LINEAR ||
@@ -1078,6 +1100,46 @@ static void volume_update_current_vol_ipc4(struct vol_data *cd)
 #endif
 }
 
+/**
+ * \brief Computes the gains of the next ramp segments.
+ * \param[in,out] mod Volume processing module handle
+ * \param[in] avail_frames Number of frames available for processing.
+ * \return Number of frames in the computed segments.
+ *
+ * The segments are split and the ramp is advanced exactly as when the
+ * segments are processed one by one, the gains are the same.
+ */
+static uint32_t volume_ramp_segments(struct processing_module *mod, uint32_t avail_frames)
+{
+	struct vol_data *cd = module_get_private_data(mod);
+	struct vol_ramp_segment *seg = cd->ramp_segments;
+	uint32_t frames = 0;
+	int i;
+
+	while (avail_frames && seg < cd->ramp_segments + VOL_RAMP_SEGMENTS_MAX) {
+		if (cd->ramp_finished || cd->vol_ramp_frames > avail_frames)
+			seg->frames = avail_frames;
+		else
+			seg->frames = cd->vol_ramp_frames;
+
+		volume_update_current_vol_ipc4(cd);
+		for (i = 0; i < cd->channels; i++)
+			seg->gain[i] = cd->volume[i];
+
+		if (cd->vol_ramp_active)
+			cd->vol_ramp_elapsed_frames += seg->frames;
+
+		if (!cd->ramp_finished)
+			volume_ramp(mod);
+
+		avail_frames -= seg->frames;
+		frames += seg->frames;
+		seg++;
+	}
+
+	return frames;
+}
+
 /*
  * \brief Copies and processes stream data.
  * \param[in,out] mod Volume processing module handle
@@ -1098,12 +1160,24 @@ static int volume_process(struct processing_module *mod,
 	while (avail_frames) {
 		volume_update_current_vol_ipc4(cd);
 
+		/* Ramp without ZC, compute the gains of all segments and then
+		 * process them in one pass.
+		 */
+		if (!cd->ramp_finished && cd->scale_vol_ramp &&
+		    cd->ramp_type != SOF_VOLUME_LINEAR_ZC && cd->vol_ramp_frames <= avail_frames) {
+			frames = volume_ramp_segments(mod, avail_frames);
+			cd->scale_vol_ramp(mod, &input_buffers[0], &output_buffers[0],
+					   cd->ramp_segments, frames);
+			avail_frames -= frames;
+			continue;
+		}
+
 		if (cd->ramp_finished || cd->vol_ramp_frames > avail_frames) {
 			/* without ramping process all at once */
 			frames = avail_frames;
 		} else if (cd->ramp_type == SOF_VOLUME_LINEAR_ZC) {
 			/* with ZC ramping look for next ZC offset */
-			frames = cd->zc_get(input_buffers[0].data, cd->vol_ramp_frames, &prev_sum);
+			frames = cd->zc_get(&input_buffers[0], cd->vol_ramp_frames, &prev_sum);
 		} else {
 			/* without ZC process max ramp chunk */
 			frames = cd->vol_ramp_frames;
@@ -1134,9 +1208,9 @@ static vol_zc_func vol_get_zc_function(struct comp_dev *dev,
 	int i;
 
 	/* map the zc function to frame format */
-	for (i = 0; i < ARRAY_SIZE(zc_func_map); i++) {
-		if (sinkb->stream.valid_sample_fmt == zc_func_map[i].frame_fmt)
-			return zc_func_map[i].func;
+	for (i = 0; i < volume_zc_func_count; i++) {
+		if (sinkb->stream.valid_sample_fmt == volume_zc_func_map[i].frame_fmt)
+			return volume_zc_func_map[i].func;
 	}
 
 	return NULL;
@@ -1235,6 +1309,8 @@ static int volume_prepare(struct processing_module *mod)
 		goto err;
 	}
 
+	cd->scale_vol_ramp = vol_get_ramp_processing_function(dev, sink_c);
+
 	cd->zc_get = vol_get_zc_function(dev, sink_c);
 	if (!cd->zc_get) {
 		comp_err(dev, "volume_prepare(): invalid cd->zc_get");
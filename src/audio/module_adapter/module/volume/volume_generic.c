@@ -68,8 +68,8 @@ static void vol_s24_to_s24(struct processing_module *mod, struct input_stream_bu
 	int32_t tmp = INT_MIN_FOR_NUMBER_OF_BITS(32);
 #endif
 
-	x = source->r_ptr;
-	y = sink->w_ptr;
+	x = audio_stream_wrap(source, (char *)source->r_ptr + bsource->consumed);
+	y = audio_stream_wrap(sink, (char *)sink->w_ptr + bsink->size);
 
 	bsource->consumed += VOL_S32_SAMPLES_TO_BYTES(remaining_samples);
 	bsink->size += VOL_S32_SAMPLES_TO_BYTES(remaining_samples);
@@ -102,6 +102,86 @@ static void vol_s24_to_s24(struct processing_module *mod, struct input_stream_bu
 	/* update peak vol */
 	peak_vol_update(cd);
 }
+
+/**
+ * \brief Volume ramp processing from 24/32 bit to 24/32 bit.
+ * \param[in,out] mod Volume processing module handle
+ * \param[in,out] bsource Source buffer.
+ * \param[in,out] bsink Destination buffer.
+ * \param[in] seg First ramp segment.
+ * \param[in] frames Number of frames to process.
+ *
+ * Copy and scale the frames of consecutive ramp segments, each with its own
+ * gains, in one channel interleaved pass.
+ */
+static void vol_s24_to_s24_ramp(struct processing_module *mod,
+				struct input_stream_buffer *bsource,
+				struct output_stream_buffer *bsink,
+				const struct vol_ramp_segment *seg, uint32_t frames)
+{
+	struct vol_data *cd = module_get_private_data(mod);
+	struct audio_stream __sparse_cache *source = bsource->data;
+	struct audio_stream __sparse_cache *sink = bsink->data;
+	const int32_t *gain = seg->gain;
+	int32_t *x;
+	int32_t *y;
+	int nmax, n, m, i, j;
+	const int nch = source->channels;
+	int remaining_samples = frames * nch;
+	int seg_samples = seg->frames * nch;
+#if CONFIG_COMP_PEAK_VOL
+	int32_t peak[SOF_IPC_MAX_CHANNELS];
+
+	for (j = 0; j < nch; j++)
+		peak[j] = INT_MIN_FOR_NUMBER_OF_BITS(32);
+#endif
+
+	x = audio_stream_wrap(source, (char *)source->r_ptr + bsource->consumed);
+	y = audio_stream_wrap(sink, (char *)sink->w_ptr + bsink->size);
+
+	bsource->consumed += VOL_S32_SAMPLES_TO_BYTES(remaining_samples);
+	bsink->size += VOL_S32_SAMPLES_TO_BYTES(remaining_samples);
+	while (remaining_samples) {
+		nmax = VOL_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(source, x));
+		n = MIN(remaining_samples, nmax);
+		nmax = VOL_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(sink, y));
+		n = MIN(n, nmax);
+		remaining_samples -= n;
+		while (n) {
+			if (!seg_samples) {
+				seg++;
+				gain = seg->gain;
+				seg_samples = seg->frames * nch;
+			}
+
+			m = MIN(n, seg_samples);
+			for (i = 0; i < m; i += nch) {
+				for (j = 0; j < nch; j++) {
+					y[i + j] = vol_mult_s24_to_s24(x[i + j], gain[j]);
+#if CONFIG_COMP_PEAK_VOL
+					peak[j] = MAX(y[i + j], peak[j]);
+#endif
+				}
+			}
+			x += m;
+			y += m;
+			n -= m;
+			seg_samples -= m;
+		}
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+
+#if CONFIG_COMP_PEAK_VOL
+	/* same as vol_s24_to_s24() reports for the frames */
+	cd->peak_regs.peak_meter[0] = peak[0];
+	for (j = 1; j < nch; j++)
+		cd->peak_regs.peak_meter[j] = MAX(peak[j], cd->peak_regs.peak_meter[j - 1]);
+#endif
+
+	/* update peak vol */
+	peak_vol_update(cd);
+}
 #endif /* CONFIG_FORMAT_S24LE */
 
 #if CONFIG_FORMAT_S32LE
@@ -131,8 +211,8 @@ static void vol_s32_to_s32(struct processing_module *mod, struct input_stream_bu
 	int32_t tmp = INT_MIN_FOR_NUMBER_OF_BITS(32);
 #endif
 
-	x = source->r_ptr;
-	y = sink->w_ptr;
+	x = audio_stream_wrap(source, (char *)source->r_ptr + bsource->consumed);
+	y = audio_stream_wrap(sink, (char *)sink->w_ptr + bsink->size);
 	bsource->consumed += VOL_S32_SAMPLES_TO_BYTES(remaining_samples);
 	bsink->size += VOL_S32_SAMPLES_TO_BYTES(remaining_samples);
 	while (remaining_samples) {
@@ -169,6 +249,97 @@ static void vol_s32_to_s32(struct processing_module *mod, struct input_stream_bu
 	/* update peak vol */
 	peak_vol_update(cd);
 }
+
+/**
+ * \brief Volume s32 to s32 multiply function
+ * \param[in] x   input sample.
+ * \param[in] vol gain.
+ * \return output sample.
+ */
+static inline int32_t vol_mult_s32_to_s32(int32_t x, int32_t vol)
+{
+	return q_multsr_sat_32x32(x, vol, Q_SHIFT_BITS_64(31, VOL_QXY_Y, 31));
+}
+
+/**
+ * \brief Volume ramp processing from 32 bit to 32 bit.
+ * \param[in,out] mod Volume processing module handle
+ * \param[in,out] bsource Source buffer.
+ * \param[in,out] bsink Destination buffer.
+ * \param[in] seg First ramp segment.
+ * \param[in] frames Number of frames to process.
+ *
+ * Copy and scale the frames of consecutive ramp segments, each with its own
+ * gains, in one channel interleaved pass.
+ */
+static void vol_s32_to_s32_ramp(struct processing_module *mod,
+				struct input_stream_buffer *bsource,
+				struct output_stream_buffer *bsink,
+				const struct vol_ramp_segment *seg, uint32_t frames)
+{
+	struct vol_data *cd = module_get_private_data(mod);
+	struct audio_stream __sparse_cache *source = bsource->data;
+	struct audio_stream __sparse_cache *sink = bsink->data;
+	const int32_t *gain = seg->gain;
+	int32_t *x;
+	int32_t *y;
+	int nmax, n, m, i, j;
+	const int nch = source->channels;
+	int remaining_samples = frames * nch;
+	int seg_samples = seg->frames * nch;
+#if CONFIG_COMP_PEAK_VOL
+	int32_t peak[SOF_IPC_MAX_CHANNELS];
+
+	for (j = 0; j < nch; j++)
+		peak[j] = INT_MIN_FOR_NUMBER_OF_BITS(32);
+#endif
+
+	x = audio_stream_wrap(source, (char *)source->r_ptr + bsource->consumed);
+	y = audio_stream_wrap(sink, (char *)sink->w_ptr + bsink->size);
+
+	bsource->consumed += VOL_S32_SAMPLES_TO_BYTES(remaining_samples);
+	bsink->size += VOL_S32_SAMPLES_TO_BYTES(remaining_samples);
+	while (remaining_samples) {
+		nmax = VOL_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(source, x));
+		n = MIN(remaining_samples, nmax);
+		nmax = VOL_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(sink, y));
+		n = MIN(n, nmax);
+		remaining_samples -= n;
+		while (n) {
+			if (!seg_samples) {
+				seg++;
+				gain = seg->gain;
+				seg_samples = seg->frames * nch;
+			}
+
+			m = MIN(n, seg_samples);
+			for (i = 0; i < m; i += nch) {
+				for (j = 0; j < nch; j++) {
+					y[i + j] = vol_mult_s32_to_s32(x[i + j], gain[j]);
+#if CONFIG_COMP_PEAK_VOL
+					peak[j] = MAX(y[i + j], peak[j]);
+#endif
+				}
+			}
+			x += m;
+			y += m;
+			n -= m;
+			seg_samples -= m;
+		}
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+
+#if CONFIG_COMP_PEAK_VOL
+	/* same as vol_s32_to_s32() reports for the frames */
+	cd->peak_regs.peak_meter[0] = peak[0];
+	for (j = 1; j < nch; j++)
+		cd->peak_regs.peak_meter[j] = MAX(peak[j], cd->peak_regs.peak_meter[j - 1]);
+#endif
+
+	/* update peak vol */
+	peak_vol_update(cd);
+}
 #endif /* CONFIG_FORMAT_S32LE */
 
 #if CONFIG_FORMAT_S16LE
@@ -198,8 +369,8 @@ static void vol_s16_to_s16(struct processing_module *mod, struct input_stream_bu
 	int16_t tmp = INT_MIN_FOR_NUMBER_OF_BITS(16);
 #endif
 
-	x = source->r_ptr;
-	y = sink->w_ptr;
+	x = audio_stream_wrap(source, (char *)source->r_ptr + bsource->consumed);
+	y = audio_stream_wrap(sink, (char *)sink->w_ptr + bsink->size);
 
 	bsource->consumed += VOL_S16_SAMPLES_TO_BYTES(remaining_samples);
 	bsink->size += VOL_S16_SAMPLES_TO_BYTES(remaining_samples);
@@ -233,17 +404,108 @@ static void vol_s16_to_s16(struct processing_module *mod, struct input_stream_bu
 	/* update peak vol */
 	peak_vol_update(cd);
 }
+
+/**
+ * \brief Volume s16 to s16 multiply function
+ * \param[in] x   input sample.
+ * \param[in] vol gain.
+ * \return output sample.
+ */
+static inline int16_t vol_mult_s16_to_s16(int16_t x, int32_t vol)
+{
+	return q_multsr_sat_32x32_16(x, vol, Q_SHIFT_BITS_32(15, VOL_QXY_Y, 15));
+}
+
+/**
+ * \brief Volume ramp processing from 16 bit to 16 bit.
+ * \param[in,out] mod Volume processing module handle
+ * \param[in,out] bsource Source buffer.
+ * \param[in,out] bsink Destination buffer.
+ * \param[in] seg First ramp segment.
+ * \param[in] frames Number of frames to process.
+ *
+ * Copy and scale the frames of consecutive ramp segments, each with its own
+ * gains, in one channel interleaved pass.
+ */
+static void vol_s16_to_s16_ramp(struct processing_module *mod,
+				struct input_stream_buffer *bsource,
+				struct output_stream_buffer *bsink,
+				const struct vol_ramp_segment *seg, uint32_t frames)
+{
+	struct vol_data *cd = module_get_private_data(mod);
+	struct audio_stream __sparse_cache *source = bsource->data;
+	struct audio_stream __sparse_cache *sink = bsink->data;
+	const int32_t *gain = seg->gain;
+	int16_t *x;
+	int16_t *y;
+	int nmax, n, m, i, j;
+	const int nch = source->channels;
+	int remaining_samples = frames * nch;
+	int seg_samples = seg->frames * nch;
+#if CONFIG_COMP_PEAK_VOL
+	int16_t peak[SOF_IPC_MAX_CHANNELS];
+
+	for (j = 0; j < nch; j++)
+		peak[j] = INT_MIN_FOR_NUMBER_OF_BITS(16);
+#endif
+
+	x = audio_stream_wrap(source, (char *)source->r_ptr + bsource->consumed);
+	y = audio_stream_wrap(sink, (char *)sink->w_ptr + bsink->size);
+
+	bsource->consumed += VOL_S16_SAMPLES_TO_BYTES(remaining_samples);
+	bsink->size += VOL_S16_SAMPLES_TO_BYTES(remaining_samples);
+	while (remaining_samples) {
+		nmax = VOL_BYTES_TO_S16_SAMPLES(audio_stream_bytes_without_wrap(source, x));
+		n = MIN(remaining_samples, nmax);
+		nmax = VOL_BYTES_TO_S16_SAMPLES(audio_stream_bytes_without_wrap(sink, y));
+		n = MIN(n, nmax);
+		remaining_samples -= n;
+		while (n) {
+			if (!seg_samples) {
+				seg++;
+				gain = seg->gain;
+				seg_samples = seg->frames * nch;
+			}
+
+			m = MIN(n, seg_samples);
+			for (i = 0; i < m; i += nch) {
+				for (j = 0; j < nch; j++) {
+					y[i + j] = vol_mult_s16_to_s16(x[i + j], gain[j]);
+#if CONFIG_COMP_PEAK_VOL
+					peak[j] = MAX(y[i + j], peak[j]);
+#endif
+				}
+			}
+			x += m;
+			y += m;
+			n -= m;
+			seg_samples -= m;
+		}
+		x = audio_stream_wrap(source, x);
+		y = audio_stream_wrap(sink, y);
+	}
+
+#if CONFIG_COMP_PEAK_VOL
+	/* same as vol_s16_to_s16() reports for the frames */
+	cd->peak_regs.peak_meter[0] = peak[0];
+	for (j = 1; j < nch; j++)
+		cd->peak_regs.peak_meter[j] = MAX(peak[j], cd->peak_regs.peak_meter[j - 1]);
+#endif
+
+	/* update peak vol */
+	peak_vol_update(cd);
+}
 #endif /* CONFIG_FORMAT_S16LE */
 
 const struct comp_func_map volume_func_map[] = {
 #if CONFIG_FORMAT_S16LE
-	{ SOF_IPC_FRAME_S16_LE, vol_s16_to_s16 },
+	{ SOF_IPC_FRAME_S16_LE, vol_s16_to_s16, vol_s16_to_s16_ramp },
 #endif /* CONFIG_FORMAT_S16LE */
 #if CONFIG_FORMAT_S24LE
-	{ SOF_IPC_FRAME_S24_4LE, vol_s24_to_s24 },
+	{ SOF_IPC_FRAME_S24_4LE, vol_s24_to_s24, vol_s24_to_s24_ramp },
 #endif /* CONFIG_FORMAT_S24LE */
 #if CONFIG_FORMAT_S32LE
-	{ SOF_IPC_FRAME_S32_LE, vol_s32_to_s32 },
+	{ SOF_IPC_FRAME_S32_LE, vol_s32_to_s32, vol_s32_to_s32_ramp },
 #endif /* CONFIG_FORMAT_S32LE */
 };
 
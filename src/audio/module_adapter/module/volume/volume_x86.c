@@ -0,0 +1,333 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+/**
+ * \file
+ * \brief Volume x86 SIMD processing implementation
+ */
+
+#include <sof/audio/buffer.h>
+#include <sof/audio/component.h>
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <ipc/stream.h>
+#include <stddef.h>
+#include <stdint.h>
+
+LOG_MODULE_DECLARE(volume_x86, CONFIG_SOF_LOG_LEVEL);
+
+#include <sof/audio/volume.h>
+
+#ifdef VOLUME_X86
+
+#include <immintrin.h>
+
+/**
+ * \brief Store the channel gains repeated four times.
+ * \param[in,out] cd Volume component private data.
+ * \param[in] nch Number of channels.
+ *
+ * The gains of four consecutive interleaved samples starting from channel j
+ * are then found at cd->vol[j .. j + 3].
+ */
+static void vol_store_gain(struct vol_data *cd, const int nch)
+{
+	int i;
+
+	for (i = 0; i < nch; i++) {
+		cd->vol[i] = cd->volume[i];
+		cd->vol[i + nch * 1] = cd->volume[i];
+		cd->vol[i + nch * 2] = cd->volume[i];
+		cd->vol[i + nch * 3] = cd->volume[i];
+	}
+}
+
+/**
+ * \brief Multiply two 32 bit lanes with 64 bit product, round and saturate.
+ * \param[in] x Samples in the low words of the 64 bit lanes.
+ * \param[in] vol Gains in the low words of the 64 bit lanes.
+ * \return Result in the low words of the 64 bit lanes.
+ *
+ * The result is the same as with q_multsr_sat_32x32() for shift VOL_QXY_Y.
+ */
+static inline __m128i vol_mult_x86_2x(__m128i x, __m128i vol)
+{
+	const __m128i rnd = _mm_set1_epi64x(1LL << (VOL_QXY_Y - 1));
+	const __m128i max = _mm_set1_epi64x((1LL << (31 + VOL_QXY_Y)) - (1LL << VOL_QXY_Y));
+	const __m128i min = _mm_set1_epi64x(-(1LL << (31 + VOL_QXY_Y)));
+	const __m128i max_th = _mm_set1_epi64x((1LL << (31 + VOL_QXY_Y)) - 1);
+	__m128i p;
+
+	p = _mm_add_epi64(_mm_mul_epi32(x, vol), rnd);
+	p = _mm_blendv_epi8(p, max, _mm_cmpgt_epi64(p, max_th));
+	p = _mm_blendv_epi8(p, min, _mm_cmpgt_epi64(min, p));
+
+	/* The low word of the logical shift equals the arithmetic shift result */
+	return _mm_srli_epi64(p, VOL_QXY_Y);
+}
+
+/**
+ * \brief Volume multiply for four 32 bit samples.
+ * \param[in] x Input samples.
+ * \param[in] vol Gains for the samples.
+ * \return Output samples saturated to 32 bits.
+ */
+static inline __m128i vol_mult_x86(__m128i x, __m128i vol)
+{
+	__m128i even = vol_mult_x86_2x(x, vol);
+	__m128i odd = vol_mult_x86_2x(_mm_srli_epi64(x, 32), _mm_srli_epi64(vol, 32));
+
+	return _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0xcc);
+}
+
+#if CONFIG_COMP_PEAK_VOL
+/**
+ * \brief Update peak meter from processed interleaved samples.
+ *
+ * The running maximum is carried over the channels the same way as in the
+ * generic version.
+ */
+static int32_t vol_peak_update(struct vol_data *cd, const void *y, int n, int nch,
+			       int32_t tmp, bool s16)
+{
+	int i;
+	int j;
+
+	for (j = 0; j < nch; j++) {
+		for (i = j; i < n; i += nch)
+			tmp = MAX(s16 ? ((const int16_t *)y)[i] : ((const int32_t *)y)[i], tmp);
+
+		cd->peak_regs.peak_meter[j] = tmp;
+	}
+
+	return tmp;
+}
+#endif
+
+#if CONFIG_FORMAT_S24LE
+/**
+ * \brief Volume processing from 24/32 bit to 24/32 bit.
+ * \param[in,out] mod Volume processing module.
+ * \param[in,out] bsource Source buffer.
+ * \param[in,out] bsink Destination buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s24_to_s24(struct processing_module *mod, struct input_stream_buffer *bsource,
+			   struct output_stream_buffer *bsink, uint32_t frames)
+{
+	struct vol_data *cd = module_get_private_data(mod);
+	struct audio_stream __sparse_cache *source = bsource->data;
+	struct audio_stream __sparse_cache *sink = bsink->data;
+	const __m128i max = _mm_set1_epi32(INT24_MAXVALUE);
+	const __m128i min = _mm_set1_epi32(INT24_MINVALUE);
+	__m128i in;
+	__m128i out;
+	int32_t *x;
+	int32_t *y;
+	int nmax, n, i, ch;
+	const int nch = source->channels;
+	int remaining_samples = frames * nch;
+#if CONFIG_COMP_PEAK_VOL
+	int32_t tmp = INT_MIN_FOR_NUMBER_OF_BITS(32);
+#endif
+
+	vol_store_gain(cd, nch);
+	x = audio_stream_wrap(source, (char *)source->r_ptr + bsource->consumed);
+	y = audio_stream_wrap(sink, (char *)sink->w_ptr + bsink->size);
+
+	bsource->consumed += VOL_S32_SAMPLES_TO_BYTES(remaining_samples);
+	bsink->size += VOL_S32_SAMPLES_TO_BYTES(remaining_samples);
+	while (remaining_samples) {
+		nmax = VOL_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(source, x));
+		n = MIN(remaining_samples, nmax);
+		nmax = VOL_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(sink, y));
+		n = MIN(n, nmax);
+		ch = 0;
+		for (i = 0; i <= n - 4; i += 4) {
+			in = _mm_loadu_si128((__m128i *)(x + i));
+			in = _mm_srai_epi32(_mm_slli_epi32(in, 8), 8);
+			out = vol_mult_x86(in, _mm_loadu_si128((__m128i *)(cd->vol + ch)));
+			out = _mm_max_epi32(_mm_min_epi32(out, max), min);
+			_mm_storeu_si128((__m128i *)(y + i), out);
+			ch += 4;
+			while (ch >= nch)
+				ch -= nch;
+		}
+
+		for (; i < n; i++) {
+			y[i] = q_multsr_sat_32x32_24(sign_extend_s24(x[i]), cd->vol[ch],
+						     Q_SHIFT_BITS_64(23, VOL_QXY_Y, 23));
+			if (++ch == nch)
+				ch = 0;
+		}
+
+#if CONFIG_COMP_PEAK_VOL
+		tmp = vol_peak_update(cd, y, n, nch, tmp, false);
+#endif
+		remaining_samples -= n;
+		x = audio_stream_wrap(source, x + n);
+		y = audio_stream_wrap(sink, y + n);
+	}
+
+	/* update peak vol */
+	peak_vol_update(cd);
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+/**
+ * \brief Volume processing from 32 bit to 32 bit.
+ * \param[in,out] mod Volume processing module.
+ * \param[in,out] bsource Source buffer.
+ * \param[in,out] bsink Destination buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s32_to_s32(struct processing_module *mod, struct input_stream_buffer *bsource,
+			   struct output_stream_buffer *bsink, uint32_t frames)
+{
+	struct vol_data *cd = module_get_private_data(mod);
+	struct audio_stream __sparse_cache *source = bsource->data;
+	struct audio_stream __sparse_cache *sink = bsink->data;
+	__m128i out;
+	int32_t *x;
+	int32_t *y;
+	int nmax, n, i, ch;
+	const int nch = source->channels;
+	int remaining_samples = frames * nch;
+#if CONFIG_COMP_PEAK_VOL
+	int32_t tmp = INT_MIN_FOR_NUMBER_OF_BITS(32);
+#endif
+
+	vol_store_gain(cd, nch);
+	x = audio_stream_wrap(source, (char *)source->r_ptr + bsource->consumed);
+	y = audio_stream_wrap(sink, (char *)sink->w_ptr + bsink->size);
+
+	bsource->consumed += VOL_S32_SAMPLES_TO_BYTES(remaining_samples);
+	bsink->size += VOL_S32_SAMPLES_TO_BYTES(remaining_samples);
+	while (remaining_samples) {
+		nmax = VOL_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(source, x));
+		n = MIN(remaining_samples, nmax);
+		nmax = VOL_BYTES_TO_S32_SAMPLES(audio_stream_bytes_without_wrap(sink, y));
+		n = MIN(n, nmax);
+		ch = 0;
+		for (i = 0; i <= n - 4; i += 4) {
+			out = vol_mult_x86(_mm_loadu_si128((__m128i *)(x + i)),
+					   _mm_loadu_si128((__m128i *)(cd->vol + ch)));
+			_mm_storeu_si128((__m128i *)(y + i), out);
+			ch += 4;
+			while (ch >= nch)
+				ch -= nch;
+		}
+
+		for (; i < n; i++) {
+			y[i] = q_multsr_sat_32x32(x[i], cd->vol[ch],
+						  Q_SHIFT_BITS_64(31, VOL_QXY_Y, 31));
+			if (++ch == nch)
+				ch = 0;
+		}
+
+#if CONFIG_COMP_PEAK_VOL
+		tmp = vol_peak_update(cd, y, n, nch, tmp, false);
+#endif
+		remaining_samples -= n;
+		x = audio_stream_wrap(source, x + n);
+		y = audio_stream_wrap(sink, y + n);
+	}
+
+	/* update peak vol */
+	peak_vol_update(cd);
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+#if CONFIG_FORMAT_S16LE
+/**
+ * \brief Volume processing from 16 bit to 16 bit.
+ * \param[in,out] mod Volume processing module.
+ * \param[in,out] bsource Source buffer.
+ * \param[in,out] bsink Destination buffer.
+ * \param[in] frames Number of frames to process.
+ */
+static void vol_s16_to_s16(struct processing_module *mod, struct input_stream_buffer *bsource,
+			   struct output_stream_buffer *bsink, uint32_t frames)
+{
+	struct vol_data *cd = module_get_private_data(mod);
+	struct audio_stream __sparse_cache *source = bsource->data;
+	struct audio_stream __sparse_cache *sink = bsink->data;
+	__m128i in;
+	__m128i lo;
+	__m128i hi;
+	int16_t *x;
+	int16_t *y;
+	int nmax, n, i, ch;
+	const int nch = source->channels;
+	int remaining_samples = frames * nch;
+#if CONFIG_COMP_PEAK_VOL
+	int16_t tmp = INT_MIN_FOR_NUMBER_OF_BITS(16);
+#endif
+
+	vol_store_gain(cd, nch);
+	x = audio_stream_wrap(source, (char *)source->r_ptr + bsource->consumed);
+	y = audio_stream_wrap(sink, (char *)sink->w_ptr + bsink->size);
+
+	bsource->consumed += VOL_S16_SAMPLES_TO_BYTES(remaining_samples);
+	bsink->size += VOL_S16_SAMPLES_TO_BYTES(remaining_samples);
+	while (remaining_samples) {
+		nmax = VOL_BYTES_TO_S16_SAMPLES(audio_stream_bytes_without_wrap(source, x));
+		n = MIN(remaining_samples, nmax);
+		nmax = VOL_BYTES_TO_S16_SAMPLES(audio_stream_bytes_without_wrap(sink, y));
+		n = MIN(n, nmax);
+		ch = 0;
+		for (i = 0; i <= n - 8; i += 8) {
+			in = _mm_loadu_si128((__m128i *)(x + i));
+			lo = vol_mult_x86(_mm_cvtepi16_epi32(in),
+					  _mm_loadu_si128((__m128i *)(cd->vol + ch)));
+			ch += 4;
+			while (ch >= nch)
+				ch -= nch;
+
+			hi = vol_mult_x86(_mm_cvtepi16_epi32(_mm_srli_si128(in, 8)),
+					  _mm_loadu_si128((__m128i *)(cd->vol + ch)));
+			ch += 4;
+			while (ch >= nch)
+				ch -= nch;
+
+			/* Saturate to 16 bits with pack */
+			_mm_storeu_si128((__m128i *)(y + i), _mm_packs_epi32(lo, hi));
+		}
+
+		for (; i < n; i++) {
+			y[i] = q_multsr_sat_32x32_16(x[i], cd->vol[ch],
+						     Q_SHIFT_BITS_32(15, VOL_QXY_Y, 15));
+			if (++ch == nch)
+				ch = 0;
+		}
+
+#if CONFIG_COMP_PEAK_VOL
+		tmp = vol_peak_update(cd, y, n, nch, tmp, true);
+#endif
+		remaining_samples -= n;
+		x = audio_stream_wrap(source, x + n);
+		y = audio_stream_wrap(sink, y + n);
+	}
+
+	/* update peak vol */
+	peak_vol_update(cd);
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+const struct comp_func_map volume_func_map[] = {
+#if CONFIG_FORMAT_S16LE
+	{ SOF_IPC_FRAME_S16_LE, vol_s16_to_s16 },
+#endif /* CONFIG_FORMAT_S16LE */
+#if CONFIG_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S24_4LE, vol_s24_to_s24 },
+#endif /* CONFIG_FORMAT_S24LE */
+#if CONFIG_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S32_LE, vol_s32_to_s32 },
+#endif /* CONFIG_FORMAT_S32LE */
+};
+
+const size_t volume_func_count = ARRAY_SIZE(volume_func_map);
+
+#endif
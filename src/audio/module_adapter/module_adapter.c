@@ -240,6 +240,11 @@ int module_adapter_prepare(struct comp_dev *dev)
 		return -EINVAL;
 	}
 
+	if (mod->simple_copy && mod->stream_copy) {
+		comp_err(dev, "module_adapter_prepare(): simple_copy and stream_copy are exclusive");
+		return -EINVAL;
+	}
+
 	/* allocate memory for input buffers */
 	mod->input_buffers = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
 				     sizeof(*mod->input_buffers) * mod->num_input_buffers);
@@ -259,9 +264,10 @@ int module_adapter_prepare(struct comp_dev *dev)
 
 	/*
 	 * no need to allocate intermediate sink buffers if the module produces only period bytes
-	 * every period and has only 1 input and 1 output buffer
+	 * every period and has only 1 input and 1 output buffer, or if it works on the source and
+	 * sink buffers directly
 	 */
-	if (mod->simple_copy)
+	if (mod->simple_copy || mod->stream_copy)
 		return 0;
 
 	/* Module is prepared, now we need to configure processing settings.
@@ -693,6 +699,104 @@ module_single_source_setup(struct comp_dev *dev,
 	return num_output_buffers;
 }
 
+/*
+ * Copy path for stream_copy modules: the module reads the source buffers and writes the sink
+ * buffers in place, so no data is moved through the intermediate linear buffers nor through
+ * the local sink buffers. Like with simple_copy, sources and sinks that are not in the same
+ * state as the dev are left out.
+ */
+static int module_adapter_stream_copy(struct comp_dev *dev)
+{
+	struct processing_module *mod = comp_get_drvdata(dev);
+	struct comp_buffer __sparse_cache *source_c[PLATFORM_MAX_STREAMS];
+	struct comp_buffer __sparse_cache *sinks_c[PLATFORM_MAX_STREAMS];
+	struct list_item *blist;
+	uint32_t min_free_frames = UINT_MAX;
+	int num_sources = 0;
+	int num_sinks = 0;
+	int ret, i;
+
+	list_for_item(blist, &dev->bsink_list) {
+		struct comp_buffer *sink = container_of(blist, struct comp_buffer, source_list);
+		struct comp_buffer __sparse_cache *sink_c = buffer_acquire(sink);
+
+		if (!sink_c->sink || sink_c->sink->state != dev->state) {
+			buffer_release(sink_c);
+			continue;
+		}
+
+		min_free_frames = MIN(min_free_frames,
+				      audio_stream_get_free_frames(&sink_c->stream));
+
+		mod->output_buffers[num_sinks].size = 0;
+		mod->output_buffers[num_sinks].data = &sink_c->stream;
+		sinks_c[num_sinks++] = sink_c;
+	}
+
+	list_for_item(blist, &dev->bsource_list) {
+		struct comp_buffer *source = container_of(blist, struct comp_buffer, sink_list);
+		struct comp_buffer __sparse_cache *src_c = buffer_acquire(source);
+		uint32_t bytes_to_process;
+		uint32_t frames;
+
+		if (!src_c->source || src_c->source->state != dev->state) {
+			buffer_release(src_c);
+			continue;
+		}
+
+		frames = MIN(min_free_frames, audio_stream_get_avail_frames(&src_c->stream));
+		bytes_to_process = frames * audio_stream_frame_bytes(&src_c->stream);
+		buffer_stream_invalidate(src_c, bytes_to_process);
+
+		mod->input_buffers[num_sources].size = bytes_to_process;
+		mod->input_buffers[num_sources].consumed = 0;
+		mod->input_buffers[num_sources].data = &src_c->stream;
+		source_c[num_sources++] = src_c;
+	}
+
+	if (!num_sources || !num_sinks) {
+		ret = 0;
+		goto out;
+	}
+
+	ret = module_process(mod, mod->input_buffers, num_sources,
+			     mod->output_buffers, num_sinks);
+	if (ret == -ENOSPC || ret == -ENODATA) {
+		ret = 0;
+		goto out;
+	}
+
+	if (ret) {
+		comp_err(dev, "module_adapter_stream_copy() error %x: module processing failed",
+			 ret);
+		goto out;
+	}
+
+	for (i = 0; i < num_sources; i++)
+		comp_update_buffer_consume(source_c[i], mod->input_buffers[i].consumed);
+
+	for (i = 0; i < num_sinks; i++) {
+		buffer_stream_writeback(sinks_c[i], mod->output_buffers[i].size);
+		comp_update_buffer_produce(sinks_c[i], mod->output_buffers[i].size);
+	}
+
+out:
+	for (i = 0; i < num_sources; i++) {
+		buffer_release(source_c[i]);
+		mod->input_buffers[i].size = 0;
+		mod->input_buffers[i].consumed = 0;
+		mod->input_buffers[i].data = NULL;
+	}
+
+	for (i = 0; i < num_sinks; i++) {
+		buffer_release(sinks_c[i]);
+		mod->output_buffers[i].size = 0;
+		mod->output_buffers[i].data = NULL;
+	}
+
+	return ret;
+}
+
 int module_adapter_copy(struct comp_dev *dev)
 {
 	struct processing_module *mod = comp_get_drvdata(dev);
@@ -710,6 +814,9 @@ int module_adapter_copy(struct comp_dev *dev)
 
 	comp_dbg(dev, "module_adapter_copy(): start");
 
+	if (mod->stream_copy)
+		return module_adapter_stream_copy(dev);
+
 	/*
 	 * Simplify calculation of bytes_to_process for modules that produce period_bytes every
 	 * period and have a 1:1, 1:N or N:1 source:sink buffer configuration
@@ -1077,13 +1184,13 @@ int module_adapter_reset(struct comp_dev *dev)
 		return ret;
 	}
 
-	if (!mod->simple_copy)
+	if (!mod->simple_copy && !mod->stream_copy)
 		for (i = 0; i < mod->num_output_buffers; i++)
 			rfree((__sparse_force void *)mod->output_buffers[i].data);
 
 	rfree(mod->output_buffers);
 
-	if (!mod->simple_copy)
+	if (!mod->simple_copy && !mod->stream_copy)
 		for (i = 0; i < mod->num_input_buffers; i++)
 			rfree((__sparse_force void *)mod->input_buffers[i].data);
 
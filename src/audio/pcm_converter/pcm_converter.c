@@ -15,6 +15,13 @@
 #include <sof/audio/pcm_converter.h>
 #include <sof/debug/panic.h>
 
+#include <errno.h>
+
+/* Samples converted at once by pcm_convert_attenuated(), the block stays in
+ * cache until it is attenuated.
+ */
+#define PCM_CONVERT_BLOCK_SAMPLES	256
+
 int pcm_convert_as_linear(const struct audio_stream __sparse_cache *source, uint32_t ioffset,
 			  struct audio_stream __sparse_cache *sink, uint32_t ooffset,
 			  uint32_t samples, pcm_converter_lin_func converter)
@@ -58,3 +65,62 @@ int pcm_convert_as_linear(const struct audio_stream __sparse_cache *source, uint
 
 	return samples;
 }
+
+/* same format, the copy and the shift are a single loop */
+static int pcm_copy_attenuated(const struct audio_stream __sparse_cache *source, uint32_t ioffset,
+			       struct audio_stream __sparse_cache *sink, uint32_t ooffset,
+			       uint32_t samples, uint32_t shift)
+{
+	int32_t *r_ptr = audio_stream_wrap(source, (int32_t *)source->r_ptr + ioffset);
+	int32_t *w_ptr = audio_stream_wrap(sink, (int32_t *)sink->w_ptr + ooffset);
+	uint32_t left, n, i;
+
+	for (left = samples; left; left -= n) {
+		n = MIN(left, audio_stream_samples_without_wrap_s32(source, r_ptr));
+		n = MIN(n, audio_stream_samples_without_wrap_s32(sink, w_ptr));
+		for (i = 0; i < n; i++)
+			w_ptr[i] = r_ptr[i] >> shift;
+
+		r_ptr = audio_stream_wrap(source, r_ptr + n);
+		w_ptr = audio_stream_wrap(sink, w_ptr + n);
+	}
+
+	return samples;
+}
+
+int pcm_convert_attenuated(const struct audio_stream __sparse_cache *source, uint32_t ioffset,
+			   struct audio_stream __sparse_cache *sink, uint32_t ooffset,
+			   uint32_t samples, pcm_converter_func converter, uint32_t shift)
+{
+	int32_t *w_ptr;
+	uint32_t done, left, n, chunk;
+	int ret;
+
+	/* attenuation is only supported for 32 bit integer samples */
+	switch (sink->frame_fmt) {
+	case SOF_IPC_FRAME_S24_4LE:
+	case SOF_IPC_FRAME_S32_LE:
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if (converter == audio_stream_copy)
+		return pcm_copy_attenuated(source, ioffset, sink, ooffset, samples, shift);
+
+	for (done = 0; done < samples; done += n) {
+		n = MIN(samples - done, PCM_CONVERT_BLOCK_SAMPLES);
+		ret = converter(source, ioffset + done, sink, ooffset + done, n);
+		if (ret < 0)
+			return ret;
+
+		w_ptr = audio_stream_wrap(sink, (int32_t *)sink->w_ptr + ooffset + done);
+		for (left = n; left; left -= chunk) {
+			chunk = MIN(left, audio_stream_samples_without_wrap_s32(sink, w_ptr));
+			pcm_shift_s32_lin(w_ptr, chunk, shift);
+			w_ptr = audio_stream_wrap(sink, w_ptr + chunk);
+		}
+	}
+
+	return samples;
+}
@@ -29,6 +29,14 @@
 #define BYTES_TO_S16_SAMPLES	1
 #define BYTES_TO_S32_SAMPLES	2
 
+void pcm_shift_s32_lin(int32_t *data, uint32_t samples, uint32_t shift)
+{
+	int i;
+
+	for (i = 0; i < samples; i++)
+		data[i] >>= shift;
+}
+
 #if CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S24LE
 
 static int pcm_convert_s16_to_s24(const struct audio_stream __sparse_cache *source,
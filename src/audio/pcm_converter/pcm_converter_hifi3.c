@@ -28,6 +28,29 @@
 #include <xtensa/tie/xt_FP.h>
 #endif
 
+void pcm_shift_s32_lin(int32_t *data, uint32_t samples, uint32_t shift)
+{
+	ae_int32x2 *in = (ae_int32x2 *)data;
+	ae_int32x2 *out = (ae_int32x2 *)data;
+	ae_valign inu = AE_LA64_PP(in);
+	ae_valign outu = AE_ZALIGN64();
+	ae_int32x2 sample;
+	uint32_t i;
+
+	for (i = 0; i < samples >> 1; i++) {
+		AE_LA32X2_IP(sample, inu, in);
+		sample = AE_SRAA32(sample, shift);
+		AE_SA32X2_IP(sample, outu, out);
+	}
+	AE_SA64POS_FP(outu, out);
+
+	if (samples & 0x01) {
+		AE_L32_IP(sample, (ae_int32 *)in, sizeof(ae_int32));
+		sample = AE_SRAA32(sample, shift);
+		AE_S32_L_IP(sample, (ae_int32 *)out, sizeof(ae_int32));
+	}
+}
+
 #if CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S24LE
 
 /**
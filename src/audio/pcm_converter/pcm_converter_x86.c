@@ -0,0 +1,291 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+/**
+ * \file audio/pcm_converter/pcm_converter_x86.c
+ * \brief PCM converter x86 SSE4.2 processing implementation
+ */
+
+#include <sof/audio/pcm_converter.h>
+#include <sof/audio/audio_stream.h>
+
+#ifdef PCM_CONVERTER_X86
+
+#include <sof/audio/format.h>
+#include <sof/common.h>
+#include <sof/compiler_attributes.h>
+#include <ipc/stream.h>
+
+#include <immintrin.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* The host build compiles pcm_converter once, without the SIMD flags, so
+ * only these functions are built for SSE4.2 and
+ * pcm_get_conversion_function() picks them when the CPU has it.
+ */
+#define PCM_X86_TARGET	__attribute__((target("sse4.2")))
+
+/*
+ * Run a converter on the linear parts of the circular buffers, the same way
+ * as the generic conversions do.
+ */
+static int pcm_convert_x86(const struct audio_stream __sparse_cache *source,
+			   uint32_t ioffset, struct audio_stream __sparse_cache *sink,
+			   uint32_t ooffset, uint32_t samples, pcm_converter_lin_func converter)
+{
+	const int s_size_in = audio_stream_sample_bytes(source);
+	const int s_size_out = audio_stream_sample_bytes(sink);
+	char *src = (char *)source->r_ptr + ioffset * s_size_in;
+	char *dst = (char *)sink->w_ptr + ooffset * s_size_out;
+	int processed;
+	int nmax, n;
+
+	for (processed = 0; processed < samples; processed += n) {
+		src = audio_stream_wrap(source, src);
+		dst = audio_stream_wrap(sink, dst);
+		n = samples - processed;
+		nmax = audio_stream_bytes_without_wrap(source, src) / s_size_in;
+		n = MIN(n, nmax);
+		nmax = audio_stream_bytes_without_wrap(sink, dst) / s_size_out;
+		n = MIN(n, nmax);
+		converter(src, dst, n);
+		src += n * s_size_in;
+		dst += n * s_size_out;
+	}
+
+	return samples;
+}
+
+/*
+ * The x86 helpers convert the largest multiple of the vector length and
+ * return the number of converted samples, the caller converts the rest.
+ */
+
+/* Left shift of 16 bit samples into 32 bits */
+static inline PCM_X86_TARGET int pcm_s16_to_s32_x86(const int16_t *src, int32_t *dst,
+						    int n, int shift)
+{
+	__m128i x;
+	__m128i lo;
+	__m128i hi;
+	int i;
+
+	for (i = 0; i <= n - 8; i += 8) {
+		x = _mm_loadu_si128((const __m128i *)(src + i));
+		lo = _mm_slli_epi32(_mm_cvtepi16_epi32(x), shift);
+		hi = _mm_slli_epi32(_mm_cvtepi16_epi32(_mm_srli_si128(x, 8)), shift);
+		_mm_storeu_si128((__m128i *)(dst + i), lo);
+		_mm_storeu_si128((__m128i *)(dst + i + 4), hi);
+	}
+
+	return i;
+}
+
+/* Rounded right shift of 32 bit samples, optionally sign extended from 24
+ * bits first, saturated to 16 bits
+ */
+static inline PCM_X86_TARGET int pcm_s32_to_s16_x86(const int32_t *src, int16_t *dst,
+						    int n, int shift, bool s24)
+{
+	const __m128i one = _mm_set1_epi32(1);
+	__m128i lo;
+	__m128i hi;
+	int i;
+
+	for (i = 0; i <= n - 8; i += 8) {
+		lo = _mm_loadu_si128((const __m128i *)(src + i));
+		hi = _mm_loadu_si128((const __m128i *)(src + i + 4));
+		if (s24) {
+			lo = _mm_srai_epi32(_mm_slli_epi32(lo, 8), 8);
+			hi = _mm_srai_epi32(_mm_slli_epi32(hi, 8), 8);
+		}
+
+		lo = _mm_srai_epi32(_mm_add_epi32(_mm_srai_epi32(lo, shift - 1), one), 1);
+		hi = _mm_srai_epi32(_mm_add_epi32(_mm_srai_epi32(hi, shift - 1), one), 1);
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(lo, hi));
+	}
+
+	return i;
+}
+
+/* Left shift of 32 bit samples */
+static inline PCM_X86_TARGET int pcm_s32_shift_x86(const int32_t *src, int32_t *dst,
+						   int n, int shift)
+{
+	__m128i x;
+	int i;
+
+	for (i = 0; i <= n - 4; i += 4) {
+		x = _mm_loadu_si128((const __m128i *)(src + i));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_slli_epi32(x, shift));
+	}
+
+	return i;
+}
+
+/* Rounded right shift of 32 bit samples by 8, saturated to 24 bits */
+static inline PCM_X86_TARGET int pcm_s32_to_s24_x86(const int32_t *src, int32_t *dst,
+						    int n)
+{
+	const __m128i one = _mm_set1_epi32(1);
+	const __m128i max = _mm_set1_epi32(INT24_MAXVALUE);
+	const __m128i min = _mm_set1_epi32(INT24_MINVALUE);
+	__m128i x;
+	int i;
+
+	for (i = 0; i <= n - 4; i += 4) {
+		x = _mm_loadu_si128((const __m128i *)(src + i));
+		x = _mm_srai_epi32(_mm_add_epi32(_mm_srai_epi32(x, 7), one), 1);
+		x = _mm_max_epi32(_mm_min_epi32(x, max), min);
+		_mm_storeu_si128((__m128i *)(dst + i), x);
+	}
+
+	return i;
+}
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S24LE
+
+static PCM_X86_TARGET void pcm_convert_s16_to_s24_lin(const void *psrc, void *pdst,
+						      uint32_t samples)
+{
+	const int16_t *src = psrc;
+	int32_t *dst = pdst;
+	int i;
+
+	for (i = pcm_s16_to_s32_x86(src, dst, samples, 8); i < samples; i++)
+		dst[i] = src[i] << 8;
+}
+
+static PCM_X86_TARGET void pcm_convert_s24_to_s16_lin(const void *psrc, void *pdst,
+						      uint32_t samples)
+{
+	const int32_t *src = psrc;
+	int16_t *dst = pdst;
+	int i;
+
+	for (i = pcm_s32_to_s16_x86(src, dst, samples, 8, true); i < samples; i++)
+		dst[i] = sat_int16(Q_SHIFT_RND(sign_extend_s24(src[i]), 23, 15));
+}
+
+static int pcm_convert_s16_to_s24(const struct audio_stream __sparse_cache *source,
+				  uint32_t ioffset, struct audio_stream __sparse_cache *sink,
+				  uint32_t ooffset, uint32_t samples)
+{
+	return pcm_convert_x86(source, ioffset, sink, ooffset, samples,
+			       pcm_convert_s16_to_s24_lin);
+}
+
+static int pcm_convert_s24_to_s16(const struct audio_stream __sparse_cache *source,
+				  uint32_t ioffset, struct audio_stream __sparse_cache *sink,
+				  uint32_t ooffset, uint32_t samples)
+{
+	return pcm_convert_x86(source, ioffset, sink, ooffset, samples,
+			       pcm_convert_s24_to_s16_lin);
+}
+
+#endif /* CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S24LE */
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE
+
+static PCM_X86_TARGET void pcm_convert_s16_to_s32_lin(const void *psrc, void *pdst,
+						      uint32_t samples)
+{
+	const int16_t *src = psrc;
+	int32_t *dst = pdst;
+	int i;
+
+	for (i = pcm_s16_to_s32_x86(src, dst, samples, 16); i < samples; i++)
+		dst[i] = src[i] << 16;
+}
+
+static PCM_X86_TARGET void pcm_convert_s32_to_s16_lin(const void *psrc, void *pdst,
+						      uint32_t samples)
+{
+	const int32_t *src = psrc;
+	int16_t *dst = pdst;
+	int i;
+
+	for (i = pcm_s32_to_s16_x86(src, dst, samples, 16, false); i < samples; i++)
+		dst[i] = sat_int16(Q_SHIFT_RND(src[i], 31, 15));
+}
+
+static int pcm_convert_s16_to_s32(const struct audio_stream __sparse_cache *source,
+				  uint32_t ioffset, struct audio_stream __sparse_cache *sink,
+				  uint32_t ooffset, uint32_t samples)
+{
+	return pcm_convert_x86(source, ioffset, sink, ooffset, samples,
+			       pcm_convert_s16_to_s32_lin);
+}
+
+static int pcm_convert_s32_to_s16(const struct audio_stream __sparse_cache *source,
+				  uint32_t ioffset, struct audio_stream __sparse_cache *sink,
+				  uint32_t ooffset, uint32_t samples)
+{
+	return pcm_convert_x86(source, ioffset, sink, ooffset, samples,
+			       pcm_convert_s32_to_s16_lin);
+}
+
+#endif /* CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE */
+
+#if CONFIG_PCM_CONVERTER_FORMAT_S24LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE
+
+static PCM_X86_TARGET void pcm_convert_s24_to_s32_lin(const void *psrc, void *pdst,
+						      uint32_t samples)
+{
+	const int32_t *src = psrc;
+	int32_t *dst = pdst;
+	int i;
+
+	for (i = pcm_s32_shift_x86(src, dst, samples, 8); i < samples; i++)
+		dst[i] = src[i] << 8;
+}
+
+static PCM_X86_TARGET void pcm_convert_s32_to_s24_lin(const void *psrc, void *pdst,
+						      uint32_t samples)
+{
+	const int32_t *src = psrc;
+	int32_t *dst = pdst;
+	int i;
+
+	for (i = pcm_s32_to_s24_x86(src, dst, samples); i < samples; i++)
+		dst[i] = sat_int24(Q_SHIFT_RND(src[i], 31, 23));
+}
+
+static int pcm_convert_s24_to_s32(const struct audio_stream __sparse_cache *source,
+				  uint32_t ioffset, struct audio_stream __sparse_cache *sink,
+				  uint32_t ooffset, uint32_t samples)
+{
+	return pcm_convert_x86(source, ioffset, sink, ooffset, samples,
+			       pcm_convert_s24_to_s32_lin);
+}
+
+static int pcm_convert_s32_to_s24(const struct audio_stream __sparse_cache *source,
+				  uint32_t ioffset, struct audio_stream __sparse_cache *sink,
+				  uint32_t ooffset, uint32_t samples)
+{
+	return pcm_convert_x86(source, ioffset, sink, ooffset, samples,
+			       pcm_convert_s32_to_s24_lin);
+}
+
+#endif /* CONFIG_PCM_CONVERTER_FORMAT_S24LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE */
+
+const struct pcm_func_map pcm_func_map_x86[] = {
+#if CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S24LE
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S24_4LE, pcm_convert_s16_to_s24 },
+	{ SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S16_LE, pcm_convert_s24_to_s16 },
+#endif /* CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S24LE */
+#if CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S32_LE, pcm_convert_s16_to_s32 },
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S16_LE, pcm_convert_s32_to_s16 },
+#endif /* CONFIG_PCM_CONVERTER_FORMAT_S16LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE */
+#if CONFIG_PCM_CONVERTER_FORMAT_S24LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE
+	{ SOF_IPC_FRAME_S24_4LE, SOF_IPC_FRAME_S32_LE, pcm_convert_s24_to_s32 },
+	{ SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S24_4LE, pcm_convert_s32_to_s24 },
+#endif /* CONFIG_PCM_CONVERTER_FORMAT_S24LE && CONFIG_PCM_CONVERTER_FORMAT_S32LE */
+};
+
+const size_t pcm_func_count_x86 = ARRAY_SIZE(pcm_func_map_x86);
+
+#endif /* PCM_CONVERTER_X86 */
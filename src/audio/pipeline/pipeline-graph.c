@@ -182,6 +182,18 @@ static void buffer_set_comp(struct comp_buffer *buffer, struct comp_dev *comp,
 		dcache_writeback_invalidate_region(uncache_to_cache(buffer), sizeof(*buffer));
 }
 
+/* A buffer between two components of a pipeline changes the copy walk of it,
+ * drop the copy schedule until the pipeline is prepared again.
+ */
+static void pipeline_copy_sched_check(struct comp_dev *comp, struct comp_buffer *buffer,
+				      int dir)
+{
+	struct comp_dev *other = buffer_get_comp(buffer, dir);
+
+	if (comp->pipeline && other && comp_is_single_pipeline(comp, other))
+		pipeline_copy_sched_free(comp->pipeline);
+}
+
 int pipeline_connect(struct comp_dev *comp, struct comp_buffer *buffer,
 		     int dir)
 {
@@ -201,6 +213,8 @@ int pipeline_connect(struct comp_dev *comp, struct comp_buffer *buffer,
 
 	irq_local_enable(flags);
 
+	pipeline_copy_sched_check(comp, buffer, dir);
+
 	return 0;
 }
 
@@ -214,6 +228,8 @@ void pipeline_disconnect(struct comp_dev *comp, struct comp_buffer *buffer, int
 	else
 		comp_dbg(comp, "disconnect buffer %d as source", buffer->id);
 
+	pipeline_copy_sched_check(comp, buffer, dir);
+
 	irq_local_disable(flags);
 
 	comp_list = comp_buffer_list(comp, dir);
@@ -241,6 +257,8 @@ int pipeline_free(struct pipeline *p)
 
 	ipc_msg_free(p->msg);
 
+	pipeline_copy_sched_free(p);
+
 	pipeline_posn_offset_put(p->posn_offset);
 
 	/* now free the pipeline */
@@ -325,6 +325,16 @@ static int pipeline_comp_prepare(struct comp_dev *current,
 	if (err < 0 || err == PPL_STATUS_PATH_STOP)
 		return err;
 
+	/* Build the flat copy schedule once per graph, without it the
+	 * pipeline is copied with the recursive walk.
+	 */
+	if (!current->pipeline->copy_sched) {
+		err = pipeline_copy_sched_build(current->pipeline);
+		if (err < 0)
+			pipe_warn(current->pipeline,
+				  "pipeline_comp_prepare(): no copy schedule, err = %d", err);
+	}
+
 	return pipeline_for_each_comp(current, ctx, dir);
 }
 
@@ -9,6 +9,8 @@
 #include <sof/audio/component_ext.h>
 #include <sof/audio/pipeline.h>
 #include <sof/lib/dai.h>
+#include <rtos/alloc.h>
+#include <rtos/interrupt.h>
 #include <rtos/wait.h>
 #include <sof/list.h>
 #include <rtos/spinlock.h>
@@ -109,6 +111,201 @@ static int pipeline_comp_copy(struct comp_dev *current,
 	return err;
 }
 
+/* max. depth of buffers from the copy start component */
+#define PPL_COPY_SCHED_DEPTH	32
+
+/* walk data for recording the flat copy schedule */
+struct pipeline_copy_sched_data {
+	struct comp_dev *start;
+	struct pipeline_copy_sched *sched;	/* NULL when only counting */
+	uint32_t count;
+	struct comp_buffer *path[PPL_COPY_SCHED_DEPTH];
+};
+
+/* Record the components in the order pipeline_comp_copy() visits them. This
+ * follows pipeline_for_each_comp() but tracks the walked buffers in the path
+ * instead of the buffer walking flag, so it can run while another walk is in
+ * progress, e.g. from pipeline_comp_prepare().
+ */
+static int pipeline_copy_sched_add(struct pipeline_copy_sched_data *sched_data,
+				   struct comp_dev *current, int dir, int depth)
+{
+	struct pipeline_copy_sched *sched = sched_data->sched;
+	struct list_item *buffer_list = comp_buffer_list(current, dir);
+	struct list_item *clist;
+	struct comp_buffer *buffer;
+	struct comp_dev *buffer_comp;
+	uint32_t index = sched_data->count;
+	int err;
+	int i;
+
+	if (!comp_is_single_pipeline(current, sched_data->start))
+		return 0;
+
+	sched_data->count++;
+	if (sched)
+		sched->entry[index].comp = current;
+
+	list_for_item(clist, buffer_list) {
+		buffer = buffer_from_list(clist, struct comp_buffer, dir);
+
+		/* don't go back to the buffer which already walked */
+		for (i = 0; i < depth; i++)
+			if (sched_data->path[i] == buffer)
+				break;
+		if (i < depth)
+			continue;
+
+		buffer_comp = buffer_get_comp(buffer, dir);
+		if (!buffer_comp || !buffer_comp->pipeline)
+			continue;
+
+		if (depth == PPL_COPY_SCHED_DEPTH)
+			return -EINVAL;
+
+		sched_data->path[depth] = buffer;
+		err = pipeline_copy_sched_add(sched_data, buffer_comp, dir, depth + 1);
+		if (err < 0)
+			return err;
+	}
+
+	if (sched)
+		sched->entry[index].next = sched_data->count;
+
+	return 0;
+}
+
+static int pipeline_copy_sched_walk(struct pipeline_copy_sched *sched,
+				    struct comp_dev *start, int dir)
+{
+	struct pipeline_copy_sched_data sched_data = {
+		.start = start,
+		.sched = sched,
+	};
+	int ret;
+
+	ret = pipeline_copy_sched_add(&sched_data, start, dir, 0);
+
+	return ret < 0 ? ret : sched_data.count;
+}
+
+void pipeline_copy_sched_free(struct pipeline *p)
+{
+	struct pipeline_copy_sched *sched = p->copy_sched;
+	uint32_t flags;
+
+	if (!sched)
+		return;
+
+	irq_local_disable(flags);
+	p->copy_sched = NULL;
+	irq_local_enable(flags);
+
+	rfree(sched);
+}
+
+int pipeline_copy_sched_build(struct pipeline *p)
+{
+	struct pipeline_copy_sched *sched;
+	struct comp_dev *start;
+	uint32_t flags;
+	int count;
+	int dir;
+	int ret;
+
+	if (!p->source_comp || !p->sink_comp)
+		return -EINVAL;
+
+	if (p->source_comp->direction == SOF_IPC_STREAM_PLAYBACK) {
+		dir = PPL_DIR_UPSTREAM;
+		start = p->sink_comp;
+	} else {
+		dir = PPL_DIR_DOWNSTREAM;
+		start = p->source_comp;
+	}
+
+	pipeline_copy_sched_free(p);
+
+	/* count first, then walk again to fill the entries */
+	count = pipeline_copy_sched_walk(NULL, start, dir);
+	if (count < 0)
+		return count;
+
+	sched = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			sizeof(*sched) + count * (sizeof(sched->entry[0]) + sizeof(uint32_t)));
+	if (!sched) {
+		pipe_err(p, "pipeline_copy_sched_build(): out of memory, %d comps", count);
+		return -ENOMEM;
+	}
+
+	sched->start = start;
+	sched->dir = dir;
+	sched->count = count;
+	sched->stack = (uint32_t *)&sched->entry[count];
+
+	ret = pipeline_copy_sched_walk(sched, start, dir);
+	if (ret != count) {
+		pipe_err(p, "pipeline_copy_sched_build(): walk changed, %d != %d", ret, count);
+		rfree(sched);
+		return ret < 0 ? ret : -EINVAL;
+	}
+
+	irq_local_disable(flags);
+	p->copy_sched = sched;
+	irq_local_enable(flags);
+
+	pipe_dbg(p, "pipeline_copy_sched_build(), %d comps", count);
+
+	return 0;
+}
+
+/* Copy components in the recorded walk order. A component that is not active
+ * skips the components walked from it, and with upstream direction a
+ * component is copied after the components walked from it, like in
+ * pipeline_comp_copy().
+ */
+static int pipeline_copy_sched_run(struct pipeline_copy_sched *sched)
+{
+	struct pipeline_copy_entry *entry = sched->entry;
+	uint32_t *stack = sched->stack;
+	uint32_t sp = 0;
+	uint32_t i = 0;
+	int err;
+
+	while (i < sched->count) {
+		/* upstream, copy the components whose walk is done */
+		while (sp && entry[stack[sp - 1]].next <= i) {
+			err = comp_copy(entry[stack[--sp]].comp);
+			if (err < 0 || err == PPL_STATUS_PATH_STOP)
+				return err;
+		}
+
+		if (!comp_is_active(entry[i].comp)) {
+			i = entry[i].next;
+			continue;
+		}
+
+		if (sched->dir == PPL_DIR_DOWNSTREAM) {
+			err = comp_copy(entry[i].comp);
+			if (err < 0 || err == PPL_STATUS_PATH_STOP)
+				return err;
+		} else {
+			stack[sp++] = i;
+		}
+
+		i++;
+	}
+
+	err = 0;
+	while (sp) {
+		err = comp_copy(entry[stack[--sp]].comp);
+		if (err < 0 || err == PPL_STATUS_PATH_STOP)
+			return err;
+	}
+
+	return err;
+}
+
 /* Copy data across all pipeline components.
  * For capture pipelines it always starts from source component
  * and continues downstream and for playback pipelines it first
@@ -122,6 +319,7 @@ int pipeline_copy(struct pipeline *p)
 		.comp_data = &data,
 		.skip_incomplete = true,
 	};
+	struct pipeline_copy_sched *sched = p->copy_sched;
 	struct comp_dev *start;
 	uint32_t dir;
 	int ret;
@@ -134,10 +332,15 @@ int pipeline_copy(struct pipeline *p)
 		start = p->source_comp;
 	}
 
-	data.start = start;
-	data.p = p;
+	/* use the flat schedule when the graph has not changed since prepare */
+	if (sched && sched->start == start && sched->dir == dir) {
+		ret = pipeline_copy_sched_run(sched);
+	} else {
+		data.start = start;
+		data.p = p;
 
-	ret = walk_ctx.comp_func(start, NULL, &walk_ctx, dir);
+		ret = walk_ctx.comp_func(start, NULL, &walk_ctx, dir);
+	}
 	if (ret < 0)
 		pipe_err(p, "pipeline_copy(): ret = %d, start->comp.id = %u, dir = %u",
 			 ret, dev_comp_id(start), dir);
@@ -9,6 +9,7 @@
 #include <sof/common.h>
 #include <sof/audio/buffer.h>
 #include <sof/audio/component.h>
+#include <sof/audio/data_blob.h>
 #include <sof/audio/pipeline.h>
 #include <sof/audio/audio_stream.h>
 #include <sof/audio/ipc-config.h>
@@ -30,12 +31,17 @@
 #include <ipc/stream.h>
 #include <ipc/topology.h>
 #include <ipc4/base-config.h>
+#include <user/src.h>
 #include <user/trace.h>
 #include <errno.h>
 #include <stddef.h>
 #include <stdint.h>
 
-#if SRC_SHORT || CONFIG_COMP_SRC_TINY
+#if CONFIG_COMP_SRC_COEF_BLOB
+/* No built-in conversions, all coefficients come from the blob */
+#define MAX_FIR_DELAY_SIZE 0
+#define MAX_OUT_DELAY_SIZE 0
+#elif SRC_SHORT || CONFIG_COMP_SRC_TINY
 #include <sof/audio/coefficients/src/src_tiny_int16_define.h>
 #include <sof/audio/coefficients/src/src_tiny_int16_table.h>
 #elif CONFIG_COMP_SRC_SMALL
@@ -51,9 +57,30 @@
 #error "No valid configuration selected for SRC"
 #endif
 
+/* The delay lines limits for the coefficients from the blob allow the
+ * longest filters of the built-in coefficient sets.
+ */
+#define SRC_BLOB_MAX_FIR_DELAY_SIZE 730
+#define SRC_BLOB_MAX_OUT_DELAY_SIZE 900
+
 /* The FIR maximum lengths are per channel so need to multiply them */
-#define MAX_FIR_DELAY_SIZE_XNCH (PLATFORM_MAX_CHANNELS * MAX_FIR_DELAY_SIZE)
-#define MAX_OUT_DELAY_SIZE_XNCH (PLATFORM_MAX_CHANNELS * MAX_OUT_DELAY_SIZE)
+#define MAX_FIR_DELAY_SIZE_XNCH \
+	(PLATFORM_MAX_CHANNELS * MAX(MAX_FIR_DELAY_SIZE, SRC_BLOB_MAX_FIR_DELAY_SIZE))
+#define MAX_OUT_DELAY_SIZE_XNCH \
+	(PLATFORM_MAX_CHANNELS * MAX(MAX_OUT_DELAY_SIZE, SRC_BLOB_MAX_OUT_DELAY_SIZE))
+
+#if SRC_SHORT
+#define SRC_COEF_BITS	16
+static int16_t src_passthrough_coef = 16384;
+#else
+#define SRC_COEF_BITS	32
+static int32_t src_passthrough_coef = 1073741824;
+#endif
+
+/* Second stage of one stage conversions and both stages of equal rates */
+static struct src_stage src_passthrough_stage = {
+	0, 0, 1, 1, 1, 1, 1, 0, -1, &src_passthrough_coef
+};
 
 LOG_MODULE_REGISTER(src, CONFIG_SOF_LOG_LEVEL);
 
@@ -87,6 +114,9 @@ struct comp_data {
 #endif /* CONFIG_IPC_MAJOR_4 */
 	struct polyphase_src src;
 	struct src_param param;
+	struct comp_data_blob_handler *model_handler;
+	struct src_stage blob_stages[SOF_SRC_MAX_STAGES];
+	void *blob_coefs;	/* copy of the blob coefficients in use */
 	int32_t *delay_lines;
 	uint32_t sink_rate;
 	uint32_t source_rate;
@@ -119,6 +149,180 @@ static int src_out_delay_length(struct src_stage *s)
 	return 1 + (s->num_of_subfilters - 1) * s->odm;
 }
 
+/* Checks a stage of the blob, returns the stage size in bytes */
+static int src_blob_stage_check(struct comp_dev *dev, const struct sof_src_stage *s,
+				size_t max_size)
+{
+	size_t max_length;
+
+	if (max_size < sizeof(*s) || s->size > max_size || s->size < sizeof(*s) ||
+	    (s->size & 0x3)) {
+		comp_err(dev, "src_blob_stage_check(): invalid stage size");
+		return -EINVAL;
+	}
+
+	/* The filter cores need subfilters with a multiple of 4 taps
+	 * and the optimized ones load the coefficients in pairs.
+	 */
+	max_length = (s->size - sizeof(*s)) / sizeof(src_passthrough_coef);
+	if (s->num_of_subfilters < 1 || s->num_of_subfilters > max_length ||
+	    s->subfilter_length < 4 || s->subfilter_length > max_length ||
+	    (s->subfilter_length & 0x3) ||
+	    (int64_t)s->num_of_subfilters * s->subfilter_length != s->filter_length ||
+	    s->filter_length > max_length ||
+	    s->idm < 0 || s->odm < 0 || s->blk_in < 1 || s->blk_out < 1 ||
+	    s->shift < 0 || s->shift > 31 ||
+	    !IS_ALIGNED((uintptr_t)s->data, sizeof(int64_t))) {
+		comp_err(dev, "src_blob_stage_check(): invalid stage, filter_length %d, blk_in %d, blk_out %d",
+			 s->filter_length, s->blk_in, s->blk_out);
+		return -EINVAL;
+	}
+
+	return s->size;
+}
+
+static void src_blob_stage_init(struct src_stage *stage, const struct sof_src_stage *s,
+				const void *coefs)
+{
+	const struct src_stage init = {
+		s->idm, s->odm, s->num_of_subfilters, s->subfilter_length,
+		s->filter_length, s->blk_in, s->blk_out, s->halfband, s->shift,
+		coefs
+	};
+
+	/* struct src_stage members are const */
+	memcpy_s(stage, sizeof(*stage), &init, sizeof(init));
+}
+
+/* Sets up the stages of a conversion from the blob. The coefficients are
+ * copied because the blob handler frees the blob when a new one arrives
+ * while the stages are still in use.
+ */
+static int src_blob_conversion(struct comp_dev *dev, struct comp_data *cd,
+			       const struct sof_src_conversion *conv)
+{
+	const struct sof_src_stage *stages[SOF_SRC_MAX_STAGES];
+	const uint8_t *p = (const uint8_t *)conv->data;
+	size_t size = conv->size - sizeof(*conv);
+	size_t coefs_size = 0;
+	size_t stage_coefs_size;
+	uint8_t *coefs;
+	int ret;
+	int i;
+
+	if (conv->num_stages < 1 || conv->num_stages > SOF_SRC_MAX_STAGES) {
+		comp_err(dev, "src_blob_conversion(): invalid num_stages %u",
+			 conv->num_stages);
+		return -EINVAL;
+	}
+
+	for (i = 0; i < conv->num_stages; i++) {
+		stages[i] = (const struct sof_src_stage *)p;
+		ret = src_blob_stage_check(dev, stages[i], size);
+		if (ret < 0)
+			return ret;
+
+		coefs_size += stages[i]->filter_length * sizeof(src_passthrough_coef);
+		p += ret;
+		size -= ret;
+	}
+
+	/* The subfilter lengths are multiples of 4 so every stage stays 64 bit aligned */
+	rfree(cd->blob_coefs);
+	cd->blob_coefs = rballoc_align(0, SOF_MEM_CAPS_RAM, coefs_size, sizeof(int64_t));
+	if (!cd->blob_coefs) {
+		comp_err(dev, "src_blob_conversion(): failed to alloc %u bytes for coefficients",
+			 coefs_size);
+		return -ENOMEM;
+	}
+
+	coefs = cd->blob_coefs;
+	for (i = 0; i < conv->num_stages; i++) {
+		stage_coefs_size = stages[i]->filter_length * sizeof(src_passthrough_coef);
+		memcpy_s(coefs, stage_coefs_size, stages[i]->data, stage_coefs_size);
+		src_blob_stage_init(&cd->blob_stages[i], stages[i], coefs);
+		coefs += stage_coefs_size;
+	}
+
+	cd->param.stage1 = &cd->blob_stages[0];
+	if (conv->num_stages == 1)
+		cd->param.stage2 = &src_passthrough_stage;
+	else
+		cd->param.stage2 = &cd->blob_stages[1];
+
+	return 0;
+}
+
+/* Finds the conversion for the rates from the coefficients blob, returns
+ * -ENOENT if there is no blob or the blob has no such conversion.
+ */
+static int src_blob_find_stages(struct comp_dev *dev, struct comp_data *cd,
+				int fs_in, int fs_out)
+{
+	const struct sof_src_config *config;
+	const struct sof_src_conversion *conv;
+	const uint8_t *p;
+	size_t size;
+	int i;
+
+	if (!comp_is_current_data_blob_valid(cd->model_handler) &&
+	    !comp_is_new_data_blob_available(cd->model_handler))
+		return -ENOENT;
+
+	config = comp_get_data_blob(cd->model_handler, &size, NULL);
+	if (!config || size < sizeof(*config) || config->size > size ||
+	    config->size < sizeof(*config)) {
+		comp_err(dev, "src_blob_find_stages(): invalid blob size %u", size);
+		return -EINVAL;
+	}
+
+	if (config->coef_bits != SRC_COEF_BITS) {
+		comp_err(dev, "src_blob_find_stages(): %u bits coefficients, need %u",
+			 config->coef_bits, SRC_COEF_BITS);
+		return -EINVAL;
+	}
+
+	p = (const uint8_t *)config->data;
+	size = config->size - sizeof(*config);
+	for (i = 0; i < config->num_conversions; i++) {
+		conv = (const struct sof_src_conversion *)p;
+		if (size < sizeof(*conv) || conv->size > size ||
+		    conv->size < sizeof(*conv) || (conv->size & 0x3)) {
+			comp_err(dev, "src_blob_find_stages(): invalid conversion %d size", i);
+			return -EINVAL;
+		}
+
+		if (conv->source_rate == fs_in && conv->sink_rate == fs_out)
+			return src_blob_conversion(dev, cd, conv);
+
+		p += conv->size;
+		size -= conv->size;
+	}
+
+	return -ENOENT;
+}
+
+#if CONFIG_COMP_SRC_COEF_BLOB
+static int src_find_stages(struct comp_dev *dev, struct comp_data *cd,
+			   int fs_in, int fs_out)
+{
+	int ret;
+
+	ret = src_blob_find_stages(dev, cd, fs_in, fs_out);
+	if (ret != -ENOENT)
+		return ret;
+
+	if (fs_in != fs_out) {
+		comp_err(dev, "src_find_stages(): no coefficients for fs_in: %u, fs_out: %u",
+			 fs_in, fs_out);
+		return -EINVAL;
+	}
+
+	cd->param.stage1 = &src_passthrough_stage;
+	cd->param.stage2 = &src_passthrough_stage;
+	return 0;
+}
+#else
 /* Returns index of a matching sample rate */
 static int src_find_fs(int fs_list[], int list_length, int fs)
 {
@@ -131,6 +335,43 @@ static int src_find_fs(int fs_list[], int list_length, int fs)
 	return -EINVAL;
 }
 
+/* The conversions in the blob override the built-in ones */
+static int src_find_stages(struct comp_dev *dev, struct comp_data *cd,
+			   int fs_in, int fs_out)
+{
+	struct src_param *a = &cd->param;
+	int idx_in;
+	int idx_out;
+	int ret;
+
+	ret = src_blob_find_stages(dev, cd, fs_in, fs_out);
+	if (ret != -ENOENT)
+		return ret;
+
+	idx_in = src_find_fs(src_in_fs, NUM_IN_FS, fs_in);
+	idx_out = src_find_fs(src_out_fs, NUM_OUT_FS, fs_out);
+
+	/* Check that both in and out rates are supported */
+	if (idx_in < 0 || idx_out < 0) {
+		comp_err(dev, "src_find_stages(): rates not supported, fs_in: %u, fs_out: %u",
+			 fs_in, fs_out);
+		return -EINVAL;
+	}
+
+	a->stage1 = src_table1[idx_out][idx_in];
+	a->stage2 = src_table2[idx_out][idx_in];
+
+	/* Check from stage1 parameter for a deleted in/out rate combination.*/
+	if (a->stage1->filter_length < 1) {
+		comp_err(dev, "src_find_stages(): Non-supported combination sfs_in = %d, fs_out = %d",
+			 fs_in, fs_out);
+		return -EINVAL;
+	}
+
+	return 0;
+}
+#endif /* CONFIG_COMP_SRC_COEF_BLOB */
+
 /* Calculates buffers to allocate for a SRC mode */
 static int src_buffer_lengths(struct comp_dev *dev, struct comp_data *cd,
 			      int nch)
@@ -141,6 +382,7 @@ static int src_buffer_lengths(struct comp_dev *dev, struct comp_data *cd,
 	int fs_in, fs_out;
 	int source_frames;
 	int r1;
+	int ret;
 
 	a = &cd->param;
 	fs_in = cd->source_rate;
@@ -155,25 +397,12 @@ static int src_buffer_lengths(struct comp_dev *dev, struct comp_data *cd,
 	}
 
 	a->nch = nch;
-	a->idx_in = src_find_fs(src_in_fs, NUM_IN_FS, fs_in);
-	a->idx_out = src_find_fs(src_out_fs, NUM_OUT_FS, fs_out);
-
-	/* Check that both in and out rates are supported */
-	if (a->idx_in < 0 || a->idx_out < 0) {
-		comp_err(dev, "src_buffer_lengths(): rates not supported, fs_in: %u, fs_out: %u",
-			 fs_in, fs_out);
-		return -EINVAL;
-	}
+	ret = src_find_stages(dev, cd, fs_in, fs_out);
+	if (ret < 0)
+		return ret;
 
-	stage1 = src_table1[a->idx_out][a->idx_in];
-	stage2 = src_table2[a->idx_out][a->idx_in];
-
-	/* Check from stage1 parameter for a deleted in/out rate combination.*/
-	if (stage1->filter_length < 1) {
-		comp_err(dev, "src_buffer_lengths(): Non-supported combination sfs_in = %d, fs_out = %d",
-			 fs_in, fs_out);
-		return -EINVAL;
-	}
+	stage1 = a->stage1;
+	stage2 = a->stage2;
 
 	a->fir_s1 = nch * src_fir_delay_length(stage1);
 	a->out_s1 = nch * src_out_delay_length(stage1);
@@ -299,18 +528,14 @@ void src_polyphase_reset(struct polyphase_src *src)
 int src_polyphase_init(struct polyphase_src *src, struct src_param *p,
 		       int32_t *delay_lines_start)
 {
-	struct src_stage *stage1;
-	struct src_stage *stage2;
 	int n_stages;
 	int ret;
 
-	if (p->idx_in < 0 || p->idx_out < 0)
+	if (!p->stage1 || !p->stage2)
 		return -EINVAL;
 
 	/* Get setup for 2 stage conversion */
-	stage1 = src_table1[p->idx_out][p->idx_in];
-	stage2 = src_table2[p->idx_out][p->idx_in];
-	ret = init_stages(stage1, stage2, src, p, 2, delay_lines_start);
+	ret = init_stages(p->stage1, p->stage2, src, p, 2, delay_lines_start);
 	if (ret < 0)
 		return -EINVAL;
 
@@ -321,7 +546,7 @@ int src_polyphase_init(struct polyphase_src *src, struct src_param *p,
 	 * tap.
 	 */
 	n_stages = (src->stage2->filter_length == 1) ? 1 : 2;
-	if (src_in_fs[p->idx_in] == src_out_fs[p->idx_out])
+	if (src->stage1->filter_length == 1 && src->stage2->filter_length == 1)
 		n_stages = 0;
 
 	/* If filter length for first stage is zero this is a deleted
@@ -925,6 +1150,14 @@ static int src_init(struct processing_module *mod)
 
 	memcpy_s(&cd->ipc_config, sizeof(cd->ipc_config), cfg->init_data, sizeof(cd->ipc_config));
 
+	/* Handler for the coefficients blob */
+	cd->model_handler = comp_data_blob_handler_new(dev);
+	if (!cd->model_handler) {
+		comp_err(dev, "src_init(): comp_data_blob_handler_new() failed.");
+		rfree(cd);
+		return -ENOMEM;
+	}
+
 	cd->delay_lines = NULL;
 	cd->src_func = src_fallback;
 	cd->polyphase_func = NULL;
@@ -999,13 +1232,23 @@ static int src_set_config(struct processing_module *mod, uint32_t config_id,
 			  const uint8_t *fragment, size_t fragment_size, uint8_t *response,
 			  size_t response_size)
 {
-	return -EINVAL;
+	struct comp_data *cd = module_get_private_data(mod);
+
+	comp_info(mod->dev, "src_set_config()");
+
+	return comp_data_blob_set(cd->model_handler, pos, data_offset_size,
+				  fragment, fragment_size);
 }
 
 static int src_get_config(struct processing_module *mod, uint32_t config_id,
 			  uint32_t *data_offset_size, uint8_t *fragment, size_t fragment_size)
 {
-	return -EINVAL;
+	struct sof_ipc_ctrl_data *cdata = (struct sof_ipc_ctrl_data *)fragment;
+	struct comp_data *cd = module_get_private_data(mod);
+
+	comp_info(mod->dev, "src_get_config()");
+
+	return comp_data_blob_get_cmd(cd->model_handler, cdata, fragment_size);
 }
 
 static int src_reset(struct processing_module *mod)
@@ -1028,6 +1271,8 @@ static int src_free(struct processing_module *mod)
 
 	/* Free dynamically reserved buffers for SRC algorithm */
 	rfree(cd->delay_lines);
+	rfree(cd->blob_coefs);
+	comp_data_blob_handler_free(cd->model_handler);
 
 	rfree(cd);
 	return 0;
@@ -1075,6 +1320,15 @@ static struct comp_dev *src_new(const struct comp_driver *drv,
 	comp_set_drvdata(dev, cd);
 	memcpy_s(&cd->ipc_config, sizeof(cd->ipc_config), spec, sizeof(cd->ipc_config));
 
+	/* Handler for the coefficients blob */
+	cd->model_handler = comp_data_blob_handler_new(dev);
+	if (!cd->model_handler) {
+		comp_err(dev, "src_new(): comp_data_blob_handler_new() failed.");
+		rfree(cd);
+		rfree(dev);
+		return NULL;
+	}
+
 	cd->delay_lines = NULL;
 	cd->src_func = src_fallback;
 	cd->polyphase_func = NULL;
@@ -1092,6 +1346,8 @@ static void src_free(struct comp_dev *dev)
 
 	/* Free dynamically reserved buffers for SRC algorithm */
 	rfree(cd->delay_lines);
+	rfree(cd->blob_coefs);
+	comp_data_blob_handler_free(cd->model_handler);
 
 	rfree(cd);
 	rfree(dev);
@@ -1112,6 +1368,35 @@ static int src_ctrl_cmd(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata)
 	return -EINVAL;
 }
 
+static int src_cmd_set_data(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+
+	switch (cdata->cmd) {
+	case SOF_CTRL_CMD_BINARY:
+		comp_info(dev, "src_cmd_set_data(), SOF_CTRL_CMD_BINARY");
+		return comp_data_blob_set_cmd(cd->model_handler, cdata);
+	default:
+		comp_err(dev, "src_cmd_set_data(), invalid command %d", cdata->cmd);
+		return -EINVAL;
+	}
+}
+
+static int src_cmd_get_data(struct comp_dev *dev, struct sof_ipc_ctrl_data *cdata,
+			    int max_size)
+{
+	struct comp_data *cd = comp_get_drvdata(dev);
+
+	switch (cdata->cmd) {
+	case SOF_CTRL_CMD_BINARY:
+		comp_info(dev, "src_cmd_get_data(), SOF_CTRL_CMD_BINARY");
+		return comp_data_blob_get_cmd(cd->model_handler, cdata, max_size);
+	default:
+		comp_err(dev, "src_cmd_get_data(), invalid command %d", cdata->cmd);
+		return -EINVAL;
+	}
+}
+
 /* used to pass standard and bespoke commands (with data) to component */
 static int src_cmd(struct comp_dev *dev, int cmd, void *data,
 		   int max_data_size)
@@ -1121,8 +1406,17 @@ static int src_cmd(struct comp_dev *dev, int cmd, void *data,
 
 	comp_info(dev, "src_cmd()");
 
-	if (cmd == COMP_CMD_SET_VALUE)
+	switch (cmd) {
+	case COMP_CMD_SET_DATA:
+		ret = src_cmd_set_data(dev, cdata);
+		break;
+	case COMP_CMD_GET_DATA:
+		ret = src_cmd_get_data(dev, cdata, max_data_size);
+		break;
+	case COMP_CMD_SET_VALUE:
 		ret = src_ctrl_cmd(dev, cdata);
+		break;
+	}
 
 	return ret;
 }
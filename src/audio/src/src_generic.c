@@ -17,6 +17,10 @@
 #include <stddef.h>
 #include <stdint.h>
 
+#if SRC_X86
+#include <immintrin.h>
+#endif
+
 #if SRC_SHORT /* 16 bit coefficients version */
 
 static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
@@ -112,6 +116,73 @@ static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
 
 #else /* 32bit coefficients version */
 
+#if SRC_X86
+/* Return the sum of the two 64 bit lanes */
+static inline int64_t src_hsum_epi64_x86(__m128i acc)
+{
+#ifdef __x86_64__
+	return _mm_cvtsi128_si64(acc) + _mm_extract_epi64(acc, 1);
+#else
+	/* The 64 bit extracts exist only in 64 bit mode */
+	int64_t y[2];
+
+	_mm_storeu_si128((__m128i *)y, acc);
+	return y[0] + y[1];
+#endif
+}
+
+/* Sum of (coef[i] >> 8) * data[i] for i = 0 .. n - 1 */
+static inline int64_t fir_mac_x86(const int32_t *coef, const int32_t *data, int n)
+{
+	__m128i acc = _mm_setzero_si128();
+	__m128i c;
+	__m128i d;
+	int64_t y;
+	int i;
+
+	for (i = 0; i <= n - 4; i += 4) {
+		c = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(coef + i)), 8);
+		d = _mm_loadu_si128((const __m128i *)(data + i));
+		acc = _mm_add_epi64(acc, _mm_mul_epi32(c, d));
+		acc = _mm_add_epi64(acc, _mm_mul_epi32(_mm_srli_epi64(c, 32),
+						       _mm_srli_epi64(d, 32)));
+	}
+
+	y = src_hsum_epi64_x86(acc);
+	for (; i < n; i++)
+		y += (int64_t)(coef[i] >> 8) * data[i];
+
+	return y;
+}
+
+/* Stereo version, sums (coef[i] >> 8) * data[2i] and (coef[i] >> 8) * data[2i + 1] */
+static inline void fir_mac_2ch_x86(const int32_t *coef, const int32_t *data, int n,
+				   int64_t *y0, int64_t *y1)
+{
+	__m128i acc0 = _mm_setzero_si128();
+	__m128i acc1 = _mm_setzero_si128();
+	__m128i c;
+	__m128i d;
+	int i;
+
+	for (i = 0; i <= n - 2; i += 2) {
+		/* Coefficients i and i + 1 in the low words of the 64 bit lanes */
+		c = _mm_cvtepi32_epi64(_mm_loadl_epi64((const __m128i *)(coef + i)));
+		c = _mm_srai_epi32(c, 8);
+		d = _mm_loadu_si128((const __m128i *)(data + 2 * i));
+		acc0 = _mm_add_epi64(acc0, _mm_mul_epi32(c, d));
+		acc1 = _mm_add_epi64(acc1, _mm_mul_epi32(c, _mm_srli_epi64(d, 32)));
+	}
+
+	*y0 += src_hsum_epi64_x86(acc0);
+	*y1 += src_hsum_epi64_x86(acc1);
+	if (i < n) {
+		*y0 += (int64_t)(coef[i] >> 8) * data[2 * i];
+		*y1 += (int64_t)(coef[i] >> 8) * data[2 * i + 1];
+	}
+}
+#endif /* SRC_X86 */
+
 static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
 				      int32_t *fir_start, int32_t *fir_end,
 				      const int taps_x_nch, const int shift,
@@ -119,7 +190,9 @@ static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
 {
 	int64_t y0;
 	int64_t y1;
+#if !SRC_X86
 	int32_t scaled_coef;
+#endif
 	int32_t *data;
 	const int32_t *coef;
 	int i;
@@ -153,6 +226,10 @@ static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
 		 * output shift includes the shift by 23 for Qx.54 to
 		 * Qx.31.
 		 */
+#if SRC_X86
+		fir_mac_2ch_x86(coef, data, n1, &y0, &y1);
+		fir_mac_2ch_x86(coef + n1, fir_start, n2, &y0, &y1);
+#else
 		for (i = 0; i < n1; i++, coef++, data += 2) {
 			scaled_coef = *coef >> 8;
 			y0 += (int64_t)scaled_coef * data[0];
@@ -168,6 +245,7 @@ static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
 			y0 += (int64_t)scaled_coef * data[0];
 			y1 += (int64_t)scaled_coef * data[1];
 		}
+#endif
 		*wp = sat_int32(y1 >> qshift);
 		*(wp + 1) = sat_int32(y0 >> qshift);
 		return;
@@ -191,6 +269,14 @@ static inline void fir_filter_generic(int32_t *rp, const void *cp, int32_t *wp0,
 		 * output shift includes the shift by 23 for Qx.54 to
 		 * Qx.31.
 		 */
+#if SRC_X86
+		if (nch == 1) {
+			y0 += fir_mac_x86(coef, data, n1);
+			y0 += fir_mac_x86(coef + n1, fir_start, n2);
+			*wp = sat_int32(y0 >> qshift);
+			return;
+		}
+#endif
 		for (i = 0; i < n1; i += nch, coef++, data += nch)
 			y0 += (int64_t)(*coef >> 8) * (*data);
 
@@ -14,46 +14,59 @@
 
 #include <sof/math/fir_generic.h>
 
-static inline void tdfb_core(struct tdfb_comp_data *cd, int in_nch, int out_nch)
+static inline void tdfb_core(struct tdfb_comp_data *cd, int in_nch, int out_nch,
+			     int frames)
 {
 	struct fir_state_32x16 *filter;
-	int32_t y0;
-	int32_t y1;
-	int is2;
+	int32_t x[TDFB_MAX_BLOCK_FRAMES];
+	int32_t y[TDFB_MAX_BLOCK_FRAMES];
+	int32_t *out;
 	int is;
 	int om;
 	int i;
+	int j;
 	int k;
 	const int num_filters = cd->config->num_filters;
 
 	/* Clear output mix*/
-	memset(cd->out, 0,  2 * out_nch * sizeof(int32_t));
+	memset(cd->out, 0, frames * out_nch * sizeof(int32_t));
 
 	/* Run and mix all filters to their output channel */
 	for (i = 0; i < num_filters; i++) {
 		is = cd->input_channel_select[i];
-		is2 = is + in_nch;
 		om = cd->output_channel_mix[i];
 		filter = &cd->fir[i];
-		/* Process sample and successive sample. This follows
-		 * optimized FIR version implementation that processes
-		 * two samples per call. The output is stored as Q5.27
-		 * to fit max. 16 filters sum to a channel.
+		/* Process four successive samples with the block FIR that
+		 * passes the coefficients once per block, or two samples
+		 * with the dual sample version in the end of buffer. The
+		 * output is stored as Q5.27 to fit max. 16 filters sum to
+		 * a channel.
 		 */
-		fir_32x16_2x(filter, cd->in[is], cd->in[is2], &y0, &y1);
-		y0 >>= 4;
-		y1 >>= 4;
+		if (frames == TDFB_MAX_BLOCK_FRAMES) {
+			for (j = 0; j < TDFB_MAX_BLOCK_FRAMES; j++)
+				x[j] = cd->in[is + j * in_nch];
+
+			fir_32x16_block(filter, x, y, TDFB_MAX_BLOCK_FRAMES);
+		} else {
+			fir_32x16_2x(filter, cd->in[is], cd->in[is + in_nch], &y[0], &y[1]);
+		}
+
+		for (j = 0; j < frames; j++)
+			y[j] >>= 4;
+
 		for (k = 0; k < out_nch; k++) {
 			if (om & 1) {
-				cd->out[k] += y0;
-				cd->out[k + out_nch] += y1;
+				out = &cd->out[k];
+				for (j = 0; j < frames; j++) {
+					*out += y[j];
+					out += out_nch;
+				}
 			}
 			om = om >> 1;
 		}
 	}
 }
 
-
 #if CONFIG_FORMAT_S16LE
 void tdfb_fir_s16(struct tdfb_comp_data *cd,
 		  const struct audio_stream __sparse_cache *source,
@@ -65,6 +78,7 @@ void tdfb_fir_s16(struct tdfb_comp_data *cd,
 	int i;
 	int j;
 	int f;
+	int m;
 	const int in_nch = source->channels;
 	const int out_nch = sink->channels;
 	int remaining_frames = frames;
@@ -75,19 +89,22 @@ void tdfb_fir_s16(struct tdfb_comp_data *cd,
 		f = MIN(remaining_frames, fmax);
 		fmax = audio_stream_frames_without_wrap(sink, y);
 		f = MIN(f, fmax);
-		for (j = 0; j < f; j += 2) {
-			/* Read two frames from all input channels */
-			for (i = 0; i < 2 * in_nch; i++) {
+		for (j = 0; j < f; j += m) {
+			/* Four frames per block when available, else two */
+			m = f - j < TDFB_MAX_BLOCK_FRAMES ? 2 : TDFB_MAX_BLOCK_FRAMES;
+
+			/* Read the frames from all input channels */
+			for (i = 0; i < m * in_nch; i++) {
 				cd->in[i] = *x << 16;
 				tdfb_direction_copy_emphasis(cd, in_nch, &emp_ch, *x << 16);
 				x++;
 			}
 
 			/* Process */
-			tdfb_core(cd, in_nch, out_nch);
+			tdfb_core(cd, in_nch, out_nch, m);
 
-			/* Write two frames of output */
-			for (i = 0; i < 2 * out_nch; i++) {
+			/* Write the frames of output */
+			for (i = 0; i < m * out_nch; i++) {
 				*y = sat_int16(Q_SHIFT_RND(cd->out[i], 27, 15));
 				y++;
 			}
@@ -110,6 +127,7 @@ void tdfb_fir_s24(struct tdfb_comp_data *cd,
 	int i;
 	int j;
 	int f;
+	int m;
 	const int in_nch = source->channels;
 	const int out_nch = sink->channels;
 	int remaining_frames = frames;
@@ -120,19 +138,22 @@ void tdfb_fir_s24(struct tdfb_comp_data *cd,
 		f = MIN(remaining_frames, fmax);
 		fmax = audio_stream_frames_without_wrap(sink, y);
 		f = MIN(f, fmax);
-		for (j = 0; j < f; j += 2) {
-			/* Read two frames from all input channels */
-			for (i = 0; i < 2 * in_nch; i++) {
+		for (j = 0; j < f; j += m) {
+			/* Four frames per block when available, else two */
+			m = f - j < TDFB_MAX_BLOCK_FRAMES ? 2 : TDFB_MAX_BLOCK_FRAMES;
+
+			/* Read the frames from all input channels */
+			for (i = 0; i < m * in_nch; i++) {
 				cd->in[i] = *x << 8;
 				tdfb_direction_copy_emphasis(cd, in_nch, &emp_ch, *x << 8);
 				x++;
 			}
 
 			/* Process */
-			tdfb_core(cd, in_nch, out_nch);
+			tdfb_core(cd, in_nch, out_nch, m);
 
-			/* Write two frames of output */
-			for (i = 0; i < 2 * out_nch; i++) {
+			/* Write the frames of output */
+			for (i = 0; i < m * out_nch; i++) {
 				*y = sat_int24(Q_SHIFT_RND(cd->out[i], 27, 23));
 				y++;
 			}
@@ -154,6 +175,7 @@ void tdfb_fir_s32(struct tdfb_comp_data *cd, const struct audio_stream __sparse_
 	int i;
 	int j;
 	int f;
+	int m;
 	const int in_nch = source->channels;
 	const int out_nch = sink->channels;
 	int remaining_frames = frames;
@@ -164,24 +186,24 @@ void tdfb_fir_s32(struct tdfb_comp_data *cd, const struct audio_stream __sparse_
 		f = MIN(remaining_frames, fmax);
 		fmax = audio_stream_frames_without_wrap(sink, y);
 		f = MIN(f, fmax);
-		for (j = 0; j < f; j += 2) {
-			/* Clear output mix*/
-			memset(cd->out, 0, 2 * out_nch * sizeof(int32_t));
+		for (j = 0; j < f; j += m) {
+			/* Four frames per block when available, else two */
+			m = f - j < TDFB_MAX_BLOCK_FRAMES ? 2 : TDFB_MAX_BLOCK_FRAMES;
 
-			/* Read two frames from all input channels */
-			for (i = 0; i < 2 * in_nch; i++) {
+			/* Read the frames from all input channels */
+			for (i = 0; i < m * in_nch; i++) {
 				cd->in[i] = *x;
 				tdfb_direction_copy_emphasis(cd, in_nch, &emp_ch, *x);
 				x++;
 			}
 
 			/* Process */
-			tdfb_core(cd, in_nch, out_nch);
+			tdfb_core(cd, in_nch, out_nch, m);
 
-			/* Write two frames of output. In Q5.27 to Q1.31 conversion
+			/* Write the frames of output. In Q5.27 to Q1.31 conversion
 			 * rounding is not applicable so just shift left by 4.
 			 */
-			for (i = 0; i < 2 * out_nch; i++) {
+			for (i = 0; i < m * out_nch; i++) {
 				*y = sat_int32((int64_t)cd->out[i] << 4);
 				y++;
 			}
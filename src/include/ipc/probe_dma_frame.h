@@ -23,6 +23,22 @@ struct probe_data_packet {
 
 #define PROBE_EXTRACT_SYNC_WORD		0xBABEBEBA
 
+/**
+ * Buffer ID of batch packets. The data of a batch packet is a sequence of
+ * struct probe_batch_record, each padded to a multiple of 4 bytes.
+ */
+#define PROBE_BATCH_BUFFER_ID		0xFFFFFFFE
+
+/**
+ * Header for the data of one probe point in a batch packet
+ */
+struct probe_batch_record {
+	uint32_t buffer_id;		/**< Buffer ID from which data was extracted */
+	uint32_t format;		/**< Encoded data format */
+	uint32_t data_size_bytes;	/**< Size of following data without padding */
+	uint8_t data[];			/**< Data extracted from buffer */
+};
+
 /**
  * \brief Definitions of shifts and masks for format encoding in probe
  *	  extraction stream
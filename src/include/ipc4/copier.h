@@ -32,17 +32,6 @@
 #include <sof/audio/buffer.h>
 #include <sof/audio/pcm_converter.h>
 
-#define COPIER_GENERIC
-
-#if defined(__XCC__)
-#include <xtensa/config/core-isa.h>
-
-#if XCHAL_HAVE_HIFI3 || XCHAL_HAVE_HIFI4
-#undef COPIER_GENERIC
-#endif
-
-#endif
-
 /* This is basic module config that may serve as a base for more specialized, module
  * specific config received along with Init Module Instance from host.
  *
@@ -320,11 +309,27 @@ struct ipc4_data_segment_enabled {
 	uint32_t data_seg_size;
 } __attribute__((packed, aligned(4)));
 
-/* One of copy_single_channel_cXX() to mux/demux channels into/from copier multi_endpoint_buffer */
-typedef void (* channel_copy_func)(struct audio_stream __sparse_cache *dst,
-				   int dst_channel,
-				   const struct audio_stream __sparse_cache *src,
-				   int src_channel, int frame_count);
+/* One of mux_cXX()/demux_cXX() to gather/scatter all channels of all endpoint buffers
+ * into/from copier multi_endpoint_buffer in a single pass. chmap[i] maps channels of
+ * endp[i] to channels of the multi-endpoint stream.
+ */
+typedef void (*multi_endpoint_func)(struct audio_stream __sparse_cache *multi,
+				    struct audio_stream __sparse_cache **endp,
+				    const uint16_t **chmap, int endp_num,
+				    uint32_t frames);
+
+void mux_c16(struct audio_stream __sparse_cache *multi,
+	     struct audio_stream __sparse_cache **endp,
+	     const uint16_t **chmap, int endp_num, uint32_t frames);
+void mux_c32(struct audio_stream __sparse_cache *multi,
+	     struct audio_stream __sparse_cache **endp,
+	     const uint16_t **chmap, int endp_num, uint32_t frames);
+void demux_c16(struct audio_stream __sparse_cache *multi,
+	       struct audio_stream __sparse_cache **endp,
+	       const uint16_t **chmap, int endp_num, uint32_t frames);
+void demux_c32(struct audio_stream __sparse_cache *multi,
+	       struct audio_stream __sparse_cache **endp,
+	       const uint16_t **chmap, int endp_num, uint32_t frames);
 
 struct copier_data {
 	/*
@@ -339,7 +344,12 @@ struct copier_data {
 
 	/* buffer to mux/demux data from/to multiple endpoint buffers for ALH multi-gateway case */
 	struct comp_buffer *multi_endpoint_buffer;
-	channel_copy_func copy_single_channel;
+	multi_endpoint_func mux;
+	multi_endpoint_func demux;
+	/* playback gateway conversion is a plain copy, the endpoints can be demuxed
+	 * straight from the source buffer, see copier_demux_from_source()
+	 */
+	bool demux_copy;
 
 	bool bsource_buffer;
 
@@ -357,7 +367,4 @@ struct copier_data {
 	uint64_t output_total_data_processed;
 };
 
-int apply_attenuation(struct comp_dev *dev, struct copier_data *cd,
-		      struct comp_buffer __sparse_cache *sink, int frame);
-
 #endif
@@ -48,10 +48,17 @@
 
 /*
  * @brief FIR filter is max 128 taps and delay lines per channel are
- * max 256 samples long.
+ * max 2 * (128 + ASRC_BLOCK_FRAMES) samples long.
  */
 #define ASRC_MAX_FILTER_LENGTH	128
 
+/*
+ * @brief Max number of output frames whose impulse responses are
+ * computed and filtered together. The ring buffers keep as many input
+ * frames of extra history for the frames waiting in a block.
+ */
+#define ASRC_BLOCK_FRAMES	4
+
 /*
  * @brief Define whether the input and output buffers shall be
  * interleaved or not.
@@ -131,6 +138,25 @@ enum asrc_error_code {
 	ASRC_EC_INVALID_FILTER_LENGTH = -15,    /*!< Length exceeds max. */
 };
 
+/*
+ * asrc_block: Output frames collected by the state machine. The
+ * impulse responses are evaluated and the ring buffers are filtered
+ * for all of them at once. Without an input frame in between, the
+ * frames share the ring buffer position and the time value increases
+ * by a constant step.
+ */
+struct asrc_block {
+	int num_frames;		/*!< Number of collected output frames */
+	int num_inputs;		/*!< Input frames written to the ring */
+				/*!< buffer since the first frame */
+	bool constant_step;	/*!< No input frame between the frames */
+	uint32_t time_value[ASRC_BLOCK_FRAMES]; /*!< Time of each frame */
+	int write_position[ASRC_BLOCK_FRAMES];	/*!< Ring buffer position */
+						/*!< of each frame */
+	int output_frame[ASRC_BLOCK_FRAMES];	/*!< Output buffer frame */
+						/*!< index of each frame */
+};
+
 /*
  * asrc_farrow: Struct which stores all the setup parameters and
  * pointers.  An instance of this struct has to be passed to all
@@ -164,8 +190,9 @@ struct asrc_farrow {
 	/* + filter coefficients */
 	const int32_t *polyphase_filters; /*!< Pointer to the filter */
 					  /*!< coefficients */
-	int32_t *impulse_response; /*!< Pointer to the impulse response */
-				   /*!< for generating one output sample */
+	int32_t *impulse_response; /*!< Pointer to the impulse responses */
+				   /*!< for generating a block of output */
+				   /*!< frames */
 
 	/* PROGRAM + general */
 	bool is_initialised;	/*!< Flag is set to true after */
@@ -207,8 +234,9 @@ struct asrc_farrow {
 					/*!< control loop */
 
 	/* + function pointer */
-	void (*calc_ir)(struct asrc_farrow *src_obj);	/*!< Pointer */
-	/*!< to the function which calculates the impulse response */
+	void (*calc_ir)(struct asrc_farrow *src_obj,
+			const struct asrc_block *block); /*!< Pointer */
+	/*!< to the function which calculates the impulse responses */
 };
 
 /*
@@ -627,29 +655,36 @@ void asrc_write_to_ring_buffer32(struct asrc_farrow *src_obj,
 				 int index_input_frame);
 
 /*
- * Filter the 32 bit ring buffer values with impulse_response
+ * Filter the 16 bit ring buffer values with the impulse responses of
+ * the block, writes one output sample per channel and frame.
  */
 void asrc_fir_filter16(struct asrc_farrow *src_obj,
 		       int16_t **output_buffers,
-		       int index_output_frame);
+		       const struct asrc_block *block);
 
 /*
- * Filter the 32 bit ring buffer values with impulse_response
+ * Filter the 32 bit ring buffer values with the impulse responses of
+ * the block, writes one output sample per channel and frame.
  */
 void asrc_fir_filter32(struct asrc_farrow *src_obj,
 		       int32_t **output_buffers,
-		       int index_output_frame);
+		       const struct asrc_block *block);
 
 /*
- * Calculates the impulse response. This impulse response is then
- * applied to the buffered signal, in order to generate the output.
- * There are four versions, from whom one is pointed to by the
- * ias_src_farrow struct.  This depends on the number of polyphase
- * filters given for the current conversion ratio.
+ * Calculates the impulse responses for the time values of the block,
+ * the response of each frame is stored after the previous one. These
+ * impulse responses are then applied to the buffered signal, in order
+ * to generate the output. There are four versions, from whom one is
+ * pointed to by the ias_src_farrow struct.  This depends on the number
+ * of polyphase filters given for the current conversion ratio.
  */
-void asrc_calc_impulse_response_n4(struct asrc_farrow *src_obj);
-void asrc_calc_impulse_response_n5(struct asrc_farrow *src_obj);
-void asrc_calc_impulse_response_n6(struct asrc_farrow *src_obj);
-void asrc_calc_impulse_response_n7(struct asrc_farrow *src_obj);
+void asrc_calc_impulse_response_n4(struct asrc_farrow *src_obj,
+				   const struct asrc_block *block);
+void asrc_calc_impulse_response_n5(struct asrc_farrow *src_obj,
+				   const struct asrc_block *block);
+void asrc_calc_impulse_response_n6(struct asrc_farrow *src_obj,
+				   const struct asrc_block *block);
+void asrc_calc_impulse_response_n7(struct asrc_farrow *src_obj,
+				   const struct asrc_block *block);
 
 #endif /* IAS_SRC_FARROW_H */
@@ -549,6 +549,16 @@ struct comp_ipc_config {
 	uint32_t xrun_action;	/**< action we should take on XRUN */
 };
 
+#if CONFIG_LIBRARY
+/** \brief Host copy() cost counters, reported by testbench. */
+struct comp_copy_stats {
+	uint64_t cycles;	/**< CPU cycles spent in copy() */
+	uint64_t time_ns;	/**< wall clock time spent in copy() */
+	uint64_t peak_ns;	/**< longest single copy() */
+	uint32_t copies;	/**< number of copy() calls */
+};
+#endif
+
 /**
  * Audio component base device "class"
  * - used by other component types.
@@ -598,6 +608,9 @@ struct comp_dev {
 #if CONFIG_PERFORMANCE_COUNTERS
 	struct perf_cnt_data pcd;
 #endif
+#if CONFIG_LIBRARY
+	struct comp_copy_stats copy_stats;
+#endif
 };
 
 /** @}*/
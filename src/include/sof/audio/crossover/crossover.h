@@ -27,6 +27,9 @@ struct comp_dev;
 /* Number of sinks for a 4 way crossover filter */
 #define CROSSOVER_4WAY_NUM_SINKS 4
 
+/* Number of frames per block when all channels are filtered together */
+#define CROSSOVER_MULTICH_FRAMES 16
+
 /**
  * The Crossover filter will have from 2 to 4 outputs.
  * Diagram of a 4-way Crossover filter (6 LR4 Filters).
@@ -66,6 +69,17 @@ struct crossover_state {
 	struct iir_state_df2t highpass[CROSSOVER_MAX_LR4];
 };
 
+/**
+ * Stores the state of all channels of the Crossover filter. The channels
+ * are filtered together one block of interleaved frames at a time.
+ */
+struct crossover_multich_state {
+	struct iir_state_df2t_multich lowpass[CROSSOVER_MAX_LR4];
+	struct iir_state_df2t_multich highpass[CROSSOVER_MAX_LR4];
+	int32_t *in; /* Block of input frames, also used as scratch */
+	int32_t *out[CROSSOVER_4WAY_NUM_SINKS]; /* Blocks of output frames */
+};
+
 typedef void (*crossover_process)(const struct comp_dev *dev,
 				  const struct comp_buffer __sparse_cache *source,
 				  struct comp_buffer __sparse_cache *sinks[],
@@ -75,15 +89,20 @@ typedef void (*crossover_process)(const struct comp_dev *dev,
 typedef void (*crossover_split)(int32_t in, int32_t out[],
 				struct crossover_state *state);
 
+typedef void (*crossover_split_multich)(struct crossover_multich_state *state,
+					int frames);
+
 /* Crossover component private data */
 struct comp_data {
 	/**< filter state */
 	struct crossover_state state[PLATFORM_MAX_CHANNELS];
+	struct crossover_multich_state multich;   /**< all channels state */
+	void *multich_data;                       /**< pointer to allocated RAM */
 	struct comp_data_blob_handler *model_handler;
 	struct sof_crossover_config *config;      /**< pointer to setup blob */
 	enum sof_ipc_frame source_format;         /**< source frame format */
 	crossover_process crossover_process;      /**< processing function */
-	crossover_split crossover_split;          /**< split function */
+	crossover_split_multich crossover_split;  /**< split function */
 };
 
 struct crossover_proc_fnmap {
@@ -142,6 +161,21 @@ static inline crossover_split crossover_find_split_func(int32_t num_sinks)
 	return crossover_split_fnmap[num_sinks - CROSSOVER_2WAY_NUM_SINKS];
 }
 
+extern const crossover_split_multich crossover_split_multich_fnmap[];
+
+/**
+ * \brief Returns Crossover split function for all channels.
+ */
+static inline crossover_split_multich
+	crossover_find_split_multich_func(int32_t num_sinks)
+{
+	if (num_sinks < CROSSOVER_2WAY_NUM_SINKS ||
+	    num_sinks > CROSSOVER_4WAY_NUM_SINKS)
+		return NULL;
+
+	return crossover_split_multich_fnmap[num_sinks - CROSSOVER_2WAY_NUM_SINKS];
+}
+
 /*
  * \brief Runs input in through the LR4 filter and returns it's output.
  */
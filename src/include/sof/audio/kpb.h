@@ -47,6 +47,17 @@ struct comp_buffer;
 /**< Host buffer shall be at least two times bigger than history buffer. */
 #define HOST_BUFFER_MIN_SIZE(hb) (hb * 2)
 
+/**< Size of a sample in the history buffer, samples in 32 bit containers
+ * may be packed.
+ */
+#if CONFIG_KPB_HISTORY_PACK_S24
+#define KPB_HISTORY_SAMPLE_BYTES(sw) (((sw) == 16) ? 2 : 3)
+#elif CONFIG_KPB_HISTORY_PACK_S16
+#define KPB_HISTORY_SAMPLE_BYTES(sw) 2
+#else
+#define KPB_HISTORY_SAMPLE_BYTES(sw) (KPB_SAMPLE_CONTAINER_SIZE(sw) / 8)
+#endif
+
 /**< Convert with right shift a bytes count to samples count */
 #define KPB_BYTES_TO_S16_SAMPLES(s)	((s) >> 1)
 #define KPB_BYTES_TO_S32_SAMPLES(s)	((s) >> 2)
@@ -140,6 +151,7 @@ struct history_data {
 	size_t buffer_size; /**< size of internal history buffer */
 	size_t buffered; /**< amount of buffered data */
 	size_t free; /** spce we can use to write new data */
+	size_t sample_bytes; /**< size of a sample stored in history buffer */
 	struct history_buffer *c_hb; /**< current buffer used for writing */
 };
 
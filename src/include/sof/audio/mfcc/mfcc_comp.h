@@ -65,9 +65,11 @@ struct mfcc_fft {
 #if MFCC_FFT_BITS == 16
 	struct icomplex16 *fft_buf; /**< fft_padded_size */
 	struct icomplex16 *fft_out; /**< fft_padded_size */
+	int16_t *fft_real; /**< fft_buf as real input for fft_padded_size */
 #elif MFCC_FFT_BITS == 32
 	struct icomplex32 *fft_buf; /**< fft_padded_size */
 	struct icomplex32 *fft_out; /**< fft_padded_size */
+	int32_t *fft_real; /**< fft_buf as real input for fft_padded_size */
 #else
 #error "MFCC_FFT_BITS needs to be 16 or 32"
 #endif
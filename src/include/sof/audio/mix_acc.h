@@ -0,0 +1,129 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2022 Intel Corporation. All rights reserved.
+ */
+
+/**
+ * \file include/sof/audio/mix_acc.h
+ * \brief Source-major mixing kernels.
+ *
+ * Streams are mixed one source at a time over a contiguous segment into a
+ * wide accumulator which is saturated once into the sink. The inner loops
+ * read one linear source and have no loop carried dependency, so they can
+ * be vectorized by the compiler. The caller splits the circular buffers
+ * into contiguous segments of at most MIX_ACC_BLOCK_SAMPLES samples.
+ */
+
+#ifndef __SOF_AUDIO_MIX_ACC_H__
+#define __SOF_AUDIO_MIX_ACC_H__
+
+#include <sof/audio/format.h>
+#include <stdint.h>
+
+/** \brief Accumulator size in samples, kept small to fit on the stack. */
+#define MIX_ACC_BLOCK_SAMPLES	64
+
+#if CONFIG_FORMAT_S16LE
+static inline void mix_acc_set_s16(int32_t *acc, const int16_t *src, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		acc[i] = src[i];
+}
+
+static inline void mix_acc_add_s16(int32_t *acc, const int16_t *src, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		acc[i] += src[i];
+}
+
+static inline void mix_acc_store_s16(int16_t *dst, const int32_t *acc, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		dst[i] = sat_int16(acc[i]);
+}
+
+/* mix a single source into a sink that already holds the sum of the others */
+static inline void mix_acc_add_sat_s16(int16_t *dst, const int16_t *src, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		dst[i] = sat_int16((int32_t)dst[i] + src[i]);
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static inline void mix_acc_set_s24(int32_t *acc, const int32_t *src, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		acc[i] = sign_extend_s24(src[i]);
+}
+
+static inline void mix_acc_add_s24(int32_t *acc, const int32_t *src, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		acc[i] += sign_extend_s24(src[i]);
+}
+
+static inline void mix_acc_store_s24(int32_t *dst, const int32_t *acc, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		dst[i] = sat_int24(acc[i]);
+}
+
+static inline void mix_acc_add_sat_s24(int32_t *dst, const int32_t *src, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		dst[i] = sat_int24(sign_extend_s24(dst[i]) + sign_extend_s24(src[i]));
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static inline void mix_acc_set_s32(int64_t *acc, const int32_t *src, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		acc[i] = src[i];
+}
+
+static inline void mix_acc_add_s32(int64_t *acc, const int32_t *src, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		acc[i] += src[i];
+}
+
+static inline void mix_acc_store_s32(int32_t *dst, const int64_t *acc, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		dst[i] = sat_int32(acc[i]);
+}
+
+static inline void mix_acc_add_sat_s32(int32_t *dst, const int32_t *src, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		dst[i] = sat_int32((int64_t)dst[i] + src[i]);
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+#endif /* __SOF_AUDIO_MIX_ACC_H__ */
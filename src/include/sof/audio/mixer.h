@@ -28,6 +28,9 @@ void sys_comp_module_mixer_interface_init(void);
 #undef MIXER_GENERIC
 #endif
 
+#elif defined(__SSE4_2__)
+#undef MIXER_GENERIC
+#define MIXER_X86
 #endif
 
 /* mixer component private data */
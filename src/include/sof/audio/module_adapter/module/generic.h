@@ -189,6 +189,17 @@ struct processing_module {
 	 */
 	bool simple_copy;
 
+	/*
+	 * flag set by a module that can process the source and sink audio_stream buffers in
+	 * place, handling the circular wrap itself. The input and output stream buffer data
+	 * then point to struct audio_stream instead of linear module buffers and sizes remain
+	 * in bytes. The input size is limited to what fits in all the sinks. No intermediate or
+	 * local sink buffers are allocated. The module reads from r_ptr and writes at w_ptr but
+	 * leaves the pointer updates to the module adapter, which applies the reported consumed
+	 * and produced sizes.
+	 */
+	bool stream_copy;
+
 	/* module-specific flags for comp_verify_params() */
 	uint32_t verify_params_flags;
 
@@ -290,4 +301,8 @@ int find_module_source_index(struct module_source_info __sparse_cache *msi,
 	return -EINVAL;
 }
 
+#ifdef UNIT_TEST
+void sys_comp_module_passthrough_interface_init(void);
+#endif
+
 #endif /* __SOF_AUDIO_MODULE_GENERIC__ */
@@ -33,6 +33,9 @@ struct audio_stream;
 #define PCM_CONVERTER_HIFI3
 #else
 #define PCM_CONVERTER_GENERIC
+#if CONFIG_LIBRARY && (defined(__x86_64__) || defined(__i386__))
+#define PCM_CONVERTER_X86
+#endif
 #endif
 #endif /* UNIT_TEST */
 
@@ -71,6 +74,16 @@ extern const struct pcm_func_map pcm_func_map[];
 /** \brief Number of conversion functions. */
 extern const size_t pcm_func_count;
 
+#ifdef PCM_CONVERTER_X86
+/** \brief Map of SSE4.2 conversion functions, used instead of the generic
+ *	   ones when the CPU supports them.
+ */
+extern const struct pcm_func_map pcm_func_map_x86[];
+
+/** \brief Number of SSE4.2 conversion functions. */
+extern const size_t pcm_func_count_x86;
+#endif /* PCM_CONVERTER_X86 */
+
 /**
  * \brief Retrieves PCM conversion function.
  * \param[in] in Source frame format.
@@ -82,6 +95,16 @@ pcm_get_conversion_function(enum sof_ipc_frame in,
 {
 	uint32_t i;
 
+#ifdef PCM_CONVERTER_X86
+	if (__builtin_cpu_supports("sse4.2")) {
+		for (i = 0; i < pcm_func_count_x86; i++) {
+			if (in == pcm_func_map_x86[i].source &&
+			    out == pcm_func_map_x86[i].sink)
+				return pcm_func_map_x86[i].func;
+		}
+	}
+#endif /* PCM_CONVERTER_X86 */
+
 	for (i = 0; i < pcm_func_count; i++) {
 		if (in != pcm_func_map[i].source)
 			continue;
@@ -167,4 +190,29 @@ int pcm_convert_as_linear(const struct audio_stream __sparse_cache *source, uint
 			  struct audio_stream __sparse_cache *sink, uint32_t ooffset,
 			  uint32_t samples, pcm_converter_lin_func converter);
 
+/**
+ * \brief Arithmetic right shift of s32 samples in linear memory, in place
+ * \param data linear memory region with samples to process
+ * \param samples number of samples to process
+ * \param shift number of bits to shift right
+ */
+void pcm_shift_s32_lin(int32_t *data, uint32_t samples, uint32_t shift);
+
+/**
+ * \brief Convert data from circular buffer and attenuate the result in the
+ *	  same pass. The conversion is run on blocks small enough to be
+ *	  attenuated while still in cache, so data is touched once.
+ * \param source buffer with samples to process, read pointer is not modified
+ * \param ioffset offset to first sample in source stream
+ * \param sink output buffer in 32 bit container, write pointer is not modified
+ * \param ooffset offset to first sample in sink stream
+ * \param samples number of samples to convert
+ * \param converter conversion function from source to sink format
+ * \param shift attenuation as number of bits to shift converted samples right
+ * \return error code or number of processed samples
+ */
+int pcm_convert_attenuated(const struct audio_stream __sparse_cache *source, uint32_t ioffset,
+			   struct audio_stream __sparse_cache *sink, uint32_t ooffset,
+			   uint32_t samples, pcm_converter_func converter, uint32_t shift);
+
 #endif /* __SOF_AUDIO_PCM_CONVERTER_H__ */
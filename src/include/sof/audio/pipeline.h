@@ -81,6 +81,9 @@ struct pipeline {
 	/* sink component for this pipe */
 	struct comp_dev *sink_comp;
 
+	/* flat copy schedule, built at prepare and dropped on graph change */
+	struct pipeline_copy_sched *copy_sched;
+
 	struct list_item list;	/**< list in walk context */
 
 	/* position update */
@@ -113,6 +116,26 @@ struct pipeline_walk_context {
 	bool skip_incomplete;
 };
 
+/* one component of a flat copy schedule */
+struct pipeline_copy_entry {
+	struct comp_dev *comp;
+	uint32_t next;		/**< first entry after the walk from this comp */
+};
+
+/*
+ * Components of a pipeline in the order pipeline_copy() walks them from
+ * the start component. The order is recorded with the same graph walk
+ * so a component reached via two paths is listed twice like it is copied
+ * twice by the walk.
+ */
+struct pipeline_copy_sched {
+	struct comp_dev *start;	/**< walk start, sink or source comp */
+	int dir;		/**< PPL_DIR_UPSTREAM or PPL_DIR_DOWNSTREAM */
+	uint32_t count;		/**< number of entries */
+	uint32_t *stack;	/**< pending post-order copies, count long */
+	struct pipeline_copy_entry entry[];
+};
+
 /* generic pipeline data used by pipeline_comp_* functions */
 struct pipeline_data {
 	struct comp_dev *start;
@@ -291,6 +314,21 @@ int pipeline_trigger_run(struct pipeline *p, struct comp_dev *host, int cmd);
  */
 int pipeline_copy(struct pipeline *p);
 
+/**
+ * \brief Build the flat copy schedule used by pipeline_copy().
+ * \param[in] p pipeline.
+ * \return 0 on success.
+ *
+ * Without a schedule pipeline_copy() walks the graph recursively.
+ */
+int pipeline_copy_sched_build(struct pipeline *p);
+
+/**
+ * \brief Free the flat copy schedule, must be done on any graph change.
+ * \param[in] p pipeline.
+ */
+void pipeline_copy_sched_free(struct pipeline *p);
+
 /**
  * \brief Get time pipeline timestamps from host to dai.
  * \param[in] p pipeline.
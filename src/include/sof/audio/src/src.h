@@ -23,8 +23,8 @@ struct src_param {
 	int blk_out;
 	int stage1_times;
 	int stage2_times;
-	int idx_in;
-	int idx_out;
+	struct src_stage *stage1;
+	struct src_stage *stage2;
 	int nch;
 };
 
@@ -119,4 +119,8 @@ int32_t src_input_rates(void);
 
 int32_t src_output_rates(void);
 
+#ifdef UNIT_TEST
+void sys_comp_src_init(void);
+#endif
+
 #endif /* __SOF_AUDIO_SRC_SRC_H__ */
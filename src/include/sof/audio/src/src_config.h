@@ -49,13 +49,20 @@
 #define SRC_GENERIC	1
 #define SRC_HIFIEP	0
 #define SRC_HIFI3	0
-#if CONFIG_LIBRARY
+#if defined(__SSE4_2__)
+#define SRC_X86		1 /* Use x86 SIMD in the generic filter core */
+#endif
+#if CONFIG_LIBRARY || defined(SRC_SHORT)
 #else
 #define SRC_SHORT	1 /* Need to use for generic code version speed */
 #endif
 #endif
 #endif
 
+#if !defined(SRC_X86)
+#define SRC_X86		0
+#endif
+
 /* Kconfig option tiny needs 16 bits coefficients, other options use 32 bits */
 #if !defined(SRC_SHORT)
 #if CONFIG_COMP_SRC_TINY
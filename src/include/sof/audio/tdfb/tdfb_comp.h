@@ -37,8 +37,10 @@
 #define TDFB_HIFI3	0
 #endif
 
-#define TDFB_IN_BUF_LENGTH (2 * PLATFORM_MAX_CHANNELS)
-#define TDFB_OUT_BUF_LENGTH (2 * PLATFORM_MAX_CHANNELS)
+/* The generic version processes up to four frames per FIR call */
+#define TDFB_MAX_BLOCK_FRAMES 4
+#define TDFB_IN_BUF_LENGTH (TDFB_MAX_BLOCK_FRAMES * PLATFORM_MAX_CHANNELS)
+#define TDFB_OUT_BUF_LENGTH (TDFB_MAX_BLOCK_FRAMES * PLATFORM_MAX_CHANNELS)
 
 /* When set to one only one IPC is sent to host. There is not other requests
  * triggered. If set to zero the IPC sent will be empty and the driver will
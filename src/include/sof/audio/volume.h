@@ -43,6 +43,9 @@ struct sof_ipc_ctrl_value_chan;
 #undef CONFIG_GENERIC
 #endif
 
+#elif defined(__SSE4_2__)
+#undef CONFIG_GENERIC
+#define VOLUME_X86
 #endif
 
 /**
@@ -115,10 +118,31 @@ struct sof_ipc_ctrl_value_chan;
 typedef void (*vol_scale_func)(struct processing_module *mod, struct input_stream_buffer *source,
 			       struct output_stream_buffer *sink, uint32_t frames);
 
+/** \brief Maximum number of ramp segments processed in one pass. */
+#define VOL_RAMP_SEGMENTS_MAX	16
+
+/**
+ * \brief Volume ramp segment, the frames processed with the same gains.
+ */
+struct vol_ramp_segment {
+	uint32_t frames;			/**< frames in segment */
+	int32_t gain[SOF_IPC_MAX_CHANNELS];	/**< gain of each channel */
+};
+
 /**
- * \brief volume interface for function getting nearest zero crossing frame
+ * \brief volume ramp processing function interface, processes the frames
+ * of consecutive ramp segments in one pass
  */
-typedef uint32_t (*vol_zc_func)(const struct audio_stream __sparse_cache *source,
+typedef void (*vol_scale_ramp_func)(struct processing_module *mod,
+				    struct input_stream_buffer *source,
+				    struct output_stream_buffer *sink,
+				    const struct vol_ramp_segment *seg, uint32_t frames);
+
+/**
+ * \brief volume interface for function getting nearest zero crossing frame,
+ * the frames start after the data already consumed from source
+ */
+typedef uint32_t (*vol_zc_func)(const struct input_stream_buffer *source,
 				uint32_t frames, int64_t *prev_sum);
 
 /**
@@ -139,6 +163,12 @@ struct vol_data {
 	int32_t mvolume[SOF_IPC_MAX_CHANNELS];	/**< mute volume */
 	int32_t rvolume[SOF_IPC_MAX_CHANNELS];	/**< ramp start volume */
 	int32_t ramp_coef[SOF_IPC_MAX_CHANNELS]; /**< parameter for slope */
+	/**< gains of the ramp segments of the current process() call */
+	struct vol_ramp_segment ramp_segments[VOL_RAMP_SEGMENTS_MAX];
+#if CONFIG_COMP_VOLUME_WINDOWS_FADE
+	int32_t fade_ramp_time;			/**< ramp time of fade_pow */
+	int32_t fade_pow;			/**< fade shape at fade_ramp_time */
+#endif
 	/**< store current volume 4 times for scale_vol function */
 	int32_t *vol;
 	uint32_t initial_ramp;			/**< ramp space in ms */
@@ -155,6 +185,7 @@ struct vol_data {
 	bool vol_ramp_active;			/**< set if volume is ramped */
 	bool ramp_finished;			/**< control ramp launch */
 	vol_scale_func scale_vol;		/**< volume processing function */
+	vol_scale_ramp_func scale_vol_ramp;	/**< ramp processing function */
 	vol_zc_func zc_get;			/**< function getting nearest zero crossing frame */
 	vol_ramp_func ramp_func;		/**< function for ramp shape */
 	bool copy_gain;				/**< control copy gain or not */
@@ -162,8 +193,9 @@ struct vol_data {
 
 /** \brief Volume processing functions map. */
 struct comp_func_map {
-	uint16_t frame_fmt;	/**< frame format */
-	vol_scale_func func;	/**< volume processing function */
+	uint16_t frame_fmt;		/**< frame format */
+	vol_scale_func func;		/**< volume processing function */
+	vol_scale_ramp_func ramp_func;	/**< optional ramp processing function */
 };
 
 /** \brief Map of formats with dedicated processing functions. */
@@ -178,14 +210,20 @@ struct comp_zc_func_map {
 	vol_zc_func func;	/**< volume zc function */
 };
 
+/** \brief Map of formats with dedicated zc functions. */
+extern const struct comp_zc_func_map volume_zc_func_map[];
+
+/** \brief Number of zc functions. */
+extern const size_t volume_zc_func_count;
+
 #if CONFIG_IPC_MAJOR_3
 /**
- * \brief Retrievies volume processing function.
+ * \brief Retrievies volume processing functions map entry.
  * \param[in,out] dev Volume base component device.
  * \param[in] sinkb Sink buffer to match against
  */
-static inline vol_scale_func vol_get_processing_function(struct comp_dev *dev,
-							 struct comp_buffer __sparse_cache *sinkb)
+static inline const struct comp_func_map *
+vol_get_func_map(struct comp_dev *dev, struct comp_buffer __sparse_cache *sinkb)
 {
 	int i;
 
@@ -194,29 +232,29 @@ static inline vol_scale_func vol_get_processing_function(struct comp_dev *dev,
 		if (sinkb->stream.frame_fmt != volume_func_map[i].frame_fmt)
 			continue;
 
-		return volume_func_map[i].func;
+		return &volume_func_map[i];
 	}
 
 	return NULL;
 }
 #else
 /**
- * \brief Retrievies volume processing function.
+ * \brief Retrievies volume processing functions map entry.
  * \param[in,out] dev Volume base component device.
  * \param[in] sinkb Sink buffer to match against
  */
-static inline vol_scale_func vol_get_processing_function(struct comp_dev *dev,
-							 struct comp_buffer __sparse_cache *sinkb)
+static inline const struct comp_func_map *
+vol_get_func_map(struct comp_dev *dev, struct comp_buffer __sparse_cache *sinkb)
 {
 	struct processing_module *mod = comp_get_drvdata(dev);
 
 	switch (mod->priv.cfg.base_cfg.audio_fmt.valid_bit_depth) {
 	case IPC4_DEPTH_16BIT:
-		return volume_func_map[0].func;
+		return &volume_func_map[0];
 	case IPC4_DEPTH_24BIT:
-		return volume_func_map[1].func;
+		return &volume_func_map[1];
 	case IPC4_DEPTH_32BIT:
-		return volume_func_map[2].func;
+		return &volume_func_map[2];
 	default:
 		comp_err(dev, "vol_get_processing_function(): unsupported depth %d",
 			 mod->priv.cfg.base_cfg.audio_fmt.depth);
@@ -225,6 +263,33 @@ static inline vol_scale_func vol_get_processing_function(struct comp_dev *dev,
 }
 #endif
 
+/**
+ * \brief Retrievies volume processing function.
+ * \param[in,out] dev Volume base component device.
+ * \param[in] sinkb Sink buffer to match against
+ */
+static inline vol_scale_func vol_get_processing_function(struct comp_dev *dev,
+							 struct comp_buffer __sparse_cache *sinkb)
+{
+	const struct comp_func_map *map = vol_get_func_map(dev, sinkb);
+
+	return map ? map->func : NULL;
+}
+
+/**
+ * \brief Retrievies volume ramp processing function, NULL when the ramp
+ * segments are processed one by one with the volume processing function.
+ * \param[in,out] dev Volume base component device.
+ * \param[in] sinkb Sink buffer to match against
+ */
+static inline vol_scale_ramp_func
+vol_get_ramp_processing_function(struct comp_dev *dev, struct comp_buffer __sparse_cache *sinkb)
+{
+	const struct comp_func_map *map = vol_get_func_map(dev, sinkb);
+
+	return map ? map->ramp_func : NULL;
+}
+
 static inline void peak_vol_update(struct vol_data *cd)
 {
 #if CONFIG_COMP_PEAK_VOL
@@ -41,20 +41,33 @@ struct icomplex16 {
 	int16_t imag;
 };
 
+struct fft_table;
+
 struct fft_plan {
 	uint32_t size;	/* fft size */
 	uint32_t len;	/* fft length in exponent of 2 */
+	struct fft_table *table;	/* shared bit reverse index and twiddle table */
 	uint16_t *bit_reverse_idx;	/* pointer to bit reverse index array */
+	struct icomplex32 *twiddle32;	/* pointer to 32-bit stage twiddle factors */
+	struct icomplex16 *twiddle16;	/* pointer to 16-bit stage twiddle factors */
 	struct icomplex32 *inb32;	/* pointer to input integer complex buffer */
 	struct icomplex32 *outb32;	/* pointer to output integer complex buffer */
 	struct icomplex16 *inb16;	/* pointer to input integer complex buffer */
 	struct icomplex16 *outb16;	/* pointer to output integer complex buffer */
 };
 
+/* twiddle factor tables, defined in fft_16.c and fft_32.c */
+extern const int16_t twiddle_real_16[];
+extern const int16_t twiddle_imag_16[];
+extern const int32_t twiddle_real_32[];
+extern const int32_t twiddle_imag_32[];
+
 /* interfaces of the library */
 struct fft_plan *fft_plan_new(void *inb, void *outb, uint32_t size, int bits);
 void fft_execute_16(struct fft_plan *plan, bool ifft);
 void fft_execute_32(struct fft_plan *plan, bool ifft);
+void fft_execute_real_16(struct fft_plan *plan, bool ifft);
+void fft_execute_real_32(struct fft_plan *plan, bool ifft);
 void fft_plan_free(struct fft_plan *plan16);
 
 #endif /* __SOF_FFT_H__ */
@@ -58,4 +58,11 @@
 #endif
 #endif
 
+/* The generic version uses x86 SIMD for the filter core when available */
+#if FIR_GENERIC && defined(__SSE4_2__)
+#define FIR_X86		1
+#else
+#define FIR_X86		0
+#endif
+
 #endif /* __SOF_AUDIO_EQ_FIR_FIR_CONFIG_H__ */
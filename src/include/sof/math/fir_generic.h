@@ -25,7 +25,7 @@ struct sof_eq_fir_coef_data;
 struct fir_state_32x16 {
 	int rwi; /* Circular read and write index */
 	int taps; /* Number of FIR taps */
-	int length; /* Number of FIR taps plus input length (even) */
+	int length; /* Number of FIR taps plus max. block input length */
 	int out_shift; /* Amount of right shifts at output */
 	int16_t *coef; /* Pointer to FIR coefficients */
 	int32_t *delay; /* Pointer to FIR delay line */
@@ -40,9 +40,19 @@ int fir_init_coef(struct fir_state_32x16 *fir,
 
 void fir_init_delay(struct fir_state_32x16 *fir, int32_t **data);
 
+#if FIR_X86
+#include <sof/math/fir_x86.h>
+#else
 int32_t fir_32x16(struct fir_state_32x16 *fir, int32_t x);
 
 void fir_32x16_2x(struct fir_state_32x16 *fir, int32_t x0, int32_t x1, int32_t *y0, int32_t *y1);
 
+/* Filter n samples from x to y, x and y can be the same buffer. Four
+ * outputs are computed per pass over the coefficients, so this is
+ * preferred over calling fir_32x16() for every sample.
+ */
+void fir_32x16_block(struct fir_state_32x16 *fir, const int32_t *x, int32_t *y, int n);
+#endif
+
 #endif
 #endif /* __SOF_MATH_FIR_GENERIC_H__ */
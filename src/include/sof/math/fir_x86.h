@@ -0,0 +1,179 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2022 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SOF_MATH_FIR_X86_H__
+#define __SOF_MATH_FIR_X86_H__
+
+#include <sof/math/fir_config.h>
+
+#if FIR_X86
+
+#include <sof/audio/format.h>
+#include <immintrin.h>
+#include <stdint.h>
+
+/*
+ * The filter core is inline here so that a component built with SIMD flags
+ * gets the vectorized version also when the library itself is not. The sums
+ * are done in 64 bits the same way as in fir_generic.c so the result is bit
+ * exact with it.
+ */
+
+/* Return the sum of the two 64 bit lanes */
+static inline int64_t fir_hsum_epi64_x86(__m128i acc)
+{
+#ifdef __x86_64__
+	return _mm_cvtsi128_si64(acc) + _mm_extract_epi64(acc, 1);
+#else
+	/* The 64 bit extracts exist only in 64 bit mode */
+	int64_t y[2];
+
+	_mm_storeu_si128((__m128i *)y, acc);
+	return y[0] + y[1];
+#endif
+}
+
+/* Return the sum of coef[i] * data[-i] for i = 0 .. n - 1 */
+static inline int64_t fir_mac_32x16_x86(const int16_t *coef, const int32_t *data, int n)
+{
+	__m128i acc = _mm_setzero_si128();
+	__m128i c;
+	__m128i d;
+	int64_t y;
+	int i = 0;
+
+#ifdef __AVX2__
+	const __m256i reverse = _mm256_set_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+	__m256i acc8 = _mm256_setzero_si256();
+	__m256i c8;
+	__m256i d8;
+
+	for (; i <= n - 8; i += 8) {
+		c8 = _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i *)(coef + i)));
+		d8 = _mm256_loadu_si256((const __m256i *)(data - i - 7));
+		d8 = _mm256_permutevar8x32_epi32(d8, reverse);
+		acc8 = _mm256_add_epi64(acc8, _mm256_mul_epi32(c8, d8));
+		acc8 = _mm256_add_epi64(acc8, _mm256_mul_epi32(_mm256_srli_epi64(c8, 32),
+							       _mm256_srli_epi64(d8, 32)));
+	}
+
+	acc = _mm_add_epi64(_mm256_castsi256_si128(acc8), _mm256_extracti128_si256(acc8, 1));
+#endif
+
+	for (; i <= n - 4; i += 4) {
+		c = _mm_cvtepi16_epi32(_mm_loadl_epi64((const __m128i *)(coef + i)));
+		d = _mm_loadu_si128((const __m128i *)(data - i - 3));
+		d = _mm_shuffle_epi32(d, _MM_SHUFFLE(0, 1, 2, 3));
+		acc = _mm_add_epi64(acc, _mm_mul_epi32(c, d));
+		acc = _mm_add_epi64(acc, _mm_mul_epi32(_mm_srli_epi64(c, 32),
+						       _mm_srli_epi64(d, 32)));
+	}
+
+	y = fir_hsum_epi64_x86(acc);
+	for (; i < n; i++)
+		y += (int64_t)coef[i] * data[-i];
+
+	return y;
+}
+
+static inline int32_t fir_32x16(struct fir_state_32x16 *fir, int32_t x)
+{
+	int64_t y;
+	int32_t *data = &fir->delay[fir->rwi];
+	int n1;
+	const int length = fir->length;
+	const int taps = fir->taps;
+	const int shift = 15 + fir->out_shift;
+
+	/* Bypass is set with length set to zero. */
+	if (!fir->length)
+		return x;
+
+	/* Write sample to delay */
+	*data = x;
+
+	/* Advance write pointer and calculate into n1 max. number of taps
+	 * to process before circular wrap.
+	 */
+	n1 = ++fir->rwi;
+	if (fir->rwi == length)
+		fir->rwi = 0;
+
+	/* Part 1 before the wrap and part 2 from the end of the delay line */
+	n1 = MIN(n1, taps);
+	y = fir_mac_32x16_x86(fir->coef, data, n1);
+	y += fir_mac_32x16_x86(fir->coef + n1, &fir->delay[length - 1], taps - n1);
+
+	/* Q2.46 -> Q2.31, saturate to Q1.31 */
+	return sat_int32(y >> shift);
+}
+
+static inline void fir_32x16_2x(struct fir_state_32x16 *fir, int32_t x0, int32_t x1,
+				int32_t *y0, int32_t *y1)
+{
+	int64_t a0;
+	int64_t a1;
+	int32_t *data = &fir->delay[fir->rwi];
+	int16_t *coef = fir->coef;
+	int n1;
+	int n2;
+	const int length = fir->length;
+	const int taps = fir->taps;
+	const int shift = 15 + fir->out_shift;
+
+	/* Bypass is set with length set to zero. */
+	if (!fir->taps) {
+		*y0 = x0;
+		*y1 = x1;
+		return;
+	}
+
+	/* Write samples to delay */
+	*data = x0;
+	*(data + 1) = x1;
+
+	/* Advance write pointer and calculate into n1 max. number of taps
+	 * to process before circular wrap.
+	 */
+	n1 = fir->rwi + 1;
+	fir->rwi += 2;
+	if (fir->rwi >= length)
+		fir->rwi -= length;
+
+	/* Part 1, the second output uses the data delayed by one sample */
+	n1 = MIN(n1, taps);
+	a0 = fir_mac_32x16_x86(coef, data, n1);
+	a1 = fir_mac_32x16_x86(coef, data + 1, n1);
+
+	/* Part 2, un-wrap data. The first tap of the second output uses the
+	 * last sample of part 1.
+	 */
+	n2 = taps - n1;
+	if (n2 > 0) {
+		a0 += fir_mac_32x16_x86(coef + n1, &fir->delay[length - 1], n2);
+		a1 += (int64_t)coef[n1] * data[1 - n1];
+		a1 += fir_mac_32x16_x86(coef + n1 + 1, &fir->delay[length - 1], n2 - 1);
+	}
+
+	/* Q2.46 -> Q2.31, saturate to Q1.31 */
+	*y0 = sat_int32(a0 >> shift);
+	*y1 = sat_int32(a1 >> shift);
+}
+
+/* Filter n samples from x to y, x and y can be the same buffer. The single
+ * sample version is vectorized over the taps, it is faster than computing
+ * four outputs per pass with scalar code.
+ */
+static inline void fir_32x16_block(struct fir_state_32x16 *fir, const int32_t *x,
+				   int32_t *y, int n)
+{
+	int i;
+
+	for (i = 0; i < n; i++)
+		y[i] = fir_32x16(fir, x[i]);
+}
+
+#endif /* FIR_X86 */
+#endif /* __SOF_MATH_FIR_X86_H__ */
@@ -37,6 +37,23 @@ struct iir_state_df1 {
 	int32_t *delay; /* Pointer to IIR delay line */
 };
 
+/* Same biquads for all channels with coefficients and states interleaved
+ * across channels. Coefficients of biquad b and channel ch are in
+ * coef[(b * SOF_EQ_IIR_NBIQUAD + i) * channels + ch] and states in
+ * delay[(b * IIR_DF1_NUM_STATE + i) * channels + ch].
+ */
+struct iir_state_df1_multich {
+	unsigned int channels; /* Number of interleaved channels */
+	unsigned int biquads; /* Number of IIR 2nd order sections total */
+	unsigned int biquads_in_series; /* Number of IIR 2nd order sections
+					 * in series.
+					 */
+	int32_t *coef; /* Pointer to interleaved IIR coefficients */
+	int32_t *delay; /* Pointer to interleaved IIR states */
+	int64_t *out; /* Sum of parallel sections, one per channel */
+	int32_t *in; /* Section input, one per channel */
+};
+
 struct sof_eq_iir_header;
 
 int iir_init_coef_df1(struct iir_state_df1 *iir,
@@ -50,6 +67,14 @@ void iir_reset_df1(struct iir_state_df1 *iir);
 
 int32_t iir_df1(struct iir_state_df1 *iir, int32_t x);
 
+int iir_multich_size_df1(struct iir_state_df1 iir[], int nch);
+
+void iir_init_multich_df1(struct iir_state_df1_multich *mc,
+			  struct iir_state_df1 iir[], int nch, void *data);
+
+void iir_df1_multich(struct iir_state_df1_multich *iir, const int32_t *x,
+		     int32_t *y, int frames);
+
 /* Inline functions */
 #if IIR_DF1_HIFI3
 #include "iir_df1_hifi3.h"
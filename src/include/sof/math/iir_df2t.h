@@ -58,6 +58,23 @@ struct iir_state_df2t {
 	int64_t *delay; /* Pointer to IIR delay line */
 };
 
+/* Same biquads for all channels with coefficients and delays interleaved
+ * across channels. Coefficients of biquad b and channel ch are in
+ * coef[(b * SOF_EQ_IIR_NBIQUAD + i) * channels + ch] and delays in
+ * delay[(b * IIR_DF2T_NUM_DELAYS + i) * channels + ch].
+ */
+struct iir_state_df2t_multich {
+	unsigned int channels; /* Number of interleaved channels */
+	unsigned int biquads; /* Number of IIR 2nd order sections total */
+	unsigned int biquads_in_series; /* Number of IIR 2nd order sections
+					 * in series.
+					 */
+	int32_t *coef; /* Pointer to interleaved IIR coefficients */
+	int64_t *delay; /* Pointer to interleaved IIR delay lines */
+	int64_t *out; /* Sum of parallel sections, one per channel */
+	int32_t *in; /* Section input, one per channel */
+};
+
 struct sof_eq_iir_header;
 
 int iir_init_coef_df2t(struct iir_state_df2t *iir,
@@ -75,6 +92,14 @@ void iir_reset_df2t(struct iir_state_df2t *iir);
 
 int32_t iir_df2t(struct iir_state_df2t *iir, int32_t x);
 
+int iir_multich_size_df2t(struct iir_state_df2t iir[], int nch);
+
+void iir_init_multich_df2t(struct iir_state_df2t_multich *mc,
+			   struct iir_state_df2t iir[], int nch, void *data);
+
+void iir_df2t_multich(struct iir_state_df2t_multich *iir, const int32_t *x,
+		      int32_t *y, int frames);
+
 /* Inline functions with or without HiFi3 intrinsics */
 #if IIR_HIFI3
 #include "iir_df2t_hifi3.h"
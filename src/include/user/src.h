@@ -0,0 +1,67 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2022 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __USER_SRC_H__
+#define __USER_SRC_H__
+
+#include <stdint.h>
+
+#define SOF_SRC_MAX_SIZE	(256 * 1024)	/* Max size for coef data in bytes */
+#define SOF_SRC_MAX_STAGES	2		/* A conversion has one or two stages */
+
+/*
+ * SRC coefficients blob, the rate pairs not listed in the blob use the
+ * coefficients built in the firmware if any.
+ *
+ * struct sof_src_config
+ *	struct sof_src_conversion conversion1
+ *		struct sof_src_stage stage1	coefficients 64 bit aligned
+ *		struct sof_src_stage stage2	optional, num_stages = 2
+ *	struct sof_src_conversion conversion2
+ *		...
+ *
+ * The coefficients are int16_t or int32_t as set in coef_bits, it must
+ * match the filter core of the firmware. The structs have no padding.
+ */
+
+struct sof_src_config {
+	uint32_t size;			/* Size of entire struct */
+	uint16_t num_conversions;	/* Number of conversions in data */
+	uint16_t coef_bits;		/* 16 or 32 */
+
+	/* reserved */
+	uint32_t reserved[4];
+
+	uint32_t data[];
+};
+
+struct sof_src_conversion {
+	uint32_t size;			/* Size of conversion including stages */
+	uint32_t source_rate;		/* Input rate in Hz */
+	uint32_t sink_rate;		/* Output rate in Hz */
+	uint16_t num_stages;		/* 1 or 2 */
+	uint16_t reserved16;
+	uint32_t reserved[2];
+
+	uint32_t data[];
+};
+
+/* The fields match struct src_stage */
+struct sof_src_stage {
+	uint32_t size;			/* Size of stage including coefficients */
+	int32_t idm;
+	int32_t odm;
+	int32_t num_of_subfilters;
+	int32_t subfilter_length;
+	int32_t filter_length;
+	int32_t blk_in;
+	int32_t blk_out;
+	int32_t halfband;
+	int32_t shift;
+
+	uint32_t data[];		/* filter_length coefficients */
+};
+
+#endif /* __USER_SRC_H__ */
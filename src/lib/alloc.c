@@ -95,6 +95,79 @@ static inline uint32_t heap_get_size(struct mm_heap *heap)
 	return size;
 }
 
+/*
+ * Each block map has a bitmap with a bit set for every free block. Block 0 is
+ * the MSB of word 0, so the first free block in a word is found with a single
+ * count leading zeros instead of walking the block headers.
+ */
+#define FREE_MAP_WORDS(count)	((count) / 32 + 1)
+
+/* set or clear the free bits of count blocks beginning at start */
+static void free_map_update(struct block_map *map, unsigned int start,
+			    unsigned int count, bool free)
+{
+	unsigned int end = start + count;
+	unsigned int word;
+	uint32_t mask;
+
+	while (start < end) {
+		word = start >> 5;
+		mask = UINT32_MAX >> (start & 31);
+		if (end >> 5 == word)
+			mask &= ~(UINT32_MAX >> (end & 31));
+
+		if (free)
+			map->free_map[word] |= mask;
+		else
+			map->free_map[word] &= ~mask;
+
+		start = (word + 1) << 5;
+	}
+}
+
+/* index of the first free (or used) block from start on, map->count if none */
+static unsigned int free_map_find(struct block_map *map, unsigned int start,
+				  bool free)
+{
+	unsigned int words = FREE_MAP_WORDS(map->count);
+	uint32_t invert = free ? 0 : UINT32_MAX;
+	unsigned int word = start >> 5;
+	uint32_t bits;
+
+	if (start >= map->count)
+		return map->count;
+
+	bits = (map->free_map[word] ^ invert) & (UINT32_MAX >> (start & 31));
+	while (!bits) {
+		if (++word == words)
+			return map->count;
+
+		bits = map->free_map[word] ^ invert;
+	}
+
+	/* bits past the end of the map are never free */
+	return MIN((word << 5) + clz(bits), map->count);
+}
+
+#if CONFIG_DEBUG_MEMORY_USAGE_SCAN
+/* largest number of consecutive free blocks in the map */
+static unsigned int free_map_max_run(struct block_map *map)
+{
+	unsigned int max = 0;
+	unsigned int start;
+	unsigned int end;
+
+	for (start = free_map_find(map, map->first_free, true);
+	     start < map->count;
+	     start = free_map_find(map, end, true)) {
+		end = free_map_find(map, start, false);
+		max = MAX(max, end - start);
+	}
+
+	return max;
+}
+#endif
+
 #if CONFIG_DEBUG_BLOCK_FREE
 static void write_pattern(struct mm_heap *heap_map, int heap_depth,
 			  uint8_t pattern)
@@ -117,7 +190,7 @@ static void write_pattern(struct mm_heap *heap_map, int heap_depth,
 }
 #endif
 
-static void init_heap_map(struct mm_heap *heap, int count)
+static void init_heap_map(struct mm *memmap, struct mm_heap *heap, int count)
 {
 	struct block_map *next_map;
 	struct block_map *current_map;
@@ -139,6 +212,65 @@ static void init_heap_map(struct mm_heap *heap, int count)
 			current_map = &heap[i].map[j];
 		}
 
+		/* keep the heap index sorted by address */
+		if (!heap[i].size)
+			continue;
+
+		for (j = memmap->heap_index_count; j > 0; j--) {
+			if (memmap->heap_index[j - 1]->heap < heap[i].heap)
+				break;
+
+			memmap->heap_index[j] = memmap->heap_index[j - 1];
+		}
+
+		memmap->heap_index[j] = &heap[i];
+		memmap->heap_index_count++;
+	}
+}
+
+/*
+ * The free bitmaps are carved from the top of the primary core system heap,
+ * which is shrunk so they can be neither allocated nor reset. The block maps
+ * are shared between cores, so the bitmaps are accessed uncached the same way
+ * as the block headers.
+ */
+static void init_heap_free_maps(struct mm *memmap)
+{
+	struct mm_heap *sys = memmap->system;
+	struct block_map *map;
+	uint32_t *free_map;
+	uintptr_t start;
+	size_t words = 0;
+	size_t bytes;
+	int i;
+	int j;
+
+	for (i = 0; i < memmap->heap_index_count; i++)
+		for (j = 0; j < memmap->heap_index[i]->blocks; j++)
+			words += FREE_MAP_WORDS(memmap->heap_index[i]->map[j].count);
+
+	start = ALIGN_DOWN(sys->heap + sys->size - words * sizeof(uint32_t),
+			   PLATFORM_DCACHE_ALIGN);
+	bytes = sys->heap + sys->size - start;
+	if (bytes > sys->info.free) {
+		tr_err(&mem_tr, "init_heap_free_maps(): no space for %d bytes", bytes);
+		sof_panic(SOF_IPC_PANIC_MEM);
+	}
+
+	sys->size -= bytes;
+	sys->info.free -= bytes;
+
+	dcache_writeback_invalidate_region((void *)start, bytes);
+	free_map = cache_to_uncache((uint32_t *)start);
+	bzero(free_map, bytes);
+
+	for (i = 0; i < memmap->heap_index_count; i++) {
+		for (j = 0; j < memmap->heap_index[i]->blocks; j++) {
+			map = &memmap->heap_index[i]->map[j];
+			map->free_map = free_map;
+			free_map_update(map, 0, map->count, true);
+			free_map += FREE_MAP_WORDS(map->count);
+		}
 	}
 }
 
@@ -168,6 +300,7 @@ static void *rmalloc_sys(struct mm_heap *heap, uint32_t flags, int caps, size_t
 
 	heap->info.used += bytes;
 	heap->info.free -= alignment + bytes;
+	heap->info.alloc_count++;
 
 	return ptr;
 }
@@ -195,12 +328,12 @@ static void *alloc_block_index(struct mm_heap *heap, int level,
 	struct block_map *map = &heap->map[level];
 	struct block_hdr *hdr;
 	void *ptr;
-	int i;
 
 	if (index < 0)
 		index = map->first_free;
 
 	map->free_count--;
+	free_map_update(map, index, 1, false);
 
 	hdr = &map->block[index];
 	ptr = (void *)(map->base + index * map->block_size);
@@ -212,16 +345,9 @@ static void *alloc_block_index(struct mm_heap *heap, int level,
 	heap->info.used += map->block_size;
 	heap->info.free -= map->block_size;
 
+	/* find next free */
 	if (index == map->first_free)
-		/* find next free */
-		for (i = map->first_free; i < map->count; ++i) {
-			hdr = &map->block[i];
-
-			if (hdr->used == 0) {
-				map->first_free = i;
-				break;
-			}
-		}
+		map->first_free = free_map_find(map, index + 1, true);
 
 	return ptr;
 }
@@ -241,9 +367,10 @@ static void *alloc_cont_blocks(struct mm_heap *heap, int level,
 	void *ptr = NULL, *unaligned_ptr;
 	unsigned int current;
 	unsigned int count = 0;			/* keep compiler quiet */
-	unsigned int start = 0;			/* keep compiler quiet */
+	unsigned int start;
+	unsigned int end;
 	uintptr_t blk_start = 0, aligned = 0;	/* keep compiler quiet */
-	size_t found = 0, total_bytes = bytes;
+	size_t total_bytes = bytes;
 
 	/* check if we have enough consecutive blocks for requested
 	 * allocation size.
@@ -252,55 +379,35 @@ static void *alloc_cont_blocks(struct mm_heap *heap, int level,
 		return NULL;
 
 	/*
-	 * Walk all blocks in the map, beginning with the first free one, until
-	 * a sufficiently large sequence is found, in which the first block
-	 * contains an address with the requested alignment.
+	 * Walk the runs of free blocks in the map, beginning with the first
+	 * free one, until a sufficiently large run is found, in which the
+	 * first block contains an address with the requested alignment.
 	 */
-	for (current = map->first_free, hdr = map->block + current;
-	     current < map->count && found < total_bytes;
-	     current++, hdr++) {
-		if (hdr->used) {
-			/* Restart the search */
-			found = 0;
-			count = 0;
-			total_bytes = bytes;
-			continue;
+	for (start = free_map_find(map, map->first_free, true);
+	     start < map->count;
+	     start = free_map_find(map, end, true)) {
+		end = free_map_find(map, start, false);
+
+		/* skip blocks which can't begin an aligned sequence */
+		for (; start < end; start++) {
+			blk_start = map->base + start * map->block_size;
+			aligned = alignment ? ALIGN_UP(blk_start, alignment) :
+				blk_start;
+
+			if (aligned < blk_start + map->block_size)
+				break;
 		}
 
-		if (!found) {
-			/* A possible beginning of a sequence */
-			blk_start = map->base + current * map->block_size;
-			start = current;
-
-			/* Check if we can start a sequence here */
-			if (alignment) {
-				aligned = ALIGN_UP(blk_start, alignment);
-
-				if (blk_start & (alignment - 1) &&
-				    aligned >= blk_start + map->block_size)
-					/*
-					 * This block doesn't contain an address
-					 * with required alignment, it is useless
-					 * as the beginning of the sequence
-					 */
-					continue;
-
-				/*
-				 * Found a potentially suitable beginning of a
-				 * sequence, from here we'll check if we get
-				 * enough blocks
-				 */
-				total_bytes += aligned - blk_start;
-			} else {
-				aligned = blk_start;
-			}
-		}
+		if (start == end)
+			continue;
 
-		count++;
-		found += map->block_size;
+		total_bytes = bytes + aligned - blk_start;
+		count = SOF_DIV_ROUND_UP(total_bytes, map->block_size);
+		if (count <= end - start)
+			break;
 	}
 
-	if (found < total_bytes) {
+	if (start >= map->count) {
 		tr_err(&mem_tr, "failed to allocate %u", total_bytes);
 		goto out;
 	}
@@ -309,6 +416,7 @@ static void *alloc_cont_blocks(struct mm_heap *heap, int level,
 
 	/* we found enough space, let's allocate it */
 	map->free_count -= count;
+	free_map_update(map, start, count, false);
 	unaligned_ptr = (void *)blk_start;
 
 	hdr = &map->block[start];
@@ -321,14 +429,8 @@ static void *alloc_cont_blocks(struct mm_heap *heap, int level,
 	 * if .first_free has to be updated, set it to first free block or past
 	 * the end of the map
 	 */
-	if (map->first_free == start) {
-		for (current = map->first_free + count, hdr = &map->block[current];
-		     current < map->count && hdr->used;
-		     current++, hdr++)
-			;
-
-		map->first_free = current;
-	}
+	if (map->first_free == start)
+		map->first_free = free_map_find(map, start + count, true);
 
 	/* update each block */
 	for (current = start; current < start + count; current++) {
@@ -342,47 +444,36 @@ out:
 	return ptr;
 }
 
-static inline struct mm_heap *find_in_heap_arr(struct mm_heap *heap_arr, int arr_len, void *ptr)
-{
-	struct mm_heap *heap;
-	int i;
-
-	for (i = 0; i < arr_len; i++) {
-		heap = &heap_arr[i];
-		if ((uint32_t)ptr >= heap->heap &&
-		    (uint32_t)ptr < heap->heap + heap->size)
-			return heap;
-	}
-	return NULL;
-}
-
 static struct mm_heap *get_heap_from_ptr(void *ptr)
 {
 	struct mm *memmap = memmap_get();
 	struct mm_heap *heap;
+	uintptr_t addr = (uintptr_t)ptr;
+	int low = 0;
+	int high = memmap->heap_index_count - 1;
+	int mid;
 
 	/* find mm_heap that ptr belongs to */
-	heap = find_in_heap_arr(memmap->system_runtime + cpu_get_id(), 1, ptr);
-	if (heap)
-		goto out;
-
-	heap = find_in_heap_arr(memmap->runtime, PLATFORM_HEAP_RUNTIME, ptr);
-	if (heap)
-		goto out;
-
-#if CONFIG_CORE_COUNT > 1
-	heap = find_in_heap_arr(memmap->runtime_shared, PLATFORM_HEAP_RUNTIME_SHARED, ptr);
-	if (heap)
-		goto out;
-#endif
-
-	heap = find_in_heap_arr(memmap->buffer, PLATFORM_HEAP_BUFFER, ptr);
-	if (heap)
-		goto out;
+	while (low <= high) {
+		mid = (low + high) / 2;
+		heap = memmap->heap_index[mid];
+
+		if (addr < heap->heap)
+			high = mid - 1;
+		else if (addr >= heap->heap + heap->size)
+			low = mid + 1;
+		else
+			goto out;
+	}
 
 	return NULL;
 
 out:
+	/* system runtime heaps can only be freed by their own core */
+	if (heap >= memmap->system_runtime &&
+	    heap < memmap->system_runtime + PLATFORM_HEAP_SYSTEM_RUNTIME &&
+	    heap != memmap->system_runtime + cpu_get_id())
+		return NULL;
 
 	return heap;
 }
@@ -444,6 +535,11 @@ static void *get_ptr_from_heap(struct mm_heap *heap, uint32_t flags,
 		break;
 	}
 
+	if (ptr)
+		heap->info.alloc_count++;
+	else
+		heap->info.fail_count++;
+
 	return ptr;
 }
 
@@ -540,6 +636,8 @@ static void free_block(void *ptr)
 		heap->info.free += block_map->block_size;
 	}
 
+	free_map_update(block_map, block, used_blocks - block, true);
+
 	/* set first free block */
 	if (block < block_map->first_free || heap_is_full)
 		block_map->first_free = block;
@@ -824,7 +922,6 @@ static void *alloc_heap_buffer(struct mm_heap *heap, uint32_t flags,
 
 	/* will request fit in single block */
 	for (i = 0, map = heap->map; i < heap->blocks; i++, map++) {
-		struct block_hdr *hdr;
 		uintptr_t free_start;
 
 		if (map->block_size < bytes || !map->free_count)
@@ -844,15 +941,12 @@ static void *alloc_heap_buffer(struct mm_heap *heap, uint32_t flags,
 		 * For performance reasons we could first check the power-of-2
 		 * case. This can be added as an optimization later.
 		 */
-		for (j = map->first_free, hdr = map->block + j,
-		     free_start = map->base + map->block_size * j;
+		for (j = free_map_find(map, map->first_free, true);
 		     j < map->count;
-		     j++, hdr++, free_start += map->block_size) {
+		     j = free_map_find(map, j + 1, true)) {
 			uintptr_t aligned;
 
-			if (hdr->used)
-				continue;
-
+			free_start = map->base + map->block_size * j;
 			aligned = ALIGN_UP(free_start, alignment);
 
 			if (aligned + bytes > free_start + map->block_size)
@@ -902,6 +996,11 @@ static void *alloc_heap_buffer(struct mm_heap *heap, uint32_t flags,
 		bzero(ptr, temp_bytes);
 #endif
 
+	if (ptr)
+		heap->info.alloc_count++;
+	else
+		heap->info.fail_count++;
+
 	return ptr;
 }
 
@@ -1070,15 +1169,19 @@ void init_heap(struct sof *sof)
 		sof_panic(SOF_IPC_PANIC_MEM);
 #endif
 
-	init_heap_map(memmap->system_runtime, PLATFORM_HEAP_SYSTEM_RUNTIME);
+	memmap->heap_index_count = 0;
 
-	init_heap_map(memmap->runtime, PLATFORM_HEAP_RUNTIME);
+	init_heap_map(memmap, memmap->system_runtime, PLATFORM_HEAP_SYSTEM_RUNTIME);
+
+	init_heap_map(memmap, memmap->runtime, PLATFORM_HEAP_RUNTIME);
 
 #if CONFIG_CORE_COUNT > 1
-	init_heap_map(memmap->runtime_shared, PLATFORM_HEAP_RUNTIME_SHARED);
+	init_heap_map(memmap, memmap->runtime_shared, PLATFORM_HEAP_RUNTIME_SHARED);
 #endif
 
-	init_heap_map(memmap->buffer, PLATFORM_HEAP_BUFFER);
+	init_heap_map(memmap, memmap->buffer, PLATFORM_HEAP_BUFFER);
+
+	init_heap_free_maps(memmap);
 
 #if CONFIG_DEBUG_BLOCK_FREE
 	write_pattern((struct mm_heap *)&memmap->buffer, PLATFORM_HEAP_BUFFER,
@@ -1095,7 +1198,9 @@ int heap_info(enum mem_zone zone, int index, struct mm_info *out)
 {
 	struct mm *memmap = memmap_get();
 	struct mm_heap *heap;
+	struct block_map *map;
 	k_spinlock_key_t key;
+	int i;
 
 	if (!out)
 		goto error;
@@ -1139,6 +1244,15 @@ int heap_info(enum mem_zone zone, int index, struct mm_info *out)
 
 	key = k_spin_lock(&memmap->lock);
 	*out = heap->info;
+
+	/* the system heaps have no block maps and never fragment */
+	out->free_max = heap->blocks ? 0 : heap->info.free;
+	for (i = 0; i < heap->blocks; i++) {
+		map = &heap->map[i];
+		out->free_max = MAX(out->free_max,
+				    free_map_max_run(map) * map->block_size);
+	}
+
 	k_spin_unlock(&memmap->lock, key);
 	return 0;
 error:
@@ -8,9 +8,9 @@
 #include <sof/audio/format.h>
 #include <sof/common.h>
 #include <sof/math/fft.h>
+#include <sof/audio/coefficients/fft/twiddle_16.h>
 
 #ifdef FFT_GENERIC
-#include <sof/audio/coefficients/fft/twiddle_16.h>
 
 /*
  * Helpers for 16 bit FFT calculation
@@ -63,6 +63,86 @@ static inline void icomplex16_shift(const struct icomplex16 *input, int16_t n,
 	}
 }
 
+/*
+ * One radix-2 pass over all transforms of size 2^depth, the stage twiddle
+ * factors are read sequentially from the plan stage twiddle table.
+ */
+static void fft_radix2_stage_16(struct icomplex16 *outb, const struct icomplex16 *twiddle,
+				int size, int depth)
+{
+	struct icomplex16 tmp1;
+	struct icomplex16 tmp2;
+	int m = 1 << depth;
+	int n = m >> 1;
+	const struct icomplex16 *tw = twiddle + n - 1;
+	int top;
+	int bottom;
+	int j;
+	int k;
+
+	/* doing FFT transforms in size m */
+	for (k = 0; k < size; k += m) {
+		/* doing one FFT transform for size m */
+		for (j = 0; j < n; ++j) {
+			top = k + j;
+			bottom = top + n;
+			/* calculate the accumulator: twiddle * bottom */
+			icomplex16_mul(&tw[j], &outb[bottom], &tmp2);
+			tmp1 = outb[top];
+			/* calculate the top output: top = top + accumulate */
+			icomplex16_add(&tmp1, &tmp2, &outb[top]);
+			/* calculate the bottom output: bottom = top - accumulate */
+			icomplex16_sub(&tmp1, &tmp2, &outb[bottom]);
+		}
+	}
+}
+
+/*
+ * Radix-4 pass that merges the radix-2 stages depth and depth + 1, bit exact with
+ * two fft_radix2_stage_16() calls but with one load and store per point.
+ */
+static void fft_radix4_stage_16(struct icomplex16 *outb, const struct icomplex16 *twiddle,
+				int size, int depth)
+{
+	struct icomplex16 x0;
+	struct icomplex16 x1;
+	struct icomplex16 x2;
+	struct icomplex16 x3;
+	struct icomplex16 tmp;
+	int n = 1 << (depth - 1);
+	int m = n << 2;
+	const struct icomplex16 *tw1 = twiddle + n - 1;
+	const struct icomplex16 *tw2 = twiddle + 2 * n - 1;
+	int p0, p1, p2, p3;
+	int j;
+	int k;
+
+	for (k = 0; k < size; k += m) {
+		for (j = 0; j < n; ++j) {
+			p0 = k + j;
+			p1 = p0 + n;
+			p2 = p1 + n;
+			p3 = p2 + n;
+
+			/* first stage butterflies (p0, p1) and (p2, p3) */
+			icomplex16_mul(&tw1[j], &outb[p1], &tmp);
+			icomplex16_add(&outb[p0], &tmp, &x0);
+			icomplex16_sub(&outb[p0], &tmp, &x1);
+			icomplex16_mul(&tw1[j], &outb[p3], &tmp);
+			icomplex16_add(&outb[p2], &tmp, &x2);
+			icomplex16_sub(&outb[p2], &tmp, &x3);
+
+			/* second stage butterflies (p0, p2) and (p1, p3) */
+			icomplex16_mul(&tw2[j], &x2, &tmp);
+			icomplex16_add(&x0, &tmp, &outb[p0]);
+			icomplex16_sub(&x0, &tmp, &outb[p2]);
+			icomplex16_mul(&tw2[j + n], &x3, &tmp);
+			icomplex16_add(&x1, &tmp, &outb[p1]);
+			icomplex16_sub(&x1, &tmp, &outb[p3]);
+		}
+	}
+}
+
 /**
  * \brief Execute the 16-bits Fast Fourier Transform (FFT) or Inverse FFT (IFFT)
  *	  For the configured fft_pan.
@@ -71,21 +151,12 @@ static inline void icomplex16_shift(const struct icomplex16 *input, int16_t n,
  */
 void fft_execute_16(struct fft_plan *plan, bool ifft)
 {
-	struct icomplex16 tmp1;
-	struct icomplex16 tmp2;
 	struct icomplex16 *inb;
 	struct icomplex16 *outb;
-	int depth;
-	int top;
-	int bottom;
-	int index;
+	int depth = 1;
 	int i;
-	int j;
-	int k;
-	int m;
-	int n;
 
-	if (!plan || !plan->bit_reverse_idx)
+	if (!plan || !plan->bit_reverse_idx || !plan->twiddle16)
 		return;
 
 	inb = plan->inb16;
@@ -100,34 +171,17 @@ void fft_execute_16(struct fft_plan *plan, bool ifft)
 	}
 
 	/* step 1: re-arrange input in bit reverse order, and shrink the level to avoid overflow */
-	for (i = 1; i < plan->size; ++i)
+	for (i = 0; i < plan->size; ++i)
 		icomplex16_shift(&inb[i], -(plan->len), &outb[plan->bit_reverse_idx[i]]);
 
-	/* step 2: loop to do FFT transform in smaller size */
-	for (depth = 1; depth <= plan->len; ++depth) {
-		m = 1 << depth;
-		n = m >> 1;
-		i = FFT_SIZE_MAX >> depth;
-
-		/* doing FFT transforms in size m */
-		for (k = 0; k < plan->size; k += m) {
-			/* doing one FFT transform for size m */
-			for (j = 0; j < n; ++j) {
-				index = i * j;
-				top = k + j;
-				bottom = top + n;
-				tmp1.real = twiddle_real_16[index];
-				tmp1.imag = twiddle_imag_16[index];
-				/* calculate the accumulator: twiddle * bottom */
-				icomplex16_mul(&tmp1, &outb[bottom], &tmp2);
-				tmp1 = outb[top];
-				/* calculate the top output: top = top + accumulate */
-				icomplex16_add(&tmp1, &tmp2, &outb[top]);
-				/* calculate the bottom output: bottom = top - accumulate */
-				icomplex16_sub(&tmp1, &tmp2, &outb[bottom]);
-			}
-		}
-	}
+	/* step 2: loop to do FFT transform in smaller size, an odd stage count starts
+	 * with one radix-2 pass and the rest is done in radix-4 passes
+	 */
+	if (plan->len & 1)
+		fft_radix2_stage_16(outb, plan->twiddle16, plan->size, depth++);
+
+	for (; depth < plan->len; depth += 2)
+		fft_radix4_stage_16(outb, plan->twiddle16, plan->size, depth);
 
 	/* shift back for ifft */
 	if (ifft) {
@@ -141,3 +195,131 @@ void fft_execute_16(struct fft_plan *plan, bool ifft)
 	}
 }
 #endif
+
+/*
+ * Split step of the real input FFT, see fft_real_split_32(). Products with the
+ * Q1.15 twiddles are rounded like in the complex transform.
+ */
+static void fft_real_split_16(struct icomplex16 *outb, int size, int stride)
+{
+	struct icomplex16 a;
+	struct icomplex16 b;
+	int32_t er, ei, or, oi;
+	int32_t tr, ti;
+	int32_t twr, twi;
+	int k;
+	int m;
+
+	a = outb[0];
+	outb[0].real = ((int32_t)a.real + a.imag) >> 1;
+	outb[0].imag = 0;
+	outb[size].real = ((int32_t)a.real - a.imag) >> 1;
+	outb[size].imag = 0;
+
+	for (k = 1; k <= size >> 1; k++) {
+		m = size - k;
+		a = outb[k];
+		b = outb[m];
+		er = ((int32_t)a.real + b.real) >> 1;
+		ei = ((int32_t)a.imag - b.imag) >> 1;
+		or = ((int32_t)a.real - b.real) >> 1;
+		oi = ((int32_t)a.imag + b.imag) >> 1;
+
+		/* W^k * (O / j) where the division by j is (oi, -or) */
+		twr = twiddle_real_16[k * stride];
+		twi = twiddle_imag_16[k * stride];
+		tr = Q_SHIFT_RND(twr * oi + twi * or, 30, 15);
+		ti = Q_SHIFT_RND(twi * oi - twr * or, 30, 15);
+
+		outb[k].real = sat_int16((er + tr) >> 1);
+		outb[k].imag = sat_int16((ei + ti) >> 1);
+		if (m != k) {
+			/* W^(N - k) is -conj(W^k) */
+			outb[m].real = sat_int16((er - tr) >> 1);
+			outb[m].imag = sat_int16((ti - ei) >> 1);
+		}
+	}
+}
+
+/*
+ * Inverse of fft_real_split_16(), the result is scaled by 1/2 to keep it in
+ * Q1.15 range.
+ */
+static void fft_real_merge_16(struct icomplex16 *inb, int size, int stride)
+{
+	struct icomplex16 a;
+	struct icomplex16 b;
+	int32_t er, ei, or, oi;
+	int32_t tr, ti;
+	int32_t twr, twi;
+	int k;
+	int m;
+
+	a = inb[0];
+	b = inb[size];
+	er = ((int32_t)a.real + b.real) >> 1;
+	ei = ((int32_t)a.imag - b.imag) >> 1;
+	or = ((int32_t)a.real - b.real) >> 1;
+	oi = ((int32_t)a.imag + b.imag) >> 1;
+	inb[0].real = sat_int16(er - oi);
+	inb[0].imag = sat_int16(ei + or);
+
+	for (k = 1; k <= size >> 1; k++) {
+		m = size - k;
+		a = inb[k];
+		b = inb[m];
+		er = ((int32_t)a.real + b.real) >> 1;
+		ei = ((int32_t)a.imag - b.imag) >> 1;
+		or = ((int32_t)a.real - b.real) >> 1;
+		oi = ((int32_t)a.imag + b.imag) >> 1;
+
+		/* j * conj(W^k) * O */
+		twr = twiddle_real_16[k * stride];
+		twi = twiddle_imag_16[k * stride];
+		tr = Q_SHIFT_RND(twi * or - twr * oi, 30, 15);
+		ti = Q_SHIFT_RND(twi * oi + twr * or, 30, 15);
+
+		inb[k].real = sat_int16(er + tr);
+		inb[k].imag = sat_int16(ei + ti);
+		if (m != k) {
+			inb[m].real = sat_int16(er - tr);
+			inb[m].imag = sat_int16(ti - ei);
+		}
+	}
+}
+
+/**
+ * \brief Execute the 16-bits FFT for real input or IFFT for real output of
+ *	  2 * plan->size points, see fft_execute_real_32() for the buffer layout.
+ * \param[in] plan - pointer to fft_plan of half of the real transform size.
+ * \param[in] ifft - set to 1 for IFFT and 0 for FFT.
+ */
+void fft_execute_real_16(struct fft_plan *plan, bool ifft)
+{
+	int16_t *out;
+	int stride;
+	int i;
+
+	if (!plan || !plan->inb16 || !plan->outb16)
+		return;
+
+	if (plan->size > FFT_SIZE_MAX / 2)
+		return;
+
+	stride = FFT_SIZE_MAX >> (plan->len + 1);
+	if (!ifft) {
+		fft_execute_16(plan, false);
+		fft_real_split_16(plan->outb16, plan->size, stride);
+		return;
+	}
+
+	fft_real_merge_16(plan->inb16, plan->size, stride);
+	fft_execute_16(plan, true);
+
+	/* compensate the 1/2 scale of the merge and the conjugated IFFT output */
+	out = (int16_t *)plan->outb16;
+	for (i = 0; i < 2 * plan->size; i += 2) {
+		out[i] = sat_int16((int32_t)out[i] << 1);
+		out[i + 1] = sat_int16(-((int32_t)out[i + 1] << 1));
+	}
+}
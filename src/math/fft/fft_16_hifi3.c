@@ -9,7 +9,6 @@
 #include <sof/math/fft.h>
 
 #ifdef FFT_HIFI3
-#include <sof/audio/coefficients/fft/twiddle_16.h>
 #include <xtensa/tie/xt_hifi3.h>
 
 /**
@@ -54,8 +53,8 @@ void fft_execute_16(struct fft_plan *plan, bool ifft)
 	}
 
 	/* step 1: re-arrange input in bit reverse order, and shrink the level to avoid overflow */
-	in = (ae_int16 *)&plan->inb16[1];
-	for (i = 1; i < size ; ++i) {
+	in = (ae_int16 *)&plan->inb16[0];
+	for (i = 0; i < size ; ++i) {
 		out = (ae_int16 *)&outb[plan->bit_reverse_idx[i]];
 		AE_L16_IP(sample, in, 2);
 		sample = AE_SRAA16RS(sample, len);
@@ -9,9 +9,9 @@
 #include <sof/common.h>
 #include <rtos/alloc.h>
 #include <sof/math/fft.h>
+#include <sof/audio/coefficients/fft/twiddle_32.h>
 
 #ifdef FFT_GENERIC
-#include <sof/audio/coefficients/fft/twiddle_32.h>
 
 /*
  * These helpers are optimized for FFT calculation only.
@@ -60,6 +60,87 @@ static inline void icomplex32_shift(const struct icomplex32 *input, int32_t n,
 	}
 }
 
+/*
+ * One radix-2 pass over all transforms of size 2^depth, the stage twiddle
+ * factors are read sequentially from the plan stage twiddle table.
+ */
+static void fft_radix2_stage_32(struct icomplex32 *outb, const struct icomplex32 *twiddle,
+				int size, int depth)
+{
+	struct icomplex32 tmp1;
+	struct icomplex32 tmp2;
+	int m = 1 << depth;
+	int n = m >> 1;
+	const struct icomplex32 *tw = twiddle + n - 1;
+	int top;
+	int bottom;
+	int j;
+	int k;
+
+	/* doing FFT transforms in size m */
+	for (k = 0; k < size; k += m) {
+		/* doing one FFT transform for size m */
+		for (j = 0; j < n; ++j) {
+			top = k + j;
+			bottom = top + n;
+			/* calculate the accumulator: twiddle * bottom */
+			icomplex32_mul(&tw[j], &outb[bottom], &tmp2);
+			tmp1 = outb[top];
+			/* calculate the top output: top = top + accumulate */
+			icomplex32_add(&tmp1, &tmp2, &outb[top]);
+			/* calculate the bottom output: bottom = top - accumulate */
+			icomplex32_sub(&tmp1, &tmp2, &outb[bottom]);
+		}
+	}
+}
+
+/*
+ * Radix-4 pass that merges the radix-2 stages depth and depth + 1. Each group of four
+ * points is loaded and stored once instead of twice while the arithmetic is the same
+ * as in two fft_radix2_stage_32() calls, so the result is bit exact with them.
+ */
+static void fft_radix4_stage_32(struct icomplex32 *outb, const struct icomplex32 *twiddle,
+				int size, int depth)
+{
+	struct icomplex32 x0;
+	struct icomplex32 x1;
+	struct icomplex32 x2;
+	struct icomplex32 x3;
+	struct icomplex32 tmp;
+	int n = 1 << (depth - 1);
+	int m = n << 2;
+	const struct icomplex32 *tw1 = twiddle + n - 1;
+	const struct icomplex32 *tw2 = twiddle + 2 * n - 1;
+	int p0, p1, p2, p3;
+	int j;
+	int k;
+
+	for (k = 0; k < size; k += m) {
+		for (j = 0; j < n; ++j) {
+			p0 = k + j;
+			p1 = p0 + n;
+			p2 = p1 + n;
+			p3 = p2 + n;
+
+			/* first stage butterflies (p0, p1) and (p2, p3) */
+			icomplex32_mul(&tw1[j], &outb[p1], &tmp);
+			icomplex32_add(&outb[p0], &tmp, &x0);
+			icomplex32_sub(&outb[p0], &tmp, &x1);
+			icomplex32_mul(&tw1[j], &outb[p3], &tmp);
+			icomplex32_add(&outb[p2], &tmp, &x2);
+			icomplex32_sub(&outb[p2], &tmp, &x3);
+
+			/* second stage butterflies (p0, p2) and (p1, p3) */
+			icomplex32_mul(&tw2[j], &x2, &tmp);
+			icomplex32_add(&x0, &tmp, &outb[p0]);
+			icomplex32_sub(&x0, &tmp, &outb[p2]);
+			icomplex32_mul(&tw2[j + n], &x3, &tmp);
+			icomplex32_add(&x1, &tmp, &outb[p1]);
+			icomplex32_sub(&x1, &tmp, &outb[p3]);
+		}
+	}
+}
+
 /**
  * \brief Execute the 32-bits Fast Fourier Transform (FFT) or Inverse FFT (IFFT)
  *	  For the configured fft_pan.
@@ -68,21 +149,12 @@ static inline void icomplex32_shift(const struct icomplex32 *input, int32_t n,
  */
 void fft_execute_32(struct fft_plan *plan, bool ifft)
 {
-	struct icomplex32 tmp1;
-	struct icomplex32 tmp2;
 	struct icomplex32 *inb;
 	struct icomplex32 *outb;
-	int depth;
-	int top;
-	int bottom;
-	int index;
+	int depth = 1;
 	int i;
-	int j;
-	int k;
-	int m;
-	int n;
 
-	if (!plan || !plan->bit_reverse_idx)
+	if (!plan || !plan->bit_reverse_idx || !plan->twiddle32)
 		return;
 
 	inb = plan->inb32;
@@ -97,34 +169,17 @@ void fft_execute_32(struct fft_plan *plan, bool ifft)
 	}
 
 	/* step 1: re-arrange input in bit reverse order, and shrink the level to avoid overflow */
-	for (i = 1; i < plan->size; ++i)
+	for (i = 0; i < plan->size; ++i)
 		icomplex32_shift(&inb[i], -(plan->len), &outb[plan->bit_reverse_idx[i]]);
 
-	/* step 2: loop to do FFT transform in smaller size */
-	for (depth = 1; depth <= plan->len; ++depth) {
-		m = 1 << depth;
-		n = m >> 1;
-		i = FFT_SIZE_MAX >> depth;
-
-		/* doing FFT transforms in size m */
-		for (k = 0; k < plan->size; k += m) {
-			/* doing one FFT transform for size m */
-			for (j = 0; j < n; ++j) {
-				index = i * j;
-				top = k + j;
-				bottom = top + n;
-				tmp1.real = twiddle_real_32[index];
-				tmp1.imag = twiddle_imag_32[index];
-				/* calculate the accumulator: twiddle * bottom */
-				icomplex32_mul(&tmp1, &outb[bottom], &tmp2);
-				tmp1 = outb[top];
-				/* calculate the top output: top = top + accumulate */
-				icomplex32_add(&tmp1, &tmp2, &outb[top]);
-				/* calculate the bottom output: bottom = top - accumulate */
-				icomplex32_sub(&tmp1, &tmp2, &outb[bottom]);
-			}
-		}
-	}
+	/* step 2: loop to do FFT transform in smaller size, an odd stage count starts
+	 * with one radix-2 pass and the rest is done in radix-4 passes
+	 */
+	if (plan->len & 1)
+		fft_radix2_stage_32(outb, plan->twiddle32, plan->size, depth++);
+
+	for (; depth < plan->len; depth += 2)
+		fft_radix4_stage_32(outb, plan->twiddle32, plan->size, depth);
 
 	/* shift back for ifft */
 	if (ifft) {
@@ -139,3 +194,139 @@ void fft_execute_32(struct fft_plan *plan, bool ifft)
 }
 
 #endif
+
+/*
+ * Split step of the real input FFT. The 2N points real sequence x[] is processed as
+ * N points complex z[n] = x[2n] + j * x[2n + 1], and the half spectrum is reconstructed
+ * from Z[k] and conj(Z[N - k]) with twiddle W_2N^k. The bins k and N - k are computed
+ * from the same pair so the step is done in place, the Fs/2 bin goes to outb[N].
+ */
+static void fft_real_split_32(struct icomplex32 *outb, int size, int stride)
+{
+	struct icomplex32 a;
+	struct icomplex32 b;
+	int64_t er, ei, or, oi;
+	int64_t tr, ti;
+	int32_t twr, twi;
+	int k;
+	int m;
+
+	a = outb[0];
+	outb[0].real = ((int64_t)a.real + a.imag) >> 1;
+	outb[0].imag = 0;
+	outb[size].real = ((int64_t)a.real - a.imag) >> 1;
+	outb[size].imag = 0;
+
+	for (k = 1; k <= size >> 1; k++) {
+		m = size - k;
+		a = outb[k];
+		b = outb[m];
+		er = ((int64_t)a.real + b.real) >> 1;
+		ei = ((int64_t)a.imag - b.imag) >> 1;
+		or = ((int64_t)a.real - b.real) >> 1;
+		oi = ((int64_t)a.imag + b.imag) >> 1;
+
+		/* W^k * (O / j) where the division by j is (oi, -or) */
+		twr = twiddle_real_32[k * stride];
+		twi = twiddle_imag_32[k * stride];
+		tr = (twr * oi + twi * or) >> 31;
+		ti = (twi * oi - twr * or) >> 31;
+
+		outb[k].real = sat_int32((er + tr) >> 1);
+		outb[k].imag = sat_int32((ei + ti) >> 1);
+		if (m != k) {
+			/* W^(N - k) is -conj(W^k) */
+			outb[m].real = sat_int32((er - tr) >> 1);
+			outb[m].imag = sat_int32((ti - ei) >> 1);
+		}
+	}
+}
+
+/*
+ * Inverse of fft_real_split_32(), builds the N points complex spectrum of z[] from the
+ * N + 1 real signal bins. The result is scaled by 1/2 to keep it in Q1.31 range.
+ */
+static void fft_real_merge_32(struct icomplex32 *inb, int size, int stride)
+{
+	struct icomplex32 a;
+	struct icomplex32 b;
+	int64_t er, ei, or, oi;
+	int64_t tr, ti;
+	int32_t twr, twi;
+	int k;
+	int m;
+
+	a = inb[0];
+	b = inb[size];
+	er = ((int64_t)a.real + b.real) >> 1;
+	ei = ((int64_t)a.imag - b.imag) >> 1;
+	or = ((int64_t)a.real - b.real) >> 1;
+	oi = ((int64_t)a.imag + b.imag) >> 1;
+	inb[0].real = sat_int32(er - oi);
+	inb[0].imag = sat_int32(ei + or);
+
+	for (k = 1; k <= size >> 1; k++) {
+		m = size - k;
+		a = inb[k];
+		b = inb[m];
+		er = ((int64_t)a.real + b.real) >> 1;
+		ei = ((int64_t)a.imag - b.imag) >> 1;
+		or = ((int64_t)a.real - b.real) >> 1;
+		oi = ((int64_t)a.imag + b.imag) >> 1;
+
+		/* j * conj(W^k) * O */
+		twr = twiddle_real_32[k * stride];
+		twi = twiddle_imag_32[k * stride];
+		tr = (twi * or - twr * oi) >> 31;
+		ti = (twi * oi + twr * or) >> 31;
+
+		inb[k].real = sat_int32(er + tr);
+		inb[k].imag = sat_int32(ei + ti);
+		if (m != k) {
+			inb[m].real = sat_int32(er - tr);
+			inb[m].imag = sat_int32(ti - ei);
+		}
+	}
+}
+
+/**
+ * \brief Execute the 32-bits FFT for real input or IFFT for real output of
+ *	  2 * plan->size points with the same scaling as fft_execute_32().
+ *	  For FFT the input buffer contains 2 * size real samples and the output
+ *	  buffer receives size + 1 complex bins from DC to Fs/2. For IFFT the input
+ *	  buffer contains the size + 1 bins and the output buffer receives 2 * size
+ *	  real samples. The input buffer content is not preserved.
+ * \param[in] plan - pointer to fft_plan of half of the real transform size.
+ * \param[in] ifft - set to 1 for IFFT and 0 for FFT.
+ */
+void fft_execute_real_32(struct fft_plan *plan, bool ifft)
+{
+	int32_t *out;
+	int stride;
+	int i;
+
+	if (!plan || !plan->inb32 || !plan->outb32)
+		return;
+
+	if (plan->size > FFT_SIZE_MAX / 2)
+		return;
+
+	stride = FFT_SIZE_MAX >> (plan->len + 1);
+	if (!ifft) {
+		fft_execute_32(plan, false);
+		fft_real_split_32(plan->outb32, plan->size, stride);
+		return;
+	}
+
+	fft_real_merge_32(plan->inb32, plan->size, stride);
+	fft_execute_32(plan, true);
+
+	/* compensate the 1/2 scale of the merge, the IFFT output is conjugated so the odd
+	 * samples in the imaginary part need to be negated
+	 */
+	out = (int32_t *)plan->outb32;
+	for (i = 0; i < 2 * plan->size; i += 2) {
+		out[i] = sat_int32((int64_t)out[i] << 1);
+		out[i + 1] = sat_int32(-((int64_t)out[i + 1] << 1));
+	}
+}
@@ -8,15 +8,132 @@
 #include <sof/audio/buffer.h>
 #include <sof/audio/format.h>
 #include <sof/common.h>
+#include <sof/debug/panic.h>
 #include <rtos/alloc.h>
+#include <sof/lib/cpu.h>
 #include <sof/math/fft.h>
 
+/*
+ * The bit reverse index and the stage twiddle factors depend only on the FFT size
+ * and word length, so they are kept in a per core cache and shared by all the
+ * plans of the same kind. Plans are created and freed from component init and
+ * free on the core that runs the component. A table is only ever looked up,
+ * referenced and released on the core that owns its cache list, so the list and
+ * the refcount need no lock. The owner core is recorded and asserted on release.
+ */
+struct fft_table {
+	struct fft_table *next;		/* next table in the core cache */
+	uint32_t size;			/* fft size */
+	int core;			/* core that owns the cache list */
+	int bits;			/* word length, 16 or 32 */
+	int refcount;			/* number of plans using the table */
+	uint16_t *bit_reverse_idx;	/* bit reverse index array */
+	void *twiddle;			/* stage twiddle factors, icomplex16 or icomplex32 */
+};
+
+static struct fft_table *fft_table_cache[CONFIG_CORE_COUNT];
+
+/*
+ * Stage s with butterfly span 2^s uses the factors W^j, j = 0 .. 2^(s - 1) - 1,
+ * that are the elements j * FFT_SIZE_MAX >> s of the full twiddle table. The
+ * stages are stored one after another so the stage with half span n starts at
+ * index n - 1 and the butterfly loop reads its factors sequentially.
+ */
+static void fft_table_twiddle_init(struct fft_table *table, int len)
+{
+	int stride;
+	int n;
+	int i = 0;
+	int j;
+	int s;
+
+	for (s = 1; s <= len; s++) {
+		n = 1 << (s - 1);
+		stride = FFT_SIZE_MAX >> s;
+		for (j = 0; j < n; j++, i++) {
+			if (table->bits == 16) {
+#if CONFIG_MATH_16BIT_FFT
+				struct icomplex16 *tw16 = table->twiddle;
+
+				tw16[i].real = twiddle_real_16[j * stride];
+				tw16[i].imag = twiddle_imag_16[j * stride];
+#endif
+			} else {
+#if CONFIG_MATH_32BIT_FFT
+				struct icomplex32 *tw32 = table->twiddle;
+
+				tw32[i].real = twiddle_real_32[j * stride];
+				tw32[i].imag = twiddle_imag_32[j * stride];
+#endif
+			}
+		}
+	}
+}
+
+static struct fft_table *fft_table_get(uint32_t size, int len, int bits)
+{
+	struct fft_table **cache = &fft_table_cache[cpu_get_id()];
+	struct fft_table *table;
+	size_t twiddle_size;
+	int i;
+
+	for (table = *cache; table; table = table->next) {
+		if (table->size == size && table->bits == bits) {
+			table->refcount++;
+			return table;
+		}
+	}
+
+	/* twiddle factors first to keep them aligned, the index array follows */
+	twiddle_size = (size - 1) * (bits == 16 ? sizeof(struct icomplex16) :
+				     sizeof(struct icomplex32));
+	table = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			sizeof(*table) + twiddle_size + size * sizeof(uint16_t));
+	if (!table)
+		return NULL;
+
+	table->size = size;
+	table->core = cpu_get_id();
+	table->bits = bits;
+	table->refcount = 1;
+	table->twiddle = table + 1;
+	table->bit_reverse_idx = (uint16_t *)((uint8_t *)table->twiddle + twiddle_size);
+
+	/* set up the bit reverse index */
+	for (i = 1; i < size; ++i)
+		table->bit_reverse_idx[i] = (table->bit_reverse_idx[i >> 1] >> 1) |
+					    ((i & 1) << (len - 1));
+
+	fft_table_twiddle_init(table, len);
+
+	table->next = *cache;
+	*cache = table;
+	return table;
+}
+
+static void fft_table_put(struct fft_table *table)
+{
+	struct fft_table **prev = &fft_table_cache[table->core];
+
+	assert(table->core == cpu_get_id());
+
+	if (--table->refcount > 0)
+		return;
+
+	while (*prev && *prev != table)
+		prev = &(*prev)->next;
+
+	if (*prev)
+		*prev = table->next;
+
+	rfree(table);
+}
+
 struct fft_plan *fft_plan_new(void *inb, void *outb, uint32_t size, int bits)
 {
 	struct fft_plan *plan;
 	int lim = 1;
 	int len = 0;
-	int i;
 
 	if (!inb || !outb)
 		return NULL;
@@ -48,17 +165,17 @@ struct fft_plan *fft_plan_new(void *inb, void *outb, uint32_t size, int bits)
 	plan->size = lim;
 	plan->len = len;
 
-	plan->bit_reverse_idx = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
-					plan->size * sizeof(uint16_t));
-	if (!plan->bit_reverse_idx) {
+	plan->table = fft_table_get(plan->size, len, bits);
+	if (!plan->table) {
 		rfree(plan);
 		return NULL;
 	}
 
-	/* set up the bit reverse index */
-	for (i = 1; i < plan->size; ++i)
-		plan->bit_reverse_idx[i] = (plan->bit_reverse_idx[i >> 1] >> 1) |
-					   ((i & 1) << (len - 1));
+	plan->bit_reverse_idx = plan->table->bit_reverse_idx;
+	if (bits == 16)
+		plan->twiddle16 = plan->table->twiddle;
+	else
+		plan->twiddle32 = plan->table->twiddle;
 
 	return plan;
 }
@@ -68,6 +185,6 @@ void fft_plan_free(struct fft_plan *plan)
 	if (!plan)
 		return;
 
-	rfree(plan->bit_reverse_idx);
+	fft_table_put(plan->table);
 	rfree(plan);
 }
@@ -44,8 +44,9 @@ int fir_delay_size(struct sof_fir_coef_data *config)
 	if (config->length & 0x3)
 		return -EINVAL;
 
-	/* The dual sample version needs one more delay entry. To preserve
-	 * align for 64 bits need to add two.
+	/* The dual sample version needs one more delay entry and the four
+	 * samples block version three more. To preserve align for 64 bits
+	 * need to add four.
 	 */
 	return (config->length + 4) * sizeof(int32_t);
 }
@@ -55,7 +56,7 @@ int fir_init_coef(struct fir_state_32x16 *fir,
 {
 	fir->rwi = 0;
 	fir->taps = (int)config->length;
-	fir->length = (int)fir->taps + 2;
+	fir->length = (int)fir->taps + 4;
 	fir->out_shift = (int)config->out_shift;
 	fir->coef = ASSUME_ALIGNED(&config->coef[0], 4);
 	return 0;
@@ -67,6 +68,7 @@ void fir_init_delay(struct fir_state_32x16 *fir, int32_t **data)
 	*data += fir->length; /* Point to next delay line start */
 }
 
+#if !FIR_X86
 int32_t fir_32x16(struct fir_state_32x16 *fir, int32_t x)
 {
 	int64_t y = 0;
@@ -180,4 +182,96 @@ void fir_32x16_2x(struct fir_state_32x16 *fir, int32_t x0, int32_t x1, int32_t *
 	*y1 = sat_int32(a1 >> shift);
 }
 
+/* Compute four successive outputs with one pass over the coefficients. The
+ * delay line is read once per tap and the three newer samples needed for
+ * the other outputs are kept in registers, shifted by one every tap.
+ */
+static void fir_32x16_4x(struct fir_state_32x16 *fir, const int32_t *x, int32_t *y)
+{
+	int64_t a0 = 0;
+	int64_t a1 = 0;
+	int64_t a2 = 0;
+	int64_t a3 = 0;
+	int32_t sample0;
+	int32_t sample1 = x[1];
+	int32_t sample2 = x[2];
+	int32_t sample3 = x[3];
+	int16_t tap;
+	int32_t *data = &fir->delay[fir->rwi];
+	int16_t *coef = &fir->coef[0];
+	int n1;
+	int n2;
+	int i;
+	const int length = fir->length;
+	const int taps = fir->taps;
+	const int shift = 15 + fir->out_shift;
+
+	/* Write samples to delay, the write can wrap after any sample */
+	n1 = fir->rwi + 1;
+	for (i = 0; i < 4; i++) {
+		fir->delay[fir->rwi] = x[i];
+		if (++fir->rwi == length)
+			fir->rwi = 0;
+	}
+
+	/* Part 1, from x[0] backwards until the circular wrap */
+	n1 = MIN(n1, taps);
+	for (i = 0; i < n1; i++) {
+		tap = *coef;
+		coef++;
+		sample0 = *data;
+		data--;
+		a3 += (int64_t)tap * sample3;
+		a2 += (int64_t)tap * sample2;
+		a1 += (int64_t)tap * sample1;
+		a0 += (int64_t)tap * sample0;
+		sample3 = sample2;
+		sample2 = sample1;
+		sample1 = sample0;
+	}
+
+	/* Part 2, un-wrap data, continue n2 times */
+	n2 = taps - n1;
+	data = &fir->delay[length - 1];
+	for (i = 0; i < n2; i++) {
+		tap = *coef;
+		coef++;
+		sample0 = *data;
+		data--;
+		a3 += (int64_t)tap * sample3;
+		a2 += (int64_t)tap * sample2;
+		a1 += (int64_t)tap * sample1;
+		a0 += (int64_t)tap * sample0;
+		sample3 = sample2;
+		sample2 = sample1;
+		sample1 = sample0;
+	}
+
+	/* Q2.46 -> Q2.31, saturate to Q1.31 */
+	y[0] = sat_int32(a0 >> shift);
+	y[1] = sat_int32(a1 >> shift);
+	y[2] = sat_int32(a2 >> shift);
+	y[3] = sat_int32(a3 >> shift);
+}
+
+void fir_32x16_block(struct fir_state_32x16 *fir, const int32_t *x, int32_t *y, int n)
+{
+	int i;
+
+	/* Bypass is set with length set to zero. */
+	if (!fir->length) {
+		for (i = 0; i < n; i++)
+			y[i] = x[i];
+		return;
+	}
+
+	for (i = 0; i + 4 <= n; i += 4)
+		fir_32x16_4x(fir, &x[i], &y[i]);
+
+	for (; i < n; i++)
+		y[i] = fir_32x16(fir, x[i]);
+}
+
+#endif /* !FIR_X86 */
+
 #endif
@@ -50,3 +50,122 @@ void iir_reset_df1(struct iir_state_df1 *iir)
 	 * omitting setting iir->delay to NULL.
 	 */
 }
+
+/* Return the size of data for iir_init_multich_df1(), or -EINVAL when the
+ * channels don't use the same sections layout and need to be processed one
+ * at a time.
+ */
+int iir_multich_size_df1(struct iir_state_df1 iir[], int nch)
+{
+	unsigned int biquads = iir[0].biquads;
+	unsigned int series = iir[0].biquads_in_series;
+	int i;
+
+	if (nch < 1 || !biquads || !series || biquads % series)
+		return -EINVAL;
+
+	for (i = 1; i < nch; i++) {
+		if (iir[i].biquads != biquads || iir[i].biquads_in_series != series)
+			return -EINVAL;
+	}
+
+	return nch * (sizeof(int64_t) + sizeof(int32_t) +
+		      biquads * (IIR_DF1_NUM_STATE + SOF_EQ_IIR_NBIQUAD) * sizeof(int32_t));
+}
+
+/* Interleave the coefficients and current states of the channels into data */
+void iir_init_multich_df1(struct iir_state_df1_multich *mc,
+			  struct iir_state_df1 iir[], int nch, void *data)
+{
+	int biquads = iir[0].biquads;
+	int ch;
+	int i;
+
+	mc->channels = nch;
+	mc->biquads = biquads;
+	mc->biquads_in_series = iir[0].biquads_in_series;
+	mc->out = data;
+	mc->delay = (int32_t *)(mc->out + nch);
+	mc->coef = mc->delay + biquads * IIR_DF1_NUM_STATE * nch;
+	mc->in = mc->coef + biquads * SOF_EQ_IIR_NBIQUAD * nch;
+
+	for (ch = 0; ch < nch; ch++) {
+		for (i = 0; i < biquads * SOF_EQ_IIR_NBIQUAD; i++)
+			mc->coef[i * nch + ch] = iir[ch].coef[i];
+
+		for (i = 0; i < biquads * IIR_DF1_NUM_STATE; i++)
+			mc->delay[i * nch + ch] = iir[ch].delay ? iir[ch].delay[i] : 0;
+	}
+}
+
+/* Process frames of interleaved channels. The biquads are run for all
+ * channels per step, the computation per channel is the same as in
+ * iir_df1() and the output is bit exact with it. The inner loops over
+ * the channels access consecutive coefficients and states so that the
+ * compiler can vectorize them. The x and y can be the same buffer.
+ */
+void iir_df1_multich(struct iir_state_df1_multich *iir, const int32_t *x,
+		     int32_t *y, int frames)
+{
+	int32_t *coefp;
+	int32_t *delay;
+	int32_t *in = iir->in;
+	int64_t *out = iir->out;
+	int64_t acc;
+	int32_t tmp;
+	int32_t w;
+	int i;
+	int j;
+	int f;
+	int ch;
+	const int nch = iir->channels;
+	const int nseries = iir->biquads_in_series;
+
+	for (f = 0; f < frames; f++) {
+		for (ch = 0; ch < nch; ch++)
+			out[ch] = 0;
+
+		coefp = iir->coef;
+		delay = iir->delay;
+		for (j = 0; j < iir->biquads; j += nseries) {
+			for (ch = 0; ch < nch; ch++)
+				in[ch] = x[ch];
+
+			for (i = 0; i < nseries; i++) {
+				/* Coefficients are {a2, a1, b2, b1, b0, shift, gain}
+				 * and states {y(n - 2), y(n - 1), x(n - 2), x(n - 1)},
+				 * each for all channels
+				 */
+				for (ch = 0; ch < nch; ch++) {
+					w = in[ch];
+					acc = (int64_t)coefp[ch] * delay[ch];
+					acc += (int64_t)coefp[nch + ch] * delay[nch + ch];
+					acc += (int64_t)coefp[2 * nch + ch] * delay[2 * nch + ch];
+					acc += (int64_t)coefp[3 * nch + ch] * delay[3 * nch + ch];
+					acc += (int64_t)coefp[4 * nch + ch] * w;
+					tmp = (int32_t)sat_int32(Q_SHIFT_RND(acc, 61, 31));
+					delay[ch] = delay[nch + ch];
+					delay[nch + ch] = tmp;
+					delay[2 * nch + ch] = delay[3 * nch + ch];
+					delay[3 * nch + ch] = w;
+					acc = (int64_t)coefp[6 * nch + ch] * tmp;
+					acc = Q_SHIFT_RND(acc, 45 + coefp[5 * nch + ch], 31);
+					in[ch] = sat_int32(acc);
+				}
+
+				coefp += SOF_EQ_IIR_NBIQUAD * nch;
+				delay += IIR_DF1_NUM_STATE * nch;
+			}
+
+			/* Output of previous section is in in[] */
+			for (ch = 0; ch < nch; ch++)
+				out[ch] += in[ch];
+		}
+
+		for (ch = 0; ch < nch; ch++)
+			y[ch] = sat_int32(out[ch]);
+
+		x += nch;
+		y += nch;
+	}
+}
@@ -10,37 +10,96 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <inttypes.h>
 #include <malloc.h>
+#include <pthread.h>
 #include <rtos/alloc.h>
 #include <sof/lib/mm_heap.h>
 
 /* testbench mem alloc definition */
 
+/*
+ * The calls are recorded to the file named by SOF_ALLOC_TRACE, one per line,
+ * for replaying them against the firmware allocator with heapsim:
+ *   m|z <zone> <flags> <caps> <bytes> <ptr>
+ *   b <flags> <caps> <bytes> <alignment> <ptr>
+ *   r <old ptr> <flags> <caps> <bytes> <old bytes> <alignment> <ptr>
+ *   f <ptr>
+ */
+static pthread_once_t alloc_trace_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t alloc_trace_lock = PTHREAD_MUTEX_INITIALIZER;
+static FILE *alloc_trace;
+
+static void alloc_trace_open(void)
+{
+	const char *name = getenv("SOF_ALLOC_TRACE");
+
+	if (!name)
+		return;
+
+	alloc_trace = fopen(name, "w");
+	if (!alloc_trace)
+		fprintf(stderr, "error: can't open allocation trace %s\n", name);
+}
+
+#define ALLOC_TRACE(...) do {						\
+		pthread_once(&alloc_trace_once, alloc_trace_open);	\
+		if (alloc_trace) {					\
+			pthread_mutex_lock(&alloc_trace_lock);		\
+			fprintf(alloc_trace, __VA_ARGS__);		\
+			pthread_mutex_unlock(&alloc_trace_lock);	\
+		}							\
+	} while (0)
+
 void *rmalloc(enum mem_zone zone, uint32_t flags, uint32_t caps, size_t bytes)
 {
-	return malloc(bytes);
+	void *ptr = malloc(bytes);
+
+	ALLOC_TRACE("m %d 0x%x 0x%x %zu 0x%" PRIxPTR "\n", zone, flags, caps, bytes,
+		    (uintptr_t)ptr);
+	return ptr;
 }
 
 void *rzalloc(enum mem_zone zone, uint32_t flags, uint32_t caps, size_t bytes)
 {
-	return calloc(bytes, 1);
+	void *ptr = calloc(bytes, 1);
+
+	ALLOC_TRACE("z %d 0x%x 0x%x %zu 0x%" PRIxPTR "\n", zone, flags, caps, bytes,
+		    (uintptr_t)ptr);
+	return ptr;
 }
 
 void rfree(void *ptr)
 {
+	if (ptr)
+		ALLOC_TRACE("f 0x%" PRIxPTR "\n", (uintptr_t)ptr);
+
 	free(ptr);
 }
 
 void *rballoc_align(uint32_t flags, uint32_t caps, size_t bytes,
 		    uint32_t alignment)
 {
-	return malloc(bytes);
+	void *ptr = malloc(bytes);
+
+	ALLOC_TRACE("b 0x%x 0x%x %zu %u 0x%" PRIxPTR "\n", flags, caps, bytes, alignment,
+		    (uintptr_t)ptr);
+	return ptr;
 }
 
 void *rbrealloc_align(void *ptr, uint32_t flags, uint32_t caps, size_t bytes,
 		      size_t old_bytes, uint32_t alignment)
 {
-	return realloc(ptr, bytes);
+	char old_ptr[2 * sizeof(uintptr_t) + 3];
+	void *new_ptr;
+
+	/* print the old pointer before realloc() has freed it */
+	snprintf(old_ptr, sizeof(old_ptr), "0x%" PRIxPTR, (uintptr_t)ptr);
+	new_ptr = realloc(ptr, bytes);
+
+	ALLOC_TRACE("r %s 0x%x 0x%x %zu %zu %u 0x%" PRIxPTR "\n", old_ptr,
+		    flags, caps, bytes, old_bytes, alignment, (uintptr_t)new_ptr);
+	return new_ptr;
 }
 
 void heap_trace(struct mm_heap *heap, int size)
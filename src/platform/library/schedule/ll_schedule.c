@@ -33,7 +33,7 @@ struct ll_vcore {
 	pthread_mutex_t list_mutex;
 	pthread_t thread_id;
 	int vcore_ready;
-	int core_id;
+	int core_id;	/* DSP core, mapped to host core when the thread starts */
 };
 
 static int tick_period_us;
@@ -68,17 +68,22 @@ static void *ll_thread(void *data)
 	uint64_t delta;
 	cpu_set_t cpuset;
 	pthread_t thread;
+	unsigned int host_core;
 
-	/* Set affinity mask to pipeline core */
+	/* Set affinity mask to pipeline core. The mapping is looked up here
+	 * and not at init so that e.g. testbench batch workers forked after
+	 * init can each use their own host cores.
+	 */
+	host_core = sof_host_core_base() + vc->core_id;
 	thread = pthread_self();
 	CPU_ZERO(&cpuset);
-	CPU_SET(vc->core_id, &cpuset);
+	CPU_SET(host_core, &cpuset);
 
-	printf("ll_schedule: new thread for core %d\n", vc->core_id);
+	printf("ll_schedule: new thread for core %d\n", host_core);
 	err = pthread_setaffinity_np(thread, sizeof(cpuset), &cpuset);
 	if (err != 0)
 		fprintf(stderr, "error: failed to set CPU affinity to core %d: %s\n",
-			vc->core_id, strerror(err));
+			host_core, strerror(err));
 
 	/* convert uS to seconds and ns */
 	ts.tv_sec = tick_period_us / 1000000;
@@ -305,7 +310,7 @@ int schedule_task_init_ll(struct task *task,
 int scheduler_init_ll(struct ll_schedule_domain *domain)
 {
 	struct ll_vcore *vcore;
-	unsigned int i, core_zero;
+	unsigned int i;
 
 	tr_info(&ll_tr, "ll_scheduler_init()");
 	tick_period_us = domain->next_tick;
@@ -314,11 +319,9 @@ int scheduler_init_ll(struct ll_schedule_domain *domain)
 	if (!vcore)
 		return -ENOMEM;
 
-	core_zero = sof_host_core_base();
-
 	for (i = 0; i < CONFIG_CORE_COUNT; i++) {
 		list_init(&vcore[i].list);
-		vcore[i].core_id = core_zero + i;
+		vcore[i].core_id = i;
 	}
 
 	scheduler_init(SOF_SCHEDULE_LL_TIMER, &schedule_ll_ops, vcore);
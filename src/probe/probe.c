@@ -77,6 +77,17 @@ struct probe_dma_ext {
 	struct dma_copy dc;		/**< DMA copy */
 };
 
+#if CONFIG_PROBE_EXTRACTION_BATCH
+/**
+ * Batch packet collecting the extracted data until the next probe task run
+ */
+struct probe_batch {
+	uintptr_t header_ptr;	/**< packet header position in DMA buffer, 0 if none */
+	uint32_t size;		/**< size of the records after the header */
+	uint64_t timestamp;	/**< timestamp of the first record */
+};
+#endif
+
 /**
  * Probe main struct
  */
@@ -84,7 +95,11 @@ struct probe_pdata {
 	struct probe_dma_ext ext_dma;				  /**< extraction DMA */
 	struct probe_dma_ext inject_dma[CONFIG_PROBE_DMA_MAX];	  /**< injection DMA */
 	struct probe_point probe_points[CONFIG_PROBE_POINTS_MAX]; /**< probe points */
+	struct probe_dma_ext *point_dma[CONFIG_PROBE_POINTS_MAX]; /**< probe point injection DMA */
 	struct probe_data_packet header;			  /**< data packet header */
+#if CONFIG_PROBE_EXTRACTION_BATCH
+	struct probe_batch batch;				  /**< open batch packet */
+#endif
 	struct task dmap_work;					  /**< probe task */
 };
 
@@ -217,6 +232,10 @@ static int probe_dma_deinit(struct probe_dma_ext *dma)
 	return 0;
 }
 
+#if CONFIG_PROBE_EXTRACTION_BATCH
+static int probe_batch_close(struct probe_pdata *_probe);
+#endif
+
 /*
  * \brief Probe task for extraction.
  *
@@ -229,6 +248,13 @@ static enum task_state probe_task(void *data)
 	uint32_t copy_align, avail;
 	int err;
 
+#if CONFIG_PROBE_EXTRACTION_BATCH
+	/* send everything extracted since the last run */
+	err = probe_batch_close(_probe);
+	if (err < 0)
+		tr_err(&pr_tr, "probe_task(): probe_batch_close() failed.");
+#endif
+
 	if (!_probe->ext_dma.dmapb.avail)
 		return SOF_TASK_STATE_RESCHEDULE;
 #if CONFIG_ZEPHYR_NATIVE_DRIVERS
@@ -500,57 +526,58 @@ int probe_dma_remove(uint32_t count, const uint32_t *stream_tag)
 }
 
 /**
- * \brief Copy data to probe buffer and update buffer pointers.
- * \param[out] pbuf DMA buffer.
+ * \brief Write back the cache of probe buffer region, wrapping at the
+ *	  buffer end.
+ * \param[in] pbuf DMA buffer.
+ * \param[in] ptr region start.
+ * \param[in] bytes size.
+ */
+static void probe_buffer_writeback(struct probe_dma_buf *pbuf, uintptr_t ptr, uint32_t bytes)
+{
+	uint32_t head = MIN(bytes, pbuf->end_addr - ptr);
+
+	dcache_writeback_region((__sparse_force void __sparse_cache *)ptr, head);
+	if (bytes > head)
+		dcache_writeback_region((__sparse_force void __sparse_cache *)pbuf->addr,
+					bytes - head);
+}
+
+/**
+ * \brief Copy data to probe buffer at given position, wrapping at the
+ *	  buffer end. The cache is not written back.
+ * \param[in] pbuf DMA buffer.
+ * \param[in,out] ptr position to copy to, updated past the data.
  * \param[in] data pointer.
  * \param[in] bytes size.
  * \return 0 on success, error code otherwise.
  */
-static int copy_to_pbuffer(struct probe_dma_buf *pbuf, void *data,
-			   uint32_t bytes)
+static int probe_buffer_write(struct probe_dma_buf *pbuf, uintptr_t *ptr,
+			      const void *data, uint32_t bytes)
 {
-	uint32_t head;
-	uint32_t tail;
+	uint32_t head = MIN(bytes, pbuf->end_addr - *ptr);
+	uint32_t tail = bytes - head;
 
 	if (bytes == 0)
 		return 0;
 
-	/* check if there is free room in probe buffer */
-	if (pbuf->size - pbuf->avail < bytes)
+	if (memcpy_s((void *)*ptr, pbuf->end_addr - *ptr, data, head)) {
+		tr_err(&pr_tr, "probe_buffer_write(): memcpy_s() failed");
 		return -EINVAL;
-
-	/* check if it will not exceed end_addr */
-	if ((char *)pbuf->end_addr - (char *)pbuf->w_ptr < bytes) {
-		head = (char *)pbuf->end_addr - (char *)pbuf->w_ptr;
-		tail = bytes - head;
-	} else {
-		head = bytes;
-		tail = 0;
 	}
 
-	/* copy data to probe buffer */
-	if (memcpy_s((void *)pbuf->w_ptr, pbuf->end_addr - pbuf->w_ptr, data, head)) {
-		tr_err(&pr_tr, "copy_to_pbuffer(): memcpy_s() failed");
-		return -EINVAL;
-	}
-	dcache_writeback_region((__sparse_force void __sparse_cache *)pbuf->w_ptr, head);
+	*ptr += head;
+	if (*ptr == pbuf->end_addr)
+		*ptr = pbuf->addr;
 
 	/* buffer ended so needs to do a second copy */
 	if (tail) {
-		pbuf->w_ptr = pbuf->addr;
-		if (memcpy_s((void *)pbuf->w_ptr, (char *)pbuf->end_addr - (char *)pbuf->w_ptr,
-			     (char *)data + head, tail)) {
-			tr_err(&pr_tr, "copy_to_pbuffer(): memcpy_s() failed");
+		if (memcpy_s((void *)pbuf->addr, pbuf->size, (const char *)data + head, tail)) {
+			tr_err(&pr_tr, "probe_buffer_write(): memcpy_s() failed");
 			return -EINVAL;
 		}
-		dcache_writeback_region((__sparse_force void __sparse_cache *)pbuf->w_ptr, tail);
-		pbuf->w_ptr = pbuf->w_ptr + tail;
-	} else {
-		pbuf->w_ptr = pbuf->w_ptr + head;
+		*ptr = pbuf->addr + tail;
 	}
 
-	pbuf->avail = (uintptr_t)pbuf->avail + bytes;
-
 	return 0;
 }
 
@@ -612,24 +639,17 @@ static int copy_from_pbuffer(struct probe_dma_buf *pbuf, void *data,
 }
 
 /**
- * \brief Generate probe data packet header, update timestamp, calc crc
- *	  and copy data to probe buffer.
+ * \brief Generate probe data packet header and calc crc.
+ * \param[out] header data packet header.
  * \param[in] buffer_id component buffer id
  * \param[in] size data size.
  * \param[in] format audio format.
- * \param[out] checksum.
- * \return 0 on success, error code otherwise.
+ * \param[in] timestamp of the data.
+ * \return checksum.
  */
-static int probe_gen_header(uint32_t buffer_id, uint32_t size,
-			    uint32_t format, uint64_t *checksum)
+static uint64_t probe_gen_header(struct probe_data_packet *header, uint32_t buffer_id,
+				 uint32_t size, uint32_t format, uint64_t timestamp)
 {
-	struct probe_pdata *_probe = probe_get();
-	struct probe_data_packet *header;
-	uint64_t timestamp;
-
-	header = &_probe->header;
-	timestamp = sof_cycle_get_64();
-
 	header->sync_word = PROBE_EXTRACT_SYNC_WORD;
 	header->buffer_id = buffer_id;
 	header->format = format;
@@ -637,18 +657,196 @@ static int probe_gen_header(uint32_t buffer_id, uint32_t size,
 	header->timestamp_high = (uint32_t)(timestamp >> 32);
 	header->data_size_bytes = size;
 
-	/* calc checksum to check validation by probe parse app */
-	*checksum = header->sync_word +
-		    header->buffer_id  +
-		    header->format +
-		    header->timestamp_high +
-		    header->timestamp_low +
-		    header->data_size_bytes;
+	/* calc checksum to check validation by probe parse app, 32 bit sum */
+	return header->sync_word +
+	       header->buffer_id +
+	       header->format +
+	       header->timestamp_high +
+	       header->timestamp_low +
+	       header->data_size_bytes;
+}
+
+/**
+ * \brief Get free room in the extraction probe buffer, the open batch
+ *	  packet is not available to the DMA yet but takes room.
+ * \param[in] _probe probe data.
+ * \return free bytes.
+ */
+static uint32_t probe_ext_free(struct probe_pdata *_probe)
+{
+	uint32_t used = _probe->ext_dma.dmapb.avail;
+
+#if CONFIG_PROBE_EXTRACTION_BATCH
+	if (_probe->batch.header_ptr)
+		used += sizeof(struct probe_data_packet) + _probe->batch.size;
+#endif
+
+	return _probe->ext_dma.dmapb.size - used;
+}
+
+#if CONFIG_PROBE_EXTRACTION_BATCH
+/**
+ * \brief Write the header and checksum of the open batch packet and make
+ *	  it available to the extraction DMA.
+ * \param[in] _probe probe data.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_batch_close(struct probe_pdata *_probe)
+{
+	struct probe_dma_buf *pbuf = &_probe->ext_dma.dmapb;
+	struct probe_batch *batch = &_probe->batch;
+	uintptr_t header_ptr = batch->header_ptr;
+	uint32_t bytes;
+	uint64_t checksum;
+	int ret;
+
+	if (!batch->header_ptr)
+		return 0;
+
+	checksum = probe_gen_header(&_probe->header, PROBE_BATCH_BUFFER_ID, batch->size, 0,
+				    batch->timestamp);
+
+	ret = probe_buffer_write(pbuf, &batch->header_ptr, &_probe->header,
+				 sizeof(_probe->header));
+	if (ret < 0)
+		return ret;
+
+	/* room for the checksum was reserved with the records */
+	ret = probe_buffer_write(pbuf, &pbuf->w_ptr, &checksum, sizeof(checksum));
+	if (ret < 0)
+		return ret;
+
+	/* the records are written back once here instead of with each copy */
+	bytes = sizeof(_probe->header) + batch->size + sizeof(checksum);
+	probe_buffer_writeback(pbuf, header_ptr, bytes);
+	pbuf->avail += bytes;
+	batch->header_ptr = 0;
+	batch->size = 0;
+
+	return 0;
+}
+
+/**
+ * \brief Add extracted data to the open batch packet, opening a new one
+ *	  if needed.
+ * \param[in] _probe probe data.
+ * \param[in] record header of the data.
+ * \param[in] head data pointer.
+ * \param[in] head_bytes size of data at head.
+ * \param[in] tail data continuing after a buffer wrap.
+ * \param[in] tail_bytes size of data at tail.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_batch_add(struct probe_pdata *_probe, const struct probe_batch_record *record,
+			   const void *head, uint32_t head_bytes,
+			   const void *tail, uint32_t tail_bytes)
+{
+	struct probe_dma_buf *pbuf = &_probe->ext_dma.dmapb;
+	struct probe_batch *batch = &_probe->batch;
+	const uint32_t pad = 0;
+	uint32_t bytes = sizeof(*record) + ALIGN_UP(record->data_size_bytes, sizeof(pad));
+	uint32_t needed = bytes + sizeof(uint64_t);
+	int ret;
+
+	if (!batch->header_ptr)
+		needed += sizeof(struct probe_data_packet);
+
+	if (probe_ext_free(_probe) < needed)
+		return -EINVAL;
+
+	/* leave room for the header written when the batch is closed */
+	if (!batch->header_ptr) {
+		batch->header_ptr = pbuf->w_ptr;
+		batch->timestamp = sof_cycle_get_64();
+		pbuf->w_ptr += sizeof(struct probe_data_packet);
+		if (pbuf->w_ptr >= pbuf->end_addr)
+			pbuf->w_ptr -= pbuf->size;
+	}
+
+	ret = probe_buffer_write(pbuf, &pbuf->w_ptr, record, sizeof(*record));
+	if (ret < 0)
+		return ret;
+
+	ret = probe_buffer_write(pbuf, &pbuf->w_ptr, head, head_bytes);
+	if (ret < 0)
+		return ret;
+
+	ret = probe_buffer_write(pbuf, &pbuf->w_ptr, tail, tail_bytes);
+	if (ret < 0)
+		return ret;
+
+	/* keep the records 4 byte aligned */
+	ret = probe_buffer_write(pbuf, &pbuf->w_ptr, &pad,
+				 bytes - sizeof(*record) - record->data_size_bytes);
+	if (ret < 0)
+		return ret;
+
+	batch->size += bytes;
+
+	return 0;
+}
+#endif /* CONFIG_PROBE_EXTRACTION_BATCH */
+
+/**
+ * \brief Copy extracted data to probe buffer, as a data packet of its own
+ *	  or as a record of the open batch packet.
+ * \param[in] _probe probe data.
+ * \param[in] buffer_id component buffer id
+ * \param[in] format audio format.
+ * \param[in] head data pointer.
+ * \param[in] head_bytes size of data at head.
+ * \param[in] tail data continuing after a buffer wrap.
+ * \param[in] tail_bytes size of data at tail.
+ * \return 0 on success, error code otherwise.
+ */
+static int probe_extract(struct probe_pdata *_probe, uint32_t buffer_id, uint32_t format,
+			 const void *head, uint32_t head_bytes,
+			 const void *tail, uint32_t tail_bytes)
+{
+#if CONFIG_PROBE_EXTRACTION_BATCH
+	struct probe_batch_record record = {
+		.buffer_id = buffer_id,
+		.format = format,
+		.data_size_bytes = head_bytes + tail_bytes,
+	};
+
+	return probe_batch_add(_probe, &record, head, head_bytes, tail, tail_bytes);
+#else
+	struct probe_dma_buf *pbuf = &_probe->ext_dma.dmapb;
+	uintptr_t w_ptr = pbuf->w_ptr;
+	uint32_t bytes = sizeof(_probe->header) + head_bytes + tail_bytes + sizeof(uint64_t);
+	uint64_t checksum;
+	int ret;
+
+	/* don't start a packet that doesn't fit */
+	if (probe_ext_free(_probe) < bytes)
+		return -EINVAL;
+
+	checksum = probe_gen_header(&_probe->header, buffer_id, head_bytes + tail_bytes,
+				    format, sof_cycle_get_64());
+
+	ret = probe_buffer_write(pbuf, &w_ptr, &_probe->header, sizeof(_probe->header));
+	if (ret < 0)
+		return ret;
+
+	ret = probe_buffer_write(pbuf, &w_ptr, head, head_bytes);
+	if (ret < 0)
+		return ret;
 
-	dcache_writeback_region((__sparse_force void __sparse_cache *)header, sizeof(*header));
+	ret = probe_buffer_write(pbuf, &w_ptr, tail, tail_bytes);
+	if (ret < 0)
+		return ret;
+
+	ret = probe_buffer_write(pbuf, &w_ptr, &checksum, sizeof(checksum));
+	if (ret < 0)
+		return ret;
 
-	return copy_to_pbuffer(&_probe->ext_dma.dmapb, header,
-			       sizeof(struct probe_data_packet));
+	probe_buffer_writeback(pbuf, pbuf->w_ptr, bytes);
+	pbuf->w_ptr = w_ptr;
+	pbuf->avail += bytes;
+
+	return 0;
+#endif
 }
 
 /**
@@ -759,8 +957,7 @@ static uint32_t probe_gen_format(uint32_t frame_fmt, uint32_t rate,
  */
 static void kick_probe_task(struct probe_pdata *_probe)
 {
-	if (_probe->ext_dma.dmapb.size - _probe->ext_dma.dmapb.avail <
-		_probe->ext_dma.dmapb.size >> 2)
+	if (probe_ext_free(_probe) < _probe->ext_dma.dmapb.size >> 2)
 		reschedule_task(&_probe->dmap_work, 0);
 }
 
@@ -768,20 +965,9 @@ static void kick_probe_task(struct probe_pdata *_probe)
 static void probe_logging_hook(uint8_t *buffer, size_t length)
 {
 	struct probe_pdata *_probe = probe_get();
-	uint64_t checksum;
 	int ret;
 
-	ret = probe_gen_header(PROBE_LOGGING_BUFFER_ID, length, 0, &checksum);
-	if (ret < 0)
-		return;
-
-	ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-			      buffer, length);
-	if (ret < 0)
-		return;
-
-	ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-			      &checksum, sizeof(checksum));
+	ret = probe_extract(_probe, PROBE_LOGGING_BUFFER_ID, 0, buffer, length, NULL, 0);
 	if (ret < 0)
 		return;
 
@@ -791,51 +977,30 @@ static void probe_logging_hook(uint8_t *buffer, size_t length)
 
 /**
  * \brief General extraction probe callback, called from buffer produce.
- *	  It will search for probe point connected to this buffer.
  *	  Extraction probe: generate format, header and copy data to probe buffer.
- *	  Injection probe: find corresponding DMA, check avail data, copy data,
+ *	  Injection probe: check avail data in the DMA of the probe point, copy data,
  *	  update pointers and request more data from host if needed.
- * \param[in] arg pointer (not used).
+ * \param[in] arg probe point connected to this buffer.
  * \param[in] type of notify.
  * \param[in] data pointer.
  */
 static void probe_cb_produce(void *arg, enum notify_id type, void *data)
 {
 	struct probe_pdata *_probe = probe_get();
+	struct probe_point *probe = arg;
 	struct buffer_cb_transact *cb_data = data;
 	struct comp_buffer __sparse_cache *buffer = cb_data->buffer;
 	struct probe_dma_ext *dma;
-	uint32_t buffer_id;
 	uint32_t head, tail;
 	uint32_t free_bytes = 0;
 	int32_t copy_bytes = 0;
 	int ret;
-	uint32_t i, j;
 	uint32_t format;
-	uint64_t checksum;
-
-	buffer_id = *(int *)arg;
 
-	/* search for probe point connected to this buffer */
-	for (i = 0; i < CONFIG_PROBE_POINTS_MAX; i++)
-		if (_probe->probe_points[i].buffer_id.full_id == buffer_id)
-			break;
-
-	if (i == CONFIG_PROBE_POINTS_MAX) {
-		tr_err(&pr_tr, "probe_cb_produce(): probe not found for buffer id: %d",
-		       buffer_id);
-		return;
-	}
-
-	if (_probe->probe_points[i].purpose == PROBE_PURPOSE_EXTRACTION) {
+	if (probe->purpose == PROBE_PURPOSE_EXTRACTION) {
 		format = probe_gen_format(buffer->stream.frame_fmt,
 					  buffer->stream.rate,
 					  buffer->stream.channels);
-		ret = probe_gen_header(buffer_id,
-				       cb_data->transaction_amount,
-				       format, &checksum);
-		if (ret < 0)
-			goto err;
 
 		/* check if transaction amount exceeds component buffer end addr */
 		/* if yes: divide copying into two stages, head and tail */
@@ -844,45 +1009,21 @@ static void probe_cb_produce(void *arg, enum notify_id type, void *data)
 			head = (uintptr_t)buffer->stream.end_addr -
 			       (uintptr_t)cb_data->transaction_begin_address;
 			tail = (uintptr_t)cb_data->transaction_amount - head;
-			ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-					      cb_data->transaction_begin_address,
-					      head);
-			if (ret < 0)
-				goto err;
-
-			ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-					      buffer->stream.addr, tail);
-			if (ret < 0)
-				goto err;
 		} else {
-			ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-					      cb_data->transaction_begin_address,
-					      cb_data->transaction_amount);
-			if (ret < 0)
-				goto err;
+			head = cb_data->transaction_amount;
+			tail = 0;
 		}
 
-		ret = copy_to_pbuffer(&_probe->ext_dma.dmapb,
-				      &checksum, sizeof(checksum));
+		ret = probe_extract(_probe, probe->buffer_id.full_id, format,
+				    cb_data->transaction_begin_address, head,
+				    buffer->stream.addr, tail);
 		if (ret < 0)
 			goto err;
 
 		kick_probe_task(_probe);
 	} else {
-		/* search for DMA used by this probe point */
-		for (j = 0; j < CONFIG_PROBE_DMA_MAX; j++) {
-			if (_probe->inject_dma[j].stream_tag !=
-			    PROBE_DMA_INVALID &&
-			    _probe->inject_dma[j].stream_tag ==
-			    _probe->probe_points[i].stream_tag) {
-				break;
-			}
-		}
-		if (j == CONFIG_PROBE_DMA_MAX) {
-			tr_err(&pr_tr, "probe_cb_produce(): dma not found");
-			return;
-		}
-		dma = &_probe->inject_dma[j];
+		/* DMA used by this probe point, resolved when it was added */
+		dma = _probe->point_dma[probe - _probe->probe_points];
 		/* get avail data info */
 		ret = dma_get_data_size_legacy(dma->dc.chan,
 					       &dma->dmapb.avail,
@@ -948,13 +1089,14 @@ err:
 
 /**
  * \brief Callback for buffer free, it will remove probe point.
- * \param[in] arg pointer (not used).
+ * \param[in] arg probe point connected to this buffer.
  * \param[in] type of notify.
  * \param[in] data pointer.
  */
 static void probe_cb_free(void *arg, enum notify_id type, void *data)
 {
-	uint32_t buffer_id = *(int *)arg;
+	struct probe_point *probe = arg;
+	uint32_t buffer_id = probe->buffer_id.full_id;
 	int ret;
 
 	tr_dbg(&pr_tr, "probe_cb_free() buffer_id = %u", buffer_id);
@@ -1167,6 +1309,7 @@ int probe_point_add(uint32_t count, const struct probe_point *probe)
 			}
 
 			stream_tag = probe[i].stream_tag;
+			_probe->point_dma[first_free] = &_probe->inject_dma[j];
 		} else {
 			/* prepare extraction DMA */
 			for (j = 0; j < CONFIG_PROBE_POINTS_MAX; j++) {
@@ -1181,6 +1324,7 @@ int probe_point_add(uint32_t count, const struct probe_point *probe)
 			}
 			/* ignore probe stream tag for extraction probes */
 			stream_tag = _probe->ext_dma.stream_tag;
+			_probe->point_dma[first_free] = NULL;
 		}
 
 		/* probe point valid, save it */
@@ -1195,17 +1339,18 @@ int probe_point_add(uint32_t count, const struct probe_point *probe)
 			return -EINVAL;
 #endif
 		} else {
-			probe_point_id_t *new_buf_id = &_probe->probe_points[first_free].buffer_id;
+			/* the probe point is the receiver so callbacks need no lookup */
+			struct probe_point *new_probe = &_probe->probe_points[first_free];
 
 #if CONFIG_IPC_MAJOR_4
-			notifier_register(&new_buf_id->full_id, buf, NOTIFIER_ID_BUFFER_PRODUCE,
+			notifier_register(new_probe, buf, NOTIFIER_ID_BUFFER_PRODUCE,
 					  &probe_cb_produce, 0);
-			notifier_register(&new_buf_id->full_id, buf, NOTIFIER_ID_BUFFER_FREE,
+			notifier_register(new_probe, buf, NOTIFIER_ID_BUFFER_FREE,
 					  &probe_cb_free, 0);
 #else
-			notifier_register(&new_buf_id->full_id, dev->cb, NOTIFIER_ID_BUFFER_PRODUCE,
+			notifier_register(new_probe, dev->cb, NOTIFIER_ID_BUFFER_PRODUCE,
 					  &probe_cb_produce, 0);
-			notifier_register(&new_buf_id->full_id, dev->cb, NOTIFIER_ID_BUFFER_FREE,
+			notifier_register(new_probe, dev->cb, NOTIFIER_ID_BUFFER_FREE,
 					  &probe_cb_free, 0);
 #endif
 		}
@@ -1294,12 +1439,8 @@ int probe_point_info(struct sof_ipc_probe_info_params *data, uint32_t max_size)
 int probe_point_remove(uint32_t count, const uint32_t *buffer_id)
 {
 	struct probe_pdata *_probe = probe_get();
-	struct ipc_comp_dev *dev;
 	uint32_t i;
 	uint32_t j;
-#if CONFIG_IPC_MAJOR_4
-	struct comp_buffer *buf;
-#endif
 
 	tr_dbg(&pr_tr, "probe_point_remove() count = %u", count);
 
@@ -1316,27 +1457,11 @@ int probe_point_remove(uint32_t count, const uint32_t *buffer_id)
 
 			if (_probe->probe_points[j].stream_tag != PROBE_POINT_INVALID &&
 			    buf_id->full_id == buffer_id[i]) {
-#if CONFIG_IPC_MAJOR_4
-				dev = ipc_get_comp_by_id(ipc_get(),
-							 IPC4_COMP_ID(buf_id->fields.module_id,
-								      buf_id->fields.instance_id));
-				if (dev) {
-					buf = ipc4_get_buffer(dev, *buf_id);
-					if (buf) {
-						notifier_unregister(NULL, buf,
-								    NOTIFIER_ID_BUFFER_PRODUCE);
-						notifier_unregister(NULL, buf,
-								    NOTIFIER_ID_BUFFER_FREE);
-					}
-				}
-#else
-				dev = ipc_get_comp_by_id(ipc_get(), buffer_id[i]);
-				if (dev) {
-					notifier_unregister(_probe, dev->cb,
-							    NOTIFIER_ID_BUFFER_PRODUCE);
-					notifier_unregister(_probe, dev->cb, NOTIFIER_ID_BUFFER_FREE);
-				}
-#endif
+				/* the probe point is the receiver of its buffer callbacks */
+				notifier_unregister(&_probe->probe_points[j], NULL,
+						    NOTIFIER_ID_BUFFER_PRODUCE);
+				notifier_unregister(&_probe->probe_points[j], NULL,
+						    NOTIFIER_ID_BUFFER_FREE);
 				_probe->probe_points[j].stream_tag =
 					PROBE_POINT_INVALID;
 			}
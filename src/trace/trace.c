@@ -7,6 +7,7 @@
 //         Karol Trzcinski <karolx.trzcinski@linux.intel.com>
 
 #include <sof/debug/panic.h>
+#include <rtos/interrupt.h>
 #include <sof/ipc/msg.h>
 #include <sof/ipc/topology.h>
 #include <rtos/timer.h>
@@ -33,15 +34,28 @@ LOG_MODULE_DECLARE(ipc, CONFIG_SOF_LOG_LEVEL);
 extern struct tr_ctx dt_tr;
 
 #if CONFIG_TRACE_FILTERING_ADAPTIVE
+/* hash slots, at most half of them are used to keep the probe sequences short */
+#define RECENT_HASH_SIZE	(2 * CONFIG_TRACE_RECENT_ENTRIES_COUNT)
+
+/* end of the recent entry lists */
+#define RECENT_NONE		-1
+
 struct recent_log_entry {
 	uint32_t entry_id;
 	uint64_t message_ts;
 	uint64_t first_suppression_ts;
 	uint32_t trigger_count;
+	int16_t prev;	/* previous entry in the least recently seen order */
+	int16_t next;	/* next entry in the least recently seen or free order */
 };
 
 struct recent_trace_context {
 	struct recent_log_entry recent_entries[CONFIG_TRACE_RECENT_ENTRIES_COUNT];
+	uint16_t hash[RECENT_HASH_SIZE];	/* entry index + 1, 0 for an empty slot */
+	int16_t oldest;			/* least recently seen entry */
+	int16_t newest;			/* most recently seen entry */
+	int16_t free;			/* first released entry */
+	int16_t unused;			/* first entry never taken into use */
 };
 #endif /* CONFIG_TRACE_FILTERING_ADAPTIVE */
 
@@ -132,40 +146,122 @@ static inline bool trace_filter_verbosity(uint32_t lvl, const struct tr_ctx *ctx
 #endif /* CONFIG_TRACE_FILTERING_VERBOSITY */
 
 #if CONFIG_TRACE_FILTERING_ADAPTIVE
-/** Report how many times an entry was suppressed and clear it. */
+static inline struct recent_trace_context *recent_trace_context_get(void)
+{
+	return &trace_get()->trace_core_context[cpu_get_id()];
+}
+
+/** Hash slot of a log entry ID, multiplicative hash reduced to the table size. */
+static inline int recent_hash(uint32_t entry_id)
+{
+	return ((uint64_t)(entry_id * 2654435761u) * RECENT_HASH_SIZE) >> 32;
+}
+
+static inline int recent_hash_next(int slot)
+{
+	return slot + 1 < RECENT_HASH_SIZE ? slot + 1 : 0;
+}
+
+/** Find the hash slot of an entry ID, or the empty slot ending its probe sequence. */
+static int recent_hash_find(struct recent_trace_context *ctx, uint32_t entry_id)
+{
+	int slot = recent_hash(entry_id);
+
+	while (ctx->hash[slot] &&
+	       ctx->recent_entries[ctx->hash[slot] - 1].entry_id != entry_id)
+		slot = recent_hash_next(slot);
+
+	return slot;
+}
+
+/** Empty a hash slot, moving back the entries whose probe sequence passed it. */
+static void recent_hash_remove(struct recent_trace_context *ctx, int slot)
+{
+	int next = slot;
+	int home;
+
+	for (;;) {
+		ctx->hash[slot] = 0;
+		do {
+			next = recent_hash_next(next);
+			if (!ctx->hash[next])
+				return;
+
+			home = recent_hash(ctx->recent_entries[ctx->hash[next] - 1].entry_id);
+			/* keep the entry in place if its home is cyclically in (slot, next] */
+		} while (slot <= next ? slot < home && home <= next :
+			 slot < home || home <= next);
+
+		ctx->hash[slot] = ctx->hash[next];
+		slot = next;
+	}
+}
+
+static void recent_list_unlink(struct recent_trace_context *ctx, int index)
+{
+	struct recent_log_entry *entry = &ctx->recent_entries[index];
+
+	if (entry->prev == RECENT_NONE)
+		ctx->oldest = entry->next;
+	else
+		ctx->recent_entries[entry->prev].next = entry->next;
+
+	if (entry->next == RECENT_NONE)
+		ctx->newest = entry->prev;
+	else
+		ctx->recent_entries[entry->next].prev = entry->prev;
+}
+
+static void recent_list_append(struct recent_trace_context *ctx, int index)
+{
+	struct recent_log_entry *entry = &ctx->recent_entries[index];
+
+	entry->prev = ctx->newest;
+	entry->next = RECENT_NONE;
+	if (ctx->newest == RECENT_NONE)
+		ctx->oldest = index;
+	else
+		ctx->recent_entries[ctx->newest].next = index;
+
+	ctx->newest = index;
+}
+
+/** Report how many times an entry was suppressed. */
 static void emit_suppressed_entry(struct recent_log_entry *entry)
 {
 	_log_message(trace_log_unfiltered, false, LOG_LEVEL_INFO, _TRACE_INV_CLASS, &dt_tr,
 		     _TRACE_INV_ID, _TRACE_INV_ID, "Suppressed %u similar messages: %pQ",
 		     entry->trigger_count - CONFIG_TRACE_BURST_COUNT,
 		     (void *)entry->entry_id);
+}
 
-	memset(entry, 0, sizeof(*entry));
+/** Stop tracking an entry, reporting its suppressed messages if any. */
+static void release_recent_entry(struct recent_trace_context *ctx, int index)
+{
+	struct recent_log_entry *entry = &ctx->recent_entries[index];
+
+	if (entry->trigger_count > CONFIG_TRACE_BURST_COUNT)
+		emit_suppressed_entry(entry);
+
+	recent_hash_remove(ctx, recent_hash_find(ctx, entry->entry_id));
+	recent_list_unlink(ctx, index);
+	entry->next = ctx->free;
+	ctx->free = index;
 }
 
 /** Flush entries that have not been seen again in the last
  * CONFIG_TRACE_RECENT_TIME_THRESHOLD microseconds before current_ts.
+ * The entries are kept in the order they were last seen so only the
+ * expired ones at the head of the list are visited.
  */
 static void emit_recent_entries(uint64_t current_ts)
 {
-	struct trace *trace = trace_get();
-	struct recent_log_entry *recent_entries =
-		trace->trace_core_context[cpu_get_id()].recent_entries;
-	int i;
-
-	/* Check if any tracked entries were dormant long enough to unsuppress them */
-	for (i = 0; i < CONFIG_TRACE_RECENT_ENTRIES_COUNT; i++) {
-		if (recent_entries[i].entry_id) {
-			if (current_ts - recent_entries[i].message_ts >
-			    CONFIG_TRACE_RECENT_TIME_THRESHOLD) {
-				if (recent_entries[i].trigger_count > CONFIG_TRACE_BURST_COUNT)
-					emit_suppressed_entry(&recent_entries[i]);
-				else
-					memset(&recent_entries[i], 0, sizeof(recent_entries[i]));
-			}
-		}
-	}
+	struct recent_trace_context *ctx = recent_trace_context_get();
 
+	while (ctx->oldest != RECENT_NONE &&
+	       current_ts - ctx->recent_entries[ctx->oldest].message_ts >
+	       CONFIG_TRACE_RECENT_TIME_THRESHOLD)
+		release_recent_entry(ctx, ctx->oldest);
 }
 
 /**
@@ -177,59 +273,68 @@ static void emit_recent_entries(uint64_t current_ts)
  */
 static bool trace_filter_flood(uint32_t log_level, uint32_t entry, uint64_t message_ts)
 {
-	struct trace *trace = trace_get();
-	struct recent_log_entry *recent_entries =
-		trace->trace_core_context[cpu_get_id()].recent_entries;
-	struct recent_log_entry *oldest_entry = recent_entries;
-	int i;
+	struct recent_trace_context *ctx = recent_trace_context_get();
+	struct recent_log_entry *recent_entry;
+	int slot;
+	int index;
 
 	/* don't attempt to suppress debug messages using this method, it would be uneffective */
 	if (log_level >= LOG_LEVEL_DEBUG)
 		return true;
 
 	/* check if same log entry was sent recently */
-	for (i = 0; i < CONFIG_TRACE_RECENT_ENTRIES_COUNT; i++) {
-		/* Identify the oldest (or empty) entry to evict if we have no match  */
-		if (oldest_entry->first_suppression_ts > recent_entries[i].first_suppression_ts)
-			oldest_entry = &recent_entries[i];
-
-		if (recent_entries[i].entry_id == entry) {
-			/* We have a match but include this message in this burst only if the
-			 * burst:
-			   - 1. hasn't lasted for too long;
-			   - 2. hasn't been quiet for too long.
-			 */
-			if (message_ts - recent_entries[i].first_suppression_ts <
-			    CONFIG_TRACE_RECENT_MAX_TIME &&
-			    message_ts - recent_entries[i].message_ts <
-			    CONFIG_TRACE_RECENT_TIME_THRESHOLD) {
-				recent_entries[i].trigger_count++;
-				/* Refresh last seen time */
-				recent_entries[i].message_ts = message_ts;
-
-				/* Allow the start of a burst to be printed normally */
-				return recent_entries[i].trigger_count <= CONFIG_TRACE_BURST_COUNT;
-			}
+	slot = recent_hash_find(ctx, entry);
+	if (ctx->hash[slot]) {
+		index = ctx->hash[slot] - 1;
+		recent_entry = &ctx->recent_entries[index];
+
+		/* We have a match but include this message in this burst only if the
+		 * burst:
+		   - 1. hasn't lasted for too long;
+		   - 2. hasn't been quiet for too long.
+		 */
+		if (message_ts - recent_entry->first_suppression_ts <
+		    CONFIG_TRACE_RECENT_MAX_TIME &&
+		    message_ts - recent_entry->message_ts <
+		    CONFIG_TRACE_RECENT_TIME_THRESHOLD) {
+			recent_entry->trigger_count++;
+			/* Refresh last seen time */
+			recent_entry->message_ts = message_ts;
+			recent_list_unlink(ctx, index);
+			recent_list_append(ctx, index);
+
+			/* Allow the start of a burst to be printed normally */
+			return recent_entry->trigger_count <= CONFIG_TRACE_BURST_COUNT;
+		}
 
-			/* Emit and clear this burst */
-			if (recent_entries[i].trigger_count > CONFIG_TRACE_BURST_COUNT)
-				emit_suppressed_entry(&recent_entries[i]);
-			else
-				memset(&recent_entries[i], 0, sizeof(recent_entries[i]));
+		/* Emit and clear this burst */
+		release_recent_entry(ctx, index);
 
-			return true;
-		}
+		return true;
 	}
 
-	/* Make room for tracking new entry, by emitting the oldest one in the filter */
-	if (oldest_entry->entry_id && oldest_entry->trigger_count > CONFIG_TRACE_BURST_COUNT)
-		emit_suppressed_entry(oldest_entry);
+	/* Make room for tracking new entry, by emitting the least recently seen one */
+	if (ctx->free == RECENT_NONE && ctx->unused == CONFIG_TRACE_RECENT_ENTRIES_COUNT) {
+		release_recent_entry(ctx, ctx->oldest);
+		/* the release may have moved the empty slot of the new entry */
+		slot = recent_hash_find(ctx, entry);
+	}
+
+	if (ctx->free != RECENT_NONE) {
+		index = ctx->free;
+		ctx->free = ctx->recent_entries[index].next;
+	} else {
+		index = ctx->unused++;
+	}
 
 	/* Start a new burst */
-	oldest_entry->entry_id = entry;
-	oldest_entry->message_ts = message_ts;
-	oldest_entry->first_suppression_ts = message_ts;
-	oldest_entry->trigger_count = 1;
+	recent_entry = &ctx->recent_entries[index];
+	recent_entry->entry_id = entry;
+	recent_entry->message_ts = message_ts;
+	recent_entry->first_suppression_ts = message_ts;
+	recent_entry->trigger_count = 1;
+	ctx->hash[slot] = index + 1;
+	recent_list_append(ctx, index);
 
 	return true;
 }
@@ -289,10 +394,18 @@ void trace_log_filtered(bool send_atomic, const void *log_entry, const struct tr
 #if CONFIG_TRACE_FILTERING_ADAPTIVE
 	if (!trace->user_filter_override) {
 		const uint64_t current_ts = sof_cycle_get_64_safe();
+		uint32_t flags;
+		bool emit;
 
+		/* the recent entries of this core are not consistent while the hash
+		 * and the lists are updated, a log from an interrupt would walk them
+		 */
+		irq_local_disable(flags);
 		emit_recent_entries(current_ts);
+		emit = trace_filter_flood(lvl, (uint32_t)log_entry, current_ts);
+		irq_local_enable(flags);
 
-		if (!trace_filter_flood(lvl, (uint32_t)log_entry, current_ts))
+		if (!emit)
 			return;
 	}
 #endif /* CONFIG_TRACE_FILTERING_ADAPTIVE */
@@ -499,11 +612,22 @@ void trace_off(void)
 
 void trace_init(struct sof *sof)
 {
+#if CONFIG_TRACE_FILTERING_ADAPTIVE
+	struct recent_trace_context *ctx;
+	int i;
+#endif /* CONFIG_TRACE_FILTERING_ADAPTIVE */
+
 	sof->trace = rzalloc(SOF_MEM_ZONE_SYS_SHARED, 0, SOF_MEM_CAPS_RAM, sizeof(*sof->trace));
 	sof->trace->enable = 1;
 	sof->trace->pos = 0;
 #if CONFIG_TRACE_FILTERING_ADAPTIVE
 	sof->trace->user_filter_override = false;
+	for (i = 0; i < CONFIG_CORE_COUNT; i++) {
+		ctx = &sof->trace->trace_core_context[i];
+		ctx->oldest = RECENT_NONE;
+		ctx->newest = RECENT_NONE;
+		ctx->free = RECENT_NONE;
+	}
 #endif /* CONFIG_TRACE_FILTERING_ADAPTIVE */
 	k_spinlock_init(&sof->trace->lock);
 
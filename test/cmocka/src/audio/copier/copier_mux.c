@@ -0,0 +1,190 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <sof/audio/audio_stream.h>
+#include <ipc4/copier.h>
+#include <ipc/stream.h>
+
+#include "../../util.h"
+
+#define TEST_ENDPOINTS		3
+#define TEST_MULTI_CHANNELS	6
+#define TEST_FRAMES		5
+
+/* the multi-endpoint stream buffer size and start in frames */
+#define TEST_MULTI_FRAMES	8
+#define TEST_MULTI_OFFSET	6
+
+static uint32_t test_seed;
+
+/* The channels of all endpoints are spread over the multi-endpoint stream in a
+ * different order than the endpoints.
+ */
+static const uint16_t test_chmap0[] = { 4 };
+static const uint16_t test_chmap1[] = { 1, 5 };
+static const uint16_t test_chmap2[] = { 3, 0, 2 };
+
+static const uint16_t *test_chmap[TEST_ENDPOINTS] = {
+	test_chmap0, test_chmap1, test_chmap2,
+};
+
+/* Buffer size and start of the endpoint streams in frames, all of them wrap
+ * at a different frame.
+ */
+static const int test_endp_frames[TEST_ENDPOINTS] = { 5, 6, 9 };
+static const int test_endp_offset[TEST_ENDPOINTS] = { 3, 5, 1 };
+
+static int32_t test_rand(void)
+{
+	test_seed = test_seed * 1664525 + 1013904223;
+	return (int32_t)test_seed;
+}
+
+static void test_stream_init(struct audio_stream *stream, enum sof_ipc_frame frame_fmt,
+			     int channels, int frames, int offset_frames)
+{
+	int sample_bytes = frame_fmt == SOF_IPC_FRAME_S16_LE ? sizeof(int16_t) : sizeof(int32_t);
+	uint32_t size = frames * channels * sample_bytes;
+	uint8_t *data = test_calloc(1, size);
+	int i;
+
+	for (i = 0; i < frames * channels; i++) {
+		if (sample_bytes == sizeof(int16_t))
+			((int16_t *)data)[i] = test_rand() >> 16;
+		else
+			((int32_t *)data)[i] = test_rand();
+	}
+
+	stream->frame_fmt = frame_fmt;
+	stream->channels = channels;
+	audio_stream_init(stream, data, size);
+	stream->r_ptr = data + offset_frames * channels * sample_bytes;
+	stream->w_ptr = stream->r_ptr;
+}
+
+/* Sample of channel ch in frame of the stream counted from ptr, with wrap */
+static int32_t test_sample(const struct audio_stream *stream, void *ptr, int frame, int ch)
+{
+	int sample_bytes = audio_stream_sample_bytes(stream);
+	uint8_t *p = (uint8_t *)ptr + (frame * stream->channels + ch) * sample_bytes;
+
+	p = audio_stream_wrap(stream, p);
+	if (sample_bytes == sizeof(int16_t))
+		return *(int16_t *)p;
+
+	return *(int32_t *)p;
+}
+
+static void test_streams_init(struct audio_stream *multi, struct audio_stream *endp_stream,
+			      struct audio_stream __sparse_cache **endp,
+			      enum sof_ipc_frame frame_fmt)
+{
+	int i;
+
+	test_stream_init(multi, frame_fmt, TEST_MULTI_CHANNELS, TEST_MULTI_FRAMES,
+			 TEST_MULTI_OFFSET);
+	for (i = 0; i < TEST_ENDPOINTS; i++) {
+		test_stream_init(&endp_stream[i], frame_fmt, i + 1, test_endp_frames[i],
+				 test_endp_offset[i]);
+		endp[i] = &endp_stream[i];
+	}
+}
+
+static void test_streams_free(struct audio_stream *multi, struct audio_stream *endp_stream)
+{
+	int i;
+
+	for (i = 0; i < TEST_ENDPOINTS; i++)
+		test_free(endp_stream[i].addr);
+
+	test_free(multi->addr);
+}
+
+static void test_demux(enum sof_ipc_frame frame_fmt, multi_endpoint_func demux)
+{
+	struct audio_stream endp_stream[TEST_ENDPOINTS];
+	struct audio_stream __sparse_cache *endp[TEST_ENDPOINTS];
+	struct audio_stream multi;
+	int frame, i, ch;
+
+	test_streams_init(&multi, endp_stream, endp, frame_fmt);
+
+	demux(&multi, endp, test_chmap, TEST_ENDPOINTS, TEST_FRAMES);
+
+	for (frame = 0; frame < TEST_FRAMES; frame++)
+		for (i = 0; i < TEST_ENDPOINTS; i++)
+			for (ch = 0; ch < endp[i]->channels; ch++)
+				assert_int_equal(test_sample(endp[i], endp[i]->w_ptr, frame, ch),
+						 test_sample(&multi, multi.r_ptr, frame,
+							     test_chmap[i][ch]));
+
+	test_streams_free(&multi, endp_stream);
+}
+
+static void test_mux(enum sof_ipc_frame frame_fmt, multi_endpoint_func mux)
+{
+	struct audio_stream endp_stream[TEST_ENDPOINTS];
+	struct audio_stream __sparse_cache *endp[TEST_ENDPOINTS];
+	struct audio_stream multi;
+	int frame, i, ch;
+
+	test_streams_init(&multi, endp_stream, endp, frame_fmt);
+
+	mux(&multi, endp, test_chmap, TEST_ENDPOINTS, TEST_FRAMES);
+
+	for (frame = 0; frame < TEST_FRAMES; frame++)
+		for (i = 0; i < TEST_ENDPOINTS; i++)
+			for (ch = 0; ch < endp[i]->channels; ch++)
+				assert_int_equal(test_sample(&multi, multi.w_ptr, frame,
+							     test_chmap[i][ch]),
+						 test_sample(endp[i], endp[i]->r_ptr, frame, ch));
+
+	test_streams_free(&multi, endp_stream);
+}
+
+static void test_copier_demux_c16(void **state)
+{
+	test_demux(SOF_IPC_FRAME_S16_LE, demux_c16);
+}
+
+static void test_copier_demux_c32(void **state)
+{
+	test_demux(SOF_IPC_FRAME_S32_LE, demux_c32);
+}
+
+static void test_copier_mux_c16(void **state)
+{
+	test_mux(SOF_IPC_FRAME_S16_LE, mux_c16);
+}
+
+static void test_copier_mux_c32(void **state)
+{
+	test_mux(SOF_IPC_FRAME_S32_LE, mux_c32);
+}
+
+static int setup(void **state)
+{
+	test_seed = 1;
+	return 0;
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup(test_copier_demux_c16, setup),
+		cmocka_unit_test_setup(test_copier_demux_c32, setup),
+		cmocka_unit_test_setup(test_copier_mux_c16, setup),
+		cmocka_unit_test_setup(test_copier_mux_c32, setup),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
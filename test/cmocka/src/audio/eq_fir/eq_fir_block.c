@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include <sof/math/fir_config.h>
+#include <sof/math/fir_generic.h>
+#include <user/fir.h>
+
+#include "../../util.h"
+
+#if !FIR_GENERIC || FIR_X86
+#error "This test needs to be built without the x86 SIMD flags"
+#endif
+
+#define TEST_SAMPLES		509
+
+struct test_fir {
+	struct fir_state_32x16 fir;
+	struct fir_state_32x16 ref;
+	struct sof_fir_coef_data *config;
+	int32_t *delay;
+	int32_t *ref_delay;
+	int32_t x[TEST_SAMPLES];
+	int32_t y[TEST_SAMPLES];
+	int32_t y_ref[TEST_SAMPLES];
+};
+
+static uint32_t test_seed;
+
+static int32_t test_rand(void)
+{
+	test_seed = test_seed * 1664525 + 1013904223;
+	return (int32_t)test_seed;
+}
+
+/* Random full scale coefficients and input, out_shift 0 makes the
+ * saturation paths to be exercised too.
+ */
+static struct test_fir *test_fir_new(int taps, int out_shift)
+{
+	struct test_fir *tf = test_calloc(1, sizeof(*tf));
+	int32_t *data;
+	int size;
+	int i;
+
+	tf->config = test_calloc(1, sizeof(*tf->config) + taps * sizeof(int16_t));
+	tf->config->length = taps;
+	tf->config->out_shift = out_shift;
+	for (i = 0; i < taps; i++)
+		tf->config->coef[i] = test_rand() >> 16;
+
+	for (i = 0; i < TEST_SAMPLES; i++)
+		tf->x[i] = test_rand();
+
+	size = fir_delay_size(tf->config);
+	assert_true(size > 0);
+	tf->delay = test_calloc(1, size);
+	tf->ref_delay = test_calloc(1, size);
+	fir_init_coef(&tf->fir, tf->config);
+	data = tf->delay;
+	fir_init_delay(&tf->fir, &data);
+	fir_init_coef(&tf->ref, tf->config);
+	data = tf->ref_delay;
+	fir_init_delay(&tf->ref, &data);
+	return tf;
+}
+
+static void test_fir_free(struct test_fir *tf)
+{
+	test_free(tf->ref_delay);
+	test_free(tf->delay);
+	test_free(tf->config);
+	test_free(tf);
+}
+
+/* Processes the input in blocks of varying length, so the four sample
+ * version starts at every delay line position and the blocks that are not
+ * a multiple of four leave a tail for the single sample version.
+ */
+static void test_fir_block(struct test_fir *tf, const int *blocks, int num_blocks)
+{
+	int i, j, n;
+
+	for (i = 0; i < TEST_SAMPLES; i++)
+		tf->y_ref[i] = fir_32x16(&tf->ref, tf->x[i]);
+
+	for (i = 0, j = 0; i < TEST_SAMPLES; i += n, j = (j + 1) % num_blocks) {
+		n = MIN(blocks[j], TEST_SAMPLES - i);
+		fir_32x16_block(&tf->fir, &tf->x[i], &tf->y[i], n);
+	}
+
+	assert_memory_equal(tf->y, tf->y_ref, sizeof(tf->y));
+}
+
+static const int test_taps[] = {4, 8, 12, 20, 44, 100, SOF_FIR_MAX_LENGTH};
+static const int test_shifts[] = {0, 2};
+
+static void test_eq_fir_block_lengths(void **state)
+{
+	const int blocks[] = {1, 2, 3, 4, 5, 6, 7, 8, 9, 13, 16, 33, 48, 63};
+	struct test_fir *tf;
+	int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(test_taps); i++) {
+		for (j = 0; j < ARRAY_SIZE(test_shifts); j++) {
+			tf = test_fir_new(test_taps[i], test_shifts[j]);
+			test_fir_block(tf, blocks, ARRAY_SIZE(blocks));
+			test_fir_free(tf);
+		}
+	}
+}
+
+/* A constant block length that is not a multiple of four, the delay line
+ * position of the four sample version drifts by three every block.
+ */
+static void test_eq_fir_block_odd(void **state)
+{
+	const int blocks[] = {7};
+	struct test_fir *tf;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(test_taps); i++) {
+		tf = test_fir_new(test_taps[i], 1);
+		test_fir_block(tf, blocks, ARRAY_SIZE(blocks));
+		test_fir_free(tf);
+	}
+}
+
+/* The whole input in one call */
+static void test_eq_fir_block_single(void **state)
+{
+	const int blocks[] = {TEST_SAMPLES};
+	struct test_fir *tf;
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(test_taps); i++) {
+		tf = test_fir_new(test_taps[i], 0);
+		test_fir_block(tf, blocks, ARRAY_SIZE(blocks));
+		test_fir_free(tf);
+	}
+}
+
+/* The bypass mode set by fir_reset() copies the input */
+static void test_eq_fir_block_bypass(void **state)
+{
+	struct test_fir *tf = test_fir_new(4, 0);
+
+	fir_reset(&tf->fir);
+	fir_32x16_block(&tf->fir, tf->x, tf->y, TEST_SAMPLES);
+	assert_memory_equal(tf->y, tf->x, sizeof(tf->y));
+	test_fir_free(tf);
+}
+
+static int setup(void **state)
+{
+	test_seed = 1;
+	return 0;
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup(test_eq_fir_block_lengths, setup),
+		cmocka_unit_test_setup(test_eq_fir_block_odd, setup),
+		cmocka_unit_test_setup(test_eq_fir_block_single, setup),
+		cmocka_unit_test_setup(test_eq_fir_block_bypass, setup),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
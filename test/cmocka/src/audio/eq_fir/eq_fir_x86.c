@@ -0,0 +1,169 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cmocka.h>
+#include <sof/math/fir_config.h>
+#include <sof/math/fir_generic.h>
+#include <user/fir.h>
+
+#include "../../util.h"
+#include "fir_generic_ref.h"
+
+#if !FIR_X86
+#error "This test needs to be built with the x86 SIMD flags"
+#endif
+
+#ifdef __AVX2__
+#define TEST_CPU_FEATURE	"avx2"
+#else
+#define TEST_CPU_FEATURE	"sse4.2"
+#endif
+
+#define TEST_SAMPLES		257
+
+struct test_fir {
+	struct fir_state_32x16 fir;
+	struct fir_state_32x16 ref;
+	struct sof_fir_coef_data *config;
+	int32_t *delay;
+	int32_t *ref_delay;
+	int32_t x[TEST_SAMPLES];
+	int32_t y[TEST_SAMPLES];
+	int32_t y_ref[TEST_SAMPLES];
+};
+
+static uint32_t test_seed;
+
+static int32_t test_rand(void)
+{
+	test_seed = test_seed * 1664525 + 1013904223;
+	return (int32_t)test_seed;
+}
+
+/* Random full scale coefficients and input, out_shift 0 makes the
+ * saturation paths to be exercised too.
+ */
+static struct test_fir *test_fir_new(int taps, int out_shift)
+{
+	struct test_fir *tf = test_calloc(1, sizeof(*tf));
+	int32_t *data;
+	int i;
+
+	tf->config = test_calloc(1, sizeof(*tf->config) + taps * sizeof(int16_t));
+	tf->config->length = taps;
+	tf->config->out_shift = out_shift;
+	for (i = 0; i < taps; i++)
+		tf->config->coef[i] = test_rand() >> 16;
+
+	for (i = 0; i < TEST_SAMPLES; i++)
+		tf->x[i] = test_rand();
+
+	tf->delay = test_calloc(taps + 4, sizeof(int32_t));
+	tf->ref_delay = test_calloc(taps + 4, sizeof(int32_t));
+	fir_init_coef(&tf->fir, tf->config);
+	data = tf->delay;
+	fir_init_delay(&tf->fir, &data);
+	generic_fir_init_coef(&tf->ref, tf->config);
+	data = tf->ref_delay;
+	generic_fir_init_delay(&tf->ref, &data);
+	return tf;
+}
+
+static void test_fir_free(struct test_fir *tf)
+{
+	test_free(tf->ref_delay);
+	test_free(tf->delay);
+	test_free(tf->config);
+	test_free(tf);
+}
+
+static const int test_taps[] = {4, 8, 12, 16, 20, 44, 100};
+static const int test_shifts[] = {0, 2};
+
+static void test_eq_fir_x86_32x16(void **state)
+{
+	struct test_fir *tf;
+	int i, j, k;
+
+	for (i = 0; i < ARRAY_SIZE(test_taps); i++) {
+		for (j = 0; j < ARRAY_SIZE(test_shifts); j++) {
+			tf = test_fir_new(test_taps[i], test_shifts[j]);
+			for (k = 0; k < TEST_SAMPLES; k++) {
+				tf->y[k] = fir_32x16(&tf->fir, tf->x[k]);
+				tf->y_ref[k] = generic_fir_32x16(&tf->ref, tf->x[k]);
+			}
+
+			assert_memory_equal(tf->y, tf->y_ref, sizeof(tf->y));
+			test_fir_free(tf);
+		}
+	}
+}
+
+static void test_eq_fir_x86_32x16_2x(void **state)
+{
+	struct test_fir *tf;
+	int i, j, k;
+
+	for (i = 0; i < ARRAY_SIZE(test_taps); i++) {
+		for (j = 0; j < ARRAY_SIZE(test_shifts); j++) {
+			tf = test_fir_new(test_taps[i], test_shifts[j]);
+			for (k = 0; k < TEST_SAMPLES - 1; k += 2) {
+				fir_32x16_2x(&tf->fir, tf->x[k], tf->x[k + 1],
+					     &tf->y[k], &tf->y[k + 1]);
+				generic_fir_32x16_2x(&tf->ref, tf->x[k], tf->x[k + 1],
+						     &tf->y_ref[k], &tf->y_ref[k + 1]);
+			}
+
+			assert_memory_equal(tf->y, tf->y_ref, sizeof(tf->y));
+			test_fir_free(tf);
+		}
+	}
+}
+
+static void test_eq_fir_x86_block(void **state)
+{
+	const int blocks[] = {1, 3, 4, 5, 7, 16, 33};
+	struct test_fir *tf;
+	int i, j, k, n;
+
+	for (i = 0; i < ARRAY_SIZE(test_taps); i++) {
+		tf = test_fir_new(test_taps[i], 0);
+		for (j = 0, k = 0; k < TEST_SAMPLES; j = (j + 1) % ARRAY_SIZE(blocks)) {
+			n = MIN(blocks[j], TEST_SAMPLES - k);
+			fir_32x16_block(&tf->fir, &tf->x[k], &tf->y[k], n);
+			generic_fir_32x16_block(&tf->ref, &tf->x[k], &tf->y_ref[k], n);
+			k += n;
+		}
+
+		assert_memory_equal(tf->y, tf->y_ref, sizeof(tf->y));
+		test_fir_free(tf);
+	}
+}
+
+static int setup(void **state)
+{
+	if (!__builtin_cpu_supports(TEST_CPU_FEATURE))
+		skip();
+
+	test_seed = 1;
+	return 0;
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup(test_eq_fir_x86_32x16, setup),
+		cmocka_unit_test_setup(test_eq_fir_x86_32x16_2x, setup),
+		cmocka_unit_test_setup(test_eq_fir_x86_block, setup),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,23 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2022 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __FIR_GENERIC_REF_H__
+#define __FIR_GENERIC_REF_H__
+
+#include <sof/math/fir_generic.h>
+#include <user/fir.h>
+#include <stdint.h>
+
+/* The generic C version, built without the SIMD flags and with the symbols
+ * renamed, see CMakeLists.txt.
+ */
+int generic_fir_init_coef(struct fir_state_32x16 *fir, struct sof_fir_coef_data *config);
+void generic_fir_init_delay(struct fir_state_32x16 *fir, int32_t **data);
+int32_t generic_fir_32x16(struct fir_state_32x16 *fir, int32_t x);
+void generic_fir_32x16_2x(struct fir_state_32x16 *fir, int32_t x0, int32_t x1,
+			  int32_t *y0, int32_t *y1);
+void generic_fir_32x16_block(struct fir_state_32x16 *fir, const int32_t *x, int32_t *y, int n);
+
+#endif /* __FIR_GENERIC_REF_H__ */
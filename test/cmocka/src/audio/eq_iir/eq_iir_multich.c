@@ -0,0 +1,350 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <sof/audio/format.h>
+#include <sof/audio/crossover/crossover.h>
+#include <sof/math/iir_df1.h>
+#include <sof/math/iir_df2t.h>
+#include <user/eq.h>
+
+#include "../../util.h"
+
+#define TEST_FRAMES		203
+#define TEST_MAX_SECTIONS	4
+#define TEST_NUM_BIQUADS	4
+
+/* The channels process the first frames one at a time, the rest of the
+ * frames are run through the multichannel filter in blocks.
+ */
+#define TEST_PREFIX_FRAMES	5
+
+/* The biquads of the 2ch EQ IIR test blob, {a2, a1, b2, b1, b0, shift, gain} */
+static const int32_t test_biquads[TEST_NUM_BIQUADS][SOF_EQ_IIR_NBIQUAD] = {
+	{0xc12c82bd, 0x7ed0b52e, 0x1fc7cc0c, 0xc07067e9, 0x1fc7cc0c, 0, 0x4000},
+	{0xcad0cdef, 0x742e8c5d, 0x0cdc9086, 0xe2f11723, 0x10b2f932, 0, 0x4000},
+	{0xcf45334a, 0x68260de9, 0x0a54e176, 0xe5d6cb75, 0x11fc1f3d, 0, 0x4000},
+	{0xf2940609, 0xe25f3930, 0x0d69ba64, 0x1ad374c8, 0x0d69ba64, -5, 0x45bf},
+};
+
+static const int test_channels[] = {1, 2, 8};
+static const int test_blocks[] = {1, 2, 3, 16, 5, 31};
+
+struct test_iir_config {
+	struct sof_eq_iir_header hdr;
+	int32_t biquads[TEST_MAX_SECTIONS * SOF_EQ_IIR_NBIQUAD];
+};
+
+static uint32_t test_seed;
+
+static int32_t test_rand(void)
+{
+	test_seed = test_seed * 1664525 + 1013904223;
+	return (int32_t)test_seed;
+}
+
+/* Full scale input every third sample so that the saturation is hit, the
+ * others are scaled down.
+ */
+static void test_input(int32_t *x, int samples)
+{
+	int i;
+
+	for (i = 0; i < samples; i++)
+		x[i] = test_rand() >> (i % 3 ? 3 : 0);
+}
+
+/* Every channel gets its own sections and gain, chosen by seed */
+static void test_config_init(struct test_iir_config *config, int sections, int series,
+			     int seed)
+{
+	int32_t *biquad;
+	int i;
+
+	memset_s(config, sizeof(*config), 0, sizeof(*config));
+	config->hdr.num_sections = sections;
+	config->hdr.num_sections_in_series = series;
+	for (i = 0; i < sections; i++) {
+		biquad = &config->biquads[i * SOF_EQ_IIR_NBIQUAD];
+		memcpy_s(biquad, SOF_EQ_IIR_NBIQUAD * sizeof(int32_t),
+			 test_biquads[(seed + i) % TEST_NUM_BIQUADS],
+			 SOF_EQ_IIR_NBIQUAD * sizeof(int32_t));
+		biquad[6] += 1000 * (seed % 5) - 2000;
+	}
+}
+
+static void test_df2t(int nch, int sections, int series)
+{
+	struct test_iir_config config[PLATFORM_MAX_CHANNELS];
+	struct iir_state_df2t iir[PLATFORM_MAX_CHANNELS];
+	struct iir_state_df2t ref[PLATFORM_MAX_CHANNELS];
+	struct iir_state_df2t_multich mc;
+	const int samples = TEST_FRAMES * nch;
+	int32_t *x = test_calloc(samples, sizeof(int32_t));
+	int32_t *y = test_calloc(samples, sizeof(int32_t));
+	int32_t *y_ref = test_calloc(samples, sizeof(int32_t));
+	int64_t *delay;
+	int64_t *ref_delay;
+	void *data;
+	int size;
+	int ch, f, i, n;
+
+	for (ch = 0; ch < nch; ch++) {
+		test_config_init(&config[ch], sections, series, ch);
+		size = iir_delay_size_df2t(&config[ch].hdr);
+		assert_true(size > 0);
+		delay = test_calloc(1, size);
+		ref_delay = test_calloc(1, size);
+		iir_init_coef_df2t(&iir[ch], &config[ch].hdr);
+		iir_init_delay_df2t(&iir[ch], &delay);
+		iir_init_coef_df2t(&ref[ch], &config[ch].hdr);
+		iir_init_delay_df2t(&ref[ch], &ref_delay);
+	}
+
+	test_input(x, samples);
+	for (f = 0; f < TEST_FRAMES; f++)
+		for (ch = 0; ch < nch; ch++)
+			y_ref[f * nch + ch] = iir_df2t(&ref[ch], x[f * nch + ch]);
+
+	for (f = 0; f < TEST_PREFIX_FRAMES; f++)
+		for (ch = 0; ch < nch; ch++)
+			y[f * nch + ch] = iir_df2t(&iir[ch], x[f * nch + ch]);
+
+	/* the delays of the prefix carry over to the multichannel state */
+	size = iir_multich_size_df2t(iir, nch);
+	assert_true(size > 0);
+	data = test_calloc(1, size);
+	iir_init_multich_df2t(&mc, iir, nch, data);
+	for (f = TEST_PREFIX_FRAMES, i = 0; f < TEST_FRAMES;
+	     f += n, i = (i + 1) % ARRAY_SIZE(test_blocks)) {
+		n = MIN(test_blocks[i], TEST_FRAMES - f);
+		iir_df2t_multich(&mc, &x[f * nch], &y[f * nch], n);
+	}
+
+	assert_memory_equal(y, y_ref, samples * sizeof(int32_t));
+
+	test_free(data);
+	for (ch = 0; ch < nch; ch++) {
+		test_free(ref[ch].delay);
+		test_free(iir[ch].delay);
+	}
+	test_free(y_ref);
+	test_free(y);
+	test_free(x);
+}
+
+static void test_df1(int nch, int sections, int series)
+{
+	struct test_iir_config config[PLATFORM_MAX_CHANNELS];
+	struct iir_state_df1 iir[PLATFORM_MAX_CHANNELS];
+	struct iir_state_df1 ref[PLATFORM_MAX_CHANNELS];
+	struct iir_state_df1_multich mc;
+	const int samples = TEST_FRAMES * nch;
+	int32_t *x = test_calloc(samples, sizeof(int32_t));
+	int32_t *y = test_calloc(samples, sizeof(int32_t));
+	int32_t *y_ref = test_calloc(samples, sizeof(int32_t));
+	int32_t *delay;
+	int32_t *ref_delay;
+	void *data;
+	int size;
+	int ch, f, i, n;
+
+	for (ch = 0; ch < nch; ch++) {
+		test_config_init(&config[ch], sections, series, ch);
+		size = iir_delay_size_df1(&config[ch].hdr);
+		assert_true(size > 0);
+		delay = test_calloc(1, size);
+		ref_delay = test_calloc(1, size);
+		iir_init_coef_df1(&iir[ch], &config[ch].hdr);
+		iir_init_delay_df1(&iir[ch], &delay);
+		iir_init_coef_df1(&ref[ch], &config[ch].hdr);
+		iir_init_delay_df1(&ref[ch], &ref_delay);
+	}
+
+	test_input(x, samples);
+	for (f = 0; f < TEST_FRAMES; f++)
+		for (ch = 0; ch < nch; ch++)
+			y_ref[f * nch + ch] = iir_df1(&ref[ch], x[f * nch + ch]);
+
+	for (f = 0; f < TEST_PREFIX_FRAMES; f++)
+		for (ch = 0; ch < nch; ch++)
+			y[f * nch + ch] = iir_df1(&iir[ch], x[f * nch + ch]);
+
+	size = iir_multich_size_df1(iir, nch);
+	assert_true(size > 0);
+	data = test_calloc(1, size);
+	iir_init_multich_df1(&mc, iir, nch, data);
+	for (f = TEST_PREFIX_FRAMES, i = 0; f < TEST_FRAMES;
+	     f += n, i = (i + 1) % ARRAY_SIZE(test_blocks)) {
+		n = MIN(test_blocks[i], TEST_FRAMES - f);
+		iir_df1_multich(&mc, &x[f * nch], &y[f * nch], n);
+	}
+
+	assert_memory_equal(y, y_ref, samples * sizeof(int32_t));
+
+	test_free(data);
+	for (ch = 0; ch < nch; ch++) {
+		test_free(ref[ch].delay);
+		test_free(iir[ch].delay);
+	}
+	test_free(y_ref);
+	test_free(y);
+	test_free(x);
+}
+
+/* Sections in series only, two parallel branches of two and one section */
+static const int test_layouts[][2] = {{4, 4}, {4, 2}, {1, 1}};
+
+static void test_eq_iir_multich_df2t(void **state)
+{
+	int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(test_channels); i++)
+		for (j = 0; j < ARRAY_SIZE(test_layouts); j++)
+			test_df2t(test_channels[i], test_layouts[j][0], test_layouts[j][1]);
+}
+
+static void test_eq_iir_multich_df1(void **state)
+{
+	int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(test_channels); i++)
+		for (j = 0; j < ARRAY_SIZE(test_layouts); j++)
+			test_df1(test_channels[i], test_layouts[j][0], test_layouts[j][1]);
+}
+
+/* The channels with different LR4 filters, split one sample at a time with
+ * crossover_split_fnmap[] and in blocks with crossover_split_multich_fnmap[]
+ * the same way as the crossover component does.
+ */
+static void test_crossover(int nch, int num_sinks)
+{
+	struct test_iir_config config[PLATFORM_MAX_CHANNELS][2 * CROSSOVER_MAX_LR4];
+	struct crossover_state cs[PLATFORM_MAX_CHANNELS];
+	struct crossover_state ref[PLATFORM_MAX_CHANNELS];
+	struct crossover_multich_state mc;
+	struct iir_state_df2t lr4[PLATFORM_MAX_CHANNELS];
+	struct iir_state_df2t *iir;
+	crossover_split split = crossover_find_split_func(num_sinks);
+	crossover_split_multich split_multich = crossover_find_split_multich_func(num_sinks);
+	const int samples = TEST_FRAMES * nch;
+	const int num_lr4s = num_sinks == CROSSOVER_2WAY_NUM_SINKS ? 1 : 3;
+	int32_t *x = test_calloc(samples, sizeof(int32_t));
+	int32_t *y[CROSSOVER_4WAY_NUM_SINKS];
+	int32_t *y_ref[CROSSOVER_4WAY_NUM_SINKS];
+	int32_t out[CROSSOVER_4WAY_NUM_SINKS];
+	void *data[2 * CROSSOVER_MAX_LR4];
+	int64_t *delay;
+	int size;
+	int ch, f, i, j, n;
+
+	for (ch = 0; ch < nch; ch++) {
+		for (i = 0; i < 2 * num_lr4s; i++) {
+			/* LR4 is two biquads in series */
+			test_config_init(&config[ch][i], 2, 2, ch + i);
+			iir = i < num_lr4s ? &cs[ch].lowpass[i] : &cs[ch].highpass[i - num_lr4s];
+			delay = test_calloc(1, iir_delay_size_df2t(&config[ch][i].hdr));
+			iir_init_coef_df2t(iir, &config[ch][i].hdr);
+			iir_init_delay_df2t(iir, &delay);
+
+			iir = i < num_lr4s ? &ref[ch].lowpass[i] : &ref[ch].highpass[i - num_lr4s];
+			delay = test_calloc(1, iir_delay_size_df2t(&config[ch][i].hdr));
+			iir_init_coef_df2t(iir, &config[ch][i].hdr);
+			iir_init_delay_df2t(iir, &delay);
+		}
+	}
+
+	for (i = 0; i < 2 * num_lr4s; i++) {
+		for (ch = 0; ch < nch; ch++)
+			lr4[ch] = i < num_lr4s ? cs[ch].lowpass[i] : cs[ch].highpass[i - num_lr4s];
+
+		size = iir_multich_size_df2t(lr4, nch);
+		assert_true(size > 0);
+		data[i] = test_calloc(1, (unsigned int)size);
+		iir_init_multich_df2t(i < num_lr4s ? &mc.lowpass[i] : &mc.highpass[i - num_lr4s],
+				      lr4, nch, data[i]);
+	}
+
+	mc.in = test_calloc(CROSSOVER_MULTICH_FRAMES * nch, sizeof(int32_t));
+	for (j = 0; j < CROSSOVER_4WAY_NUM_SINKS; j++) {
+		mc.out[j] = test_calloc(CROSSOVER_MULTICH_FRAMES * nch, sizeof(int32_t));
+		y[j] = test_calloc(samples, sizeof(int32_t));
+		y_ref[j] = test_calloc(samples, sizeof(int32_t));
+	}
+
+	test_input(x, samples);
+	for (f = 0; f < TEST_FRAMES; f++) {
+		for (ch = 0; ch < nch; ch++) {
+			split(x[f * nch + ch], out, &ref[ch]);
+			for (j = 0; j < num_sinks; j++)
+				y_ref[j][f * nch + ch] = out[j];
+		}
+	}
+
+	/* the input block is used as scratch, it is written for every block of at
+	 * most CROSSOVER_MULTICH_FRAMES as in the component
+	 */
+	for (f = 0, i = 0; f < TEST_FRAMES; f += n, i = (i + 1) % ARRAY_SIZE(test_blocks)) {
+		n = MIN(MIN(test_blocks[i], CROSSOVER_MULTICH_FRAMES), TEST_FRAMES - f);
+		memcpy_s(mc.in, n * nch * sizeof(int32_t), &x[f * nch], n * nch * sizeof(int32_t));
+		split_multich(&mc, n);
+		for (j = 0; j < num_sinks; j++)
+			memcpy_s(&y[j][f * nch], n * nch * sizeof(int32_t), mc.out[j],
+				 n * nch * sizeof(int32_t));
+	}
+
+	for (j = 0; j < num_sinks; j++)
+		assert_memory_equal(y[j], y_ref[j], samples * sizeof(int32_t));
+
+	for (j = 0; j < CROSSOVER_4WAY_NUM_SINKS; j++) {
+		test_free(y_ref[j]);
+		test_free(y[j]);
+		test_free(mc.out[j]);
+	}
+	test_free(mc.in);
+	for (i = 0; i < num_lr4s; i++) {
+		test_free(data[i]);
+		test_free(data[num_lr4s + i]);
+		for (ch = 0; ch < nch; ch++) {
+			test_free(cs[ch].lowpass[i].delay);
+			test_free(cs[ch].highpass[i].delay);
+			test_free(ref[ch].lowpass[i].delay);
+			test_free(ref[ch].highpass[i].delay);
+		}
+	}
+	test_free(x);
+}
+
+static void test_eq_iir_multich_crossover(void **state)
+{
+	int i, num_sinks;
+
+	for (i = 0; i < ARRAY_SIZE(test_channels); i++)
+		for (num_sinks = CROSSOVER_2WAY_NUM_SINKS;
+		     num_sinks <= CROSSOVER_4WAY_NUM_SINKS; num_sinks++)
+			test_crossover(test_channels[i], num_sinks);
+}
+
+static int setup(void **state)
+{
+	test_seed = 1;
+	return 0;
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup(test_eq_iir_multich_df2t, setup),
+		cmocka_unit_test_setup(test_eq_iir_multich_df1, setup),
+		cmocka_unit_test_setup(test_eq_iir_multich_crossover, setup),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,155 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/format.h>
+#include <sof/audio/mixer.h>
+
+#include "../../util.h"
+#include "mixer_generic_ref.h"
+
+#ifndef MIXER_X86
+#error "This test needs to be built with the x86 SIMD flags"
+#endif
+
+#define TEST_CHANNELS		2
+#define TEST_FRAMES		40
+#define TEST_MAX_SOURCES	4
+
+static uint32_t test_seed;
+
+static int32_t test_rand(void)
+{
+	test_seed = test_seed * 1664525 + 1013904223;
+	return (int32_t)test_seed;
+}
+
+static mixer_func test_get_func(const struct mixer_func_map *map, size_t count,
+				uint16_t frame_fmt)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		if (map[i].frame_fmt == frame_fmt)
+			return map[i].func;
+
+	return NULL;
+}
+
+/* Full scale random samples for sources, the sums saturate often */
+static void test_stream_init(struct audio_stream *stream, enum sof_ipc_frame frame_fmt,
+			     int frames, int offset_frames, bool fill)
+{
+	int sample_bytes = frame_fmt == SOF_IPC_FRAME_S16_LE ? sizeof(int16_t) : sizeof(int32_t);
+	uint32_t size = frames * TEST_CHANNELS * sample_bytes;
+	uint8_t *data = test_calloc(1, size);
+	int i;
+
+	for (i = 0; fill && i < size / sample_bytes; i++) {
+		if (sample_bytes == sizeof(int16_t))
+			((int16_t *)data)[i] = test_rand() >> 16;
+		else
+			((int32_t *)data)[i] = test_rand();
+	}
+
+	stream->frame_fmt = frame_fmt;
+	stream->channels = TEST_CHANNELS;
+	audio_stream_init(stream, data, size);
+	stream->r_ptr = data + offset_frames * TEST_CHANNELS * sample_bytes;
+	stream->w_ptr = stream->r_ptr;
+}
+
+/* The sources are shorter than the mixed frames and the sink starts in the
+ * middle, so all the streams wrap.
+ */
+static void test_mixer_x86_format(enum sof_ipc_frame frame_fmt)
+{
+	const struct audio_stream *sources[TEST_MAX_SOURCES];
+	struct audio_stream source[TEST_MAX_SOURCES];
+	struct audio_stream sink;
+	struct audio_stream ref;
+	mixer_func func = test_get_func(mixer_func_map, mixer_func_count, frame_fmt);
+	mixer_func generic_func = test_get_func(generic_mixer_func_map,
+						generic_mixer_func_count, frame_fmt);
+	int num_sources;
+	int i;
+
+	assert_non_null(func);
+	assert_non_null(generic_func);
+
+	for (i = 0; i < TEST_MAX_SOURCES; i++) {
+		test_stream_init(&source[i], frame_fmt, 23 + 7 * i, 3 * i, true);
+		sources[i] = &source[i];
+	}
+
+	for (num_sources = 1; num_sources <= TEST_MAX_SOURCES; num_sources++) {
+		test_stream_init(&sink, frame_fmt, TEST_FRAMES + 1, 17, false);
+		test_stream_init(&ref, frame_fmt, TEST_FRAMES + 1, 17, false);
+
+		func(NULL, &sink, sources, num_sources, TEST_FRAMES);
+		generic_func(NULL, &ref, sources, num_sources, TEST_FRAMES);
+		assert_memory_equal(sink.addr, ref.addr, sink.size);
+
+		test_free(ref.addr);
+		test_free(sink.addr);
+	}
+
+	for (i = 0; i < TEST_MAX_SOURCES; i++)
+		test_free(source[i].addr);
+}
+
+#if CONFIG_FORMAT_S16LE
+static void test_mixer_x86_s16(void **state)
+{
+	test_mixer_x86_format(SOF_IPC_FRAME_S16_LE);
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static void test_mixer_x86_s24(void **state)
+{
+	test_mixer_x86_format(SOF_IPC_FRAME_S24_4LE);
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void test_mixer_x86_s32(void **state)
+{
+	test_mixer_x86_format(SOF_IPC_FRAME_S32_LE);
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+static int setup(void **state)
+{
+	if (!__builtin_cpu_supports("sse4.2"))
+		skip();
+
+	test_seed = 1;
+	return 0;
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+#if CONFIG_FORMAT_S16LE
+		cmocka_unit_test_setup(test_mixer_x86_s16, setup),
+#endif
+#if CONFIG_FORMAT_S24LE
+		cmocka_unit_test_setup(test_mixer_x86_s24, setup),
+#endif
+#if CONFIG_FORMAT_S32LE
+		cmocka_unit_test_setup(test_mixer_x86_s32, setup),
+#endif
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
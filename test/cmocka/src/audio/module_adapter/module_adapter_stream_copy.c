@@ -0,0 +1,213 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <sof/audio/component_ext.h>
+#include <sof/audio/module_adapter/module/generic.h>
+#include <ipc/stream.h>
+#include <ipc/topology.h>
+
+#include "../../util.h"
+
+#define TEST_RATE		48000
+#define TEST_CHANNELS		2
+#define TEST_FRAMES		48
+#define TEST_FRAME_BYTES	(TEST_CHANNELS * sizeof(int32_t))
+#define TEST_SOURCE_FRAMES	(2 * TEST_FRAMES + 5)
+#define TEST_SINK_FRAMES	(2 * TEST_FRAMES - 3)
+
+struct test_data {
+	struct comp_dev *dev;
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	int32_t next_in;
+	int32_t next_out;
+};
+
+static int setup_group(void **state)
+{
+	sys_comp_init(sof_get());
+	sys_comp_module_passthrough_interface_init();
+	return 0;
+}
+
+static int setup(void **state)
+{
+	struct sof_ipc_comp_process *ipc;
+	struct test_data *td;
+	struct sof_ipc_stream_params params = {
+		.frame_fmt = SOF_IPC_FRAME_S32_LE,
+		.rate = TEST_RATE,
+		.channels = TEST_CHANNELS,
+		.sample_container_bytes = sizeof(int32_t),
+		.sample_valid_bytes = sizeof(int32_t),
+	};
+	const struct sof_uuid uuid = {
+		.a = 0x376b5e44, .b = 0x9c82, .c = 0x4ec2,
+		.d = {0xbc, 0x83, 0x10, 0xea, 0x10, 0x1a, 0xf8, 0x8f}
+	};
+
+	td = test_calloc(1, sizeof(*td));
+	ipc = test_calloc(1, sizeof(*ipc) + SOF_UUID_SIZE);
+	memcpy_s(ipc + 1, SOF_UUID_SIZE, &uuid, SOF_UUID_SIZE);
+	ipc->comp.hdr.size = sizeof(*ipc) + SOF_UUID_SIZE;
+	ipc->comp.type = SOF_COMP_MODULE_ADAPTER;
+	ipc->comp.ext_data_length = SOF_UUID_SIZE;
+	ipc->config.hdr.size = sizeof(struct sof_ipc_comp_config);
+
+	td->dev = comp_new((struct sof_ipc_comp *)ipc);
+	test_free(ipc);
+	if (!td->dev)
+		return -EINVAL;
+
+	td->dev->frames = TEST_FRAMES;
+	td->source = create_test_source(td->dev, 0, SOF_IPC_FRAME_S32_LE, TEST_CHANNELS,
+					TEST_SOURCE_FRAMES * TEST_FRAME_BYTES);
+	td->sink = create_test_sink(td->dev, 0, SOF_IPC_FRAME_S32_LE, TEST_CHANNELS,
+				    TEST_SINK_FRAMES * TEST_FRAME_BYTES);
+	td->source->stream.rate = TEST_RATE;
+	td->sink->stream.rate = TEST_RATE;
+
+	if (comp_params(td->dev, &params) < 0 || comp_prepare(td->dev) < 0)
+		return -EINVAL;
+
+	*state = td;
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	struct test_data *td = *state;
+
+	free_test_source(td->source);
+	free_test_sink(td->sink);
+	comp_free(td->dev);
+	test_free(td);
+	return 0;
+}
+
+/* Writes a ramp to the source so that any lost, repeated or reordered
+ * sample shows up in the sink.
+ */
+static void test_produce(struct test_data *td, int frames)
+{
+	struct audio_stream *source = &td->source->stream;
+	int32_t *x = source->w_ptr;
+	int i;
+
+	for (i = 0; i < frames * TEST_CHANNELS; i++) {
+		*x++ = td->next_in++;
+		x = audio_stream_wrap(source, x);
+	}
+
+	audio_stream_produce(source, frames * TEST_FRAME_BYTES);
+}
+
+static void test_consume(struct test_data *td, int frames)
+{
+	struct audio_stream *sink = &td->sink->stream;
+	int32_t *y = sink->r_ptr;
+	int i;
+
+	for (i = 0; i < frames * TEST_CHANNELS; i++) {
+		assert_int_equal(*y++, td->next_out++);
+		y = audio_stream_wrap(sink, y);
+	}
+
+	audio_stream_consume(sink, frames * TEST_FRAME_BYTES);
+}
+
+/* No local sink buffer is needed, the data goes straight to the sink */
+static void test_stream_copy_prepare(void **state)
+{
+	struct test_data *td = *state;
+	struct processing_module *mod = comp_get_drvdata(td->dev);
+
+	assert_true(mod->stream_copy);
+	assert_true(list_is_empty(&mod->sink_buffer_list));
+	assert_int_equal(mod->deep_buff_bytes, 0);
+}
+
+/* Varying amounts per copy so that both the source and the sink wrap */
+static void test_stream_copy_wrap(void **state)
+{
+	struct test_data *td = *state;
+	struct processing_module *mod = comp_get_drvdata(td->dev);
+	int i;
+
+	for (i = 0; i < 20; i++) {
+		int frames = TEST_FRAMES + i % 5 - 2;
+
+		test_produce(td, frames);
+		assert_int_equal(comp_copy(td->dev), 0);
+		assert_int_equal(audio_stream_get_avail_frames(&td->source->stream), 0);
+		assert_int_equal(audio_stream_get_avail_frames(&td->sink->stream), frames);
+		assert_null(mod->input_buffers[0].data);
+		assert_null(mod->output_buffers[0].data);
+		test_consume(td, frames);
+	}
+}
+
+/* The copy is limited to the free space in the sink, the rest stays in the
+ * source for the next copy.
+ */
+static void test_stream_copy_sink_full(void **state)
+{
+	struct test_data *td = *state;
+	const int frames = TEST_FRAMES + 10;
+	const int sink_used = TEST_SINK_FRAMES - TEST_FRAMES;
+
+	test_produce(td, sink_used);
+	assert_int_equal(comp_copy(td->dev), 0);
+
+	test_produce(td, frames);
+	assert_int_equal(comp_copy(td->dev), 0);
+	assert_int_equal(audio_stream_get_avail_frames(&td->sink->stream), TEST_SINK_FRAMES);
+	assert_int_equal(audio_stream_get_avail_frames(&td->source->stream),
+			 frames - TEST_FRAMES);
+
+	/* nothing can be copied to a full sink */
+	assert_int_equal(comp_copy(td->dev), 0);
+	assert_int_equal(audio_stream_get_avail_frames(&td->source->stream),
+			 frames - TEST_FRAMES);
+
+	test_consume(td, TEST_SINK_FRAMES);
+	assert_int_equal(comp_copy(td->dev), 0);
+	assert_int_equal(audio_stream_get_avail_frames(&td->source->stream), 0);
+	test_consume(td, frames - TEST_FRAMES);
+}
+
+/* A sink in a different state than the module is left out of the copy */
+static void test_stream_copy_sink_inactive(void **state)
+{
+	struct test_data *td = *state;
+
+	test_produce(td, TEST_FRAMES);
+	td->sink->sink->state = COMP_STATE_PAUSED;
+	assert_int_equal(comp_copy(td->dev), 0);
+	assert_int_equal(audio_stream_get_avail_frames(&td->source->stream), TEST_FRAMES);
+	assert_int_equal(audio_stream_get_avail_frames(&td->sink->stream), 0);
+
+	td->sink->sink->state = td->dev->state;
+	assert_int_equal(comp_copy(td->dev), 0);
+	test_consume(td, TEST_FRAMES);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_stream_copy_prepare, setup, teardown),
+		cmocka_unit_test_setup_teardown(test_stream_copy_wrap, setup, teardown),
+		cmocka_unit_test_setup_teardown(test_stream_copy_sink_full, setup, teardown),
+		cmocka_unit_test_setup_teardown(test_stream_copy_sink_inactive, setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, setup_group, NULL);
+}
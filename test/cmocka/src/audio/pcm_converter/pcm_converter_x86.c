@@ -0,0 +1,161 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/pcm_converter.h>
+#include <ipc/stream.h>
+
+#include "../../util.h"
+
+#ifndef PCM_CONVERTER_X86
+#error "This test needs to be built with PCM_CONVERTER_X86"
+#endif
+
+#define TEST_SOURCE_SAMPLES	45
+#define TEST_SINK_SAMPLES	53
+#define TEST_MAX_SAMPLES	50
+
+static uint32_t test_seed;
+
+static int32_t test_rand(void)
+{
+	test_seed = test_seed * 1664525 + 1013904223;
+	return (int32_t)test_seed;
+}
+
+static pcm_converter_func test_get_func(const struct pcm_func_map *map, size_t count,
+					enum sof_ipc_frame source, enum sof_ipc_frame sink)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		if (map[i].source == source && map[i].sink == sink)
+			return map[i].func;
+
+	return NULL;
+}
+
+/* Full scale random samples, also in the unused bits of the s24 container,
+ * every fifth sample is the largest or the smallest value to saturate
+ */
+static void test_stream_init(struct audio_stream *stream, enum sof_ipc_frame frame_fmt,
+			     int samples, int offset, bool fill)
+{
+	int sample_bytes = frame_fmt == SOF_IPC_FRAME_S16_LE ? sizeof(int16_t) : sizeof(int32_t);
+	uint32_t size = samples * sample_bytes;
+	uint8_t *data = test_calloc(1, size);
+	int32_t x;
+	int i;
+
+	for (i = 0; fill && i < samples; i++) {
+		x = test_rand();
+		if (!(i % 5))
+			x = i & 1 ? INT32_MAX : INT32_MIN;
+
+		if (sample_bytes == sizeof(int16_t))
+			((int16_t *)data)[i] = x >> 16;
+		else
+			((int32_t *)data)[i] = x;
+	}
+
+	stream->frame_fmt = frame_fmt;
+	stream->channels = 1;
+	audio_stream_init(stream, data, size);
+	stream->r_ptr = data + offset * sample_bytes;
+	stream->w_ptr = stream->r_ptr;
+}
+
+/* Every SSE4.2 conversion gives the same output as the generic one for all
+ * counts of samples, so with and without the non-vector tail, and for all
+ * offsets, so with the source and the sink wrapping in different places.
+ */
+static void test_pcm_converter_x86(void **state)
+{
+	struct audio_stream source;
+	struct audio_stream sink;
+	struct audio_stream ref;
+	pcm_converter_func func;
+	pcm_converter_func generic_func;
+	int samples;
+	int offset;
+	int i;
+
+	assert_true(pcm_func_count_x86 > 0);
+
+	for (i = 0; i < pcm_func_count_x86; i++) {
+		func = pcm_func_map_x86[i].func;
+		generic_func = test_get_func(pcm_func_map, pcm_func_count,
+					     pcm_func_map_x86[i].source,
+					     pcm_func_map_x86[i].sink);
+		assert_non_null(generic_func);
+		assert_ptr_not_equal(func, generic_func);
+
+		for (samples = 1; samples <= TEST_MAX_SAMPLES; samples++) {
+			offset = samples % TEST_SOURCE_SAMPLES;
+			test_stream_init(&source, pcm_func_map_x86[i].source,
+					 TEST_SOURCE_SAMPLES, offset, true);
+			offset = (3 * samples) % TEST_SINK_SAMPLES;
+			test_stream_init(&sink, pcm_func_map_x86[i].sink,
+					 TEST_SINK_SAMPLES, offset, false);
+			test_stream_init(&ref, pcm_func_map_x86[i].sink,
+					 TEST_SINK_SAMPLES, offset, false);
+
+			assert_int_equal(func(&source, 1, &sink, 2, samples), samples);
+			assert_int_equal(generic_func(&source, 1, &ref, 2, samples), samples);
+			assert_memory_equal(sink.addr, ref.addr, sink.size);
+
+			test_free(ref.addr);
+			test_free(sink.addr);
+			test_free(source.addr);
+		}
+	}
+}
+
+/* The lookup picks the SSE4.2 functions and the generic ones for the rest */
+static void test_pcm_converter_x86_lookup(void **state)
+{
+	int i;
+
+	for (i = 0; i < pcm_func_count_x86; i++)
+		assert_ptr_equal(pcm_get_conversion_function(pcm_func_map_x86[i].source,
+							     pcm_func_map_x86[i].sink),
+				 pcm_func_map_x86[i].func);
+
+	for (i = 0; i < pcm_func_count; i++) {
+		if (test_get_func(pcm_func_map_x86, pcm_func_count_x86,
+				  pcm_func_map[i].source, pcm_func_map[i].sink))
+			continue;
+
+		assert_ptr_equal(pcm_get_conversion_function(pcm_func_map[i].source,
+							     pcm_func_map[i].sink),
+				 pcm_func_map[i].func);
+	}
+}
+
+static int setup(void **state)
+{
+	if (!__builtin_cpu_supports("sse4.2"))
+		skip();
+
+	test_seed = 1;
+	return 0;
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup(test_pcm_converter_x86, setup),
+		cmocka_unit_test_setup(test_pcm_converter_x86_lookup, setup),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
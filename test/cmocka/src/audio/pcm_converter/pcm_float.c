@@ -11,6 +11,7 @@
 #include <ipc/stream.h>
 #include <ipc/stream.h>
 
+#include <errno.h>
 #include <stdio.h>
 #include <stdarg.h>
 #include <stddef.h>
@@ -517,6 +518,65 @@ static void test_pcm_convert_f_to_s32_big_pos(void **state)
 	/* free memory */
 	free_test_sink(sink);
 }
+
+static void _test_pcm_convert_attenuated(enum sof_ipc_frame frm_in,
+					 enum sof_ipc_frame frm_out, bool supported)
+{
+	static const int32_t source_buf[] = {
+		PCM_TEST_INT_NUMBERS,
+		INT32_MIN + 1, INT32_MIN,
+		INT32_MAX - 1, INT32_MAX,
+	};
+	const uint32_t shift = 3;
+	const uint8_t fillval = 0xAB;
+	const int samples = ARRAY_SIZE(source_buf);
+	const int bytes = samples * sizeof(int32_t);
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+	pcm_converter_func fun;
+	int32_t *read_val;
+	int i, ret;
+
+	source = create_test_source(NULL, 0, frm_in, 1, bytes);
+	sink = create_test_sink(NULL, 0, frm_out, 1, bytes);
+
+	memcpy_s(source->stream.w_ptr, source->stream.size, source_buf, bytes);
+	audio_stream_produce(&source->stream, bytes);
+	memset(sink->stream.w_ptr, fillval, bytes);
+
+	fun = pcm_get_conversion_function(frm_in, frm_out);
+	assert_non_null(fun);
+	ret = pcm_convert_attenuated(&source->stream, 0, &sink->stream, 0,
+				     samples, fun, shift);
+	assert_int_equal(ret, supported ? samples : -EINVAL);
+
+	for (i = 0; i < samples; ++i) {
+		read_val = audio_stream_read_frag(&sink->stream, i, sizeof(int32_t));
+		if (!supported)
+			/* a rejected sink must be left untouched */
+			assert_int_equal(*read_val, (int32_t)0xABABABAB);
+		else
+			assert_int_equal(*read_val, source_buf[i] >> shift);
+	}
+
+	free_test_source(source);
+	free_test_sink(sink);
+}
+
+static void test_pcm_convert_attenuated_s32(void **state)
+{
+	_test_pcm_convert_attenuated(SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_S32_LE, true);
+}
+
+static void test_pcm_convert_attenuated_s32_to_f(void **state)
+{
+	_test_pcm_convert_attenuated(SOF_IPC_FRAME_S32_LE, SOF_IPC_FRAME_FLOAT, false);
+}
+
+static void test_pcm_convert_attenuated_f_to_f(void **state)
+{
+	_test_pcm_convert_attenuated(SOF_IPC_FRAME_FLOAT, SOF_IPC_FRAME_FLOAT, false);
+}
 #endif /* CONFIG_FORMAT_FLOAT && CONFIG_FORMAT_S32LE */
 
 int main(void)
@@ -536,6 +596,9 @@ int main(void)
 		cmocka_unit_test(test_pcm_convert_f_to_s32),
 		cmocka_unit_test(test_pcm_convert_f_to_s32_big_neg),
 		cmocka_unit_test(test_pcm_convert_f_to_s32_big_pos),
+		cmocka_unit_test(test_pcm_convert_attenuated_s32),
+		cmocka_unit_test(test_pcm_convert_attenuated_s32_to_f),
+		cmocka_unit_test(test_pcm_convert_attenuated_f_to_f),
 #endif /* CONFIG_FORMAT_FLOAT && CONFIG_FORMAT_S32LE */
 	};
 
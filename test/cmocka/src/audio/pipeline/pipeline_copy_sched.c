@@ -0,0 +1,276 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <sof/audio/buffer.h>
+#include <sof/audio/component_ext.h>
+#include <sof/audio/pipeline.h>
+#include <ipc/stream.h>
+
+#define TEST_PIPELINE_ID	1
+#define TEST_OTHER_PIPELINE_ID	2
+#define TEST_MAX_COMPS		40
+#define TEST_MAX_LOG		64
+
+/* PPL_COPY_SCHED_DEPTH in pipeline-stream.c */
+#define TEST_SCHED_DEPTH	32
+
+struct test_graph {
+	struct pipeline p;
+	struct pipeline other;
+	struct comp_dev comp[TEST_MAX_COMPS];
+	struct comp_buffer buffer[TEST_MAX_COMPS * 2];
+	int num_buffers;
+};
+
+static uint32_t test_log[TEST_MAX_LOG];
+static int test_log_count;
+
+static int test_comp_copy(struct comp_dev *dev)
+{
+	assert_true(test_log_count < TEST_MAX_LOG);
+	test_log[test_log_count++] = dev_comp_id(dev);
+	return 0;
+}
+
+static const struct comp_driver test_drv = {
+	.ops = {
+		.copy = test_comp_copy,
+	},
+};
+
+static void test_comp_init(struct test_graph *g, int id, bool same_pipeline)
+{
+	struct comp_dev *comp = &g->comp[id];
+
+	comp->ipc_config.id = id;
+	comp->ipc_config.pipeline_id = same_pipeline ? TEST_PIPELINE_ID :
+				       TEST_OTHER_PIPELINE_ID;
+	comp->pipeline = same_pipeline ? &g->p : &g->other;
+	comp->state = COMP_STATE_ACTIVE;
+	comp->drv = &test_drv;
+	list_init(&comp->bsource_list);
+	list_init(&comp->bsink_list);
+}
+
+static struct comp_buffer *test_connect(struct test_graph *g, int source, int sink)
+{
+	struct comp_buffer *buffer = &g->buffer[g->num_buffers];
+
+	assert_true(g->num_buffers < ARRAY_SIZE(g->buffer));
+	buffer->id = g->num_buffers++;
+	list_init(&buffer->source_list);
+	list_init(&buffer->sink_list);
+	pipeline_connect(&g->comp[source], buffer, PPL_CONN_DIR_COMP_TO_BUFFER);
+	pipeline_connect(&g->comp[sink], buffer, PPL_CONN_DIR_BUFFER_TO_COMP);
+	return buffer;
+}
+
+/* Host 0 feeds 1 and 2 that are mixed in 3 and go out to the DAI 4, so 0
+ * is walked twice. Component 5 of another pipeline also feeds 3.
+ */
+static struct test_graph *test_graph_new(int direction)
+{
+	struct test_graph *g = test_calloc(1, sizeof(*g));
+	int i;
+
+	g->p.pipeline_id = TEST_PIPELINE_ID;
+	g->other.pipeline_id = TEST_OTHER_PIPELINE_ID;
+	for (i = 0; i < 5; i++)
+		test_comp_init(g, i, true);
+
+	test_comp_init(g, 5, false);
+
+	test_connect(g, 0, 1);
+	test_connect(g, 0, 2);
+	test_connect(g, 1, 3);
+	test_connect(g, 2, 3);
+	test_connect(g, 3, 4);
+	test_connect(g, 5, 3);
+
+	g->comp[0].direction = direction;
+	g->p.source_comp = &g->comp[0];
+	g->p.sink_comp = &g->comp[4];
+	return g;
+}
+
+/* A chain of comps components, 0 is the host */
+static struct test_graph *test_chain_new(int comps)
+{
+	struct test_graph *g = test_calloc(1, sizeof(*g));
+	int i;
+
+	g->p.pipeline_id = TEST_PIPELINE_ID;
+	for (i = 0; i < comps; i++)
+		test_comp_init(g, i, true);
+
+	for (i = 0; i < comps - 1; i++)
+		test_connect(g, i, i + 1);
+
+	g->comp[0].direction = SOF_IPC_STREAM_PLAYBACK;
+	g->p.source_comp = &g->comp[0];
+	g->p.sink_comp = &g->comp[comps - 1];
+	return g;
+}
+
+static void test_graph_free(struct test_graph *g)
+{
+	pipeline_copy_sched_free(&g->p);
+	test_free(g);
+}
+
+/* Runs pipeline_copy() and returns the number of copies logged to log */
+static int test_copy(struct test_graph *g, uint32_t *log)
+{
+	test_log_count = 0;
+	assert_int_equal(pipeline_copy(&g->p), 0);
+	memcpy_s(log, TEST_MAX_LOG * sizeof(*log), test_log, test_log_count * sizeof(*log));
+	return test_log_count;
+}
+
+/* The flat schedule copies in the same order as the recursive walk */
+static void test_copy_sched_order(struct test_graph *g, int expected_count)
+{
+	uint32_t walk_log[TEST_MAX_LOG];
+	uint32_t sched_log[TEST_MAX_LOG];
+	int walk_count;
+	int sched_count;
+
+	assert_null(g->p.copy_sched);
+	walk_count = test_copy(g, walk_log);
+	assert_int_equal(walk_count, expected_count);
+
+	assert_int_equal(pipeline_copy_sched_build(&g->p), 0);
+	assert_non_null(g->p.copy_sched);
+	sched_count = test_copy(g, sched_log);
+	assert_int_equal(sched_count, walk_count);
+	assert_memory_equal(sched_log, walk_log, walk_count * sizeof(walk_log[0]));
+}
+
+static void test_pipeline_copy_sched_playback(void **state)
+{
+	struct test_graph *g = test_graph_new(SOF_IPC_STREAM_PLAYBACK);
+
+	/* 4, 3, 2 and 1 once and 0 twice, the other pipeline is not copied */
+	test_copy_sched_order(g, 6);
+	assert_ptr_equal(g->p.copy_sched->start, &g->comp[4]);
+	assert_int_equal(g->p.copy_sched->dir, PPL_DIR_UPSTREAM);
+
+	/* the DAI is copied last */
+	assert_int_equal(test_log[5], 4);
+	test_graph_free(g);
+}
+
+static void test_pipeline_copy_sched_capture(void **state)
+{
+	struct test_graph *g = test_graph_new(SOF_IPC_STREAM_CAPTURE);
+
+	/* 0, 1 and 2 once and the mixer path 3 and 4 twice */
+	test_copy_sched_order(g, 7);
+	assert_ptr_equal(g->p.copy_sched->start, &g->comp[0]);
+	assert_int_equal(g->p.copy_sched->dir, PPL_DIR_DOWNSTREAM);
+
+	/* the host is copied first */
+	assert_int_equal(test_log[0], 0);
+	test_graph_free(g);
+}
+
+/* An inactive component stops the walk from it in both ways of copying */
+static void test_pipeline_copy_sched_inactive(void **state)
+{
+	struct test_graph *g = test_graph_new(SOF_IPC_STREAM_PLAYBACK);
+
+	g->comp[1].state = COMP_STATE_PAUSED;
+	test_copy_sched_order(g, 4);
+	test_graph_free(g);
+
+	g = test_graph_new(SOF_IPC_STREAM_CAPTURE);
+	g->comp[2].state = COMP_STATE_PAUSED;
+	test_copy_sched_order(g, 4);
+	test_graph_free(g);
+}
+
+/* Connecting a buffer within the pipeline drops the schedule, the next
+ * copy uses the recursive walk that sees the new component.
+ */
+static void test_pipeline_copy_sched_connect(void **state)
+{
+	struct test_graph *g = test_graph_new(SOF_IPC_STREAM_PLAYBACK);
+	uint32_t log[TEST_MAX_LOG];
+
+	assert_int_equal(pipeline_copy_sched_build(&g->p), 0);
+
+	/* a buffer to another pipeline does not change the walk */
+	test_comp_init(g, 6, false);
+	test_connect(g, 6, 2);
+	assert_non_null(g->p.copy_sched);
+
+	test_comp_init(g, 7, true);
+	test_connect(g, 7, 2);
+	assert_null(g->p.copy_sched);
+	assert_int_equal(test_copy(g, log), 7);
+
+	test_copy_sched_order(g, 7);
+	test_graph_free(g);
+}
+
+static void test_pipeline_copy_sched_disconnect(void **state)
+{
+	struct test_graph *g = test_graph_new(SOF_IPC_STREAM_PLAYBACK);
+	struct comp_buffer *buffer = &g->buffer[1];
+	uint32_t log[TEST_MAX_LOG];
+
+	/* the buffer from 0 to 2 */
+	assert_ptr_equal(buffer->source, &g->comp[0]);
+	assert_ptr_equal(buffer->sink, &g->comp[2]);
+
+	assert_int_equal(pipeline_copy_sched_build(&g->p), 0);
+	pipeline_disconnect(&g->comp[2], buffer, PPL_CONN_DIR_BUFFER_TO_COMP);
+	assert_null(g->p.copy_sched);
+	assert_int_equal(test_copy(g, log), 5);
+
+	test_copy_sched_order(g, 5);
+	test_graph_free(g);
+}
+
+/* A graph deeper than the schedule walk supports is copied recursively */
+static void test_pipeline_copy_sched_depth(void **state)
+{
+	struct test_graph *g = test_chain_new(TEST_SCHED_DEPTH + 1);
+	uint32_t log[TEST_MAX_LOG];
+	int i;
+
+	test_copy_sched_order(g, TEST_SCHED_DEPTH + 1);
+	test_graph_free(g);
+
+	g = test_chain_new(TEST_SCHED_DEPTH + 2);
+	assert_int_equal(pipeline_copy_sched_build(&g->p), -EINVAL);
+	assert_null(g->p.copy_sched);
+
+	assert_int_equal(test_copy(g, log), TEST_SCHED_DEPTH + 2);
+	for (i = 0; i < TEST_SCHED_DEPTH + 2; i++)
+		assert_int_equal(log[i], i);
+
+	test_graph_free(g);
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(test_pipeline_copy_sched_playback),
+		cmocka_unit_test(test_pipeline_copy_sched_capture),
+		cmocka_unit_test(test_pipeline_copy_sched_inactive),
+		cmocka_unit_test(test_pipeline_copy_sched_connect),
+		cmocka_unit_test(test_pipeline_copy_sched_disconnect),
+		cmocka_unit_test(test_pipeline_copy_sched_depth),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,371 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <kernel/abi.h>
+#include <sof/audio/component_ext.h>
+#include <sof/audio/src/src.h>
+#include <sof/audio/src/src_config.h>
+#include <ipc/control.h>
+#include <ipc/stream.h>
+#include <ipc/topology.h>
+#include <user/src.h>
+
+#include "../../util.h"
+
+#define TEST_RATE		48000
+#define TEST_CHANNELS		2
+#define TEST_PERIOD_US		1000
+#define TEST_FRAMES		(TEST_RATE * TEST_PERIOD_US / 1000000)
+#define TEST_TAPS		4
+#define TEST_INPUT		(1 << 20)
+
+#if SRC_SHORT
+#define TEST_COEF_BITS		16
+#define TEST_COEF_HALF		16384
+#define TEST_COEF_QUARTER	8192
+typedef int16_t test_coef_t;
+#else
+#define TEST_COEF_BITS		32
+#define TEST_COEF_HALF		1073741824
+#define TEST_COEF_QUARTER	536870912
+typedef int32_t test_coef_t;
+#endif
+
+/* The heap mocks are replaced with ones that poison the released memory,
+ * a conversion left pointing to a released blob reads garbage.
+ */
+struct test_alloc_hdr {
+	size_t size;
+	uint64_t reserved;
+};
+
+static void *test_alloc(size_t bytes)
+{
+	struct test_alloc_hdr *hdr = calloc(1, sizeof(*hdr) + bytes);
+
+	if (!hdr)
+		return NULL;
+
+	hdr->size = bytes;
+	return hdr + 1;
+}
+
+void *rballoc_align(uint32_t flags, uint32_t caps, size_t bytes, uint32_t alignment)
+{
+	return test_alloc(bytes);
+}
+
+void *rzalloc(enum mem_zone zone, uint32_t flags, uint32_t caps, size_t bytes)
+{
+	return test_alloc(bytes);
+}
+
+void *rbrealloc_align(void *ptr, uint32_t flags, uint32_t caps, size_t bytes,
+		      size_t old_bytes, uint32_t alignment)
+{
+	void *new_ptr = test_alloc(bytes);
+
+	if (new_ptr && ptr)
+		memcpy_s(new_ptr, bytes, ptr, MIN(bytes, old_bytes));
+
+	rfree(ptr);
+	return new_ptr;
+}
+
+void rfree(void *ptr)
+{
+	struct test_alloc_hdr *hdr = ptr;
+
+	if (!ptr)
+		return;
+
+	hdr--;
+	memset(ptr, 0x5a, hdr->size);
+	free(hdr);
+}
+
+struct test_data {
+	struct comp_dev *dev;
+	struct comp_buffer *source;
+	struct comp_buffer *sink;
+};
+
+/* Single stage 1:1 FIR with the gain in the first tap, the other taps are zero */
+struct test_stage {
+	struct sof_src_stage hdr;
+	test_coef_t coef[TEST_TAPS];
+};
+
+struct test_conversion {
+	struct sof_src_conversion hdr;
+	struct test_stage stage;
+};
+
+struct test_blob {
+	struct sof_src_config hdr;
+	struct test_conversion conv;
+};
+
+static void test_blob_init(struct test_blob *blob, uint32_t source_rate, test_coef_t gain)
+{
+	struct sof_src_stage *stage = &blob->conv.stage.hdr;
+
+	memset(blob, 0, sizeof(*blob));
+	blob->hdr.size = sizeof(*blob);
+	blob->hdr.num_conversions = 1;
+	blob->hdr.coef_bits = TEST_COEF_BITS;
+	blob->conv.hdr.size = sizeof(blob->conv);
+	blob->conv.hdr.source_rate = source_rate;
+	blob->conv.hdr.sink_rate = TEST_RATE;
+	blob->conv.hdr.num_stages = 1;
+	stage->size = sizeof(blob->conv.stage);
+	stage->num_of_subfilters = 1;
+	stage->subfilter_length = TEST_TAPS;
+	stage->filter_length = TEST_TAPS;
+	stage->blk_in = 1;
+	stage->blk_out = 1;
+	blob->conv.stage.coef[0] = gain;
+}
+
+static int setup_group(void **state)
+{
+	sys_comp_init(sof_get());
+	sys_comp_src_init();
+	return 0;
+}
+
+static int setup(void **state)
+{
+	struct sof_ipc_comp_src *ipc;
+	struct test_data *td;
+	const size_t bytes = TEST_FRAMES * TEST_CHANNELS * sizeof(int32_t);
+	const struct sof_uuid uuid = {
+		.a = 0xc1c5326d, .b = 0x8390, .c = 0x46b4,
+		.d = {0xaa, 0x47, 0x95, 0xc3, 0xbe, 0xca, 0x65, 0x50}
+	};
+
+	td = test_malloc(sizeof(*td));
+	ipc = test_calloc(1, sizeof(*ipc) + SOF_UUID_SIZE);
+	memcpy_s(ipc + 1, SOF_UUID_SIZE, &uuid, SOF_UUID_SIZE);
+	ipc->comp.hdr.size = sizeof(*ipc) + SOF_UUID_SIZE;
+	ipc->comp.type = SOF_COMP_SRC;
+	ipc->comp.ext_data_length = SOF_UUID_SIZE;
+	ipc->config.hdr.size = sizeof(struct sof_ipc_comp_config);
+	ipc->source_rate = TEST_RATE;
+	ipc->sink_rate = TEST_RATE;
+
+	td->dev = comp_new((struct sof_ipc_comp *)ipc);
+	test_free(ipc);
+	if (!td->dev)
+		return -EINVAL;
+
+	td->dev->period = TEST_PERIOD_US;
+	td->source = create_test_source(td->dev, 0, SOF_IPC_FRAME_S32_LE, TEST_CHANNELS,
+					2 * bytes);
+	td->sink = create_test_sink(td->dev, 0, SOF_IPC_FRAME_S32_LE, TEST_CHANNELS,
+				    2 * bytes);
+	td->source->stream.rate = TEST_RATE;
+	td->sink->stream.rate = TEST_RATE;
+
+	*state = td;
+	return 0;
+}
+
+static int teardown(void **state)
+{
+	struct test_data *td = *state;
+
+	free_test_source(td->source);
+	free_test_sink(td->sink);
+	comp_free(td->dev);
+	test_free(td);
+	return 0;
+}
+
+static int set_blob(struct test_data *td, const void *blob, size_t size)
+{
+	struct sof_ipc_ctrl_data *cdata;
+	int ret;
+
+	cdata = test_calloc(1, sizeof(*cdata) + sizeof(struct sof_abi_hdr) + size);
+	cdata->cmd = SOF_CTRL_CMD_BINARY;
+	cdata->num_elems = size;
+	cdata->data->magic = SOF_ABI_MAGIC;
+	cdata->data->abi = SOF_ABI_VERSION;
+	cdata->data->size = size;
+	memcpy_s(cdata->data->data, size, blob, size);
+
+	ret = comp_cmd(td->dev, COMP_CMD_SET_DATA, cdata, sizeof(*cdata) + size);
+	test_free(cdata);
+	return ret;
+}
+
+static int run_params(struct test_data *td)
+{
+	struct sof_ipc_stream_params params = {
+		.frame_fmt = SOF_IPC_FRAME_S32_LE,
+		.rate = TEST_RATE,
+		.channels = TEST_CHANNELS,
+		.sample_container_bytes = sizeof(int32_t),
+		.sample_valid_bytes = sizeof(int32_t),
+	};
+
+	return comp_params(td->dev, &params);
+}
+
+/* Runs one period of a constant input and checks the settled output */
+static void verify_gain(struct test_data *td, int32_t expected)
+{
+	struct audio_stream *source = &td->source->stream;
+	struct audio_stream *sink = &td->sink->stream;
+	int32_t *x = source->w_ptr;
+	int32_t *y;
+	int i;
+
+	for (i = 0; i < TEST_FRAMES * TEST_CHANNELS; i++)
+		x[i] = TEST_INPUT;
+
+	audio_stream_produce(source, TEST_FRAMES * TEST_CHANNELS * sizeof(int32_t));
+	assert_int_equal(comp_copy(td->dev), 0);
+	assert_int_equal(audio_stream_get_avail_frames(sink), TEST_FRAMES);
+
+	/* skip the delay line fill */
+	y = sink->r_ptr;
+	for (i = TEST_TAPS * TEST_CHANNELS; i < TEST_FRAMES * TEST_CHANNELS; i++)
+		assert_int_equal(y[i], expected);
+}
+
+static void test_src_blob_conversion(void **state)
+{
+	struct test_data *td = *state;
+	struct test_blob blob;
+
+	test_blob_init(&blob, TEST_RATE, TEST_COEF_HALF);
+	assert_int_equal(set_blob(td, &blob, sizeof(blob)), 0);
+	assert_int_equal(run_params(td), 0);
+	assert_int_equal(comp_prepare(td->dev), 0);
+	verify_gain(td, TEST_INPUT / 2);
+}
+
+/* A blob set in READY state between params() and prepare() releases the
+ * previous blob, the conversion set up in params() must not use it.
+ */
+static void test_src_blob_update_after_params(void **state)
+{
+	struct test_data *td = *state;
+	struct test_blob blob;
+
+	test_blob_init(&blob, TEST_RATE, TEST_COEF_HALF);
+	assert_int_equal(set_blob(td, &blob, sizeof(blob)), 0);
+	assert_int_equal(run_params(td), 0);
+
+	test_blob_init(&blob, TEST_RATE, TEST_COEF_QUARTER);
+	assert_int_equal(set_blob(td, &blob, sizeof(blob)), 0);
+	assert_int_equal(comp_prepare(td->dev), 0);
+	verify_gain(td, TEST_INPUT / 2);
+
+	/* the new blob is used from the next params() */
+	assert_int_equal(comp_reset(td->dev), 0);
+	audio_stream_reset(&td->source->stream);
+	audio_stream_reset(&td->sink->stream);
+	assert_int_equal(run_params(td), 0);
+	assert_int_equal(comp_prepare(td->dev), 0);
+	verify_gain(td, TEST_INPUT / 4);
+}
+
+/* The rates not in the blob use the built-in coefficients */
+static void test_src_blob_no_conversion(void **state)
+{
+	struct test_data *td = *state;
+	struct test_blob blob;
+
+	test_blob_init(&blob, 44100, TEST_COEF_HALF);
+	assert_int_equal(set_blob(td, &blob, sizeof(blob)), 0);
+	assert_int_equal(run_params(td), 0);
+}
+
+static void test_src_blob_invalid(void **state)
+{
+	struct test_data *td = *state;
+	struct test_blob blob;
+	struct sof_src_stage *stage = &blob.conv.stage.hdr;
+	int i;
+
+	for (i = 0; ; i++) {
+		test_blob_init(&blob, TEST_RATE, TEST_COEF_HALF);
+		switch (i) {
+		case 0:
+			blob.hdr.coef_bits = 48 - TEST_COEF_BITS;
+			break;
+		case 1:
+			blob.hdr.size = sizeof(blob) + 4;
+			break;
+		case 2:
+			blob.conv.hdr.size = sizeof(blob.conv) + 4;
+			break;
+		case 3:
+			blob.conv.hdr.num_stages = 0;
+			break;
+		case 4:
+			blob.conv.hdr.num_stages = SOF_SRC_MAX_STAGES + 1;
+			break;
+		case 5:
+			/* a second stage that does not fit in the conversion */
+			blob.conv.hdr.num_stages = 2;
+			break;
+		case 6:
+			stage->size = sizeof(blob.conv.stage) + 4;
+			break;
+		case 7:
+			/* coefficients beyond the stage size */
+			stage->num_of_subfilters = 2;
+			stage->filter_length = 2 * TEST_TAPS;
+			break;
+		case 8:
+			stage->subfilter_length = TEST_TAPS - 2;
+			stage->filter_length = TEST_TAPS - 2;
+			break;
+		case 9:
+			stage->filter_length = TEST_TAPS - 1;
+			break;
+		case 10:
+			stage->blk_in = 0;
+			break;
+		case 11:
+			stage->blk_out = 0;
+			break;
+		case 12:
+			stage->idm = -1;
+			break;
+		case 13:
+			stage->shift = 32;
+			break;
+		default:
+			return;
+		}
+
+		assert_int_equal(set_blob(td, &blob, sizeof(blob)), 0);
+		assert_true(run_params(td) < 0);
+	}
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test_setup_teardown(test_src_blob_conversion, setup, teardown),
+		cmocka_unit_test_setup_teardown(test_src_blob_update_after_params, setup,
+						teardown),
+		cmocka_unit_test_setup_teardown(test_src_blob_no_conversion, setup, teardown),
+		cmocka_unit_test_setup_teardown(test_src_blob_invalid, setup, teardown),
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, setup_group, NULL);
+}
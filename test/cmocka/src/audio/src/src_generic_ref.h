@@ -0,0 +1,17 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2022 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __SRC_GENERIC_REF_H__
+#define __SRC_GENERIC_REF_H__
+
+#include <sof/audio/src/src.h>
+
+/* The generic C version, built without the SIMD flags and with the symbols
+ * renamed, see CMakeLists.txt.
+ */
+void generic_src_polyphase_stage_cir(struct src_stage_prm *s);
+void generic_src_polyphase_stage_cir_s16(struct src_stage_prm *s);
+
+#endif /* __SRC_GENERIC_REF_H__ */
@@ -0,0 +1,194 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <sof/audio/src/src.h>
+#include <sof/audio/src/src_config.h>
+
+#include "../../util.h"
+#include "src_generic_ref.h"
+
+#if !SRC_X86 || SRC_SHORT
+#error "This test needs to be built with the x86 SIMD flags and 32 bit coefficients"
+#endif
+
+#define TEST_BLOCKS		64
+#define TEST_IN_BLOCKS		5
+#define TEST_SUBFILTERS		2
+#define TEST_BLK_IN		3
+#define TEST_STAGE_SHIFT	1
+
+struct test_src_run {
+	struct src_state state;
+	struct src_stage_prm prm;
+	void *y;
+};
+
+static uint32_t test_seed;
+
+static int32_t test_rand(void)
+{
+	test_seed = test_seed * 1664525 + 1013904223;
+	return (int32_t)test_seed;
+}
+
+/* The delay lines are set up the same way as in src_polyphase_init() */
+static void test_src_run_init(struct test_src_run *run, struct src_stage *stage, void *x,
+			      size_t x_size, size_t y_size, int nch, int shift)
+{
+	struct src_state *state = &run->state;
+
+	state->fir_delay_size = nch * (stage->subfilter_length +
+				       (stage->num_of_subfilters - 1) * stage->idm +
+				       stage->blk_in);
+	state->out_delay_size = nch * (1 + (stage->num_of_subfilters - 1) * stage->odm);
+	state->fir_delay = test_calloc(state->fir_delay_size + state->out_delay_size,
+				       sizeof(int32_t));
+	state->out_delay = state->fir_delay + state->fir_delay_size;
+	state->fir_wp = &state->fir_delay[state->fir_delay_size - 1];
+	state->out_rp = state->out_delay;
+
+	run->y = test_calloc(1, y_size);
+	run->prm.nch = nch;
+	run->prm.x_rptr = x;
+	run->prm.x_end_addr = (char *)x + x_size;
+	run->prm.x_size = x_size;
+	run->prm.y_wptr = run->y;
+	run->prm.y_addr = run->y;
+	run->prm.y_end_addr = (char *)run->y + y_size;
+	run->prm.y_size = y_size;
+	run->prm.shift = shift;
+	run->prm.state = state;
+	run->prm.stage = stage;
+}
+
+static void test_src_run_free(struct test_src_run *run)
+{
+	test_free(run->y);
+	test_free(run->state.fir_delay);
+}
+
+/* Runs the stage in varying number of blocks per call, the input buffer is
+ * smaller than the total input so the reads wrap around.
+ */
+static void test_src_stage(int nch, int subfilter_length, int sample_bytes, int shift)
+{
+	const int filter_length = TEST_SUBFILTERS * subfilter_length;
+	int32_t *coefs = test_calloc(filter_length, sizeof(int32_t));
+	struct src_stage stage = {
+		1, 1, TEST_SUBFILTERS, subfilter_length, filter_length,
+		TEST_BLK_IN, TEST_SUBFILTERS, 0, TEST_STAGE_SHIFT, coefs
+	};
+	struct test_src_run run;
+	struct test_src_run ref;
+	const size_t x_size = nch * (TEST_IN_BLOCKS * TEST_BLK_IN + 1) * sample_bytes;
+	const size_t y_size = nch * TEST_BLOCKS * TEST_SUBFILTERS * sample_bytes;
+	void *x = test_calloc(1, x_size);
+	int times;
+	int n;
+	int i;
+
+	for (i = 0; i < filter_length; i++)
+		coefs[i] = test_rand();
+
+	for (i = 0; i < x_size / sample_bytes; i++) {
+		if (sample_bytes == sizeof(int16_t))
+			((int16_t *)x)[i] = test_rand() >> 16;
+		else
+			((int32_t *)x)[i] = test_rand() >> shift;
+	}
+
+	test_src_run_init(&run, &stage, x, x_size, y_size, nch, shift);
+	test_src_run_init(&ref, &stage, x, x_size, y_size, nch, shift);
+
+	for (n = 0; n < TEST_BLOCKS; n += times) {
+		times = MIN(n % 4 + 1, TEST_BLOCKS - n);
+		run.prm.times = times;
+		ref.prm.times = times;
+#if CONFIG_FORMAT_S16LE
+		if (sample_bytes == sizeof(int16_t)) {
+			src_polyphase_stage_cir_s16(&run.prm);
+			generic_src_polyphase_stage_cir_s16(&ref.prm);
+			continue;
+		}
+#endif
+#if CONFIG_FORMAT_S24LE || CONFIG_FORMAT_S32LE
+		src_polyphase_stage_cir(&run.prm);
+		generic_src_polyphase_stage_cir(&ref.prm);
+#endif
+	}
+
+	assert_memory_equal(run.y, ref.y, y_size);
+
+	test_src_run_free(&ref);
+	test_src_run_free(&run);
+	test_free(x);
+	test_free(coefs);
+}
+
+static const int test_channels[] = {1, 2, 3, 8};
+static const int test_subfilter_lengths[] = {4, 20, 64};
+
+static void test_src_x86_format(int sample_bytes, int shift)
+{
+	int i, j;
+
+	for (i = 0; i < ARRAY_SIZE(test_channels); i++)
+		for (j = 0; j < ARRAY_SIZE(test_subfilter_lengths); j++)
+			test_src_stage(test_channels[i], test_subfilter_lengths[j],
+				       sample_bytes, shift);
+}
+
+#if CONFIG_FORMAT_S16LE
+static void test_src_x86_s16(void **state)
+{
+	test_src_x86_format(sizeof(int16_t), 0);
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static void test_src_x86_s24(void **state)
+{
+	test_src_x86_format(sizeof(int32_t), 8);
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void test_src_x86_s32(void **state)
+{
+	test_src_x86_format(sizeof(int32_t), 0);
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+static int setup(void **state)
+{
+	if (!__builtin_cpu_supports("sse4.2"))
+		skip();
+
+	test_seed = 1;
+	return 0;
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+#if CONFIG_FORMAT_S16LE
+		cmocka_unit_test_setup(test_src_x86_s16, setup),
+#endif
+#if CONFIG_FORMAT_S24LE
+		cmocka_unit_test_setup(test_src_x86_s24, setup),
+#endif
+#if CONFIG_FORMAT_S32LE
+		cmocka_unit_test_setup(test_src_x86_s32, setup),
+#endif
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
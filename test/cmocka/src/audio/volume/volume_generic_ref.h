@@ -0,0 +1,18 @@
+/* SPDX-License-Identifier: BSD-3-Clause
+ *
+ * Copyright(c) 2022 Intel Corporation. All rights reserved.
+ */
+
+#ifndef __VOLUME_GENERIC_REF_H__
+#define __VOLUME_GENERIC_REF_H__
+
+#include <sof/audio/volume.h>
+#include <stddef.h>
+
+/* The generic C version, built without the SIMD flags and with the symbols
+ * renamed, see CMakeLists.txt.
+ */
+extern const struct comp_func_map generic_volume_func_map[];
+extern const size_t generic_volume_func_count;
+
+#endif /* __VOLUME_GENERIC_REF_H__ */
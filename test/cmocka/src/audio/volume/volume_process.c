@@ -14,6 +14,7 @@
 #include <sof/audio/component.h>
 #include <sof/audio/module_adapter/module/generic.h>
 #include <sof/audio/volume.h>
+#include <rtos/string.h>
 #include "../module_adapter.h"
 
 /* Add macro for a volume test level. The levels to test with this code
@@ -256,12 +257,8 @@ static void verify_s32_to_s24_s32(struct processing_module *mod,
 }
 #endif /* CONFIG_FORMAT_S32LE */
 
-static void test_audio_vol(void **state)
+static void fill_source(struct processing_module_test_data *vol_state)
 {
-	struct processing_module_test_data *vol_state = *state;
-	struct processing_module *mod = vol_state->mod;
-	struct vol_data *cd = module_get_private_data(mod);
-
 	switch (vol_state->sinks[0]->stream.frame_fmt) {
 	case SOF_IPC_FRAME_S16_LE:
 		fill_source_s16(vol_state);
@@ -277,6 +274,15 @@ static void test_audio_vol(void **state)
 		/* TODO: add 3LE support */
 		break;
 	}
+}
+
+static void test_audio_vol(void **state)
+{
+	struct processing_module_test_data *vol_state = *state;
+	struct processing_module *mod = vol_state->mod;
+	struct vol_data *cd = module_get_private_data(mod);
+
+	fill_source(vol_state);
 
 	vol_state->input_buffers[0]->consumed = 0;
 	vol_state->output_buffers[0]->size = 0;
@@ -287,6 +293,91 @@ static void test_audio_vol(void **state)
 	vol_state->verify(mod, vol_state->sinks[0], vol_state->sources[0]);
 }
 
+/* The ramp processing of segments must match processing them one by one */
+static void test_audio_vol_ramp(void **state)
+{
+	struct processing_module_test_data *vol_state = *state;
+	struct processing_module *mod = vol_state->mod;
+	struct vol_data *cd = module_get_private_data(mod);
+	struct audio_stream *sink = &vol_state->sinks[0]->stream;
+	const int nseg = 3;
+	const uint32_t seg_frames = mod->dev->frames / nseg;
+	size_t bytes = audio_stream_frame_bytes(sink) * seg_frames * nseg;
+	vol_scale_ramp_func scale_vol_ramp;
+	uint8_t *ref;
+	int i, j;
+
+	scale_vol_ramp = vol_get_ramp_processing_function(mod->dev, vol_state->sinks[0]);
+	if (!scale_vol_ramp)
+		skip();
+
+	fill_source(vol_state);
+
+	for (i = 0; i < nseg; i++) {
+		cd->ramp_segments[i].frames = seg_frames;
+		for (j = 0; j < sink->channels; j++)
+			cd->ramp_segments[i].gain[j] =
+				(int64_t)cd->volume[j] * (i + 1) / (nseg * (j + 1));
+	}
+
+	vol_state->input_buffers[0]->consumed = 0;
+	vol_state->output_buffers[0]->size = 0;
+	scale_vol_ramp(mod, vol_state->input_buffers[0], vol_state->output_buffers[0],
+		       cd->ramp_segments, seg_frames * nseg);
+	assert_int_equal(vol_state->output_buffers[0]->size, bytes);
+
+	ref = test_malloc(bytes);
+	memcpy_s(ref, bytes, sink->w_ptr, bytes);
+	memset_s(sink->w_ptr, bytes, 0, bytes);
+
+	vol_state->input_buffers[0]->consumed = 0;
+	vol_state->output_buffers[0]->size = 0;
+	for (i = 0; i < nseg; i++) {
+		for (j = 0; j < sink->channels; j++)
+			cd->volume[j] = cd->ramp_segments[i].gain[j];
+		cd->scale_vol(mod, vol_state->input_buffers[0], vol_state->output_buffers[0],
+			      seg_frames);
+	}
+
+	assert_memory_equal(ref, sink->w_ptr, bytes);
+	test_free(ref);
+}
+
+/* The ZC ramp looks for the zero crossing in the frames after the consumed
+ * ones. All frames are positive except one, the first half is consumed.
+ */
+static void test_audio_vol_zc(void **state)
+{
+	struct processing_module_test_data *vol_state = *state;
+	struct processing_module *mod = vol_state->mod;
+	struct audio_stream *source = &vol_state->sources[0]->stream;
+	const uint32_t half = mod->dev->frames / 2;
+	const uint32_t neg_frame = 5;
+	int sample_bytes = audio_stream_sample_bytes(source);
+	int nch = source->channels;
+	vol_zc_func zc_get = NULL;
+	int64_t prev_sum = 0;
+	int32_t val;
+	int i;
+
+	for (i = 0; i < volume_zc_func_count; i++)
+		if (volume_zc_func_map[i].frame_fmt == source->frame_fmt)
+			zc_get = volume_zc_func_map[i].func;
+
+	assert_non_null(zc_get);
+
+	for (i = 0; i < 2 * half * nch; i++) {
+		val = i / nch == half + neg_frame ? -1000 : 1000;
+		if (sample_bytes == sizeof(int16_t))
+			((int16_t *)source->r_ptr)[i] = val;
+		else
+			((int32_t *)source->r_ptr)[i] = val;
+	}
+
+	vol_state->input_buffers[0]->consumed = half * audio_stream_frame_bytes(source);
+	assert_int_equal(zc_get(vol_state->input_buffers[0], half, &prev_sum), neg_frame + 1);
+}
+
 static struct processing_module_test_parameters test_parameters[] = {
 #if CONFIG_FORMAT_S16LE
 	{ 2, 48, 1, SOF_IPC_FRAME_S16_LE, SOF_IPC_FRAME_S16_LE,   verify_s16_to_s16 },
@@ -306,10 +397,11 @@ int main(void)
 {
 	struct vol_test_parameters *parameters;
 	uint32_t volume_values[] = {VOL_MAX, VOL_ZERO_DB, VOL_MINUS_80DB};
-	int num_tests = ARRAY_SIZE(test_parameters) * ARRAY_SIZE(volume_values);
+	int num_params = ARRAY_SIZE(test_parameters) * ARRAY_SIZE(volume_values);
+	int num_tests = 3 * num_params;
 	int i, j;
 
-	parameters = test_calloc(num_tests, sizeof(struct vol_test_parameters));
+	parameters = test_calloc(num_params, sizeof(struct vol_test_parameters));
 	for (i = 0; i < ARRAY_SIZE(test_parameters); i++) {
 		for (j = 0; j < ARRAY_SIZE(volume_values); j++) {
 			parameters[i * ARRAY_SIZE(test_parameters) + j].volume = volume_values[j];
@@ -320,12 +412,24 @@ int main(void)
 
 	struct CMUnitTest tests[num_tests];
 
-	for (i = 0; i < num_tests; i++) {
+	for (i = 0; i < num_params; i++) {
 		tests[i].name = "test_audio_vol";
 		tests[i].test_func = test_audio_vol;
 		tests[i].setup_func = setup;
 		tests[i].teardown_func = teardown;
 		tests[i].initial_state = &parameters[i];
+
+		tests[num_params + i].name = "test_audio_vol_ramp";
+		tests[num_params + i].test_func = test_audio_vol_ramp;
+		tests[num_params + i].setup_func = setup;
+		tests[num_params + i].teardown_func = teardown;
+		tests[num_params + i].initial_state = &parameters[i];
+
+		tests[2 * num_params + i].name = "test_audio_vol_zc";
+		tests[2 * num_params + i].test_func = test_audio_vol_zc;
+		tests[2 * num_params + i].setup_func = setup;
+		tests[2 * num_params + i].teardown_func = teardown;
+		tests[2 * num_params + i].initial_state = &parameters[i];
 	}
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
@@ -0,0 +1,185 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <stdint.h>
+#include <cmocka.h>
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/module_adapter/module/generic.h>
+#include <sof/audio/volume.h>
+#include <rtos/string.h>
+
+#include "../../util.h"
+#include "volume_generic_ref.h"
+
+#ifndef VOLUME_X86
+#error "This test needs to be built with the x86 SIMD flags"
+#endif
+
+#define TEST_FRAMES		45
+#define TEST_SOURCE_FRAMES	37
+#define TEST_SINK_FRAMES	50
+
+struct test_vol_run {
+	struct processing_module mod;
+	struct vol_data cd;
+	struct audio_stream sink;
+	struct input_stream_buffer input;
+	struct output_stream_buffer output;
+};
+
+static uint32_t test_seed;
+
+static int32_t test_rand(void)
+{
+	test_seed = test_seed * 1664525 + 1013904223;
+	return (int32_t)test_seed;
+}
+
+static vol_scale_func test_get_func(const struct comp_func_map *map, size_t count,
+				    uint16_t frame_fmt)
+{
+	int i;
+
+	for (i = 0; i < count; i++)
+		if (map[i].frame_fmt == frame_fmt)
+			return map[i].func;
+
+	return NULL;
+}
+
+static void test_stream_init(struct audio_stream *stream, enum sof_ipc_frame frame_fmt,
+			     int channels, int frames, int offset_frames, bool fill)
+{
+	int sample_bytes = frame_fmt == SOF_IPC_FRAME_S16_LE ? sizeof(int16_t) : sizeof(int32_t);
+	uint32_t size = frames * channels * sample_bytes;
+	uint8_t *data = test_calloc(1, size);
+	int i;
+
+	for (i = 0; fill && i < size / sample_bytes; i++) {
+		if (sample_bytes == sizeof(int16_t))
+			((int16_t *)data)[i] = test_rand() >> 16;
+		else
+			((int32_t *)data)[i] = test_rand();
+	}
+
+	stream->frame_fmt = frame_fmt;
+	stream->channels = channels;
+	audio_stream_init(stream, data, size);
+	stream->r_ptr = data + offset_frames * channels * sample_bytes;
+	stream->w_ptr = stream->r_ptr;
+}
+
+static void test_vol_run_init(struct test_vol_run *run, struct audio_stream *source,
+			      const int32_t *volume)
+{
+	int i;
+
+	memset_s(run, sizeof(*run), 0, sizeof(*run));
+	run->mod.priv.private = &run->cd;
+	run->cd.vol = test_calloc(SOF_IPC_MAX_CHANNELS * 4, sizeof(int32_t));
+	for (i = 0; i < source->channels; i++)
+		run->cd.volume[i] = volume[i];
+
+	test_stream_init(&run->sink, source->frame_fmt, source->channels,
+			 TEST_SINK_FRAMES, 29, false);
+	run->input.data = source;
+	run->output.data = &run->sink;
+}
+
+static void test_vol_run_free(struct test_vol_run *run)
+{
+	test_free(run->sink.addr);
+	test_free(run->cd.vol);
+}
+
+/* Different gain for every channel, including the maximum gain that
+ * saturates and the unity gain. The source and the sink wrap.
+ */
+static void test_volume_x86_format(enum sof_ipc_frame frame_fmt)
+{
+	const int channels[] = {1, 2, 3, 4, 5, 8};
+	const int32_t volume[SOF_IPC_MAX_CHANNELS] = {
+		VOL_MAX, VOL_ZERO_DB, VOL_ZERO_DB / 3, 1, VOL_MIN, VOL_ZERO_DB * 5 + 7,
+		VOL_ZERO_DB / 10000, VOL_MAX - 1
+	};
+	vol_scale_func func = test_get_func(volume_func_map, volume_func_count, frame_fmt);
+	vol_scale_func generic_func = test_get_func(generic_volume_func_map,
+						    generic_volume_func_count, frame_fmt);
+	struct audio_stream source;
+	struct test_vol_run run;
+	struct test_vol_run ref;
+	int i;
+
+	assert_non_null(func);
+	assert_non_null(generic_func);
+
+	for (i = 0; i < ARRAY_SIZE(channels); i++) {
+		test_stream_init(&source, frame_fmt, channels[i], TEST_SOURCE_FRAMES, 11, true);
+		test_vol_run_init(&run, &source, volume);
+		test_vol_run_init(&ref, &source, volume);
+
+		func(&run.mod, &run.input, &run.output, TEST_FRAMES);
+		generic_func(&ref.mod, &ref.input, &ref.output, TEST_FRAMES);
+		assert_int_equal(run.input.consumed, ref.input.consumed);
+		assert_int_equal(run.output.size, ref.output.size);
+		assert_memory_equal(run.sink.addr, ref.sink.addr, run.sink.size);
+
+		test_vol_run_free(&ref);
+		test_vol_run_free(&run);
+		test_free(source.addr);
+	}
+}
+
+#if CONFIG_FORMAT_S16LE
+static void test_volume_x86_s16(void **state)
+{
+	test_volume_x86_format(SOF_IPC_FRAME_S16_LE);
+}
+#endif /* CONFIG_FORMAT_S16LE */
+
+#if CONFIG_FORMAT_S24LE
+static void test_volume_x86_s24(void **state)
+{
+	test_volume_x86_format(SOF_IPC_FRAME_S24_4LE);
+}
+#endif /* CONFIG_FORMAT_S24LE */
+
+#if CONFIG_FORMAT_S32LE
+static void test_volume_x86_s32(void **state)
+{
+	test_volume_x86_format(SOF_IPC_FRAME_S32_LE);
+}
+#endif /* CONFIG_FORMAT_S32LE */
+
+static int setup(void **state)
+{
+	if (!__builtin_cpu_supports("sse4.2"))
+		skip();
+
+	test_seed = 1;
+	return 0;
+}
+
+int main(void)
+{
+	const struct CMUnitTest tests[] = {
+#if CONFIG_FORMAT_S16LE
+		cmocka_unit_test_setup(test_volume_x86_s16, setup),
+#endif
+#if CONFIG_FORMAT_S24LE
+		cmocka_unit_test_setup(test_volume_x86_s24, setup),
+#endif
+#if CONFIG_FORMAT_S32LE
+		cmocka_unit_test_setup(test_volume_x86_s32, setup),
+#endif
+	};
+
+	cmocka_set_message_output(CM_OUTPUT_TAP);
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -4,6 +4,7 @@
 //
 // Author: Slawomir Blauciak <slawomir.blauciak@linux.intel.com>
 
+#include <stdbool.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdarg.h>
@@ -13,6 +14,7 @@
 
 #include <sof/sof.h>
 #include <rtos/alloc.h>
+#include <sof/lib/cpu.h>
 #include <sof/lib/mm_heap.h>
 #include <sof/lib/memory.h>
 #include <ipc/header.h>
@@ -323,9 +325,262 @@ static void test_lib_alloc(void **state)
 	}
 }
 
+/* block 0 is the MSB of word 0 of the free bitmap */
+static bool free_map_bit(struct block_map *map, unsigned int block)
+{
+	return map->free_map[block >> 5] & (0x80000000 >> (block & 31));
+}
+
+/* the free bitmap matches the block headers, free_count and first_free */
+static void check_free_map(struct block_map *map)
+{
+	unsigned int words = map->count / 32 + 1;
+	unsigned int first_free = map->count;
+	unsigned int free_count = 0;
+	unsigned int i;
+
+	for (i = 0; i < words * 32; i++) {
+		if (i >= map->count) {
+			assert_false(free_map_bit(map, i));
+			continue;
+		}
+
+		assert_int_equal(free_map_bit(map, i), !map->block[i].used);
+		if (!free_map_bit(map, i))
+			continue;
+
+		if (!free_count++)
+			first_free = i;
+	}
+
+	assert_int_equal(free_count, map->free_count);
+	assert_int_equal(first_free, map->first_free);
+}
+
+/* index of the block of the map that ptr is in */
+static unsigned int map_block(struct block_map *map, void *ptr)
+{
+	uintptr_t base = (uintptr_t)uncache_to_cache((void *)(uintptr_t)map->base);
+	uintptr_t addr = (uintptr_t)uncache_to_cache(ptr);
+
+	assert_true(addr >= base);
+	assert_true(addr < base + map->count * map->block_size);
+
+	return (addr - base) / map->block_size;
+}
+
+/* single blocks are taken lowest first, across the bitmap words */
+static void test_lib_alloc_free_map_block(void **state)
+{
+	struct block_map *map = memmap_get()->runtime[0].map;
+	void **mem = malloc(sizeof(void *) * map->count);
+	int i;
+
+	check_free_map(map);
+	assert_int_equal(map->free_count, map->count);
+
+	for (i = 0; i < map->count; i++) {
+		mem[i] = rmalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+				 map->block_size);
+		assert_non_null(mem[i]);
+		assert_int_equal(map_block(map, mem[i]), i);
+	}
+
+	check_free_map(map);
+	assert_int_equal(map->free_count, 0);
+
+	/* free every third block from the end, first_free follows */
+	for (i = map->count - 1; i >= 0; i -= 3) {
+		rfree(mem[i]);
+		check_free_map(map);
+		assert_int_equal(map->first_free, i);
+	}
+
+	/* the holes are filled from the lowest one */
+	for (i = (map->count - 1) % 3; i < map->count; i += 3) {
+		mem[i] = rmalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+				 map->block_size);
+		assert_non_null(mem[i]);
+		assert_int_equal(map_block(map, mem[i]), i);
+		check_free_map(map);
+	}
+
+	for (i = 0; i < map->count; i++)
+		rfree(mem[i]);
+
+	check_free_map(map);
+	assert_int_equal(map->free_count, map->count);
+
+	free(mem);
+}
+
+/* continuous blocks are taken from the first free run that is long enough */
+static void test_lib_alloc_free_map_cont(void **state)
+{
+	struct block_map *map = memmap_get()->buffer[0].map;
+	size_t bytes = map->block_size;
+	void *mem[32];
+	void *run, *small, *large;
+	unsigned int run_count;
+	int i;
+
+	check_free_map(map);
+	assert_int_equal(map->free_count, map->count);
+	assert_true(map->count > 64);
+
+	mem[0] = rballoc(0, SOF_MEM_CAPS_RAM, bytes / 2);
+	assert_int_equal(map_block(map, mem[0]), 0);
+
+	run_count = map->free_count;
+	run = rballoc(0, SOF_MEM_CAPS_RAM, 3 * bytes);
+	run_count -= map->free_count;
+	assert_true(run_count >= 3);
+	assert_int_equal(map_block(map, run), 1);
+
+	mem[1] = rballoc(0, SOF_MEM_CAPS_RAM, bytes / 2);
+	assert_int_equal(map_block(map, mem[1]), 1 + run_count);
+	check_free_map(map);
+
+	/* leave a hole of run_count blocks after block 0 */
+	rfree(run);
+	check_free_map(map);
+	assert_int_equal(map->first_free, 1);
+
+	/* too large for the hole */
+	large = rballoc(0, SOF_MEM_CAPS_RAM, (run_count + 1) * bytes);
+	assert_int_equal(map_block(map, large), 2 + run_count);
+	check_free_map(map);
+
+	small = rballoc(0, SOF_MEM_CAPS_RAM, 3 * bytes);
+	assert_int_equal(map_block(map, small), 1);
+	check_free_map(map);
+
+	rfree(large);
+	rfree(small);
+	rfree(mem[1]);
+	rfree(mem[0]);
+	check_free_map(map);
+	assert_int_equal(map->free_count, map->count);
+
+	/* a run across the first bitmap word boundary */
+	for (i = 0; i < 30; i++) {
+		mem[i] = rballoc(0, SOF_MEM_CAPS_RAM, bytes / 2);
+		assert_int_equal(map_block(map, mem[i]), i);
+	}
+
+	run = rballoc(0, SOF_MEM_CAPS_RAM, 3 * bytes);
+	assert_int_equal(map_block(map, run), 30);
+	for (i = 30; i < 30 + run_count; i++)
+		assert_false(free_map_bit(map, i));
+	assert_true(free_map_bit(map, 30 + run_count));
+	check_free_map(map);
+
+	rfree(run);
+	check_free_map(map);
+	assert_int_equal(map->first_free, 30);
+
+	for (i = 0; i < 30; i++)
+		rfree(mem[i]);
+	check_free_map(map);
+	assert_int_equal(map->free_count, map->count);
+}
+
+/* Takes every block of the heap, including the first and the last one, and
+ * frees them, so rfree() has to look up the heap at both of its boundaries.
+ */
+static void test_lib_alloc_heap_bounds(struct mm_heap *heap, enum mem_zone zone)
+{
+	struct block_map *last = &heap->map[heap->blocks - 1];
+	uint32_t used = heap->info.used;
+	unsigned int count = 0;
+	unsigned int n = 0;
+	void **mem;
+	int i, j;
+
+	for (i = 0; i < heap->blocks; i++) {
+		assert_int_equal(heap->map[i].free_count, heap->map[i].count);
+		count += heap->map[i].count;
+	}
+
+	mem = malloc(sizeof(void *) * count);
+
+	for (i = 0; i < heap->blocks; i++) {
+		for (j = 0; j < heap->map[i].count; j++) {
+			mem[n] = rmalloc(zone, 0, SOF_MEM_CAPS_RAM,
+					 heap->map[i].block_size);
+			assert_non_null(mem[n]);
+			assert_int_equal(map_block(&heap->map[i], mem[n]), j);
+			n++;
+		}
+	}
+
+	assert_int_equal(map_block(&heap->map[0], mem[0]), 0);
+	assert_int_equal(map_block(last, mem[n - 1]), last->count - 1);
+
+	while (n--)
+		rfree(mem[n]);
+
+	for (i = 0; i < heap->blocks; i++) {
+		check_free_map(&heap->map[i]);
+		assert_int_equal(heap->map[i].free_count, heap->map[i].count);
+	}
+	assert_int_equal(heap->info.used, used);
+
+	free(mem);
+}
+
+/* the first block of a buffer heap */
+static void test_lib_alloc_heap_first(struct mm_heap *heap)
+{
+	struct block_map *map = heap->map;
+	void *mem;
+
+	if (!heap->size)
+		return;
+
+	mem = rballoc(0, heap->caps, 1);
+	assert_non_null(mem);
+	assert_int_equal(map_block(map, mem), 0);
+
+	rfree(mem);
+	check_free_map(map);
+	assert_int_equal(map->free_count, map->count);
+}
+
+static void test_lib_alloc_heap_index(void **state)
+{
+	struct mm *memmap = memmap_get();
+	int i;
+
+	/* sorted by address and not overlapping */
+	assert_true(memmap->heap_index_count > 1);
+	for (i = 1; i < memmap->heap_index_count; i++)
+		assert_true(memmap->heap_index[i - 1]->heap +
+			    memmap->heap_index[i - 1]->size <=
+			    memmap->heap_index[i]->heap);
+
+	test_lib_alloc_heap_bounds(memmap->runtime, SOF_MEM_ZONE_RUNTIME);
+	test_lib_alloc_heap_bounds(memmap->system_runtime + cpu_get_id(),
+				   SOF_MEM_ZONE_SYS_RUNTIME);
+#if CONFIG_CORE_COUNT > 1
+	test_lib_alloc_heap_bounds(memmap->runtime_shared,
+				   SOF_MEM_ZONE_RUNTIME_SHARED);
+#endif
+
+	for (i = 0; i < PLATFORM_HEAP_BUFFER; i++)
+		test_lib_alloc_heap_first(memmap->buffer + i);
+}
+
+static const struct CMUnitTest free_map_tests[] = {
+	cmocka_unit_test(test_lib_alloc_free_map_block),
+	cmocka_unit_test(test_lib_alloc_free_map_cont),
+	cmocka_unit_test(test_lib_alloc_heap_index),
+};
+
 int main(void)
 {
-	struct CMUnitTest tests[ARRAY_SIZE(test_cases)];
+	struct CMUnitTest tests[ARRAY_SIZE(test_cases) +
+				ARRAY_SIZE(free_map_tests)];
 
 	int i;
 
@@ -339,6 +594,9 @@ int main(void)
 		t->teardown_func = NULL;
 	}
 
+	for (i = 0; i < ARRAY_SIZE(free_map_tests); ++i)
+		tests[ARRAY_SIZE(test_cases) + i] = free_map_tests[i];
+
 	cmocka_set_message_output(CM_OUTPUT_TAP);
 
 	return cmocka_run_group_tests(tests, setup, teardown);
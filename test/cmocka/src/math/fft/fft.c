@@ -17,6 +17,7 @@
 #include <sof/audio/component.h>
 #include <sof/audio/format.h>
 #include <sof/math/fft.h>
+#include <rtos/string.h>
 
 #include "input.h"
 
@@ -786,6 +787,196 @@ static void test_math_fft_1024_ifft_16(void **state)
 	assert_int_equal(db < FFT_DB_TH_16, 0);
 }
 
+static void test_math_fft_real_1024_16(void **state)
+{
+	struct icomplex16 *inb;
+	struct icomplex16 *outb;
+	struct icomplex16 *ifft_outb;
+	struct fft_plan *plan;
+	struct fft_plan *ifft_plan;
+	int16_t *in;
+	int16_t *out;
+	int fft_size = 1024;
+	int half_size = fft_size / 2;
+	int64_t signal_td = 0;
+	int64_t noise_td = 0;
+	double signal;
+	double noise;
+	double snr;
+	int r;
+	int i;
+
+	(void)state;
+
+	in = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, fft_size * sizeof(int16_t));
+	inb = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+		      (half_size + 1) * sizeof(struct icomplex16));
+	outb = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+		       (half_size + 1) * sizeof(struct icomplex16));
+	ifft_outb = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			    (half_size + 1) * sizeof(struct icomplex16));
+	assert_non_null(in);
+	assert_non_null(inb);
+	assert_non_null(outb);
+	assert_non_null(ifft_outb);
+
+	/* real samples are packed as half size complex input */
+	get_sine_16(in, SINE_FREQ, SINE_FS, fft_size);
+	memcpy_s(inb, (half_size + 1) * sizeof(struct icomplex16), in,
+		 fft_size * sizeof(int16_t));
+
+	plan = fft_plan_new(inb, outb, half_size, 16);
+	ifft_plan = fft_plan_new(outb, ifft_outb, half_size, 16);
+	assert_non_null(plan);
+	assert_non_null(ifft_plan);
+
+	fft_execute_real_16(plan, false);
+
+	/* find peak */
+	r = power_peak_index_16(outb, fft_size);
+	i = (int)round((SINE_FREQ * fft_size) / SINE_FS);
+	printf("%s: peak at point %d\n", __func__, r);
+	assert_in_range(r, i - 1, i + 1);
+
+	/* the min. SNR should be met */
+	noise = integrate_power_16(outb, 0, i - 2);
+	signal = integrate_power_16(outb, i - 1, i + 1);
+	noise += integrate_power_16(outb, i + 2, half_size - 1);
+	snr = 10 * log10(signal / noise);
+	printf("%s: SNR %5.2f dB\n", __func__, snr);
+	assert_int_equal(snr < MIN_SNR_1024_16, 0);
+
+	/* the real output IFFT should restore the input */
+	fft_execute_real_16(ifft_plan, true);
+	out = (int16_t *)ifft_outb;
+	for (i = 0; i < fft_size; i++) {
+		signal_td += (int64_t)in[i] * in[i];
+		noise_td += (int64_t)(out[i] - in[i]) * (out[i] - in[i]);
+	}
+
+	snr = 10 * log10((double)signal_td / noise_td);
+	printf("%s: IFFT SNR %6.2f dB\n", __func__, snr);
+	assert_int_equal(snr < FFT_DB_TH_16, 0);
+
+	fft_plan_free(ifft_plan);
+	fft_plan_free(plan);
+	rfree(ifft_outb);
+	rfree(outb);
+	rfree(inb);
+	rfree(in);
+}
+
+static void test_math_fft_real_1024(void **state)
+{
+	struct icomplex32 *inb;
+	struct icomplex32 *outb;
+	struct icomplex32 *ifft_outb;
+	struct fft_plan *plan;
+	struct fft_plan *ifft_plan;
+	int32_t *in;
+	int32_t *out;
+	int fft_size = 1024;
+	int half_size = fft_size / 2;
+	int64_t signal_td = 0;
+	int64_t noise_td = 0;
+	double signal;
+	double noise;
+	double snr;
+	int r;
+	int i;
+
+	(void)state;
+
+	in = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM, fft_size * sizeof(int32_t));
+	inb = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+		      (half_size + 1) * sizeof(struct icomplex32));
+	outb = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+		       (half_size + 1) * sizeof(struct icomplex32));
+	ifft_outb = rzalloc(SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM,
+			    (half_size + 1) * sizeof(struct icomplex32));
+	assert_non_null(in);
+	assert_non_null(inb);
+	assert_non_null(outb);
+	assert_non_null(ifft_outb);
+
+	/* real samples are packed as half size complex input */
+	get_sine_32(in, SINE_FREQ, SINE_FS, fft_size);
+	memcpy_s(inb, (half_size + 1) * sizeof(struct icomplex32), in,
+		 fft_size * sizeof(int32_t));
+
+	plan = fft_plan_new(inb, outb, half_size, 32);
+	ifft_plan = fft_plan_new(outb, ifft_outb, half_size, 32);
+	assert_non_null(plan);
+	assert_non_null(ifft_plan);
+
+	fft_execute_real_32(plan, false);
+
+	/* find peak */
+	r = power_peak_index_32(outb, fft_size);
+	i = (int)round((SINE_FREQ * fft_size) / SINE_FS);
+	printf("%s: peak at point %d\n", __func__, r);
+	assert_in_range(r, i - 1, i + 1);
+
+	/* the min. SNR should be met */
+	noise = integrate_power_32(outb, 0, i - 2);
+	signal = integrate_power_32(outb, i - 1, i + 1);
+	noise += integrate_power_32(outb, i + 2, half_size - 1);
+	snr = 10 * log10(signal / noise);
+	printf("%s: SNR %5.2f dB\n", __func__, snr);
+	assert_int_equal(snr < MIN_SNR_1024, 0);
+
+	/* the real output IFFT should restore the input */
+	fft_execute_real_32(ifft_plan, true);
+	out = (int32_t *)ifft_outb;
+	for (i = 0; i < fft_size; i++) {
+		signal_td += (int64_t)(in[i] / 32) * (in[i] / 32);
+		noise_td += (int64_t)((out[i] - in[i]) / 32) * ((out[i] - in[i]) / 32);
+	}
+
+	snr = 10 * log10((double)signal_td / noise_td);
+	printf("%s: IFFT SNR %6.2f dB\n", __func__, snr);
+	assert_int_equal(snr < FFT_DB_TH, 0);
+
+	fft_plan_free(ifft_plan);
+	fft_plan_free(plan);
+	rfree(ifft_outb);
+	rfree(outb);
+	rfree(inb);
+	rfree(in);
+}
+
+static void test_math_fft_plan_shared(void **state)
+{
+	struct icomplex32 buf32[4];
+	struct icomplex16 buf16[4];
+	struct fft_plan *plan1;
+	struct fft_plan *plan2;
+	struct fft_plan *plan3;
+
+	(void)state;
+
+	plan1 = fft_plan_new(buf32, buf32, 256, 32);
+	plan2 = fft_plan_new(buf32, buf32, 256, 32);
+	plan3 = fft_plan_new(buf16, buf16, 256, 16);
+	assert_non_null(plan1);
+	assert_non_null(plan2);
+	assert_non_null(plan3);
+
+	/* same size and word length share the tables */
+	assert_ptr_equal(plan1->bit_reverse_idx, plan2->bit_reverse_idx);
+	assert_ptr_equal(plan1->twiddle32, plan2->twiddle32);
+	assert_ptr_not_equal(plan1->bit_reverse_idx, plan3->bit_reverse_idx);
+
+	/* the tables stay valid while a plan still uses them */
+	fft_plan_free(plan1);
+	assert_int_equal(plan2->bit_reverse_idx[1], 128);
+	assert_int_equal(plan2->twiddle32[0].real, twiddle_real_32[0]);
+	assert_int_equal(plan3->twiddle16[2].imag, twiddle_imag_16[FFT_SIZE_MAX / 4]);
+
+	fft_plan_free(plan2);
+	fft_plan_free(plan3);
+}
+
 int main(void)
 {
 	const struct CMUnitTest tests[] = {
@@ -793,11 +984,14 @@ int main(void)
 		cmocka_unit_test(test_math_fft_512_16),
 		cmocka_unit_test(test_math_fft_1024_16),
 		cmocka_unit_test(test_math_fft_1024_ifft_16),
+		cmocka_unit_test(test_math_fft_real_1024_16),
 		cmocka_unit_test(test_math_fft_256),
 		cmocka_unit_test(test_math_fft_512),
 		cmocka_unit_test(test_math_fft_1024),
 		cmocka_unit_test(test_math_fft_1024_ifft),
 		cmocka_unit_test(test_math_fft_512_2ch),
+		cmocka_unit_test(test_math_fft_real_1024),
+		cmocka_unit_test(test_math_fft_plan_shared),
 	};
 
 	cmocka_set_message_output(CM_OUTPUT_TAP);
@@ -110,8 +110,6 @@ struct fuzz {
 	/* ipc mutex */
 	pthread_mutex_t ipc_mutex;
 
-	FILE *tplg_file;
-
 	void *platform_data; /* core does not touch this */
 };
 
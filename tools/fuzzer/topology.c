@@ -108,7 +108,8 @@ static int fuzzer_complete_pipeline(struct fuzz *fuzzer, uint32_t comp_id)
 
 /* load pipeline graph DAPM widget*/
 static int fuzzer_load_graph(void *dev, struct comp_info *temp_comp_list,
-		      int count, int num_comps, int pipeline_id)
+			     struct snd_soc_tplg_dapm_graph_elem *routes,
+			     int count, int num_comps, int pipeline_id)
 {
 	struct sof_ipc_pipe_comp_connect connection;
 	struct fuzz *fuzzer = (struct fuzz *)dev;
@@ -120,7 +121,7 @@ static int fuzzer_load_graph(void *dev, struct comp_info *temp_comp_list,
 	for (i = 0; i < count; i++) {
 		ret = tplg_create_graph(num_comps, pipeline_id, temp_comp_list,
 				      pipeline_string, &connection,
-				      fuzzer->tplg_file, i, count);
+				      &routes[i], i, count);
 		if (ret < 0)
 			return ret;
 
@@ -376,21 +377,6 @@ static int fuzzer_load_widget(struct tplg_context *ctx)
 		return -EINVAL;
 	}
 
-	/* allocate memory for widget */
-	ctx->widget_size = sizeof(struct snd_soc_tplg_dapm_widget);
-	ctx->widget = malloc(ctx->widget_size);
-	if (!ctx->widget) {
-		fprintf(stderr, "error: mem alloc\n");
-		return -errno;
-	}
-
-	/* read widget data */
-	ret = fread(ctx->widget, ctx->widget_size, 1, ctx->file);
-	if (ret != 1) {
-		ret = -EINVAL;
-		goto exit;
-	}
-
 	/*
 	 * create a list with all widget info
 	 * containing mapping between component names and ids
@@ -491,27 +477,13 @@ static int fuzzer_load_widget(struct tplg_context *ctx)
 		break;
 	/* unsupported widgets */
 	default:
-		if (fseek(ctx->file, ctx->widget->priv.size, SEEK_CUR)) {
-			fprintf(stderr, "error: fseek unsupported widget\n");
-			ret = -errno;
-			goto exit;
-		}
-
 		printf("info: Widget type not supported %d\n", ctx->widget->id);
-		ret = tplg_create_controls(ctx->widget->num_kcontrols, ctx->file, NULL, 0);
-		if (ret < 0) {
-			fprintf(stderr, "error: loading controls\n");
-			goto exit;
-		}
-		ret = 0;
 		break;
 	}
 
 	ret = 1;
 
 exit:
-	/* free allocated widget data */
-	free(ctx->widget);
 	return ret;
 }
 
@@ -521,48 +493,22 @@ int fuzzer_parse_topology(struct tplg_context *ctx)
 	struct snd_soc_tplg_hdr *hdr;
 	struct fuzz *fuzzer = ctx->fuzzer;
 	struct comp_info *comp_list_realloc = NULL;
+	struct tplg_block *block;
 	char message[DEBUG_MSG_LEN];
 	int num_comps = 0;
-	int i, ret = 0;
-	size_t file_size, size;
-
-	/* open topology file */
-	ctx->file = fopen(ctx->tplg_file, "rb");
-	if (!ctx->file) {
-		fprintf(stderr, "error: opening file %s\n", ctx->tplg_file);
-		return -errno;
-	}
-	fuzzer->tplg_file = ctx->file;
+	int i, b, ret = 0;
+	size_t size;
 
-	/* file size */
-	if (fseek(ctx->file, 0, SEEK_END)) {
-		fprintf(stderr, "error: seek to end of topology\n");
-		fclose(ctx->file);
-		return -errno;
-	}
-	file_size = ftell(ctx->file);
-	if (fseek(ctx->file, 0, SEEK_SET)) {
-		fprintf(stderr, "error: seek to beginning of topology\n");
-		fclose(ctx->file);
-		return -errno;
-	}
-
-	/* allocate memory */
-	size = sizeof(struct snd_soc_tplg_hdr);
-	hdr = (struct snd_soc_tplg_hdr *)malloc(size);
-	if (!hdr) {
-		fprintf(stderr, "error: mem alloc\n");
-		return -EINVAL;
-	}
+	/* map and index the topology file */
+	ret = tplg_map_open(ctx);
+	if (ret < 0)
+		return ret;
 
 	fprintf(stdout, "debug: %s", "topology parsing start\n");
 
-	while (1) {
-		/* read topology header */
-		ret = fread(hdr, sizeof(struct snd_soc_tplg_hdr), 1,
-			    fuzzer->tplg_file);
-		if (ret != 1)
-			return -EINVAL;
+	for (b = 0; b < ctx->map.num_blocks; b++) {
+		block = &ctx->map.blocks[b];
+		hdr = block->hdr;
 
 		sprintf(message, "type: %x, size: 0x%x count: %d index: %d\n",
 			hdr->type, hdr->payload_size, hdr->count, hdr->index);
@@ -583,6 +529,7 @@ int fuzzer_parse_topology(struct tplg_context *ctx)
 
 			if (!comp_list_realloc && size) {
 				fprintf(stderr, "error: mem realloc\n");
+				tplg_map_close(ctx);
 				return -ENOMEM;
 			}
 			ctx->info = comp_list_realloc;
@@ -590,9 +537,9 @@ int fuzzer_parse_topology(struct tplg_context *ctx)
 			for (i = (ctx->info_elems - hdr->count); i < ctx->info_elems; i++)
 				ctx->info[i].name = NULL;
 
-			for (ctx->info_index = (ctx->info_elems - hdr->count);
-			     ctx->info_index < ctx->info_elems;
-			     ctx->info_index++) {
+			for (i = 0; i < hdr->count; i++) {
+				ctx->info_index = ctx->info_elems - hdr->count + i;
+				tplg_map_widget(ctx, block->first + i);
 				ret = fuzzer_load_widget(ctx);
 				if (ret < 0) {
 					printf("error: loading widget\n");
@@ -604,18 +551,14 @@ int fuzzer_parse_topology(struct tplg_context *ctx)
 
 		/* set up component connections from pipeline graph */
 		case SND_SOC_TPLG_TYPE_DAPM_GRAPH:
-			if (fuzzer_load_graph(fuzzer, comp_list_realloc, hdr->count,
-				       num_comps, hdr->index) < 0) {
+			if (fuzzer_load_graph(fuzzer, comp_list_realloc, block->payload,
+					      hdr->count, num_comps, hdr->index) < 0) {
 				fprintf(stderr, "error: pipeline graph\n");
+				tplg_map_close(ctx);
 				return -EINVAL;
 			}
-			if (ftell(fuzzer->tplg_file) == file_size)
-				goto finish;
 			break;
 		default:
-			fseek(fuzzer->tplg_file, hdr->payload_size, SEEK_CUR);
-			if (ftell(fuzzer->tplg_file) == file_size)
-				goto finish;
 			break;
 		}
 	}
@@ -628,12 +571,10 @@ finish:
 	fprintf(stdout, "debug: %s", "topology parsing end\n");
 
 	/* free all data */
-	free(hdr);
-
 	for (i = 0; i < num_comps; i++)
 		free(comp_list_realloc[i].name);
 
 	free(comp_list_realloc);
-	fclose(fuzzer->tplg_file);
+	tplg_map_close(ctx);
 	return 0;
 }
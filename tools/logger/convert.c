@@ -7,14 +7,19 @@
 
 #include <assert.h>
 #include <endian.h>
+#include <stdarg.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 #include <errno.h>
+#include <inttypes.h>
+#include <pthread.h>
 #include <unistd.h>
 #include <math.h>
 #include <sof/lib/uuid.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <time.h>
 #include <user/abi_dbg.h>
 #include <user/trace.h>
@@ -30,6 +35,11 @@
 #define TRACE_MAX_IDS_STR		10
 #define TRACE_IDS_MASK			((1 << TRACE_ID_LENGTH) - 1)
 #define INVALID_TRACE_ID		(-1 & TRACE_IDS_MASK)
+#define LOG_BUF_SIZE			4096
+#define PIPE_BATCH_RECORDS		512
+#define PIPE_READ_SIZE			(64 * 1024)
+#define PIPE_TEXT_SIZE			(64 * 1024)
+#define UUID_STR_MAX			(UUID_NAME_MAX_LEN + 64) /* name, uuid, colors */
 
 /** Dictionary entry. This MUST match the start of the linker output
  * defined by _DECLARE_LOG_ENTRY().
@@ -43,21 +53,62 @@ struct ldc_entry_header {
 	uint32_t text_len;
 };
 
-/** Dictionary entry + unformatted parameters */
+/** How a printf conversion of a dictionary entry consumes its raw parameter */
+enum ldc_param_type {
+	LDC_PARAM_RAW = 0,	/* passed to printf() without modification */
+	LDC_PARAM_STRING,	/* %s, pointers to firmware memory can't be printed */
+	LDC_PARAM_UUID,		/* %pUx, uuid entry address */
+	LDC_PARAM_ENTRY,	/* %pQ, log entry address */
+};
+
+struct ldc_param {
+	enum ldc_param_type type;
+	bool be;		/* %pUb and %pUB */
+	bool upper;		/* %pUB and %pUL */
+};
+
+/** Dictionary entry parsed once from the mapped ldc file */
 struct ldc_entry {
 	struct ldc_entry_header header;
-	char *file_name;
-	char *text;
-	uint32_t *params;
+	const char *text;	/* format string as stored in the dictionary */
+	char *format;		/* text with %pUx and %pQ replaced by %s */
+	char *file_name_buf;
+	const char *file_name;	/* formatted for output, points into file_name_buf */
+	struct ldc_param params[TRACE_MAX_PARAMS_COUNT];
+};
+
+/** Mapped ldc file and its entries indexed by (address - base_address) / 4 */
+struct ldc_cache {
+	const uint8_t *data;
+	size_t size;
+	bool mapped;		/* data comes from mmap(), not from malloc() */
+	struct ldc_entry **entries;
+	size_t num_slots;
 };
 
+static struct ldc_cache ldc_cache;
+
 /** Dictionary entry + formatted parameters */
 struct proc_ldc_entry {
-	int subst_mask;
 	struct ldc_entry_header header;
-	char *file_name;
-	char *text;
+	const char *file_name;
+	const char *text;
 	uintptr_t params[TRACE_MAX_PARAMS_COUNT];
+	char strings[TRACE_MAX_PARAMS_COUNT][UUID_STR_MAX]; /* substituted params */
+};
+
+/** Growable text buffer log statements are formatted into */
+struct log_buf {
+	char *data;
+	size_t len;
+	size_t size;
+};
+
+/** Per statement state which depends on the statements before it */
+struct entry_timing {
+	uint64_t last_timestamp;	/* of the previous statement, for DELTA */
+	uint64_t origin;		/* timestamp shown as zero */
+	bool first;			/* shown with a zero DELTA */
 };
 
 static const char *BAD_PTR_STR = "<bad uid ptr 0x%.8x>";
@@ -67,28 +118,36 @@ static const char *BAD_PTR_STR = "<bad uid ptr 0x%.8x>";
 
 static const char *missing = "<missing>";
 
-static int read_entry_from_ldc_file(struct ldc_entry *entry, uint32_t log_entry_address);
+static const struct ldc_entry *get_ldc_entry(uint32_t log_entry_address);
 
-char *format_uid_raw(const struct sof_uuid_entry *uid_entry, int use_colors, int name_first,
-		     bool be, bool upper)
+static int snprintf_uid_raw(char *buf, size_t size, const struct sof_uuid_entry *uid_entry,
+			    int use_colors, int name_first, bool be, bool upper)
 {
 	const struct sof_uuid *uid_val = &uid_entry->id;
 	uint32_t a = be ? htobe32(uid_val->a) : uid_val->a;
 	uint16_t b = be ? htobe16(uid_val->b) : uid_val->b;
 	uint16_t c = be ? htobe16(uid_val->c) : uid_val->c;
-	char *str;
-
-	str = log_asprintf(upper ? UUID_UPPER : UUID_LOWER,
-			   use_colors ? KBLU : "",
-			   name_first ? uid_entry->name : "",
-			   name_first ? " " : "",
-			   a, b, c,
-			   uid_val->d[0], uid_val->d[1], uid_val->d[2],
-			   uid_val->d[3], uid_val->d[4], uid_val->d[5],
-			   uid_val->d[6], uid_val->d[7],
-			   name_first ? "" : " ",
-			   name_first ? "" : uid_entry->name,
-			   use_colors ? KNRM : "");
+
+	return snprintf(buf, size, upper ? UUID_UPPER : UUID_LOWER,
+			use_colors ? KBLU : "",
+			name_first ? uid_entry->name : "",
+			name_first ? " " : "",
+			a, b, c,
+			uid_val->d[0], uid_val->d[1], uid_val->d[2],
+			uid_val->d[3], uid_val->d[4], uid_val->d[5],
+			uid_val->d[6], uid_val->d[7],
+			name_first ? "" : " ",
+			name_first ? "" : uid_entry->name,
+			use_colors ? KNRM : "");
+}
+
+char *format_uid_raw(const struct sof_uuid_entry *uid_entry, int use_colors, int name_first,
+		     bool be, bool upper)
+{
+	char *str = malloc(UUID_STR_MAX);
+
+	if (str)
+		snprintf_uid_raw(str, UUID_STR_MAX, uid_entry, use_colors, name_first, be, upper);
 	return str;
 }
 
@@ -121,104 +180,101 @@ uint32_t get_uuid_key(const struct sof_uuid_entry *entry)
 		uids_dict->data_offset + uids_dict->base_address;
 }
 
-static const char *format_uid(uint32_t uid_ptr, int use_colors, bool be, bool upper)
+static void snprintf_uid(char *buf, size_t size, uint32_t uid_ptr, int use_colors,
+			 bool be, bool upper)
 {
 	const struct snd_sof_uids_header *uids_dict = global_config->uids_dict;
-	const struct sof_uuid_entry *uid_entry;
-	char *str;
 
 	if (uid_ptr < uids_dict->base_address ||
-	    uid_ptr >= uids_dict->base_address + uids_dict->data_length) {
-		str = calloc(1, strlen(BAD_PTR_STR) + 1 + 6);
-		if (!str) {
-			log_err("can't allocate memory\n");
-			exit(EXIT_FAILURE);
-		}
-		sprintf(str, BAD_PTR_STR, uid_ptr);
-	} else {
-		uid_entry = get_uuid_entry(uid_ptr);
-		str = format_uid_raw(uid_entry, use_colors, 1, be, upper);
-	}
-
-	return str;
+	    uid_ptr >= uids_dict->base_address + uids_dict->data_length)
+		snprintf(buf, size, BAD_PTR_STR, uid_ptr);
+	else
+		snprintf_uid_raw(buf, size, get_uuid_entry(uid_ptr), use_colors, 1, be, upper);
 }
 
-/* fmt should point '%pUx`, return pointer to UUID string or zero */
-static const char *asprintf_uuid(const char *fmt, uint32_t uuid_key, bool use_colors, int *fmt_len)
+/* fmt should point '%pUx`, return length of the conversion or zero */
+static int parse_uuid_fmt(const char *fmt, const char *fmt_end, struct ldc_param *param)
 {
-	const char *fmt_end = fmt + strlen(fmt);
-	int be, upper;
 	int len = 4; /* assure full formating, with x */
 
-	if (fmt + 2 >= fmt_end || fmt[1] != 'p' || fmt[2] != 'U') {
-		*fmt_len = 0;
-		return NULL;
-	}
+	if (fmt + 2 >= fmt_end || fmt[1] != 'p' || fmt[2] != 'U')
+		return 0;
+
 	/* check 'x' value */
 	switch (fmt + 3 < fmt_end ? fmt[3] : 0) {
 	case 'b':
-		be = 1;
-		upper = 0;
+		param->be = true;
+		param->upper = false;
 		break;
 	case 'B':
-		be = 1;
-		upper = 1;
+		param->be = true;
+		param->upper = true;
 		break;
 	case 'l':
-		be = 0;
-		upper = 0;
+		param->be = false;
+		param->upper = false;
 		break;
 	case 'L':
-		be = 0;
-		upper = 1;
+		param->be = false;
+		param->upper = true;
 		break;
 	default:
-		be = 0;
-		upper = 0;
+		param->be = false;
+		param->upper = false;
 		--len;
 		break;
 	}
-	*fmt_len = len;
-	return format_uid(uuid_key, use_colors, be, upper);
+	return len;
 }
 
-static const char *asprintf_entry_text(uint32_t entry_address)
+/* slot of the entry cache for a log entry address, NULL if it's not a valid one */
+static struct ldc_entry **ldc_cache_slot(uint32_t log_entry_address)
 {
-	struct ldc_entry entry;
-	int ret;
+	uint32_t base_address = global_config->logs_header->base_address;
+	uint32_t offset = log_entry_address - base_address;
 
-	ret = read_entry_from_ldc_file(&entry, entry_address);
-	if (ret)
+	/* log entries are 4 bytes aligned by _DECLARE_LOG_ENTRY() */
+	if (log_entry_address < base_address || offset % sizeof(uint32_t) ||
+	    offset / sizeof(uint32_t) >= ldc_cache.num_slots)
 		return NULL;
 
-	free(entry.file_name);
+	return &ldc_cache.entries[offset / sizeof(uint32_t)];
+}
+
+/* Only looks up entries already loaded by load_entry_params(), so formatter
+ * threads never modify the cache.
+ */
+static const char *get_entry_text(uint32_t entry_address)
+{
+	struct ldc_entry **slot = ldc_cache_slot(entry_address);
+
+	return slot && *slot ? (*slot)->text : NULL;
+}
+
+/** Loads the dictionary entries referenced by %pQ params of a statement */
+static void load_entry_params(const struct ldc_entry *entry, const uint32_t *params)
+{
+	int i;
 
-	return entry.text;
+	for (i = 0; i < entry->header.params_num; i++)
+		if (entry->params[i].type == LDC_PARAM_ENTRY)
+			get_ldc_entry(params[i]);
 }
 
-/** printf-like formatting from the binary ldc_entry input to the
- *  formatted proc_lpc_entry output. Also copies the unmodified
- *  ldc_entry_header from input to output.
+/** Scans the dictionary text of a freshly loaded entry for conversion
+ *  specifiers once, so printing the entry later does not have to.
+ *  Rewrites %pUx and %pQ in the format copy into %s and records how
+ *  each raw parameter is to be converted.
  *
- * @param[out] pe copy of the header + formatted output
- * @param[in] e copy of the dictionary entry where unformatted,
-    uint32_t params have been inserted.
-   @param[in] use_colors whether to use ANSI terminal codes
-*/
-static void process_params(struct proc_ldc_entry *pe,
-			   const struct ldc_entry *e,
-			   int use_colors)
+ * @param[in,out] e dictionary entry with text and format set
+ */
+static void parse_entry_format(struct ldc_entry *e)
 {
-	char *p = e->text;
-	const char *t_end = p + strlen(e->text);
+	char *p = e->format;
+	const char *t_end = p + strlen(e->format);
 	int uuid_fmt_len;
 	int i = 0;
 
-	pe->subst_mask = 0;
-	pe->header =  e->header;
-	pe->file_name = e->file_name;
-	pe->text = e->text;
-
 	/*
 	 * Scan the text for possible replacements. We follow the Linux kernel
 	 * that uses %pUx formats for UUID / GUID printing, where 'x' is
@@ -226,15 +282,12 @@ static void process_params(struct proc_ldc_entry *pe,
 	 * For decoding log entry text from pointer %pQ is used.
 	 */
 	while ((p = strchr(p, '%'))) {
-		uint32_t raw_param;
-
 		if (i >= e->header.params_num) {
-			/* Don't read e->params[] out of bounds. */
+			/* Don't read params[] out of bounds. */
 			log_err("Too many %% conversion specifiers in '%s'\n",
 				e->text);
 			break;
 		}
-		raw_param = e->params[i];
 
 		/* % can't be the last char */
 		if (p + 1 >= t_end) {
@@ -243,56 +296,35 @@ static void process_params(struct proc_ldc_entry *pe,
 		}
 
 		/* scan format string */
+		uuid_fmt_len = parse_uuid_fmt(p, t_end, &e->params[i]);
 		if (p[1] == '%') {
 			/* Skip "%%" */
 			p += 2;
 		} else if (p[1] == 's') {
 			/* %s format specifier */
-			/* check for string printing, because it leads to logger crash */
-			log_err("String printing is not supported\n");
-			pe->params[i] = (uintptr_t)log_asprintf("<String @ 0x%08x>", raw_param);
-			if (!pe->params[i])
-				abort();
-			pe->subst_mask |= 1 << i;
-			++i;
+			e->params[i++].type = LDC_PARAM_STRING;
 			p += 2;
-		} else if (p + 2 < t_end && p[1] == 'p' && p[2] == 'U') {
+		} else if (uuid_fmt_len) {
 			/* %pUx format specifier */
-			/* substitute UUID entry address with formatted string pointer from heap */
-			pe->params[i] = (uintptr_t)asprintf_uuid(p, raw_param, use_colors,
-								 &uuid_fmt_len);
-			if (!pe->params[i])
-				abort();
-			pe->subst_mask |= 1 << i;
-			++i;
+			e->params[i++].type = LDC_PARAM_UUID;
 			/* replace uuid formatter with %s */
 			p[1] = 's';
 			memmove(&p[2], &p[uuid_fmt_len], (int)(t_end - &p[uuid_fmt_len]) + 1);
-			p += uuid_fmt_len - 2;
+			p += 2;
 			t_end -= uuid_fmt_len - 2;
 		} else if (p + 2 < t_end && p[1] == 'p' && p[2] == 'Q') {
 			/* %pQ format specifier */
-			/* substitute log entry address with formatted entry text */
-			pe->params[i] = (uintptr_t)asprintf_entry_text(raw_param);
-
-			if (pe->params[i])
-				pe->subst_mask |= 1 << i;
-			else
-				pe->params[i] = (uintptr_t)missing;
-
-			++i;
-
+			e->params[i++].type = LDC_PARAM_ENTRY;
 			/* replace entry formatter with %s */
 			p[1] = 's';
 			memmove(&p[2], &p[3], t_end - &p[2]);
-			p++;
+			p += 2;
 			t_end--;
 		} else {
 			/* arguments different from %pU and %pQ should be passed without
 			 * modification
 			 */
-			pe->params[i] = raw_param;
-			++i;
+			e->params[i++].type = LDC_PARAM_RAW;
 			p += 2;
 		}
 	}
@@ -300,14 +332,114 @@ static void process_params(struct proc_ldc_entry *pe,
 		log_err("Too few %% conversion specifiers in '%s'\n", e->text);
 }
 
-static void free_proc_ldc_entry(struct proc_ldc_entry *pe)
+static void log_buf_init(struct log_buf *buf, size_t size)
+{
+	buf->data = malloc(size);
+	if (!buf->data)
+		abort();
+	buf->size = size;
+	buf->len = 0;
+}
+
+static void log_buf_free(struct log_buf *buf)
+{
+	free(buf->data);
+	buf->data = NULL;
+	buf->size = 0;
+	buf->len = 0;
+}
+
+static int log_buf_printf(struct log_buf *buf, const char *fmt, ...)
+{
+	va_list args;
+	size_t avail;
+	int ret;
+
+	for (;;) {
+		avail = buf->size - buf->len;
+		va_start(args, fmt);
+		ret = vsnprintf(buf->data + buf->len, avail, fmt, args);
+		va_end(args);
+		if (ret < 0)
+			return ret;
+		if (ret < avail) {
+			buf->len += ret;
+			return ret;
+		}
+
+		/* grow and format again, happens only until buffers get big enough */
+		buf->size *= 2;
+		if (buf->size < buf->len + ret + 1)
+			buf->size = buf->len + ret + 1;
+		buf->data = realloc(buf->data, buf->size);
+		if (!buf->data)
+			abort();
+	}
+}
+
+/** Like log_err() but the copy for the -o output file is kept in order
+ *  with the text formatted into buf.
+ */
+static void log_buf_err(struct log_buf *buf, const char *msg)
+{
+	FILE *out_fd = global_config->out_fd;
+
+	fprintf(stderr, "error: %s", msg);
+	if (out_fd != stderr && out_fd != stdout)
+		log_buf_printf(buf, "error: %s", msg);
+}
+
+/** printf-like formatting from the raw parameters of one log statement
+ *  to the formatted proc_lpc_entry output, following the conversions
+ *  pre-parsed in the dictionary entry. Also copies the unmodified
+ *  ldc_entry_header from input to output. Substituted strings are
+ *  formatted into pe itself, nothing is allocated.
+ *
+ * @param[out] pe copy of the header + formatted output
+ * @param[in] e cached dictionary entry
+ * @param[in] raw_params uint32_t params read from the log
+ * @param[in] use_colors whether to use ANSI terminal codes
+ * @param[out] out text buffer for error messages
+ */
+static void process_params(struct proc_ldc_entry *pe,
+			   const struct ldc_entry *e,
+			   const uint32_t *raw_params,
+			   int use_colors, struct log_buf *out)
 {
+	const struct ldc_param *param;
 	int i;
 
-	for (i = 0; i < TRACE_MAX_PARAMS_COUNT; i++) {
-		if (pe->subst_mask & (1 << i))
-			free((void *)pe->params[i]);
-		pe->params[i] = 0;
+	pe->header =  e->header;
+	pe->file_name = e->file_name;
+	pe->text = e->format;
+
+	for (i = 0; i < e->header.params_num; i++) {
+		param = &e->params[i];
+
+		switch (param->type) {
+		case LDC_PARAM_STRING:
+			/* check for string printing, because it leads to logger crash */
+			log_buf_err(out, "String printing is not supported\n");
+			snprintf(pe->strings[i], sizeof(pe->strings[i]), "<String @ 0x%08x>",
+				 raw_params[i]);
+			pe->params[i] = (uintptr_t)pe->strings[i];
+			break;
+		case LDC_PARAM_UUID:
+			/* substitute UUID entry address with formatted string */
+			snprintf_uid(pe->strings[i], sizeof(pe->strings[i]), raw_params[i],
+				     use_colors, param->be, param->upper);
+			pe->params[i] = (uintptr_t)pe->strings[i];
+			break;
+		case LDC_PARAM_ENTRY:
+			/* substitute log entry address with cached entry text */
+			pe->params[i] = (uintptr_t)get_entry_text(raw_params[i]);
+			if (!pe->params[i])
+				pe->params[i] = (uintptr_t)missing;
+			break;
+		default:
+			pe->params[i] = raw_params[i];
+			break;
+		}
 	}
 }
 
@@ -458,16 +590,50 @@ static char *format_file_name(char *file_name_raw, int full_name)
 }
 
 static int entry_number = 1;
-/** Formats and outputs one entry from the trace + the corresponding
- * ldc_entry from the dictionary passed as arguments. Expects the log
- * variables to have already been copied into the ldc_entry.
+static uint64_t timestamp_origin;
+
+/** Advances the timestamp state by one statement. This depends on all
+ * the statements before, so it's done in input order, before the
+ * statement may be formatted by another thread.
  */
-static void print_entry_params(const struct log_entry_header *dma_log,
-			       const struct ldc_entry *entry, uint64_t last_timestamp)
+static void update_entry_timing(const struct log_entry_header *dma_log,
+				uint64_t last_timestamp, struct entry_timing *timing)
 {
-	static uint64_t timestamp_origin;
+	timing->last_timestamp = last_timestamp;
+	timing->first = false;
 
-	FILE *out_fd = global_config->out_fd;
+	if (dma_log->timestamp < last_timestamp)
+		entry_number = 1;
+
+	/* The first entry:
+	 *  - is never shown with a relative TIMESTAMP (to itself!?)
+	 *  - shows a zero DELTA
+	 */
+	if (entry_number == 1) {
+		entry_number++;
+		/* Display absolute (and random) timestamps */
+		timestamp_origin = 0;
+		timing->first = true;
+	} else if (entry_number == 2) {
+		entry_number++;
+		if (global_config->relative_timestamps == 1)
+			/* Switch to relative timestamps from now on. */
+			timestamp_origin = last_timestamp;
+	} /* We don't need the exact entry_number after 3 */
+
+	timing->origin = timestamp_origin;
+}
+
+/** Formats one entry from the trace + the corresponding ldc_entry from
+ * the dictionary passed as arguments, with the log variables read from
+ * the trace in params, into the out text buffer.
+ */
+static void format_entry(struct log_buf *out, const struct log_entry_header *dma_log,
+			 const struct ldc_entry *entry, const uint32_t *params,
+			 const struct entry_timing *timing)
+{
+	uint64_t last_timestamp = timing->last_timestamp;
+	uint64_t timestamp_origin = timing->origin;
 	int use_colors = global_config->use_colors;
 	int raw_output = global_config->raw_output;
 	int hide_location = global_config->hide_location;
@@ -476,7 +642,7 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 	char ids[TRACE_MAX_IDS_STR];
 	float dt = to_usecs(dma_log->timestamp - last_timestamp);
 	struct proc_ldc_entry proc_entry;
-	static char time_fmt[64];
+	char time_fmt[64];
 	int ret;
 
 	if (raw_output)
@@ -486,28 +652,13 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 	if (dt > 1000.0 * 1000.0 * 1000.0)
 		dt = NAN;
 
-	if (dma_log->timestamp < last_timestamp) {
-		fprintf(out_fd,
-			"\n\t\t --- negative DELTA = %.3f us: wrap, IPC_TRACE, other? ---\n\n",
-			-to_usecs(last_timestamp - dma_log->timestamp));
-		entry_number = 1;
-	}
+	if (dma_log->timestamp < last_timestamp)
+		log_buf_printf(out,
+			       "\n\t\t --- negative DELTA = %.3f us: wrap, IPC_TRACE, other? ---\n\n",
+			       -to_usecs(last_timestamp - dma_log->timestamp));
 
-	/* The first entry:
-	 *  - is never shown with a relative TIMESTAMP (to itself!?)
-	 *  - shows a zero DELTA
-	 */
-	if (entry_number == 1) {
-		entry_number++;
-		/* Display absolute (and random) timestamps */
-		timestamp_origin = 0;
+	if (timing->first)
 		dt = 0;
-	} else if (entry_number == 2) {
-		entry_number++;
-		if (global_config->relative_timestamps == 1)
-			/* Switch to relative timestamps from now on. */
-			timestamp_origin = last_timestamp;
-	} /* We don't need the exact entry_number after 3 */
 
 	if (dma_log->id_0 != INVALID_TRACE_ID &&
 	    dma_log->id_1 != INVALID_TRACE_ID)
@@ -523,21 +674,20 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 			snprintf(time_fmt, sizeof(time_fmt), "%%.%df %%.%df ",
 				 time_precision, time_precision);
 
-		fprintf(out_fd, entry_fmt,
-			entry->header.level == use_colors ?
-				(LOG_LEVEL_CRITICAL ? KRED : KNRM) : "",
-			dma_log->core_id,
-			entry->header.level,
-			get_component_name(entry->header.component_class, dma_log->uid),
-			raw_output && strlen(ids) ? "-" : "",
-			ids);
+		log_buf_printf(out, entry_fmt,
+			       entry->header.level == use_colors ?
+					(LOG_LEVEL_CRITICAL ? KRED : KNRM) : "",
+			       dma_log->core_id,
+			       entry->header.level,
+			       get_component_name(entry->header.component_class, dma_log->uid),
+			       raw_output && strlen(ids) ? "-" : "",
+			       ids);
 		if (time_precision >= 0)
-			fprintf(out_fd, time_fmt,
-				to_usecs(dma_log->timestamp - timestamp_origin), dt);
+			log_buf_printf(out, time_fmt,
+				       to_usecs(dma_log->timestamp - timestamp_origin), dt);
 		if (!hide_location)
-			fprintf(out_fd, "(%s:%u) ",
-				format_file_name(entry->file_name, raw_output),
-				entry->header.line_idx);
+			log_buf_printf(out, "(%s:%u) ",
+				       entry->file_name, entry->header.line_idx);
 	} else {
 		if (time_precision >= 0) {
 			const unsigned int ts_width = timestamp_width(time_precision);
@@ -546,147 +696,246 @@ static void print_entry_params(const struct log_entry_header *dma_log,
 				 "%%s[%%%d.%df] (%%%d.%df)%%s ",
 				 ts_width, time_precision, ts_width, time_precision);
 
-			fprintf(out_fd, time_fmt,
-				use_colors ? KGRN : "",
-				to_usecs(dma_log->timestamp - timestamp_origin), dt,
-				use_colors ? KNRM : "");
+			log_buf_printf(out, time_fmt,
+				       use_colors ? KGRN : "",
+				       to_usecs(dma_log->timestamp - timestamp_origin), dt,
+				       use_colors ? KNRM : "");
 		}
 
 		/* core id */
-		fprintf(out_fd, "c%d ", dma_log->core_id);
+		log_buf_printf(out, "c%d ", dma_log->core_id);
 
 		/* component name and id */
-		fprintf(out_fd, "%s%-12s %-5s%s ",
-			use_colors ? KYEL : "",
-			get_component_name(entry->header.component_class, dma_log->uid),
-			ids,
-			use_colors ? KNRM : "");
+		log_buf_printf(out, "%s%-12s %-5s%s ",
+			       use_colors ? KYEL : "",
+			       get_component_name(entry->header.component_class, dma_log->uid),
+			       ids,
+			       use_colors ? KNRM : "");
 
 		/* location */
 		if (!hide_location)
-			fprintf(out_fd, "%24s:%-4u ",
-				format_file_name(entry->file_name, raw_output),
-				entry->header.line_idx);
+			log_buf_printf(out, "%24s:%-4u ",
+				       entry->file_name, entry->header.line_idx);
 
 		/* level name */
-		fprintf(out_fd, "%s%s",
-			use_colors ? get_level_color(entry->header.level) : "",
-			get_level_name(entry->header.level));
+		log_buf_printf(out, "%s%s",
+			       use_colors ? get_level_color(entry->header.level) : "",
+			       get_level_name(entry->header.level));
 	}
 
 	/* Minimal, printf-like formatting */
-	process_params(&proc_entry, entry, use_colors);
+	process_params(&proc_entry, entry, params, use_colors, out);
 
 	switch (proc_entry.header.params_num) {
 	case 0:
-		ret = fprintf(out_fd, "%s", proc_entry.text);
+		ret = log_buf_printf(out, "%s", proc_entry.text);
 		break;
 	case 1:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0]);
+		ret = log_buf_printf(out, proc_entry.text, proc_entry.params[0]);
 		break;
 	case 2:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1]);
+		ret = log_buf_printf(out, proc_entry.text, proc_entry.params[0],
+				     proc_entry.params[1]);
 		break;
 	case 3:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1],
-			      proc_entry.params[2]);
+		ret = log_buf_printf(out, proc_entry.text, proc_entry.params[0],
+				     proc_entry.params[1], proc_entry.params[2]);
 		break;
 	case 4:
-		ret = fprintf(out_fd, proc_entry.text, proc_entry.params[0], proc_entry.params[1],
-			      proc_entry.params[2], proc_entry.params[3]);
+		ret = log_buf_printf(out, proc_entry.text, proc_entry.params[0],
+				     proc_entry.params[1], proc_entry.params[2],
+				     proc_entry.params[3]);
 		break;
 	default:
 		log_err("Unsupported number of arguments for '%s'", proc_entry.text);
 		ret = 0; /* don't log ferror */
 		break;
 	}
-	free_proc_ldc_entry(&proc_entry);
 	/* log format text comes from ldc file (may be invalid), so error check is needed here */
 	if (ret < 0)
-		log_err("trace fprintf failed for '%s', %d '%s'",
-			proc_entry.text, ferror(out_fd), strerror(ferror(out_fd)));
-	fprintf(out_fd, "%s\n", use_colors ? KNRM : "");
-	fflush(out_fd);
+		log_err("trace formatting failed for '%s', %d '%s'",
+			proc_entry.text, ret, strerror(errno));
+	log_buf_printf(out, "%s\n", use_colors ? KNRM : "");
 }
 
-static int read_entry_from_ldc_file(struct ldc_entry *entry, uint32_t log_entry_address)
+static void free_ldc_entry(struct ldc_entry *entry)
 {
-	uint32_t base_address = global_config->logs_header->base_address;
-	uint32_t data_offset = global_config->logs_header->data_offset;
-
-	int ret;
-
-	/* evaluate entry offset in input file */
-	uint32_t entry_offset = (log_entry_address - base_address) + data_offset;
-
-	entry->file_name = NULL;
-	entry->text = NULL;
-	entry->params = NULL;
+	free(entry->format);
+	free(entry->file_name_buf);
+	free(entry);
+}
 
-	/* set file position to beginning of processed entry */
-	fseek(global_config->ldc_fd, entry_offset, SEEK_SET);
+/** Parses the dictionary entry at offset from the start of the mapped
+ *  log entries section.
+ *
+ * @return newly allocated entry or NULL on error
+ */
+static struct ldc_entry *load_ldc_entry(uint32_t offset)
+{
+	const struct snd_sof_logs_header *logs_header = global_config->logs_header;
+	const char *data = (const char *)ldc_cache.data + logs_header->data_offset + offset;
+	size_t avail = logs_header->data_length - offset;
+	struct ldc_entry *entry;
+
+	entry = calloc(1, sizeof(*entry));
+	if (!entry) {
+		log_err("can't allocate %zu byte for ldc entry\n", sizeof(*entry));
+		return NULL;
+	}
 
 	/* fetching elf header params */
-	ret = fread(&entry->header, sizeof(entry->header), 1, global_config->ldc_fd);
-	if (ret != 1) {
+	if (avail < sizeof(entry->header)) {
 		log_err("Failed to read entry header for offset 0x%x in dictionary.\n",
-			entry_offset);
-		ret = -1;
-		goto out;
+			offset + logs_header->data_offset);
+		goto err;
 	}
+	entry->header = *(const struct ldc_entry_header *)data;
+	data += sizeof(entry->header);
+	avail -= sizeof(entry->header);
+
 	if (entry->header.file_name_len > TRACE_MAX_FILENAME_LEN) {
 		log_err("Invalid filename length %d or ldc file does not match firmware\n",
 			entry->header.file_name_len);
-		ret = -EINVAL;
-		goto out;
+		goto err;
+	}
+	if (entry->header.text_len > TRACE_MAX_TEXT_LEN) {
+		log_err("Invalid text length.\n");
+		goto err;
+	}
+	if (entry->header.params_num > TRACE_MAX_PARAMS_COUNT) {
+		log_err("Invalid number of parameters.\n");
+		goto err;
+	}
+	if (avail < entry->header.file_name_len + entry->header.text_len) {
+		log_err("Failed to read log message at offset 0x%x from dictionary.\n",
+			offset + logs_header->data_offset);
+		goto err;
 	}
-	entry->file_name = (char *)malloc(entry->header.file_name_len);
 
-	if (!entry->file_name) {
+	/* the location is printed with every statement, format it only once */
+	entry->file_name_buf = strndup(data, entry->header.file_name_len);
+	if (!entry->file_name_buf) {
 		log_err("can't allocate %d byte for entry.file_name\n",
 			entry->header.file_name_len);
-		ret = -ENOMEM;
-		goto out;
+		goto err;
+	}
+	entry->file_name = format_file_name(entry->file_name_buf, global_config->raw_output);
+	data += entry->header.file_name_len;
+
+	/* the text is used in place, printf() gets a copy with conversions rewritten */
+	if (strnlen(data, entry->header.text_len) == entry->header.text_len) {
+		log_err("Unterminated log message at offset 0x%x in dictionary.\n",
+			offset + logs_header->data_offset);
+		goto err;
+	}
+	entry->text = data;
+	entry->format = strdup(data);
+	if (!entry->format) {
+		log_err("can't allocate %d byte for entry.text\n", entry->header.text_len);
+		goto err;
 	}
+	parse_entry_format(entry);
 
-	ret = fread(entry->file_name, sizeof(char), entry->header.file_name_len,
-		    global_config->ldc_fd);
-	if (ret != entry->header.file_name_len) {
-		log_err("Failed to read source filename for offset 0x%x in dictionary.\n",
-			entry_offset);
-		ret = -1;
-		goto out;
+	return entry;
+
+err:
+	free_ldc_entry(entry);
+	return NULL;
+}
+
+/** Returns the dictionary entry for the log entry address, parsing it
+ *  from the mapped ldc file on first use only.
+ */
+static const struct ldc_entry *get_ldc_entry(uint32_t log_entry_address)
+{
+	uint32_t base_address = global_config->logs_header->base_address;
+	uint32_t offset = log_entry_address - base_address;
+	struct ldc_entry **slot;
+
+	/* log entries are 4 bytes aligned by _DECLARE_LOG_ENTRY() */
+	if (log_entry_address < base_address || offset % sizeof(uint32_t) ||
+	    offset / sizeof(uint32_t) >= ldc_cache.num_slots) {
+		log_err("Invalid log entry address 0x%x\n", log_entry_address);
+		return NULL;
 	}
 
-	/* fetching text */
-	if (entry->header.text_len > TRACE_MAX_TEXT_LEN) {
-		log_err("Invalid text length.\n");
-		ret = -EINVAL;
-		goto out;
+	slot = &ldc_cache.entries[offset / sizeof(uint32_t)];
+	if (!*slot)
+		*slot = load_ldc_entry(offset);
+
+	return *slot;
+}
+
+/** Maps the whole ldc file, or reads it when it can't be mapped, and
+ *  allocates the empty entry index for the log entries section.
+ */
+static int ldc_cache_init(void)
+{
+	const struct snd_sof_logs_header *logs_header = global_config->logs_header;
+	FILE *ldc_fd = global_config->ldc_fd;
+	struct stat st;
+	void *data;
+	int ret;
+
+	if (fstat(fileno(ldc_fd), &st) < 0) {
+		ret = -errno;
+		log_err("Can't stat %s: %s\n", global_config->ldc_file, strerror(-ret));
+		return ret;
 	}
-	entry->text = (char *)malloc(entry->header.text_len);
-	if (!entry->text) {
-		log_err("can't allocate %d byte for entry.text\n", entry->header.text_len);
-		ret = -ENOMEM;
-		goto out;
+	ldc_cache.size = st.st_size;
+
+	if ((uint64_t)logs_header->data_offset + logs_header->data_length > ldc_cache.size ||
+	    logs_header->data_offset % sizeof(uint32_t)) {
+		log_err("Invalid log entries section in %s.\n", global_config->ldc_file);
+		return -EINVAL;
 	}
-	ret = fread(entry->text, sizeof(char), entry->header.text_len, global_config->ldc_fd);
-	if (ret != entry->header.text_len) {
-		log_err("Failed to read log message at offset 0x%x from dictionary.\n",
-			entry_offset);
-		ret = -1;
-		goto out;
+
+	data = mmap(NULL, ldc_cache.size, PROT_READ, MAP_PRIVATE, fileno(ldc_fd), 0);
+	if (data != MAP_FAILED) {
+		ldc_cache.mapped = true;
+	} else {
+		data = malloc(ldc_cache.size);
+		if (!data) {
+			log_err("can't allocate %zu byte for %s\n", ldc_cache.size,
+				global_config->ldc_file);
+			return -ENOMEM;
+		}
+		if (fseek(ldc_fd, 0, SEEK_SET) ||
+		    fread(data, ldc_cache.size, 1, ldc_fd) != 1) {
+			log_err("Error while reading %s.\n", global_config->ldc_file);
+			free(data);
+			return -EIO;
+		}
+	}
+	ldc_cache.data = data;
+
+	ldc_cache.num_slots = logs_header->data_length / sizeof(uint32_t);
+	ldc_cache.entries = calloc(ldc_cache.num_slots + 1, sizeof(*ldc_cache.entries));
+	if (!ldc_cache.entries) {
+		log_err("can't allocate ldc entry index\n");
+		return -ENOMEM;
 	}
 
 	return 0;
+}
 
-out:
-	free(entry->text);
-	entry->text = NULL;
-	free(entry->file_name);
-	entry->file_name = NULL;
+static void ldc_cache_free(void)
+{
+	size_t i;
 
-	return ret;
+	if (ldc_cache.entries) {
+		for (i = 0; i < ldc_cache.num_slots; i++)
+			if (ldc_cache.entries[i])
+				free_ldc_entry(ldc_cache.entries[i]);
+		free(ldc_cache.entries);
+	}
+
+	if (ldc_cache.mapped)
+		munmap((void *)ldc_cache.data, ldc_cache.size);
+	else
+		free((void *)ldc_cache.data);
+
+	memset(&ldc_cache, 0, sizeof(ldc_cache));
 }
 
 /** Gets the dictionary entry matching the log entry argument, reads
@@ -700,38 +949,27 @@ out:
  */
 static int fetch_entry(const struct log_entry_header *dma_log, uint64_t *last_timestamp)
 {
-	struct ldc_entry entry;
+	static struct log_buf out;
+	const struct ldc_entry *entry;
+	uint32_t params[TRACE_MAX_PARAMS_COUNT];
+	struct entry_timing timing;
 	int ret;
 
-	ret = read_entry_from_ldc_file(&entry, dma_log->log_entry_address);
-	if (ret < 0) {
-		log_err("read_entry_from_ldc_file(0x%x) returned %d\n",
-			dma_log->log_entry_address, ret);
-		goto out;
+	entry = get_ldc_entry(dma_log->log_entry_address);
+	if (!entry) {
+		log_err("get_ldc_entry(0x%x) failed\n", dma_log->log_entry_address);
+		return -EINVAL;
 	}
 
 	/* fetching entry params from dma dump */
-	if (entry.header.params_num > TRACE_MAX_PARAMS_COUNT) {
-		log_err("Invalid number of parameters.\n");
-		ret = -EINVAL;
-		goto out;
-	}
-	entry.params = (uint32_t *)malloc(sizeof(uint32_t) * entry.header.params_num);
-	if (!entry.params) {
-		log_err("can't allocate %d byte for entry.params\n",
-			(int)(sizeof(uint32_t) * entry.header.params_num));
-		ret = -ENOMEM;
-		goto out;
-	}
-
 	if (global_config->serial_fd < 0) {
-		ret = fread(entry.params, sizeof(uint32_t), entry.header.params_num,
+		ret = fread(params, sizeof(uint32_t), entry->header.params_num,
 			    global_config->in_fd);
-		if (ret != entry.header.params_num) {
+		if (ret != entry->header.params_num) {
 			fprintf(global_config->out_fd,
 				"warn: failed to fread() %d params from the log for %s:%d\n",
-				entry.header.params_num,
-				entry.file_name, entry.header.line_idx);
+				entry->header.params_num,
+				entry->file_name, entry->header.line_idx);
 
 			ret = ferror(global_config->in_fd) ? -1 : 0;
 
@@ -739,23 +977,23 @@ static int fetch_entry(const struct log_entry_header *dma_log, uint64_t *last_ti
 				fprintf(global_config->out_fd,
 					"warn: log's End Of File. Device suspend?\n");
 
-			goto out;
+			return ret;
 		}
 	} else { /* serial */
-		size_t size = sizeof(uint32_t) * entry.header.params_num;
+		size_t size = sizeof(uint32_t) * entry->header.params_num;
 		uint8_t *n;
 
 		/* Repeatedly read() how much we still miss until we got
 		 * enough for the number of params needed by this
 		 * particular statement.
 		 */
-		for (n = (uint8_t *)entry.params; size; n += ret, size -= ret) {
+		for (n = (uint8_t *)params; size; n += ret, size -= ret) {
 			ret = read(global_config->serial_fd, n, size);
 			if (ret < 0) {
 				ret = -errno;
 				log_err("Failed to fread %d params from serial: %s\n",
-					entry.header.params_num, strerror(errno));
-				goto out;
+					entry->header.params_num, strerror(errno));
+				return ret;
 			}
 			if (ret != size)
 				log_err("Partial read of %u bytes of %zu, reading more\n",
@@ -764,20 +1002,18 @@ static int fetch_entry(const struct log_entry_header *dma_log, uint64_t *last_ti
 	} /* serial */
 
 	/* printing entry content */
-	print_entry_params(dma_log, &entry, *last_timestamp);
+	load_entry_params(entry, params);
+	update_entry_timing(dma_log, *last_timestamp, &timing);
 	*last_timestamp = dma_log->timestamp;
 
-	/* set f_ldc file position to the beginning */
-	rewind(global_config->ldc_fd);
-
-	ret = 0;
-out:
-	/* free alocated memory */
-	free(entry.params);
-	free(entry.text);
-	free(entry.file_name);
+	if (!out.data)
+		log_buf_init(&out, LOG_BUF_SIZE);
+	out.len = 0;
+	format_entry(&out, dma_log, entry, params, &timing);
+	fwrite(out.data, 1, out.len, global_config->out_fd);
+	fflush(global_config->out_fd);
 
-	return ret;
+	return 0;
 }
 
 static int serial_read(uint64_t *last_timestamp)
@@ -833,6 +1069,478 @@ static int serial_read(uint64_t *last_timestamp)
 	return fetch_entry(&dma_log, last_timestamp);
 }
 
+/** One log statement handed from the reader to the formatters */
+struct pipe_record {
+	struct log_entry_header dma_log;
+	const struct ldc_entry *entry;	/* NULL when only the note is printed */
+	uint32_t params[TRACE_MAX_PARAMS_COUNT];
+	struct entry_timing timing;
+	char *note;			/* reader messages printed before the statement */
+};
+
+struct pipe_batch {
+	struct pipe_batch *next;	/* free list or formatters queue */
+	struct pipe_batch *next_out;	/* writer queue, in input order */
+	unsigned int count;
+	bool formatted;
+	struct log_buf text;
+	struct pipe_record records[PIPE_BATCH_RECORDS];
+};
+
+/** Reader thread -> formatter threads -> ordered writer */
+struct logger_pipe {
+	pthread_mutex_t lock;
+	pthread_cond_t free_cond;	/* a batch was put back on the free list */
+	pthread_cond_t todo_cond;	/* a batch was queued for formatting */
+	pthread_cond_t done_cond;	/* a batch was formatted */
+	struct pipe_batch *free;
+	struct pipe_batch *todo_head;
+	struct pipe_batch *todo_tail;
+	struct pipe_batch *out_head;
+	struct pipe_batch *out_tail;
+	bool reader_done;
+	int reader_ret;
+	unsigned int skipped_dwords;
+
+	/* statistics */
+	uint64_t entries;
+	uint64_t bytes_in;
+	uint64_t bytes_out;
+	unsigned int batches;
+	unsigned int reader_waits;	/* formatting or output is the bottleneck */
+	unsigned int writer_waits;	/* input or formatting is the bottleneck */
+};
+
+/** Appends a reader message to the text printed before the next
+ *  statement, so it stays in order with the statements. Errors also go
+ *  to stderr right away, like log_err().
+ */
+static void pipe_note(char **note, bool err, const char *fmt, ...)
+{
+	FILE *out_fd = global_config->out_fd;
+	va_list args;
+	char *text;
+	char *joined;
+
+	va_start(args, fmt);
+	text = log_vasprintf(fmt, args);
+	va_end(args);
+	if (!text)
+		abort();
+
+	if (err) {
+		fprintf(stderr, "error: %s", text);
+		if (out_fd == stderr || out_fd == stdout) {
+			free(text);
+			return;
+		}
+		joined = log_asprintf("error: %s", text);
+		free(text);
+		text = joined;
+		if (!text)
+			abort();
+	}
+
+	if (*note) {
+		joined = log_asprintf("%s%s", *note, text);
+		if (!joined)
+			abort();
+		free(*note);
+		free(text);
+		text = joined;
+	}
+	*note = text;
+}
+
+static struct pipe_batch *pipe_get_free(struct logger_pipe *pipe)
+{
+	struct pipe_batch *batch;
+
+	pthread_mutex_lock(&pipe->lock);
+	while (!pipe->free) {
+		pipe->reader_waits++;
+		pthread_cond_wait(&pipe->free_cond, &pipe->lock);
+	}
+	batch = pipe->free;
+	pipe->free = batch->next;
+	pthread_mutex_unlock(&pipe->lock);
+
+	batch->count = 0;
+	batch->formatted = false;
+	return batch;
+}
+
+static void pipe_submit(struct logger_pipe *pipe, struct pipe_batch *batch)
+{
+	batch->next = NULL;
+	batch->next_out = NULL;
+
+	pthread_mutex_lock(&pipe->lock);
+	if (pipe->todo_tail)
+		pipe->todo_tail->next = batch;
+	else
+		pipe->todo_head = batch;
+	pipe->todo_tail = batch;
+
+	if (pipe->out_tail)
+		pipe->out_tail->next_out = batch;
+	else
+		pipe->out_head = batch;
+	pipe->out_tail = batch;
+
+	pipe->batches++;
+	pthread_cond_signal(&pipe->todo_cond);
+	pthread_mutex_unlock(&pipe->lock);
+}
+
+/** Splits the raw input into statements, in the same way as
+ *  logger_read(), and does everything which depends on the statements
+ *  before: dictionary lookup, timestamps and resynchronization.
+ */
+static void *pipe_reader(void *arg)
+{
+	const struct snd_sof_logs_header *logs_header = global_config->logs_header;
+	struct logger_pipe *pipe = arg;
+	struct log_entry_header dma_log;
+	const struct ldc_entry *entry;
+	const uint32_t *raw_params;
+	struct pipe_batch *batch;
+	struct pipe_record *rec;
+	uint64_t last_timestamp = 0;
+	bool ldc_address_OK = false;
+	char *note = NULL;
+	uint8_t *buf;
+	size_t have = 0;
+	size_t wanted;
+	size_t need;
+	size_t pos;
+	ssize_t bytes;
+	int fd = fileno(global_config->in_fd);
+	int ret = 0;
+	int i;
+
+	buf = malloc(PIPE_READ_SIZE);
+	if (!buf)
+		abort();
+
+	batch = pipe_get_free(pipe);
+
+	for (;;) {
+		wanted = PIPE_READ_SIZE - have;
+		bytes = read(fd, buf + have, wanted);
+		if (bytes < 0) {
+			if (errno == EINTR)
+				continue;
+			ret = -errno;
+			log_err("in %s(), read(..., %s) failed: %s(%d)\n",
+				__func__, global_config->in_file, strerror(-ret), ret);
+			break;
+		}
+		have += bytes;
+		pipe->bytes_in += bytes;
+
+		/* statements start at 4 bytes offsets in buf, params are aligned */
+		for (pos = 0; have - pos >= sizeof(dma_log); pos += need) {
+			dma_log = *(const struct log_entry_header *)(buf + pos);
+
+			if (dma_log.log_entry_address < logs_header->base_address ||
+			    dma_log.log_entry_address > logs_header->base_address +
+			    logs_header->data_length) {
+				if (global_config->trace && ldc_address_OK) {
+					pipe_note(&note, true,
+						  "log_entry_address %#10x is not in dictionary range!\n",
+						  dma_log.log_entry_address);
+					pipe_note(&note, false,
+						  "warn: Seeking forward 4 bytes at a time until re-synchronize.\n");
+				}
+				ldc_address_OK = false;
+				need = sizeof(uint32_t);
+				pipe->skipped_dwords++;
+				continue;
+			} else if (!ldc_address_OK) {
+				if (pipe->skipped_dwords != 0)
+					pipe_note(&note, false,
+						  "\nFound valid LDC address after skipping %zu bytes (one line uses %zu + 0 to 16 bytes)\n",
+						  sizeof(uint32_t) * pipe->skipped_dwords,
+						  sizeof(dma_log));
+				ldc_address_OK = true;
+				pipe->skipped_dwords = 0;
+			}
+
+			entry = get_ldc_entry(dma_log.log_entry_address);
+			if (!entry) {
+				log_err("get_ldc_entry(0x%x) failed\n", dma_log.log_entry_address);
+				ret = -EINVAL;
+				log_err("fetch_entry() failed with: %d, aborting\n", ret);
+				goto out;
+			}
+
+			need = sizeof(dma_log) + sizeof(uint32_t) * entry->header.params_num;
+			if (have - pos < need)
+				break;
+
+			rec = &batch->records[batch->count];
+			rec->dma_log = dma_log;
+			rec->entry = entry;
+			raw_params = (const uint32_t *)(buf + pos + sizeof(dma_log));
+			for (i = 0; i < entry->header.params_num; i++)
+				rec->params[i] = raw_params[i];
+			load_entry_params(entry, rec->params);
+			update_entry_timing(&dma_log, last_timestamp, &rec->timing);
+			last_timestamp = dma_log.timestamp;
+			rec->note = note;
+			note = NULL;
+			pipe->entries++;
+
+			if (++batch->count == PIPE_BATCH_RECORDS) {
+				pipe_submit(pipe, batch);
+				batch = pipe_get_free(pipe);
+			}
+		}
+
+		have -= pos;
+		memmove(buf, buf + pos, have);
+
+		if (bytes) {
+			/* the input is drained for now, don't hold statements back */
+			if (bytes < wanted && batch->count) {
+				pipe_submit(pipe, batch);
+				batch = pipe_get_free(pipe);
+			}
+			continue;
+		}
+
+		/* End of file, with the params of the last statement cut */
+		if (have >= sizeof(dma_log)) {
+			dma_log = *(const struct log_entry_header *)buf;
+			entry = get_ldc_entry(dma_log.log_entry_address);
+			pipe_note(&note, false,
+				  "warn: failed to fread() %d params from the log for %s:%d\n",
+				  entry->header.params_num, entry->file_name,
+				  entry->header.line_idx);
+			pipe_note(&note, false, "warn: log's End Of File. Device suspend?\n");
+		}
+		have = 0;
+
+		if (!global_config->trace)
+			break;
+
+		/* for trace mode, try to reopen */
+		pipe_note(&note, false, "\n       ---- %s; %s -----\n\n",
+			  "Re-opening trace input file", "device suspend?");
+		if (!freopen(NULL, "rb", global_config->in_fd)) {
+			ret = -errno;
+			log_err("in %s(), freopen(..., %s) failed: %s(%d)\n",
+				__func__, global_config->in_file, strerror(-ret), -ret);
+			break;
+		}
+		fd = fileno(global_config->in_fd);
+		entry_number = 1;
+	}
+
+out:
+	if (note) {
+		rec = &batch->records[batch->count++];
+		rec->entry = NULL;
+		rec->note = note;
+	}
+
+	if (batch->count) {
+		pipe_submit(pipe, batch);
+	} else {
+		pthread_mutex_lock(&pipe->lock);
+		batch->next = pipe->free;
+		pipe->free = batch;
+		pthread_mutex_unlock(&pipe->lock);
+	}
+
+	pthread_mutex_lock(&pipe->lock);
+	pipe->reader_ret = ret;
+	pipe->reader_done = true;
+	pthread_cond_broadcast(&pipe->todo_cond);
+	pthread_cond_broadcast(&pipe->done_cond);
+	pthread_mutex_unlock(&pipe->lock);
+
+	free(buf);
+	return NULL;
+}
+
+static void *pipe_formatter(void *arg)
+{
+	struct logger_pipe *pipe = arg;
+	struct pipe_batch *batch;
+	struct pipe_record *rec;
+	unsigned int i;
+
+	for (;;) {
+		pthread_mutex_lock(&pipe->lock);
+		while (!pipe->todo_head && !pipe->reader_done)
+			pthread_cond_wait(&pipe->todo_cond, &pipe->lock);
+		batch = pipe->todo_head;
+		if (batch) {
+			pipe->todo_head = batch->next;
+			if (!pipe->todo_head)
+				pipe->todo_tail = NULL;
+		}
+		pthread_mutex_unlock(&pipe->lock);
+
+		if (!batch)
+			return NULL;
+
+		batch->text.len = 0;
+		for (i = 0; i < batch->count; i++) {
+			rec = &batch->records[i];
+			if (rec->note)
+				log_buf_printf(&batch->text, "%s", rec->note);
+			if (rec->entry)
+				format_entry(&batch->text, &rec->dma_log, rec->entry,
+					     rec->params, &rec->timing);
+		}
+
+		pthread_mutex_lock(&pipe->lock);
+		batch->formatted = true;
+		pthread_cond_signal(&pipe->done_cond);
+		pthread_mutex_unlock(&pipe->lock);
+	}
+}
+
+/** Writes the formatted batches in input order until the reader is done */
+static int pipe_writer(struct logger_pipe *pipe)
+{
+	FILE *out_fd = global_config->out_fd;
+	struct pipe_batch *batch;
+	unsigned int i;
+	int ret = 0;
+
+	for (;;) {
+		pthread_mutex_lock(&pipe->lock);
+		while (!pipe->out_head || !pipe->out_head->formatted) {
+			if (!pipe->out_head && pipe->reader_done)
+				break;
+			pipe->writer_waits++;
+			pthread_cond_wait(&pipe->done_cond, &pipe->lock);
+		}
+		batch = pipe->out_head;
+		if (batch) {
+			pipe->out_head = batch->next_out;
+			if (!pipe->out_head)
+				pipe->out_tail = NULL;
+		}
+		pthread_mutex_unlock(&pipe->lock);
+
+		if (!batch)
+			return ret;
+
+		if (fwrite(batch->text.data, 1, batch->text.len, out_fd) != batch->text.len &&
+		    !ret) {
+			ret = -ferror(out_fd);
+			log_err("write failed: %s\n", strerror(errno));
+		}
+		fflush(out_fd);
+		pipe->bytes_out += batch->text.len;
+
+		for (i = 0; i < batch->count; i++)
+			free(batch->records[i].note);
+
+		pthread_mutex_lock(&pipe->lock);
+		batch->next = pipe->free;
+		pipe->free = batch;
+		pthread_cond_signal(&pipe->free_cond);
+		pthread_mutex_unlock(&pipe->lock);
+	}
+}
+
+static double timespec_diff(const struct timespec *start, const struct timespec *end)
+{
+	return (end->tv_sec - start->tv_sec) + (end->tv_nsec - start->tv_nsec) / 1e9;
+}
+
+/** Decodes the input with a reader thread, a pool of formatter threads
+ *  and the calling thread writing the output in order, then prints the
+ *  throughput statistics to stderr.
+ *
+ * @param[out] skipped_dwords number of dwords skipped after the last statement
+ */
+static int logger_read_pipelined(unsigned int *skipped_dwords)
+{
+	int threads = global_config->threads;
+	int num_batches = 2 * threads + 2;
+	struct logger_pipe pipe;
+	struct pipe_batch *batch;
+	struct timespec start, end;
+	pthread_t *tids;
+	double secs;
+	int ret;
+	int i;
+
+	memset(&pipe, 0, sizeof(pipe));
+	pthread_mutex_init(&pipe.lock, NULL);
+	pthread_cond_init(&pipe.free_cond, NULL);
+	pthread_cond_init(&pipe.todo_cond, NULL);
+	pthread_cond_init(&pipe.done_cond, NULL);
+
+	for (i = 0; i < num_batches; i++) {
+		batch = calloc(1, sizeof(*batch));
+		if (!batch)
+			abort();
+		log_buf_init(&batch->text, PIPE_TEXT_SIZE);
+		batch->next = pipe.free;
+		pipe.free = batch;
+	}
+
+	tids = calloc(threads + 1, sizeof(*tids));
+	if (!tids)
+		abort();
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	ret = pthread_create(&tids[0], NULL, pipe_reader, &pipe);
+	if (ret) {
+		log_err("can't create reader thread: %s\n", strerror(ret));
+		abort();
+	}
+	for (i = 1; i <= threads; i++) {
+		ret = pthread_create(&tids[i], NULL, pipe_formatter, &pipe);
+		if (ret) {
+			log_err("can't create formatter thread: %s\n", strerror(ret));
+			abort();
+		}
+	}
+
+	ret = pipe_writer(&pipe);
+
+	for (i = 0; i <= threads; i++)
+		pthread_join(tids[i], NULL);
+
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	secs = timespec_diff(&start, &end);
+
+	fprintf(stderr, "%" PRIu64 " statements, %.2f MB in, %.2f MB out in %.3f s",
+		pipe.entries, pipe.bytes_in / 1e6, pipe.bytes_out / 1e6, secs);
+	fprintf(stderr, ": %.0f statements/s, %.2f MB/s in\n",
+		secs > 0 ? pipe.entries / secs : 0, secs > 0 ? pipe.bytes_in / 1e6 / secs : 0);
+	fprintf(stderr,
+		"%d formatter threads, %u batches, reader waited %u times, writer waited %u times\n",
+		threads, pipe.batches, pipe.reader_waits, pipe.writer_waits);
+
+	while (pipe.free) {
+		batch = pipe.free;
+		pipe.free = batch->next;
+		log_buf_free(&batch->text);
+		free(batch);
+	}
+	free(tids);
+
+	pthread_cond_destroy(&pipe.done_cond);
+	pthread_cond_destroy(&pipe.todo_cond);
+	pthread_cond_destroy(&pipe.free_cond);
+	pthread_mutex_destroy(&pipe.lock);
+
+	*skipped_dwords = pipe.skipped_dwords;
+
+	return pipe.reader_ret ? pipe.reader_ret : ret;
+}
+
 /** Main logger loop */
 static int logger_read(void)
 {
@@ -854,6 +1562,11 @@ static int logger_read(void)
 				return ret;
 		}
 
+	if (global_config->threads) {
+		ret = logger_read_pipelined(&skipped_dwords);
+		goto out;
+	}
+
 	/* One iteration per log statement */
 	while (!ferror(global_config->in_fd)) {
 		/* getting entry parameters from dma dump */
@@ -947,6 +1660,7 @@ static int logger_read(void)
 		}
 	} /* next log entry */
 
+out:
 	/* End of (etrace) file */
 	fprintf(global_config->out_fd,
 		"Skipped %zu bytes after the last statement",
@@ -1131,6 +1845,10 @@ int convert(void)
 		goto out;
 	}
 
+	ret = ldc_cache_init();
+	if (ret)
+		goto out;
+
 	if (config->filter_config) {
 		ret = filter_update_firmware();
 		if (ret) {
@@ -1141,6 +1859,7 @@ int convert(void)
 
 	ret = logger_read();
 out:
+	ldc_cache_free();
 	free(config->uids_dict);
 	return ret;
 }
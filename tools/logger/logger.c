@@ -33,6 +33,9 @@
 
 #define APP_NAME "sof-logger"
 
+/* formatter threads of -j */
+#define MAX_THREADS 64
+
 #ifndef ARRAY_SIZE
 #define ARRAY_SIZE(x) (sizeof(x)/sizeof(x[0]))
 #endif
@@ -86,6 +89,10 @@ static void usage(void)
 	fprintf(stdout, "%s:\t -F filter\t\tUpdate trace filter, format: "
 		"<level>=<comp1>[, <comp2>]\n",
 		APP_NAME);
+	fprintf(stdout, "%s:\t -j threads\t\tDecode with a reader thread, threads formatters\n",
+		APP_NAME);
+	fprintf(stdout, "%s:\t\t\t\tand an ordered writer, print throughput to stderr\n",
+		APP_NAME);
 	exit(0);
 }
 
@@ -287,7 +294,7 @@ struct convert_config * const global_config = &_global_config;
 
 int main(int argc, char *argv[])
 {
-	static const char optstring[] = "ho:i:l:ps:c:u:tv:rd:Le:f:gF:n";
+	static const char optstring[] = "ho:i:l:ps:c:u:tv:rd:Le:f:gF:nj:";
 	struct convert_config config;
 	unsigned int baud = 0;
 	const char *snapshot_file = 0;
@@ -314,6 +321,7 @@ int main(int argc, char *argv[])
 	config.time_precision = 6;
 	config.relative_timestamps = INT_MAX; /* unspecified */
 	config.filter_config = NULL;
+	config.threads = 0;
 
 	while ((opt = getopt(argc, argv, optstring)) != -1) {
 		switch (opt) {
@@ -392,6 +400,14 @@ int main(int argc, char *argv[])
 			if (ret < 0)
 				return ret;
 			break;
+		case 'j':
+			config.threads = atoi(optarg);
+			if (config.threads < 1 || config.threads > MAX_THREADS) {
+				fprintf(stderr, "%s: invalid option: -j %s\n",
+					APP_NAME, optarg);
+				return -EINVAL;
+			}
+			break;
 		case 'h':
 		default: /* '?' */
 			usage();
@@ -448,6 +464,11 @@ int main(int argc, char *argv[])
 		usage();
 	}
 
+	if (config.threads && baud) {
+		fprintf(stderr, "error: -j is not supported with UART input\n");
+		usage();
+	}
+
 	if (config.input_std) {
 		config.in_fd = stdin;
 	} else if (baud) {
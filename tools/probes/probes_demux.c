@@ -14,27 +14,42 @@
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
 
 #include <ipc/probe_dma_frame.h>
+#include <sof/common.h>
 
+#include "probes_demux.h"
 #include "wave.h"
 
 #define APP_NAME "sof-probes"
 
-#define PACKET_MAX_SIZE	4096	/**< Size limit for probe data packet */
-#define DATA_READ_LIMIT 4096	/**< Data limit for file read */
+#define PACKET_MAX_SIZE	4096	/**< Initial size of the packet buffer */
+#define PACKET_DATA_LIMIT (1 << 20)	/**< Larger packets are taken as false syncs */
+#define DATA_READ_LIMIT 65536	/**< Data limit for file read */
 #define FILES_LIMIT	32	/**< Maximum num of probe output files */
 #define FILE_PATH_LIMIT 128	/**< Path limit for probe output files */
+#define FILE_BUFFER_SIZE (256 * 1024)	/**< Write buffer of each output file */
 
 struct wave_files {
 	FILE *fd;
+	uint8_t *buffer;	/* write buffer of fd, NULL for stdout */
+	bool has_header;	/* data is preceded by a wave header */
 	uint32_t buffer_id;
 	uint32_t fmt;
-	uint32_t size;
+	uint64_t size;
+	uint64_t last_size;	/* size at the previous statistics print */
 	struct wave header;
 };
 
+struct parser_stats {
+	uint64_t bytes;		/* bytes read from the stream */
+	uint64_t packets;	/* valid packets */
+	uint64_t bad_packets;	/* packets dropped by checksum or size check */
+	uint64_t skipped;	/* bytes skipped while looking for a sync word */
+};
+
 enum p_state {
 	READY = 0,		/**< At this stage app is looking for a SYNC word */
 	SYNC,			/**< SYNC received, copying data */
@@ -43,6 +58,13 @@ enum p_state {
 
 struct dma_frame_parser {
 	bool log_to_stdout;
+	bool raw;				/* no wave headers */
+	bool stream;				/* stream_id data goes to stdout */
+	uint32_t stream_id;
+	struct parser_stats stats;
+	struct parser_stats last_stats;		/* at the previous statistics print */
+	struct timespec start_time;
+	struct timespec last_time;
 	enum p_state state;
 	struct probe_data_packet *packet;
 	size_t packet_size;
@@ -89,6 +111,8 @@ bool is_audio_format(uint32_t format)
 int init_wave(struct dma_frame_parser *p, uint32_t buffer_id, uint32_t format)
 {
 	bool audio = is_audio_format(format);
+	bool to_stdout = p->stream ? buffer_id == p->stream_id : !audio && p->log_to_stdout;
+	uint32_t rate = (format & PROBE_MASK_SAMPLE_RATE) >> PROBE_SHIFT_SAMPLE_RATE;
 	char path[FILE_PATH_LIMIT];
 	int i;
 
@@ -98,34 +122,48 @@ int init_wave(struct dma_frame_parser *p, uint32_t buffer_id, uint32_t format)
 		exit(0);
 	}
 
-	sprintf(path, "buffer_%d.%s", buffer_id, audio ? "wav" : "bin");
+	sprintf(path, "buffer_%d.%s", buffer_id, !audio ? "bin" : p->raw ? "raw" : "wav");
 
-	fprintf(stderr, "%s:\t Creating file %s\n", APP_NAME, path);
-
-	if (!audio && p->log_to_stdout) {
+	if (to_stdout) {
+		fprintf(stderr, "%s:\t Streaming buffer %u to stdout\n", APP_NAME, buffer_id);
 		p->files[i].fd = stdout;
 	} else {
+		fprintf(stderr, "%s:\t Creating file %s\n", APP_NAME, path);
 		p->files[i].fd = fopen(path, "wb");
 		if (!p->files[i].fd) {
 			fprintf(stderr, "error: unable to create file %s, error %d\n",
 				path, errno);
 			exit(0);
 		}
+
+		/* large writes keep up with long captures of many buffers */
+		p->files[i].buffer = malloc(FILE_BUFFER_SIZE);
+		if (p->files[i].buffer)
+			setvbuf(p->files[i].fd, (char *)p->files[i].buffer, _IOFBF,
+				FILE_BUFFER_SIZE);
 	}
 
 	p->files[i].buffer_id = buffer_id;
 	p->files[i].fmt = format;
 
-	if (!audio)
+	if (!audio || p->raw)
 		return i;
 
+	if (rate >= ARRAY_SIZE(sample_rate)) {
+		fprintf(stderr, "warning: unknown sample rate %u of buffer %u\n", rate,
+			buffer_id);
+		rate = 0;
+	}
+
+	p->files[i].has_header = true;
+
 	p->files[i].header.riff.chunk_id = HEADER_RIFF;
 	p->files[i].header.riff.format = HEADER_WAVE;
 	p->files[i].header.fmt.subchunk_id = HEADER_FMT;
 	p->files[i].header.fmt.subchunk_size = 16;
 	p->files[i].header.fmt.audio_format = 1;
 	p->files[i].header.fmt.num_channels = ((format & PROBE_MASK_NB_CHANNELS) >> PROBE_SHIFT_NB_CHANNELS) + 1;
-	p->files[i].header.fmt.sample_rate = sample_rate[(format & PROBE_MASK_SAMPLE_RATE) >> PROBE_SHIFT_SAMPLE_RATE];
+	p->files[i].header.fmt.sample_rate = sample_rate[rate];
 	p->files[i].header.fmt.bits_per_sample = (((format & PROBE_MASK_CONTAINER_SIZE) >> PROBE_SHIFT_CONTAINER_SIZE) + 1) * 8;
 	p->files[i].header.fmt.byte_rate = p->files[i].header.fmt.sample_rate *
 					p->files[i].header.fmt.num_channels *
@@ -134,6 +172,12 @@ int init_wave(struct dma_frame_parser *p, uint32_t buffer_id, uint32_t format)
 					  p->files[i].header.fmt.bits_per_sample / 8;
 	p->files[i].header.data.subchunk_id = HEADER_DATA;
 
+	/* the length of a stream is not known, use the maximum */
+	if (to_stdout) {
+		p->files[i].header.riff.chunk_size = UINT32_MAX;
+		p->files[i].header.data.subchunk_size = UINT32_MAX;
+	}
+
 	fwrite(&p->files[i].header, sizeof(struct wave), 1, p->files[i].fd);
 
 	return i;
@@ -141,17 +185,26 @@ int init_wave(struct dma_frame_parser *p, uint32_t buffer_id, uint32_t format)
 
 void finalize_wave_files(struct wave_files *files)
 {
-	uint32_t i, chunk_size;
+	uint32_t i, chunk_size, data_size;
 
 	/* fill the header at the beginning of each file */
 	/* and close all opened files */
 	/* check wave struct to understand the offsets */
 	for (i = 0; i < FILES_LIMIT; i++) {
-		if (!is_audio_format(files[i].fmt))
+		if (!files[i].fd)
+			continue;
+
+		if (files[i].fd == stdout) {
+			fflush(stdout);
+			files[i].fd = NULL;
 			continue;
+		}
 
-		if (files[i].fd) {
-			chunk_size = files[i].size + sizeof(struct wave) -
+		if (files[i].has_header) {
+			/* sizes of wave files over 4 GiB are saturated */
+			data_size = files[i].size > UINT32_MAX - sizeof(struct wave) ?
+				UINT32_MAX - sizeof(struct wave) : files[i].size;
+			chunk_size = data_size + sizeof(struct wave) -
 				     offsetof(struct riff_chunk, format);
 
 			fseek(files[i].fd, sizeof(uint32_t), SEEK_SET);
@@ -159,10 +212,13 @@ void finalize_wave_files(struct wave_files *files)
 			fseek(files[i].fd, sizeof(struct wave) -
 			      offsetof(struct data_subchunk, subchunk_size),
 			      SEEK_SET);
-			fwrite(&files[i].size, sizeof(uint32_t), 1, files[i].fd);
-
-			fclose(files[i].fd);
+			fwrite(&data_size, sizeof(uint32_t), 1, files[i].fd);
 		}
+
+		fclose(files[i].fd);
+		free(files[i].buffer);
+		files[i].fd = NULL;
+		files[i].buffer = NULL;
 	}
 }
 
@@ -181,18 +237,73 @@ int validate_data_packet(struct probe_data_packet *packet)
 	checksump = (uint64_t *) (packet->data + packet->data_size_bytes);
 
 	if (sum != *checksump) {
-		fprintf(stderr, "Checksum error 0x%016" PRIx64 " != 0x%016" PRIx64 "\n",
-			sum, *checksump);
+		fprintf(stderr, "Checksum error 0x%016" PRIx64 " != 0x%016" PRIx64
+			", packet dropped\n", sum, *checksump);
 		return -EINVAL;
 	}
 
 	return 0;
 }
 
+/* find corresponding file and save the data */
+int save_data(struct dma_frame_parser *p, uint32_t buffer_id, uint32_t format,
+	      const uint8_t *data, uint32_t size)
+{
+	int file = get_buffer_file(p->files, buffer_id);
+
+	if (file < 0)
+		file = init_wave(p, buffer_id, format);
+
+	if (file < 0) {
+		fprintf(stderr, "unable to open file for %u\n", buffer_id);
+		return -EIO;
+	}
+
+	fwrite(data, 1, size, p->files[file].fd);
+	p->files[file].size += size;
+
+	return 0;
+}
+
+/* save the data of each record of a batch packet */
+int save_batch(struct dma_frame_parser *p, const uint8_t *data, uint32_t size)
+{
+	const struct probe_batch_record *record;
+	uint32_t record_size;
+	uint32_t pos = 0;
+	int ret;
+
+	while (size - pos >= sizeof(*record)) {
+		record = (const struct probe_batch_record *)(data + pos);
+		record_size = sizeof(*record) + ((record->data_size_bytes + 3) & ~3);
+		if (record_size > size - pos) {
+			fprintf(stderr, "Batch record of %u bytes exceeds packet\n",
+				record->data_size_bytes);
+			return 0;
+		}
+
+		ret = save_data(p, record->buffer_id, record->format, record->data,
+				record->data_size_bytes);
+		if (ret < 0)
+			return ret;
+
+		pos += record_size;
+	}
+
+	return 0;
+}
+
 int process_sync(struct dma_frame_parser *p)
 {
 	struct probe_data_packet *temp_packet;
 
+	/* the checksum is known only after the data, reject false syncs early */
+	if (p->packet->data_size_bytes > PACKET_DATA_LIMIT) {
+		fprintf(stderr, "Packet of %u bytes exceeds the limit, packet dropped\n",
+			p->packet->data_size_bytes);
+		return -EINVAL;
+	}
+
 	/* request to copy data_size from probe packet and 64-bit checksum */
 	p->total_data_to_copy = p->packet->data_size_bytes + sizeof(uint64_t);
 
@@ -224,7 +335,7 @@ struct dma_frame_parser *parser_init(void)
 	}
 	memset(p, 0, sizeof(*p));
 	p->packet = malloc(PACKET_MAX_SIZE);
-	if (!p) {
+	if (!p->packet) {
 		fprintf(stderr, "error: allocation failed, err %d\n",
 			errno);
 		free(p);
@@ -232,11 +343,14 @@ struct dma_frame_parser *parser_init(void)
 	}
 	memset(p->packet, 0, PACKET_MAX_SIZE);
 	p->packet_size = PACKET_MAX_SIZE;
+	clock_gettime(CLOCK_MONOTONIC, &p->start_time);
+	p->last_time = p->start_time;
 	return p;
 }
 
 void parser_free(struct dma_frame_parser *p)
 {
+	finalize_wave_files(p->files);
 	free(p->packet);
 	free(p);
 }
@@ -246,6 +360,58 @@ void parser_log_to_stdout(struct dma_frame_parser *p)
 	p->log_to_stdout = true;
 }
 
+void parser_raw_output(struct dma_frame_parser *p)
+{
+	p->raw = true;
+}
+
+void parser_stream_to_stdout(struct dma_frame_parser *p, uint32_t buffer_id)
+{
+	p->stream = true;
+	p->stream_id = buffer_id;
+}
+
+static double elapsed_seconds(const struct timespec *from, const struct timespec *to)
+{
+	return (to->tv_sec - from->tv_sec) + (to->tv_nsec - from->tv_nsec) / 1e9;
+}
+
+void parser_print_stats(struct dma_frame_parser *p, bool total)
+{
+	static const struct parser_stats none;
+	const struct parser_stats *last = total ? &none : &p->last_stats;
+	const struct timespec *from = total ? &p->start_time : &p->last_time;
+	struct timespec now;
+	double seconds;
+	uint64_t size;
+	int i;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	seconds = elapsed_seconds(from, &now);
+	if (seconds <= 0)
+		seconds = 1e-9;
+
+	fprintf(stderr, "%s:\t %.1f s: %.1f kB/s, %" PRIu64 " packets, %" PRIu64
+		" dropped, %" PRIu64 " bytes skipped\n", APP_NAME,
+		elapsed_seconds(&p->start_time, &now),
+		(p->stats.bytes - last->bytes) / seconds / 1000,
+		p->stats.packets - last->packets, p->stats.bad_packets - last->bad_packets,
+		p->stats.skipped - last->skipped);
+
+	for (i = 0; i < FILES_LIMIT; i++) {
+		if (!p->files[i].fd)
+			continue;
+
+		size = p->files[i].size - (total ? 0 : p->files[i].last_size);
+		fprintf(stderr, "%s:\t   buffer %u: %" PRIu64 " bytes, %.1f kB/s\n", APP_NAME,
+			p->files[i].buffer_id, size, size / seconds / 1000);
+		p->files[i].last_size = p->files[i].size;
+	}
+
+	p->last_stats = p->stats;
+	p->last_time = now;
+}
+
 void parser_fetch_free_buffer(struct dma_frame_parser *p, uint8_t **d, size_t *len)
 {
 	*d = &p->data[p->start];
@@ -255,10 +421,12 @@ void parser_fetch_free_buffer(struct dma_frame_parser *p, uint8_t **d, size_t *l
 int parser_parse_data(struct dma_frame_parser *p, size_t d_len)
 {
 	uint i = 0;
+	int ret;
 
+	p->stats.bytes += d_len;
 	p->len = p->start + d_len;
-	/* processing all loaded bytes */
-	while (i < p->len) {
+	/* processing all loaded bytes, and a packet completed by the last of them */
+	while (i < p->len || (p->total_data_to_copy == 0 && p->state != READY)) {
 		if (p->total_data_to_copy == 0) {
 			switch (p->state) {
 			case READY:
@@ -269,7 +437,6 @@ int parser_parse_data(struct dma_frame_parser *p, size_t d_len)
 					i += p->start;
 				} else if (*((uint32_t *)&p->data[i]) ==
 					   PROBE_EXTRACT_SYNC_WORD) {
-					memset(p->packet, 0, p->packet_size);
 					/* request to copy full data packet */
 					p->total_data_to_copy =
 						sizeof(struct probe_data_packet);
@@ -277,14 +444,21 @@ int parser_parse_data(struct dma_frame_parser *p, size_t d_len)
 					p->state = SYNC;
 					p->start = 0;
 				} else {
+					p->stats.skipped++;
 					i++;
 				}
 				break;
 			case SYNC:
-				/* SYNC -> CHECK */
-				if (process_sync(p) < 0) {
+				/* SYNC -> CHECK, or READY if the size is not valid */
+				ret = process_sync(p);
+				if (ret == -ENOMEM) {
 					fprintf(stderr, "OOM, quitting\n");
-					return -ENOMEM;
+					return ret;
+				}
+				if (ret < 0) {
+					p->stats.bad_packets++;
+					p->state = READY;
+					break;
 				}
 				p->state = CHECK;
 				break;
@@ -292,25 +466,20 @@ int parser_parse_data(struct dma_frame_parser *p, size_t d_len)
 				/* CHECK -> READY */
 				/* find corresponding file and save data if valid */
 				if (validate_data_packet(p->packet) == 0) {
-					int file = get_buffer_file(p->files,
-								   p->packet->buffer_id);
-
-					if (file < 0)
-						file = init_wave(p, p->packet->buffer_id,
-								 p->packet->format);
-
-					if (file < 0) {
-						fprintf(stderr,
-							"unable to open file for %u\n",
-							p->packet->buffer_id);
-						return -EIO;
-					}
-
-					fwrite(p->packet->data, 1,
-					       p->packet->data_size_bytes,
-					       p->files[file].fd);
-					p->files[file].size += p->packet->data_size_bytes;
-					}
+					p->stats.packets++;
+					if (p->packet->buffer_id == PROBE_BATCH_BUFFER_ID)
+						ret = save_batch(p, p->packet->data,
+								 p->packet->data_size_bytes);
+					else
+						ret = save_data(p, p->packet->buffer_id,
+								p->packet->format,
+								p->packet->data,
+								p->packet->data_size_bytes);
+					if (ret < 0)
+						return ret;
+				} else {
+					p->stats.bad_packets++;
+				}
 				p->state = READY;
 				break;
 			}
@@ -333,5 +502,10 @@ int parser_parse_data(struct dma_frame_parser *p, size_t d_len)
 			i += data_to_copy;
 		}
 	}
+
+	/* keep live output going even if stdout is a full buffered pipe */
+	if (p->stream || p->log_to_stdout)
+		fflush(stdout);
+
 	return 0;
 }
@@ -18,6 +18,12 @@ struct dma_frame_parser *parser_init(void);
 
 void parser_log_to_stdout(struct dma_frame_parser *p);
 
+void parser_raw_output(struct dma_frame_parser *p);
+
+void parser_stream_to_stdout(struct dma_frame_parser *p, uint32_t buffer_id);
+
+void parser_print_stats(struct dma_frame_parser *p, bool total);
+
 void parser_free(struct dma_frame_parser *p);
 
 void parser_fetch_free_buffer(struct dma_frame_parser *p, uint8_t **d, size_t *len);
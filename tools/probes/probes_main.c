@@ -11,14 +11,21 @@
  *
  * Usage to parse data and create wave files: ./sof-probes -p data.bin
  *
+ * The data can also be streamed through a pipe, FIFO or socket on stdin for
+ * long captures, e.g. to play buffer 5 live and print throughput every 10 s:
+ * ./sof-probes -s 5 -t 10 < /tmp/probes.fifo | aplay
+ *
  */
 
 #include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdio.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 #include <unistd.h>
 
 #include "probes_demux.h"
@@ -30,57 +37,119 @@ static void usage(void)
 	fprintf(stdout, "Usage %s <option(s)> <buffer_id/file>\n\n", APP_NAME);
 	fprintf(stdout, "%s:\t -p file\tParse extracted file\n\n", APP_NAME);
 	fprintf(stdout, "%s:\t -l \t\tLog to stdout\n\n", APP_NAME);
+	fprintf(stdout, "%s:\t -r \t\tSave audio without wave headers\n\n", APP_NAME);
+	fprintf(stdout, "%s:\t -s buffer_id\tStream the buffer data to stdout\n\n", APP_NAME);
+	fprintf(stdout, "%s:\t -t seconds\tPrint throughput and drop counters periodically\n\n",
+		APP_NAME);
 	fprintf(stdout, "%s:\t -h \t\tHelp, usage info\n", APP_NAME);
+	fprintf(stdout, "\nData is read from stdin if no file is given, until EOF or SIGINT\n");
 	exit(0);
 }
 
-void parse_data(const char *file_in, bool log_to_stdout)
+/* set by the handler, read back after read() returns */
+static volatile sig_atomic_t stop;
+static volatile sig_atomic_t print_stats;
+
+static void signal_handler(int sig)
 {
-	struct dma_frame_parser *p = parser_init();
-	FILE *fd_in;
-	uint8_t *data;
-	size_t len;
-	int ret;
+	if (sig == SIGALRM)
+		print_stats = 1;
+	else
+		stop = 1;
+}
 
-	if (!p) {
-		fprintf(stderr, "parser_init() failed\n");
-		exit(1);
-	}
+/* without SA_RESTART a blocking read() returns on the signals */
+static void set_signal_handler(int sig)
+{
+	struct sigaction sa;
 
-	if (log_to_stdout)
-		parser_log_to_stdout(p);
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = signal_handler;
+	sigemptyset(&sa.sa_mask);
+	sigaction(sig, &sa, NULL);
+}
+
+void parse_data(struct dma_frame_parser *p, const char *file_in, unsigned int stats_period)
+{
+	uint8_t *data;
+	size_t len;
+	ssize_t ret;
+	int fd_in;
 
 	if (file_in) {
-		fd_in = fopen(file_in, "rb");
-		if (!fd_in) {
+		fd_in = open(file_in, O_RDONLY);
+		if (fd_in < 0) {
 			fprintf(stderr, "error: unable to open file %s, error %d\n",
 				file_in, errno);
 			exit(0);
 		}
 	} else {
-		fd_in = stdin;
+		fd_in = STDIN_FILENO;
+	}
+
+	set_signal_handler(SIGINT);
+	set_signal_handler(SIGTERM);
+	if (stats_period) {
+		set_signal_handler(SIGALRM);
+		alarm(stats_period);
 	}
 
-	do {
+	while (!stop) {
+		if (print_stats) {
+			print_stats = 0;
+			parser_print_stats(p, false);
+			alarm(stats_period);
+		}
+
 		parser_fetch_free_buffer(p, &data, &len);
-		len = fread(data, 1, len, fd_in);
-		ret = parser_parse_data(p, len);
-	} while (!ret && !feof(fd_in));
+		ret = read(fd_in, data, len);
+		if (ret < 0) {
+			if (errno == EINTR)
+				continue;
+			fprintf(stderr, "error: read failed, error %d\n", errno);
+			break;
+		}
+		if (!ret || parser_parse_data(p, ret))
+			break;
+	}
+
+	alarm(0);
+	if (file_in)
+		close(fd_in);
 }
 
 int main(int argc, char *argv[])
 {
+	struct dma_frame_parser *p = parser_init();
+	unsigned int stats_period = 0;
 	const char *fname = NULL;
 	bool log_to_stdout = false;
+	bool stream = false;
 	int opt;
 
-	while ((opt = getopt(argc, argv, "lhp:")) != -1) {
+	if (!p) {
+		fprintf(stderr, "parser_init() failed\n");
+		exit(1);
+	}
+
+	while ((opt = getopt(argc, argv, "lhrp:s:t:")) != -1) {
 		switch (opt) {
 		case 'p':
 			fname = optarg;
 			break;
 		case 'l':
 			log_to_stdout = true;
+			parser_log_to_stdout(p);
+			break;
+		case 'r':
+			parser_raw_output(p);
+			break;
+		case 's':
+			stream = true;
+			parser_stream_to_stdout(p, strtoul(optarg, NULL, 0));
+			break;
+		case 't':
+			stats_period = strtoul(optarg, NULL, 0);
 			break;
 		case 'h':
 		default:
@@ -88,7 +157,15 @@ int main(int argc, char *argv[])
 			return 0;
 		}
 	}
-	parse_data(fname, log_to_stdout);
+
+	if (log_to_stdout && stream) {
+		fprintf(stderr, "error: -l and -s both use stdout\n");
+		exit(1);
+	}
+
+	parse_data(p, fname, stats_period);
+	parser_print_stats(p, true);
+	parser_free(p);
 
 	return 0;
 }
@@ -0,0 +1,326 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+/*
+ * PCM converter benchmark, runs every function of pcm_func_map and
+ * pcm_func_vc_map on circular buffers and reports the cost per sample.
+ * On x86 the SSE4.2 functions of pcm_func_map_x86 are run too.
+ *
+ * For sinks in 32 bit containers the conversion followed by a separate
+ * attenuation pass is compared with pcm_convert_attenuated(), the outputs
+ * must be identical.
+ */
+
+#include <sof/audio/audio_stream.h>
+#include <sof/audio/pcm_converter.h>
+#include <sof/common.h>
+#include <rtos/string.h>
+#include <ipc/stream.h>
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CONVBENCH_SAMPLES	1024
+#define CONVBENCH_ITERATIONS	2000
+#define CONVBENCH_SHIFT		3
+
+/* buffers are not a multiple of the conversion size, so the calls wrap */
+#define CONVBENCH_BUFFER_SAMPLES(n)	((n) * 3 + 7)
+
+struct convbench {
+	uint32_t samples;
+	int iterations;
+	int errors;
+};
+
+static const char *convbench_fmt_name(enum sof_ipc_frame fmt)
+{
+	switch (fmt) {
+	case SOF_IPC_FRAME_S16_LE:
+		return "s16";
+	case SOF_IPC_FRAME_S24_4LE:
+		return "s24";
+	case SOF_IPC_FRAME_S32_LE:
+		return "s32";
+	case SOF_IPC_FRAME_FLOAT:
+		return "float";
+	case SOF_IPC_FRAME_S24_3LE:
+		return "s24_3";
+	default:
+		return "?";
+	}
+}
+
+static uint64_t convbench_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static int convbench_stream_init(struct audio_stream *stream, enum sof_ipc_frame fmt,
+				 uint32_t samples)
+{
+	uint32_t size;
+	void *addr;
+
+	memset(stream, 0, sizeof(*stream));
+	stream->frame_fmt = fmt;
+	stream->valid_sample_fmt = fmt;
+	stream->channels = 1;
+
+	size = CONVBENCH_BUFFER_SAMPLES(samples) * audio_stream_sample_bytes(stream);
+	addr = calloc(1, size);
+	if (!addr)
+		return -ENOMEM;
+
+	audio_stream_init(stream, addr, size);
+
+	/* the converters only check avail and free, pointers are moved by hand */
+	stream->avail = size;
+	stream->free = size;
+	return 0;
+}
+
+/* random samples in the range of the valid sample format */
+static void convbench_fill(struct audio_stream *stream, enum sof_ipc_frame valid_fmt)
+{
+	uint32_t samples = stream->size / audio_stream_sample_bytes(stream);
+	uint8_t *p8 = stream->addr;
+	int32_t *p32 = stream->addr;
+	int16_t *p16 = stream->addr;
+	float *pf = stream->addr;
+	uint32_t i;
+
+	for (i = 0; i < samples; i++) {
+		switch (stream->frame_fmt) {
+		case SOF_IPC_FRAME_S16_LE:
+			p16[i] = rand();
+			break;
+		case SOF_IPC_FRAME_S24_3LE:
+			p8[3 * i] = rand();
+			p8[3 * i + 1] = rand();
+			p8[3 * i + 2] = rand();
+			break;
+		case SOF_IPC_FRAME_FLOAT:
+			pf[i] = (float)rand() / RAND_MAX * 2.0f - 1.0f;
+			break;
+		default:
+			p32[i] = ((uint32_t)rand() << 16) ^ rand();
+			if (valid_fmt == SOF_IPC_FRAME_S24_4LE)
+				p32[i] = (int32_t)((uint32_t)p32[i] << 8) >> 8;
+			else if (valid_fmt == SOF_IPC_FRAME_S16_LE)
+				p32[i] = (int16_t)p32[i];
+			break;
+		}
+	}
+}
+
+static void *convbench_advance(struct audio_stream *stream, void *ptr, uint32_t samples)
+{
+	return audio_stream_wrap(stream, (char *)ptr + samples * audio_stream_sample_bytes(stream));
+}
+
+/* the attenuation as a separate pass, like the copier used to do it */
+static void convbench_shift(struct audio_stream *sink, uint32_t samples, uint32_t shift)
+{
+	int32_t *ptr = sink->w_ptr;
+	uint32_t n;
+
+	while (samples) {
+		n = MIN(samples, audio_stream_samples_without_wrap_s32(sink, ptr));
+		pcm_shift_s32_lin(ptr, n, shift);
+		ptr = audio_stream_wrap(sink, ptr + n);
+		samples -= n;
+	}
+}
+
+static uint64_t convbench_run(struct convbench *cb, struct audio_stream *source,
+			      struct audio_stream *sink, pcm_converter_func func,
+			      int mode)
+{
+	uint64_t start;
+	int i;
+
+	source->r_ptr = source->addr;
+	sink->w_ptr = sink->addr;
+
+	start = convbench_ns();
+	for (i = 0; i < cb->iterations; i++) {
+		switch (mode) {
+		case 0:
+			func(source, 0, sink, 0, cb->samples);
+			break;
+		case 1:
+			func(source, 0, sink, 0, cb->samples);
+			convbench_shift(sink, cb->samples, CONVBENCH_SHIFT);
+			break;
+		default:
+			pcm_convert_attenuated(source, 0, sink, 0, cb->samples, func,
+					       CONVBENCH_SHIFT);
+			break;
+		}
+
+		source->r_ptr = convbench_advance(source, source->r_ptr, cb->samples);
+		sink->w_ptr = convbench_advance(sink, sink->w_ptr, cb->samples);
+	}
+
+	return convbench_ns() - start;
+}
+
+/* the separate and the fused attenuation must give the same output */
+static int convbench_check(struct convbench *cb, struct audio_stream *source,
+			   struct audio_stream *sink, pcm_converter_func func)
+{
+	void *ref;
+	int ret;
+
+	ref = malloc(sink->size);
+	if (!ref)
+		return -ENOMEM;
+
+	/* start close to the end of both buffers to cross the wrap */
+	source->r_ptr = convbench_advance(source, source->addr,
+					  CONVBENCH_BUFFER_SAMPLES(cb->samples) - 5);
+	sink->w_ptr = convbench_advance(sink, sink->addr,
+					CONVBENCH_BUFFER_SAMPLES(cb->samples) - 3);
+
+	memset(sink->addr, 0, sink->size);
+	func(source, 0, sink, 0, cb->samples);
+	convbench_shift(sink, cb->samples, CONVBENCH_SHIFT);
+	memcpy_s(ref, sink->size, sink->addr, sink->size);
+
+	memset(sink->addr, 0, sink->size);
+	pcm_convert_attenuated(source, 0, sink, 0, cb->samples, func, CONVBENCH_SHIFT);
+	ret = memcmp(ref, sink->addr, sink->size) ? -EINVAL : 0;
+
+	free(ref);
+	return ret;
+}
+
+static void convbench_func(struct convbench *cb, const char *name,
+			   enum sof_ipc_frame source_fmt, enum sof_ipc_frame valid_source_fmt,
+			   enum sof_ipc_frame sink_fmt, pcm_converter_func func)
+{
+	struct audio_stream source = { 0 };
+	struct audio_stream sink = { 0 };
+	double total = (double)cb->samples * cb->iterations;
+	uint64_t ns;
+
+	if (convbench_stream_init(&source, source_fmt, cb->samples) < 0 ||
+	    convbench_stream_init(&sink, sink_fmt, cb->samples) < 0) {
+		fprintf(stderr, "error: out of memory\n");
+		cb->errors++;
+		goto out;
+	}
+
+	convbench_fill(&source, valid_source_fmt);
+
+	ns = convbench_run(cb, &source, &sink, func, 0);
+	printf("%-28s %8.3f", name, ns / total);
+
+	/* the copier attenuates sinks with 32 bit integer containers */
+	if (sink_fmt == SOF_IPC_FRAME_S24_4LE || sink_fmt == SOF_IPC_FRAME_S32_LE) {
+		if (convbench_check(cb, &source, &sink, func) < 0) {
+			printf("  attenuated output mismatch");
+			cb->errors++;
+		} else {
+			ns = convbench_run(cb, &source, &sink, func, 1);
+			printf(" %10.3f", ns / total);
+			ns = convbench_run(cb, &source, &sink, func, 2);
+			printf(" %8.3f", ns / total);
+		}
+	}
+
+	printf("\n");
+
+out:
+	free(source.addr);
+	free(sink.addr);
+}
+
+static void convbench_usage(char *name)
+{
+	printf("Usage: %s [-s <samples>] [-n <iterations>]\n\n", name);
+	printf("Benchmark the PCM conversion functions, times are ns per sample\n");
+	printf("for the conversion, conversion followed by attenuation and fused\n");
+	printf("conversion and attenuation.\n\n");
+	printf("  -s <samples>    samples per conversion call, default %d\n", CONVBENCH_SAMPLES);
+	printf("  -n <iterations> conversion calls per function, default %d\n",
+	       CONVBENCH_ITERATIONS);
+	printf("  -h              help\n");
+}
+
+int main(int argc, char **argv)
+{
+	struct convbench cb = {
+		.samples = CONVBENCH_SAMPLES,
+		.iterations = CONVBENCH_ITERATIONS,
+	};
+	char name[64];
+	int option;
+	size_t i;
+
+	while ((option = getopt(argc, argv, "hs:n:")) != -1) {
+		switch (option) {
+		case 's':
+			cb.samples = atoi(optarg);
+			break;
+		case 'n':
+			cb.iterations = atoi(optarg);
+			break;
+		case 'h':
+		default:
+			convbench_usage(argv[0]);
+			return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	/* even number of samples for the packed 24 bit link gateway conversion */
+	if (!cb.samples || cb.samples & 1 || cb.iterations <= 0) {
+		convbench_usage(argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	printf("%-28s %8s %10s %8s\n", "conversion", "convert", "+attenuate", "fused");
+
+	for (i = 0; i < pcm_func_count; i++) {
+		snprintf(name, sizeof(name), "%s -> %s",
+			 convbench_fmt_name(pcm_func_map[i].source),
+			 convbench_fmt_name(pcm_func_map[i].sink));
+		convbench_func(&cb, name, pcm_func_map[i].source, pcm_func_map[i].source,
+			       pcm_func_map[i].sink, pcm_func_map[i].func);
+	}
+
+#ifdef PCM_CONVERTER_X86
+	for (i = 0; __builtin_cpu_supports("sse4.2") && i < pcm_func_count_x86; i++) {
+		snprintf(name, sizeof(name), "%s -> %s sse4.2",
+			 convbench_fmt_name(pcm_func_map_x86[i].source),
+			 convbench_fmt_name(pcm_func_map_x86[i].sink));
+		convbench_func(&cb, name, pcm_func_map_x86[i].source, pcm_func_map_x86[i].source,
+			       pcm_func_map_x86[i].sink, pcm_func_map_x86[i].func);
+	}
+#endif /* PCM_CONVERTER_X86 */
+
+	for (i = 0; i < pcm_func_vc_count; i++) {
+		const struct pcm_func_vc_map *map = &pcm_func_vc_map[i];
+
+		snprintf(name, sizeof(name), "%s/%s -> %s/%s %x %x",
+			 convbench_fmt_name(map->valid_src_bits), convbench_fmt_name(map->source),
+			 convbench_fmt_name(map->valid_sink_bits), convbench_fmt_name(map->sink),
+			 map->type, map->direction);
+		convbench_func(&cb, name, map->source, map->valid_src_bits, map->sink,
+			       map->func);
+	}
+
+	if (cb.errors)
+		printf("\n%d conversions failed\n", cb.errors);
+
+	return cb.errors ? EXIT_FAILURE : EXIT_SUCCESS;
+}
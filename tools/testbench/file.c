@@ -10,6 +10,10 @@
 #include <stdlib.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <ctype.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sof/sof.h>
 #include <sof/list.h>
 #include <sof/audio/stream.h>
@@ -35,10 +39,11 @@ static const struct comp_driver comp_file_host;
  * Helpers for s24_4le data. To avoid an overflown 24 bit to be taken as valid 32 bit
  * sample mask in file read the 8 most signing bits to zeros. In file write similarly
  * shift the 24 bit word to MSB and possibly overflow it, then shift it back to LSB
- * side to create sign extension.
+ * side to create sign extension. WAV files have the 24 bits in the MSB side of the
+ * 32 bit container so for them the shift is done in file read and left out in write.
  */
 
-static void mask_sink_s24(const struct audio_stream *sink, int samples)
+static void mask_sink_s24(const struct audio_stream *sink, int samples, int shift)
 {
 	int32_t *snk = (int32_t *)sink->w_ptr;
 	size_t bytes = samples * sizeof(int32_t);
@@ -49,15 +54,17 @@ static void mask_sink_s24(const struct audio_stream *sink, int samples)
 	while (bytes) {
 		bytes_snk = audio_stream_bytes_without_wrap(sink, snk);
 		samples_avail = FILE_BYTES_TO_S32_SAMPLES(MIN(bytes, bytes_snk));
-		for (i = 0; i < samples_avail; i++)
-			*snk++ &= 0x00ffffff;
+		for (i = 0; i < samples_avail; i++) {
+			*snk = (*snk >> shift) & 0x00ffffff;
+			snk++;
+		}
 
-		bytes -= samples * sizeof(int32_t);
+		bytes -= samples_avail * sizeof(int32_t);
 		snk = audio_stream_wrap(sink, snk);
 	}
 }
 
-static void sign_extend_source_s24(const struct audio_stream *source, int samples)
+static void sign_extend_source_s24(const struct audio_stream *source, int samples, int shift)
 {
 	int32_t tmp;
 	int32_t *src = (int32_t *)source->r_ptr;
@@ -71,14 +78,133 @@ static void sign_extend_source_s24(const struct audio_stream *source, int sample
 		samples_avail = FILE_BYTES_TO_S32_SAMPLES(MIN(bytes, bytes_src));
 		for (i = 0; i < samples_avail; i++) {
 			tmp = *src << 8;
-			*src++ = tmp >> 8;
+			*src++ = tmp >> shift;
 		}
 
-		bytes -= samples * sizeof(int32_t);
+		bytes -= samples_avail * sizeof(int32_t);
 		src = audio_stream_wrap(source, src);
 	}
 }
 
+/*
+ * Read up to bytes from input file, the data is copied from the mapping
+ * if the file is mapped. Returns the number of bytes read.
+ */
+static size_t file_read_bytes(struct file_state *fs, void *dst, size_t bytes)
+{
+	struct file_map *map = &fs->map;
+
+	bytes = MIN(bytes, fs->data_left);
+	if (map->addr) {
+		bytes = MIN(bytes, map->size - map->pos);
+		memcpy_s(dst, bytes, map->addr + map->pos, bytes);
+		map->pos += bytes;
+	} else {
+		bytes = fread(dst, 1, bytes, fs->rfh);
+	}
+
+	fs->data_left -= bytes;
+	return bytes;
+}
+
+/* Move the output mapping window to file offset, the file is extended to cover it */
+static int file_map_window(struct file_state *fs, off_t offset)
+{
+	struct file_map *map = &fs->map;
+	int fd = fileno(fs->wfh);
+	void *addr;
+
+	if (map->addr) {
+		munmap(map->addr, map->size);
+		map->addr = NULL;
+	}
+
+	if (ftruncate(fd, offset + FILE_MAP_WINDOW_SIZE) < 0)
+		return -errno;
+
+	/* populate the window at once instead of faulting it in page by page */
+	addr = mmap(NULL, FILE_MAP_WINDOW_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+		    fd, offset);
+	if (addr == MAP_FAILED)
+		return -errno;
+
+	map->addr = addr;
+	map->size = FILE_MAP_WINDOW_SIZE;
+	map->offset = offset;
+	map->pos = 0;
+	return 0;
+}
+
+/*
+ * Write bytes to output file, to the mapping window if the file is mapped.
+ * Returns the number of bytes written.
+ */
+static size_t file_write_bytes(struct file_state *fs, const void *src, size_t bytes)
+{
+	struct file_map *map = &fs->map;
+	size_t written = 0;
+	size_t n;
+	int ret;
+
+	if (!map->addr)
+		return fwrite(src, 1, bytes, fs->wfh);
+
+	while (written < bytes) {
+		if (map->pos == map->size) {
+			ret = file_map_window(fs, map->offset + map->size);
+			if (ret < 0) {
+				fprintf(stderr, "error: mapping file %s - %s\n", fs->fn,
+					strerror(-ret));
+				break;
+			}
+		}
+
+		n = MIN(bytes - written, map->size - map->pos);
+		memcpy_s(map->addr + map->pos, map->size - map->pos,
+			 (const uint8_t *)src + written, n);
+		map->pos += n;
+		written += n;
+	}
+
+	return written;
+}
+
+/*
+ * Parse a decimal integer from input file. Returns 1 for success and EOF
+ * when there are no more numbers, like fscanf() with a single conversion.
+ */
+static int file_scan_int(struct file_state *fs, int32_t *value)
+{
+	struct file_map *map = &fs->map;
+	const uint8_t *p;
+	const uint8_t *end;
+	int64_t v = 0;
+	bool negative = false;
+
+	if (!map->addr)
+		return fscanf(fs->rfh, "%d", value);
+
+	p = map->addr + map->pos;
+	end = map->addr + map->size;
+	while (p < end && isspace(*p))
+		p++;
+
+	if (p < end && (*p == '-' || *p == '+'))
+		negative = *p++ == '-';
+
+	if (p == end || !isdigit(*p)) {
+		map->pos = p - map->addr;
+		return EOF;
+	}
+
+	while (p < end && isdigit(*p))
+		v = v * 10 + *p++ - '0';
+
+	map->pos = p - map->addr;
+	*value = negative ? -v : v;
+	return 1;
+}
+
 /*
  * Read 32-bit samples from binary file
  */
@@ -94,7 +220,8 @@ static int read_binary_s32(struct file_comp_data *cd, const struct audio_stream
 	while (bytes) {
 		bytes_snk = audio_stream_bytes_without_wrap(sink, snk);
 		samples_avail = FILE_BYTES_TO_S32_SAMPLES(MIN(bytes, bytes_snk));
-		ret = fread(snk, sizeof(int32_t), samples_avail, cd->fs.rfh);
+		ret = file_read_bytes(&cd->fs, snk, samples_avail * sizeof(int32_t)) /
+			sizeof(int32_t);
 		if (!ret) {
 			cd->fs.reached_eof = 1;
 			return samples_copied;
@@ -124,7 +251,8 @@ static int write_binary_s32(struct file_comp_data *cd, const struct audio_stream
 	while (bytes) {
 		bytes_src = audio_stream_bytes_without_wrap(source, src);
 		samples_avail = FILE_BYTES_TO_S32_SAMPLES(MIN(bytes, bytes_src));
-		ret = fwrite(src, sizeof(int32_t), samples_avail, cd->fs.wfh);
+		ret = file_write_bytes(&cd->fs, src, samples_avail * sizeof(int32_t)) /
+			sizeof(int32_t);
 		if (ret == 0) {
 			cd->fs.write_failed = true;
 			return samples_copied;
@@ -153,7 +281,7 @@ static int read_text_s32(struct file_comp_data *cd, const struct audio_stream *s
 		bytes_snk = audio_stream_bytes_without_wrap(sink, snk);
 		samples = FILE_BYTES_TO_S32_SAMPLES(MIN(bytes, bytes_snk));
 		for (i = 0; i < samples; i++) {
-			ret = fscanf(cd->fs.rfh, "%d", snk++);
+			ret = file_scan_int(&cd->fs, snk++);
 			if (ret == EOF) {
 				cd->fs.reached_eof = 1;
 				return samples_copied;
@@ -204,7 +332,8 @@ static int read_samples_s32(struct file_comp_data *cd, const struct audio_stream
 
 	switch (cd->fs.f_format) {
 	case FILE_RAW:
-		/* raw input file */
+	case FILE_WAV:
+		/* raw input file or WAV data chunk */
 		n_samples = read_binary_s32(cd, sink, samples);
 		break;
 	case FILE_TEXT:
@@ -216,7 +345,7 @@ static int read_samples_s32(struct file_comp_data *cd, const struct audio_stream
 	}
 
 	if (fmt == SOF_IPC_FRAME_S24_4LE)
-		mask_sink_s24(sink, samples);
+		mask_sink_s24(sink, samples, cd->fs.f_format == FILE_WAV ? 8 : 0);
 
 	return n_samples;
 }
@@ -230,11 +359,12 @@ static int write_samples_s32(struct file_comp_data *cd, struct audio_stream *sou
 	int samples_written;
 
 	if (fmt == SOF_IPC_FRAME_S24_4LE)
-		sign_extend_source_s24(source, samples);
+		sign_extend_source_s24(source, samples, cd->fs.f_format == FILE_WAV ? 0 : 8);
 
 	switch (cd->fs.f_format) {
 	case FILE_RAW:
-		/* raw input file */
+	case FILE_WAV:
+		/* raw output file or WAV data chunk */
 		samples_written = write_binary_s32(cd, source, samples);
 		break;
 	case FILE_TEXT:
@@ -263,7 +393,8 @@ static int read_binary_s16(struct file_comp_data *cd, const struct audio_stream
 	while (bytes) {
 		bytes_snk = audio_stream_bytes_without_wrap(sink, snk);
 		samples_avail = FILE_BYTES_TO_S16_SAMPLES(MIN(bytes, bytes_snk));
-		ret = fread(snk, sizeof(int16_t), samples_avail, cd->fs.rfh);
+		ret = file_read_bytes(&cd->fs, snk, samples_avail * sizeof(int16_t)) /
+			sizeof(int16_t);
 		if (!ret) {
 			cd->fs.reached_eof = 1;
 			return samples_copied;
@@ -293,7 +424,8 @@ static int write_binary_s16(struct file_comp_data *cd, const struct audio_stream
 	while (bytes) {
 		bytes_src = audio_stream_bytes_without_wrap(source, src);
 		samples_avail = FILE_BYTES_TO_S16_SAMPLES(MIN(bytes, bytes_src));
-		ret = fwrite(src, sizeof(int16_t), samples_avail, cd->fs.wfh);
+		ret = file_write_bytes(&cd->fs, src, samples_avail * sizeof(int16_t)) /
+			sizeof(int16_t);
 		if (!ret) {
 			cd->fs.write_failed = true;
 			return samples_copied;
@@ -315,6 +447,7 @@ static int read_text_s16(struct file_comp_data *cd, const struct audio_stream *s
 	int16_t *snk = (int16_t *)sink->w_ptr;
 	size_t bytes = samples * sizeof(int16_t);
 	size_t bytes_snk;
+	int32_t value;
 	int ret;
 	int i;
 	int samples_copied = 0;
@@ -323,11 +456,12 @@ static int read_text_s16(struct file_comp_data *cd, const struct audio_stream *s
 		bytes_snk = audio_stream_bytes_without_wrap(sink, snk);
 		samples = FILE_BYTES_TO_S16_SAMPLES(MIN(bytes, bytes_snk));
 		for (i = 0; i < samples; i++) {
-			ret = fscanf(cd->fs.rfh, "%hd", snk++);
+			ret = file_scan_int(&cd->fs, &value);
 			if (ret == EOF) {
 				cd->fs.reached_eof = true;
 				return samples_copied;
 			}
+			*snk++ = value;
 			samples_copied++;
 			bytes -= sizeof(int16_t);
 		}
@@ -373,7 +507,8 @@ static int read_samples_s16(struct file_comp_data *cd, const struct audio_stream
 
 	switch (cd->fs.f_format) {
 	case FILE_RAW:
-		/* raw input file */
+	case FILE_WAV:
+		/* raw input file or WAV data chunk */
 		n_samples = read_binary_s16(cd, sink, samples);
 		break;
 	case FILE_TEXT:
@@ -396,7 +531,8 @@ static int write_samples_s16(struct file_comp_data *cd, struct audio_stream *sou
 
 	switch (cd->fs.f_format) {
 	case FILE_RAW:
-		/* raw input file */
+	case FILE_WAV:
+		/* raw output file or WAV data chunk */
 		samples_written = write_binary_s16(cd, source, samples);
 		break;
 	case FILE_TEXT:
@@ -529,9 +665,321 @@ static enum file_format get_file_format(char *filename)
 	if (!strcmp(ext, ".txt"))
 		return FILE_TEXT;
 
+	if (!strcmp(ext, ".wav"))
+		return FILE_WAV;
+
 	return FILE_RAW;
 }
 
+/* RIFF WAVE file header, the data chunk follows a fmt chunk for PCM samples */
+#define WAV_FORMAT_PCM		1
+#define WAV_FORMAT_EXTENSIBLE	0xfffe
+#define WAV_SIZE_UNKNOWN	UINT32_MAX
+
+struct wav_chunk {
+	char id[4];
+	uint32_t size;
+};
+
+struct wav_fmt {
+	uint16_t format;
+	uint16_t channels;
+	uint32_t rate;
+	uint32_t byte_rate;
+	uint16_t block_align;
+	uint16_t bits;
+};
+
+struct wav_fmt_ext {
+	uint16_t size;
+	uint16_t valid_bits;
+	uint32_t channel_mask;
+	uint16_t sub_format; /* first two bytes of sub format GUID */
+	uint8_t guid[14];
+};
+
+struct wav_header {
+	struct wav_chunk riff;
+	char wave[4];
+	struct wav_chunk fmt_chunk;
+	struct wav_fmt fmt;
+	struct wav_chunk data_chunk;
+};
+
+/* WAV files have 16 bit or 32 bit container, s24_4le is stored in the MSB side of 32 bits */
+static int wav_bits(struct file_comp_data *cd)
+{
+	return cd->frame_fmt == SOF_IPC_FRAME_S16_LE ? 16 : 32;
+}
+
+/*
+ * Read the RIFF header and chunks up to the data chunk. Chunks other than
+ * fmt are skipped. The file position is left at start of sample data.
+ */
+static int file_wav_read_header(struct file_comp_data *cd)
+{
+	struct file_state *fs = &cd->fs;
+	struct wav_chunk chunk;
+	struct wav_fmt fmt;
+	struct wav_fmt_ext ext;
+	uint8_t skip[64];
+	char wave[4];
+	bool have_fmt = false;
+	size_t bytes;
+	size_t n;
+
+	if (file_read_bytes(fs, &chunk, sizeof(chunk)) != sizeof(chunk) ||
+	    file_read_bytes(fs, wave, sizeof(wave)) != sizeof(wave) ||
+	    memcmp(chunk.id, "RIFF", 4) || memcmp(wave, "WAVE", 4)) {
+		fprintf(stderr, "error: %s is not a RIFF WAVE file\n", fs->fn);
+		return -EINVAL;
+	}
+
+	while (file_read_bytes(fs, &chunk, sizeof(chunk)) == sizeof(chunk)) {
+		if (!memcmp(chunk.id, "data", 4))
+			break;
+
+		/* chunks are padded to even size */
+		bytes = chunk.size + (chunk.size & 1);
+		if (!memcmp(chunk.id, "fmt ", 4) && chunk.size >= sizeof(fmt)) {
+			bytes -= file_read_bytes(fs, &fmt, sizeof(fmt));
+			if (fmt.format == WAV_FORMAT_EXTENSIBLE &&
+			    chunk.size >= sizeof(fmt) + sizeof(ext)) {
+				bytes -= file_read_bytes(fs, &ext, sizeof(ext));
+				if (ext.sub_format == WAV_FORMAT_PCM)
+					fmt.format = WAV_FORMAT_PCM;
+			}
+			have_fmt = true;
+		}
+
+		while (bytes) {
+			n = file_read_bytes(fs, skip, MIN(bytes, sizeof(skip)));
+			if (!n)
+				break;
+			bytes -= n;
+		}
+	}
+
+	if (!have_fmt || memcmp(chunk.id, "data", 4)) {
+		fprintf(stderr, "error: no fmt or data chunk in %s\n", fs->fn);
+		return -EINVAL;
+	}
+
+	if (fmt.format != WAV_FORMAT_PCM) {
+		fprintf(stderr, "error: %s format 0x%x is not PCM\n", fs->fn, fmt.format);
+		return -EINVAL;
+	}
+
+	if (fmt.channels != cd->channels || fmt.bits != wav_bits(cd)) {
+		fprintf(stderr, "error: %s has %d channels of %d bits, expected %d of %d bits\n",
+			fs->fn, fmt.channels, fmt.bits, cd->channels, wav_bits(cd));
+		return -EINVAL;
+	}
+
+	if (fmt.rate != cd->rate)
+		fprintf(stderr, "warning: %s rate %u differs from stream rate %u\n",
+			fs->fn, fmt.rate, cd->rate);
+
+	/* streamed or over 4 GB files have unknown size, read them to end */
+	if (chunk.size != WAV_SIZE_UNKNOWN)
+		fs->data_left = chunk.size;
+
+	return 0;
+}
+
+/* Set WAV header for data_bytes of samples, too large or unknown size is set to max */
+static void wav_header_init(struct file_comp_data *cd, struct wav_header *hdr, size_t data_bytes)
+{
+	int bytes = wav_bits(cd) >> 3;
+
+	memcpy_s(hdr->riff.id, sizeof(hdr->riff.id), "RIFF", 4);
+	memcpy_s(hdr->wave, sizeof(hdr->wave), "WAVE", 4);
+	memcpy_s(hdr->fmt_chunk.id, sizeof(hdr->fmt_chunk.id), "fmt ", 4);
+	memcpy_s(hdr->data_chunk.id, sizeof(hdr->data_chunk.id), "data", 4);
+	hdr->fmt_chunk.size = sizeof(hdr->fmt);
+	hdr->fmt.format = WAV_FORMAT_PCM;
+	hdr->fmt.channels = cd->channels;
+	hdr->fmt.rate = cd->rate;
+	hdr->fmt.byte_rate = cd->rate * cd->channels * bytes;
+	hdr->fmt.block_align = cd->channels * bytes;
+	hdr->fmt.bits = wav_bits(cd);
+
+	if (data_bytes > WAV_SIZE_UNKNOWN - sizeof(*hdr)) {
+		hdr->riff.size = WAV_SIZE_UNKNOWN;
+		hdr->data_chunk.size = WAV_SIZE_UNKNOWN;
+	} else {
+		hdr->riff.size = sizeof(*hdr) - sizeof(hdr->riff) + data_bytes;
+		hdr->data_chunk.size = data_bytes;
+	}
+}
+
+/* Update the WAV header in start of output file with the final data size */
+static int file_wav_update_header(struct file_comp_data *cd, size_t data_bytes)
+{
+	struct file_map *map = &cd->fs.map;
+	struct wav_header hdr;
+
+	wav_header_init(cd, &hdr, data_bytes);
+	if (map->addr && !map->offset) {
+		memcpy_s(map->addr, map->size, &hdr, sizeof(hdr));
+		return 0;
+	}
+
+	if (fseek(cd->fs.wfh, 0, SEEK_SET) < 0 || fwrite(&hdr, sizeof(hdr), 1, cd->fs.wfh) != 1)
+		return -errno;
+
+	return 0;
+}
+
+/* Map a regular input file whole, other files are read with stdio */
+static int file_map_input(struct file_state *fs)
+{
+	int fd = fileno(fs->rfh);
+	struct stat st;
+	void *addr;
+
+	if (fstat(fd, &st) < 0)
+		return -errno;
+
+	if (!S_ISREG(st.st_mode) || !st.st_size)
+		return 0;
+
+	/* fall back to stdio if the file system can't map the file */
+	addr = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (addr == MAP_FAILED)
+		return 0;
+
+	madvise(addr, st.st_size, MADV_SEQUENTIAL);
+	fs->map.addr = addr;
+	fs->map.size = st.st_size;
+	return 0;
+}
+
+/* Map the first window of a regular output file, other files are written with stdio */
+static int file_map_output(struct file_state *fs)
+{
+	int fd = fileno(fs->wfh);
+	struct stat st;
+
+	if (fstat(fd, &st) < 0)
+		return -errno;
+
+	if (!S_ISREG(st.st_mode))
+		return 0;
+
+	/* fall back to stdio if the file system can't map the file */
+	if (file_map_window(fs, 0) < 0 && ftruncate(fd, 0) < 0)
+		return -errno;
+
+	return 0;
+}
+
+static int file_open_input(struct file_comp_data *cd)
+{
+	int ret;
+
+	cd->fs.rfh = fopen(cd->fs.fn, "r");
+	if (!cd->fs.rfh) {
+		fprintf(stderr, "error: opening file %s for reading - %s\n",
+			cd->fs.fn, strerror(errno));
+		return -errno;
+	}
+
+	ret = file_map_input(&cd->fs);
+	if (ret < 0) {
+		fprintf(stderr, "error: mapping file %s - %s\n", cd->fs.fn, strerror(-ret));
+		return ret;
+	}
+
+	if (cd->fs.f_format == FILE_WAV)
+		return file_wav_read_header(cd);
+
+	return 0;
+}
+
+static int file_open_output(struct file_comp_data *cd)
+{
+	struct wav_header hdr;
+	int ret;
+
+	cd->fs.wfh = fopen(cd->fs.fn, "w+");
+	if (!cd->fs.wfh) {
+		fprintf(stderr, "error: opening file %s for writing - %s\n",
+			cd->fs.fn, strerror(errno));
+		return -errno;
+	}
+
+	/* text output is formatted with stdio */
+	if (cd->fs.f_format == FILE_TEXT)
+		return 0;
+
+	ret = file_map_output(&cd->fs);
+	if (ret < 0) {
+		fprintf(stderr, "error: mapping file %s - %s\n", cd->fs.fn, strerror(-ret));
+		return ret;
+	}
+
+	if (cd->fs.f_format != FILE_WAV)
+		return 0;
+
+	/* reserve space for header, it is updated with data size in file_close() */
+	if (cd->fs.map.addr) {
+		cd->fs.map.pos = sizeof(hdr);
+		return 0;
+	}
+
+	/* the size stays unknown if the output is not seekable */
+	wav_header_init(cd, &hdr, SIZE_MAX);
+	if (fwrite(&hdr, sizeof(hdr), 1, cd->fs.wfh) != 1) {
+		fprintf(stderr, "error: writing file %s - %s\n", cd->fs.fn, strerror(errno));
+		return -EIO;
+	}
+
+	return 0;
+}
+
+static void file_close(struct file_comp_data *cd)
+{
+	struct file_map *map = &cd->fs.map;
+	off_t size;
+	int ret;
+
+	if (cd->fs.mode == FILE_READ) {
+		if (map->addr)
+			munmap(map->addr, map->size);
+
+		if (cd->fs.rfh)
+			fclose(cd->fs.rfh);
+
+		return;
+	}
+
+	if (!cd->fs.wfh)
+		return;
+
+	if (map->addr)
+		size = map->offset + map->pos;
+	else
+		size = ftell(cd->fs.wfh);
+
+	if (cd->fs.f_format == FILE_WAV && size >= (off_t)sizeof(struct wav_header)) {
+		ret = file_wav_update_header(cd, size - sizeof(struct wav_header));
+		if (ret < 0)
+			fprintf(stderr, "warning: WAV header update failed for %s - %s\n",
+				cd->fs.fn, strerror(-ret));
+	}
+
+	/* drop the unused part of the last mapped window */
+	if (map->addr) {
+		munmap(map->addr, map->size);
+		if (ftruncate(fileno(cd->fs.wfh), size) < 0)
+			fprintf(stderr, "error: truncating file %s - %s\n",
+				cd->fs.fn, strerror(errno));
+	}
+
+	fclose(cd->fs.wfh);
+}
+
 static struct comp_dev *file_new(const struct comp_driver *drv,
 				 const struct comp_ipc_config *config,
 				 const void *spec)
@@ -542,6 +990,7 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 	struct dai_data *dd;
 	struct dai *fdai;
 	struct file_comp_data *cd;
+	int ret;
 
 	debug_print("file_new()\n");
 
@@ -590,29 +1039,24 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 	dev->direction = ipc_file->direction;
 
 	/* open file handle(s) depending on mode */
+	cd->fs.data_left = SIZE_MAX;
 	switch (cd->fs.mode) {
 	case FILE_READ:
-		cd->fs.rfh = fopen(cd->fs.fn, "r");
-		if (!cd->fs.rfh) {
-			fprintf(stderr, "error: opening file %s for reading - %s\n",
-				cd->fs.fn, strerror(errno));
-			goto error;
-		}
+		ret = file_open_input(cd);
 		break;
 	case FILE_WRITE:
-		cd->fs.wfh = fopen(cd->fs.fn, "w+");
-		if (!cd->fs.wfh) {
-			fprintf(stderr, "error: opening file %s for writing - %s\n",
-				cd->fs.fn, strerror(errno));
-			goto error;
-		}
+		ret = file_open_output(cd);
 		break;
 	default:
 		/* TODO: duplex mode */
 		fprintf(stderr, "Error: Unknown file mode %d\n", cd->fs.mode);
-		goto error;
+		ret = -EINVAL;
+		break;
 	}
 
+	if (ret < 0)
+		goto error;
+
 	cd->fs.reached_eof = false;
 	cd->fs.write_failed = false;
 	cd->fs.n = 0;
@@ -621,6 +1065,8 @@ static struct comp_dev *file_new(const struct comp_driver *drv,
 	return dev;
 
 error:
+	file_close(cd);
+	free(cd->fs.fn);
 	free(cd);
 
 error_skip_cd:
@@ -644,11 +1090,7 @@ static void file_free(struct comp_dev *dev)
 
 	comp_dbg(dev, "file_free()");
 
-	if (cd->fs.mode == FILE_READ)
-		fclose(cd->fs.rfh);
-	else
-		fclose(cd->fs.wfh);
-
+	file_close(cd);
 	free(cd->fs.fn);
 	free(cd);
 	free((void *)dd->dai->drv);
@@ -0,0 +1,639 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+/*
+ * Heap simulator, replays allocation traces recorded by the testbench with
+ * SOF_ALLOC_TRACE=<file> against the firmware allocator in src/lib/alloc.c
+ * and reports the peak use, fragmentation and cost of the calls.
+ *
+ * The simulated heaps are not backed by memory, only the allocator metadata
+ * is. The replay never touches the allocated memory, so rzalloc() calls are
+ * replayed with rmalloc() and rbrealloc() calls without copying.
+ */
+
+#include <sof/sof.h>
+#include <sof/debug/panic.h>
+#include <sof/lib/mm_heap.h>
+#include <sof/lib/memory.h>
+#include <sof/math/numbers.h>
+#include <rtos/alloc.h>
+#include <ipc/topology.h>
+
+#include <errno.h>
+#include <getopt.h>
+#include <inttypes.h>
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define HEAPSIM_MAX_HEAPS	16
+#define HEAPSIM_MAX_BLOCKS	16
+#define HEAPSIM_LINE_SIZE	256
+
+/* simulated heap addresses, below 4 GB as the block maps use 32 bit bases */
+#define HEAPSIM_HEAP_BASE	0x10000000
+#define HEAPSIM_HEAP_ALIGN	0x1000
+
+/* HEAP_BUFFER_BASE of the library platform memory map */
+#define HEAPSIM_LIB_BUFFER_BASE	0xBE1C0000
+
+/* one heap of the memory map, size is only used for heaps without blocks */
+struct heapsim_heap {
+	enum mem_zone zone;
+	int index;
+	uint32_t caps;
+	uint32_t size;
+	int blocks;
+	uint16_t block_size[HEAPSIM_MAX_BLOCKS];
+	uint16_t block_count[HEAPSIM_MAX_BLOCKS];
+};
+
+struct heapsim_zone {
+	const char *name;
+	enum mem_zone zone;
+	int count;
+};
+
+static const struct heapsim_zone heapsim_zones[] = {
+	{"sys", SOF_MEM_ZONE_SYS, PLATFORM_HEAP_SYSTEM},
+	{"sys_runtime", SOF_MEM_ZONE_SYS_RUNTIME, PLATFORM_HEAP_SYSTEM_RUNTIME},
+	{"runtime", SOF_MEM_ZONE_RUNTIME, PLATFORM_HEAP_RUNTIME},
+	{"buffer", SOF_MEM_ZONE_BUFFER, PLATFORM_HEAP_BUFFER},
+#if CONFIG_CORE_COUNT > 1
+	{"runtime_shared", SOF_MEM_ZONE_RUNTIME_SHARED, PLATFORM_HEAP_RUNTIME_SHARED},
+	{"sys_shared", SOF_MEM_ZONE_SYS_SHARED, PLATFORM_HEAP_SYSTEM_SHARED},
+#endif
+};
+
+/* default memory map, the same as the library platform memory map */
+static const struct heapsim_heap heapsim_default_map[] = {
+	{SOF_MEM_ZONE_SYS, 0, SOF_MEM_CAPS_RAM | SOF_MEM_CAPS_EXT | SOF_MEM_CAPS_CACHE,
+	 HEAP_SYSTEM_M_SIZE, 0},
+	{SOF_MEM_ZONE_SYS_RUNTIME, 0, SOF_MEM_CAPS_RAM | SOF_MEM_CAPS_EXT | SOF_MEM_CAPS_CACHE |
+	 SOF_MEM_CAPS_DMA, 0, 3, {64, 512, 1024},
+	 {HEAP_SYS_RT_0_COUNT64, HEAP_SYS_RT_0_COUNT512, HEAP_SYS_RT_0_COUNT1024}},
+	{SOF_MEM_ZONE_RUNTIME, 0, SOF_MEM_CAPS_RAM | SOF_MEM_CAPS_EXT | SOF_MEM_CAPS_CACHE,
+	 0, 7, {64, 128, 256, 512, 1024, 2048, 4096},
+	 {HEAP_COUNT64, HEAP_COUNT128, HEAP_COUNT256, HEAP_COUNT512, HEAP_COUNT1024,
+	  HEAP_COUNT2048, HEAP_COUNT4096}},
+	{SOF_MEM_ZONE_BUFFER, 0, SOF_MEM_CAPS_RAM | SOF_MEM_CAPS_HP | SOF_MEM_CAPS_CACHE |
+	 SOF_MEM_CAPS_DMA, 0, 1, {HEAP_BUFFER_BLOCK_SIZE},
+	 {(SOF_FW_END - HEAPSIM_LIB_BUFFER_BASE) / HEAP_BUFFER_BLOCK_SIZE}},
+	{SOF_MEM_ZONE_BUFFER, 1, SOF_MEM_CAPS_RAM | SOF_MEM_CAPS_LP | SOF_MEM_CAPS_CACHE |
+	 SOF_MEM_CAPS_DMA, 0, 1, {HEAP_LP_BUFFER_BLOCK_SIZE}, {HEAP_LP_BUFFER_COUNT}},
+};
+
+enum heapsim_call {
+	HEAPSIM_RMALLOC = 0,
+	HEAPSIM_RBALLOC,
+	HEAPSIM_RBREALLOC,
+	HEAPSIM_RFREE,
+	HEAPSIM_CALLS,
+};
+
+static const char * const heapsim_call_names[] = {
+	"rmalloc", "rballoc", "rbrealloc", "rfree",
+};
+
+struct heapsim_cost {
+	uint64_t count;
+	uint64_t fails;
+	uint64_t total_ns;
+	uint64_t max_ns;
+};
+
+/* recorded pointer to simulated pointer, open addressing */
+struct heapsim_ptr {
+	uintptr_t key;
+	void *ptr;
+};
+
+struct heapsim {
+	struct heapsim_heap heap[HEAPSIM_MAX_HEAPS];
+	struct mm_heap *mm_heap[HEAPSIM_MAX_HEAPS];
+	uint32_t peak[HEAPSIM_MAX_HEAPS];
+	int heaps;
+	struct heapsim_ptr *ptrs;
+	size_t ptrs_size;
+	size_t ptrs_used;
+	struct heapsim_cost cost[HEAPSIM_CALLS];
+	int panics;
+	int verbose;
+	int line;
+};
+
+static struct mm heapsim_memmap;
+static struct block_map heapsim_empty_map;
+static struct sof heapsim_sof;
+static jmp_buf heapsim_panic_jmp;
+
+int test_bench_trace;
+
+struct sof *sof_get(void)
+{
+	return &heapsim_sof;
+}
+
+/* e.g. rmalloc_sys() panics when the system heap runs out, skip the call */
+void __panic(uint32_t p, char *filename, uint32_t linenum)
+{
+	longjmp(heapsim_panic_jmp, 1);
+}
+
+static struct mm_heap *heapsim_zone_heaps(struct mm *memmap, enum mem_zone zone)
+{
+	switch (zone) {
+	case SOF_MEM_ZONE_SYS:
+		return memmap->system;
+	case SOF_MEM_ZONE_SYS_RUNTIME:
+		return memmap->system_runtime;
+	case SOF_MEM_ZONE_RUNTIME:
+		return memmap->runtime;
+	case SOF_MEM_ZONE_BUFFER:
+		return memmap->buffer;
+#if CONFIG_CORE_COUNT > 1
+	case SOF_MEM_ZONE_RUNTIME_SHARED:
+		return memmap->runtime_shared;
+	case SOF_MEM_ZONE_SYS_SHARED:
+		return memmap->system_shared;
+#endif
+	default:
+		return NULL;
+	}
+}
+
+static const struct heapsim_zone *heapsim_zone_find(const char *name)
+{
+	int i;
+
+	for (i = 0; i < ARRAY_SIZE(heapsim_zones); i++)
+		if (!strcmp(heapsim_zones[i].name, name))
+			return &heapsim_zones[i];
+
+	return NULL;
+}
+
+/*
+ * Memory map lines are "<zone> <index> <caps> <size>" for the system heaps
+ * and "<zone> <index> <caps> <block size>x<count> ..." for the others.
+ */
+static int heapsim_parse_map(struct heapsim *sim, const char *name)
+{
+	const struct heapsim_zone *zone;
+	struct heapsim_heap *heap;
+	char line[HEAPSIM_LINE_SIZE];
+	char zone_name[32];
+	unsigned int size, count;
+	char *tok, *save;
+	int n = 0;
+	FILE *f;
+
+	f = fopen(name, "r");
+	if (!f) {
+		fprintf(stderr, "error: can't open memory map %s\n", name);
+		return -errno;
+	}
+
+	sim->heaps = 0;
+	while (fgets(line, sizeof(line), f)) {
+		n++;
+		tok = strtok_r(line, " \t\n", &save);
+		if (!tok || tok[0] == '#')
+			continue;
+
+		if (sim->heaps == HEAPSIM_MAX_HEAPS)
+			goto err;
+
+		heap = &sim->heap[sim->heaps];
+		memset(heap, 0, sizeof(*heap));
+		snprintf(zone_name, sizeof(zone_name), "%s", tok);
+		zone = heapsim_zone_find(zone_name);
+		tok = strtok_r(NULL, " \t\n", &save);
+		if (!zone || !tok)
+			goto err;
+
+		heap->zone = zone->zone;
+		heap->index = atoi(tok);
+		tok = strtok_r(NULL, " \t\n", &save);
+		if (heap->index < 0 || heap->index >= zone->count || !tok)
+			goto err;
+
+		heap->caps = strtoul(tok, NULL, 0);
+		while ((tok = strtok_r(NULL, " \t\n", &save))) {
+			if (sscanf(tok, "%ix%i", &size, &count) == 2) {
+				if (heap->blocks == HEAPSIM_MAX_BLOCKS ||
+				    size > UINT16_MAX || count > UINT16_MAX)
+					goto err;
+
+				heap->block_size[heap->blocks] = size;
+				heap->block_count[heap->blocks] = count;
+				heap->blocks++;
+			} else {
+				heap->size = strtoul(tok, NULL, 0);
+			}
+		}
+
+		sim->heaps++;
+	}
+
+	fclose(f);
+	return 0;
+
+err:
+	fprintf(stderr, "error: %s:%d: invalid memory map line\n", name, n);
+	fclose(f);
+	return -EINVAL;
+}
+
+/* build the struct mm of the memory map the same way the platforms do */
+static int heapsim_init_memmap(struct heapsim *sim)
+{
+	struct mm *memmap = &heapsim_memmap;
+	struct heapsim_heap *cfg;
+	struct mm_heap *heap;
+	struct block_map *map;
+	uint32_t base = HEAPSIM_HEAP_BASE;
+	int i, j;
+
+	heapsim_sof.memory_map = memmap;
+
+	for (i = 0; i < sim->heaps; i++) {
+		cfg = &sim->heap[i];
+		heap = heapsim_zone_heaps(memmap, cfg->zone) + cfg->index;
+		if (heap->size) {
+			fprintf(stderr, "error: heap %d of zone %d defined twice\n", cfg->index,
+				cfg->zone);
+			return -EINVAL;
+		}
+
+		sim->mm_heap[i] = heap;
+		heap->caps = cfg->caps;
+
+		/* the system heaps hold the allocator bitmaps so they need memory */
+		if (!cfg->blocks) {
+			heap->heap = (uintptr_t)calloc(cfg->size, 1);
+			if (!heap->heap)
+				return -ENOMEM;
+
+			heap->size = cfg->size;
+			heap->info.free = cfg->size;
+			continue;
+		}
+
+		map = calloc(cfg->blocks, sizeof(*map));
+		if (!map)
+			return -ENOMEM;
+
+		heap->map = map;
+		heap->blocks = cfg->blocks;
+		heap->heap = base;
+		for (j = 0; j < cfg->blocks; j++) {
+			map[j].block_size = cfg->block_size[j];
+			map[j].count = cfg->block_count[j];
+			map[j].free_count = cfg->block_count[j];
+			map[j].block = calloc(cfg->block_count[j] + 1, sizeof(struct block_hdr));
+			if (!map[j].block)
+				return -ENOMEM;
+
+			heap->size += cfg->block_size[j] * cfg->block_count[j];
+		}
+
+		heap->info.free = heap->size;
+		base = ALIGN_UP(base + heap->size, HEAPSIM_HEAP_ALIGN);
+	}
+
+	if (!memmap->system[0].size) {
+		fprintf(stderr, "error: no primary core system heap in the memory map\n");
+		return -EINVAL;
+	}
+
+	/* init_heap() expects a map in every block heap, leave the unused ones empty */
+	for (i = 0; i < ARRAY_SIZE(heapsim_zones); i++) {
+		if (heapsim_zones[i].zone == SOF_MEM_ZONE_SYS ||
+		    heapsim_zones[i].zone == SOF_MEM_ZONE_SYS_SHARED)
+			continue;
+
+		heap = heapsim_zone_heaps(memmap, heapsim_zones[i].zone);
+		for (j = 0; j < heapsim_zones[i].count; j++)
+			if (!heap[j].map)
+				heap[j].map = &heapsim_empty_map;
+	}
+
+	/* e.g. no room for the free block bitmaps in the system heap */
+	if (setjmp(heapsim_panic_jmp)) {
+		fprintf(stderr, "error: the allocator panicked in init_heap()\n");
+		return -EINVAL;
+	}
+
+	init_heap(&heapsim_sof);
+	return 0;
+}
+
+static struct heapsim_ptr *heapsim_ptr_slot(struct heapsim *sim, uintptr_t key)
+{
+	size_t i = (key >> 3) & (sim->ptrs_size - 1);
+
+	while (sim->ptrs[i].key && sim->ptrs[i].key != key)
+		i = (i + 1) & (sim->ptrs_size - 1);
+
+	return &sim->ptrs[i];
+}
+
+static int heapsim_ptr_add(struct heapsim *sim, uintptr_t key, void *ptr)
+{
+	struct heapsim_ptr *old = sim->ptrs;
+	size_t old_size = sim->ptrs_size;
+	struct heapsim_ptr *slot;
+	size_t i;
+
+	if (!key)
+		return 0;
+
+	/* keep the table at most half full */
+	if (2 * (sim->ptrs_used + 1) > sim->ptrs_size) {
+		sim->ptrs_size = old_size ? 2 * old_size : 1024;
+		sim->ptrs = calloc(sim->ptrs_size, sizeof(*sim->ptrs));
+		if (!sim->ptrs)
+			return -ENOMEM;
+
+		for (i = 0; i < old_size; i++)
+			if (old[i].key)
+				*heapsim_ptr_slot(sim, old[i].key) = old[i];
+
+		free(old);
+	}
+
+	slot = heapsim_ptr_slot(sim, key);
+	if (!slot->key)
+		sim->ptrs_used++;
+
+	slot->key = key;
+	slot->ptr = ptr;
+	return 0;
+}
+
+/* remove the pointer and return the simulated one */
+static void *heapsim_ptr_remove(struct heapsim *sim, uintptr_t key)
+{
+	struct heapsim_ptr *slot;
+	struct heapsim_ptr entry;
+	void *ptr;
+	size_t i;
+
+	if (!key || !sim->ptrs_size)
+		return NULL;
+
+	slot = heapsim_ptr_slot(sim, key);
+	if (!slot->key)
+		return NULL;
+
+	ptr = slot->ptr;
+	slot->key = 0;
+	sim->ptrs_used--;
+
+	/* re-insert the rest of the cluster */
+	i = (slot - sim->ptrs + 1) & (sim->ptrs_size - 1);
+	while (sim->ptrs[i].key) {
+		entry = sim->ptrs[i];
+		sim->ptrs[i].key = 0;
+		*heapsim_ptr_slot(sim, entry.key) = entry;
+		i = (i + 1) & (sim->ptrs_size - 1);
+	}
+
+	return ptr;
+}
+
+static uint64_t heapsim_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void heapsim_account(struct heapsim *sim, enum heapsim_call call, uint64_t start,
+			    bool fail)
+{
+	struct heapsim_cost *cost = &sim->cost[call];
+	uint64_t ns = heapsim_now_ns() - start;
+	int i;
+
+	cost->count++;
+	cost->total_ns += ns;
+	cost->max_ns = MAX(cost->max_ns, ns);
+	if (fail) {
+		cost->fails++;
+		if (sim->verbose)
+			fprintf(stderr, "line %d: %s failed\n", sim->line,
+				heapsim_call_names[call]);
+	}
+
+	for (i = 0; i < sim->heaps; i++)
+		sim->peak[i] = MAX(sim->peak[i], sim->mm_heap[i]->info.used);
+}
+
+/* replay one trace line, see src/platform/library/lib/alloc.c for the format */
+static int heapsim_replay_line(struct heapsim *sim, const char *line)
+{
+	uint32_t flags, caps, alignment;
+	uintptr_t key, old_key;
+	size_t bytes, old_bytes;
+	uint64_t start;
+	void *ptr;
+	int zone;
+
+	switch (line[0]) {
+	case 'm':
+	case 'z':
+		if (sscanf(line + 1, "%d %" SCNx32 " %" SCNx32 " %zu %" SCNxPTR,
+			   &zone, &flags, &caps, &bytes, &key) != 5)
+			return -EINVAL;
+
+		start = heapsim_now_ns();
+		ptr = rmalloc(zone, flags, caps, bytes);
+
+		heapsim_account(sim, HEAPSIM_RMALLOC, start, !ptr);
+		break;
+	case 'b':
+		if (sscanf(line + 1, "%" SCNx32 " %" SCNx32 " %zu %" SCNu32 " %" SCNxPTR,
+			   &flags, &caps, &bytes, &alignment, &key) != 5)
+			return -EINVAL;
+
+		start = heapsim_now_ns();
+		ptr = rballoc_align(flags, caps, bytes, alignment);
+		heapsim_account(sim, HEAPSIM_RBALLOC, start, !ptr);
+		break;
+	case 'r':
+		if (sscanf(line + 1, "%" SCNxPTR " %" SCNx32 " %" SCNx32 " %zu %zu %" SCNu32
+			   " %" SCNxPTR, &old_key, &flags, &caps, &bytes, &old_bytes, &alignment,
+			   &key) != 7)
+			return -EINVAL;
+
+		ptr = heapsim_ptr_remove(sim, old_key);
+		start = heapsim_now_ns();
+		ptr = rbrealloc_align(ptr, flags | SOF_MEM_FLAG_NO_COPY, caps, bytes, old_bytes,
+				      alignment);
+		heapsim_account(sim, HEAPSIM_RBREALLOC, start, !ptr);
+		break;
+	case 'f':
+		if (sscanf(line + 1, "%" SCNxPTR, &key) != 1)
+			return -EINVAL;
+
+		ptr = heapsim_ptr_remove(sim, key);
+		start = heapsim_now_ns();
+		rfree(ptr);
+		heapsim_account(sim, HEAPSIM_RFREE, start, false);
+		return 0;
+	default:
+		return -EINVAL;
+	}
+
+	/* allocations that failed in the simulator are dropped from the trace */
+	return ptr ? heapsim_ptr_add(sim, key, ptr) : 0;
+}
+
+static int heapsim_replay(struct heapsim *sim, const char *name)
+{
+	char line[HEAPSIM_LINE_SIZE];
+	FILE *f;
+	int ret;
+
+	f = fopen(name, "r");
+	if (!f) {
+		fprintf(stderr, "error: can't open allocation trace %s\n", name);
+		return -errno;
+	}
+
+	while (fgets(line, sizeof(line), f)) {
+		sim->line++;
+
+		/* the allocator state is consistent at its panic points */
+		if (setjmp(heapsim_panic_jmp)) {
+			sim->panics++;
+			if (sim->verbose)
+				fprintf(stderr, "line %d: allocator panic\n", sim->line);
+			continue;
+		}
+
+		ret = heapsim_replay_line(sim, line);
+		if (ret < 0) {
+			fprintf(stderr, "error: %s:%d: invalid trace line\n", name, sim->line);
+			fclose(f);
+			return ret;
+		}
+	}
+
+	fclose(f);
+	return 0;
+}
+
+static void heapsim_report(struct heapsim *sim)
+{
+	const struct heapsim_cost *cost;
+	const struct heapsim_heap *heap;
+	struct mm_info info;
+	int i, j;
+
+	printf("%-14s %5s %9s %9s %9s %9s %9s %8s %6s\n", "zone", "index", "size", "peak",
+	       "used", "free", "free max", "allocs", "fails");
+	for (i = 0; i < sim->heaps; i++) {
+		heap = &sim->heap[i];
+		if (heap_info(heap->zone, heap->index, &info) < 0)
+			continue;
+
+		for (j = 0; heapsim_zones[j].zone != heap->zone; j++)
+			;
+
+		printf("%-14s %5d %9u %9u %9u %9u %9u %8u %6u\n", heapsim_zones[j].name,
+		       heap->index, sim->mm_heap[i]->size, sim->peak[i], info.used, info.free,
+		       info.free_max, info.alloc_count, info.fail_count);
+	}
+
+	printf("\n%-10s %10s %8s %10s %10s\n", "call", "count", "fails", "avg ns", "max ns");
+	for (i = 0; i < HEAPSIM_CALLS; i++) {
+		cost = &sim->cost[i];
+		if (!cost->count)
+			continue;
+
+		printf("%-10s %10" PRIu64 " %8" PRIu64 " %10" PRIu64 " %10" PRIu64 "\n",
+		       heapsim_call_names[i], cost->count, cost->fails,
+		       cost->total_ns / cost->count, cost->max_ns);
+	}
+
+	if (sim->panics)
+		printf("\n%d calls made the allocator panic\n", sim->panics);
+}
+
+static void heapsim_usage(char *name)
+{
+	printf("Usage: %s [-m <memory map>] [-v] <allocation trace>\n\n", name);
+	printf("Replay an allocation trace recorded by running the testbench with\n");
+	printf("SOF_ALLOC_TRACE=<file> against the firmware heap allocator.\n\n");
+	printf("  -m <file> memory map, lines of \"<zone> <index> <caps> <size>\" for system\n");
+	printf("            heaps and \"<zone> <index> <caps> <block size>x<count> ...\"\n");
+	printf("            for the others, the library platform map is used by default\n");
+	printf("  -v        trace the failing calls\n");
+	printf("  -h        help\n");
+}
+
+int main(int argc, char **argv)
+{
+	struct heapsim *sim;
+	char *map = NULL;
+	int option;
+	int ret;
+
+	sim = calloc(1, sizeof(*sim));
+	if (!sim)
+		return EXIT_FAILURE;
+
+	while ((option = getopt(argc, argv, "hm:v")) != -1) {
+		switch (option) {
+		case 'm':
+			map = optarg;
+			break;
+		case 'v':
+			sim->verbose = 1;
+			break;
+		case 'h':
+		default:
+			heapsim_usage(argv[0]);
+			free(sim);
+			return option == 'h' ? EXIT_SUCCESS : EXIT_FAILURE;
+		}
+	}
+
+	if (optind != argc - 1) {
+		heapsim_usage(argv[0]);
+		free(sim);
+		return EXIT_FAILURE;
+	}
+
+	if (map) {
+		ret = heapsim_parse_map(sim, map);
+		if (ret < 0)
+			goto out;
+	} else {
+		memcpy_s(sim->heap, sizeof(sim->heap), heapsim_default_map,
+			 sizeof(heapsim_default_map));
+		sim->heaps = ARRAY_SIZE(heapsim_default_map);
+	}
+
+	ret = heapsim_init_memmap(sim);
+	if (ret < 0)
+		goto out;
+
+	ret = heapsim_replay(sim, argv[optind]);
+	if (ret < 0)
+		goto out;
+
+	heapsim_report(sim);
+
+out:
+	free(sim->ptrs);
+	free(sim);
+	return ret < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -57,10 +57,14 @@ struct testbench_prm {
 	int tick_period_us;
 	int pipeline_duration_ms;
 	int real_time;
-	FILE *file;
 	char *pipeline_string;
 	int output_file_index;
 	int input_file_index;
+	char *profile_file; /* component profile CSV or JSON output */
+
+	/* batch mode */
+	char *batch_file; /* manifest with one job per line */
+	int batch_workers; /* number of jobs to run in parallel */
 
 	/* global cmd line args that can override topology */
 	enum sof_ipc_frame cmd_frame_fmt;
@@ -89,6 +93,8 @@ void sys_comp_file_init(void);
 
 void sys_comp_filewrite_init(void);
 
+void register_all_comps(void);
+
 int tb_setup(struct sof *sof, struct testbench_prm *tp);
 void tb_free(struct sof *sof);
 
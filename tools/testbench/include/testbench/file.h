@@ -11,6 +11,9 @@
 #ifndef _FILE_H
 #define _FILE_H
 
+#include <stdint.h>
+#include <sys/types.h>
+
 /**< Convert with right shift a bytes count to samples count */
 #define FILE_BYTES_TO_S16_SAMPLES(s)	((s) >> 1)
 #define FILE_BYTES_TO_S32_SAMPLES(s)	((s) >> 2)
@@ -25,12 +28,30 @@ enum file_mode {
 enum file_format {
 	FILE_TEXT = 0,
 	FILE_RAW,
+	FILE_WAV,
+};
+
+/* Output files are mapped a window at a time, the file is extended as the window moves */
+#define FILE_MAP_WINDOW_SIZE	(16 * 1024 * 1024)
+
+/*
+ * Memory mapped file. Regular input files are mapped whole and output files
+ * one window at a time. The stdio handles are used when the file can't be
+ * mapped, e.g. for a pipe.
+ */
+struct file_map {
+	uint8_t *addr;	/* mapped data, NULL if not mapped */
+	size_t size;	/* mapped length */
+	size_t pos;	/* read or write position in mapping */
+	off_t offset;	/* file offset of the mapping */
 };
 
 /* file component state */
 struct file_state {
 	char *fn;
 	FILE *rfh, *wfh; /* read/write file handle */
+	struct file_map map;
+	size_t data_left; /* input bytes left, WAV data chunk can end before the file */
 	bool reached_eof;
 	bool write_failed;
 	int n;
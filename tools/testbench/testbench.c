@@ -15,8 +15,11 @@
 #include <tplg_parser/topology.h>
 #include "testbench/trace.h"
 #include "testbench/file.h"
+#include <inttypes.h>
 #include <limits.h>
 #include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #ifdef TESTBENCH_CACHE_CHECK
 #include <arch/lib/cache.h>
@@ -71,10 +74,25 @@ DECLARE_SOF_TB_UUID("mfcc", mfcc_uuid, 0xdb10a773, 0x1aa4, 0x4cea,
 
 #define TESTBENCH_NCH 2 /* Stereo */
 
+#define BATCH_MAX_ARGS	64
+
 struct pipeline_thread_data {
 	struct testbench_prm *tp;
 	int count;			/* copy iteration count */
 	int core_id;
+	int err;			/* result of the last pipeline run */
+};
+
+/* batch mode jobs */
+struct tb_batch {
+	struct testbench_prm *jobs;
+	int num_jobs;
+};
+
+/* batch mode worker slot, a forked process running one job */
+struct tb_batch_slot {
+	pid_t pid;
+	int job;
 };
 
 /* shared library look up table */
@@ -249,21 +267,29 @@ static void print_usage(char *executable)
 	printf("  -D <pipeline duration in ms>\n");
 	printf("  -P <number of dynamic pipeline iterations>\n");
 	printf("  -T <microseconds for tick, 0 for batch mode>\n");
-	printf("  -V <number of virtual cores>\n\n");
+	printf("  -V <number of virtual cores>\n");
+	printf("  -B <job manifest>, run the jobs listed in manifest, one per line\n");
+	printf("  -j <number of jobs to run in parallel with -B>\n");
+	printf("  -M <profile file>, write component copy() profile as .json or CSV\n\n");
 	printf("Options for input and output format override:\n");
 	printf("  -b <input_format>, S16_LE, S24_LE, or S32_LE\n");
 	printf("  -c <input channels>\n");
 	printf("  -n <output channels>\n");
 	printf("  -r <input rate>\n");
 	printf("  -R <output rate>\n\n");
+	printf("Files ending with .txt are text, .wav are RIFF WAVE and others raw binary.\n\n");
+	printf("Job manifest lines take the options -t -i -o -b -r -R -c -n -p -C -M,\n");
+	printf("options not given on the line except -M are taken from the command line.\n\n");
 	printf("Environment variables\n");
 	printf("  SOF_HOST_CORE0=<i> - Map DSP core 0..N to host i..i+N\n");
+	printf("  SOF_ALLOC_TRACE=<file> - Record heap calls for replay with heapsim\n");
 	printf("Help:\n");
 	printf("  -h\n\n");
 	printf("Example Usage:\n");
 	printf("%s -i in.txt -o out.txt -t test.tplg ", executable);
 	printf("-r 48000 -R 96000 -c 2 ");
 	printf("-b S16_LE -a volume=libsof_volume.so\n");
+	printf("%s -q -B jobs.txt -j 8 -b S32_LE\n", executable);
 }
 
 /* free components */
@@ -394,12 +420,149 @@ static void test_pipeline_get_file_stats(int pipeline_id)
 	}
 }
 
+/* copy() cost totals of a component or a pipeline */
+struct tb_comp_profile {
+	uint64_t cycles;
+	uint64_t time_ns;
+	uint64_t peak_ns;
+	uint64_t copies;
+};
+
+static void test_profile_add(struct tb_comp_profile *prof, const struct comp_copy_stats *stats)
+{
+	prof->cycles += stats->cycles;
+	prof->time_ns += stats->time_ns;
+	prof->peak_ns = MAX(prof->peak_ns, stats->peak_ns);
+	prof->copies += stats->copies;
+}
+
+/* Print one profile line, MCPS is the cycles per second of processed audio */
+static void test_profile_print(FILE *csv, FILE *json, int run, int pipeline_id, int comp_id,
+			       const char *name, const struct tb_comp_profile *prof,
+			       double audio_time)
+{
+	double mcycles = prof->cycles / 1e6;
+	double mcps = audio_time > 0 ? mcycles / audio_time : 0;
+	uint64_t avg_ns = prof->copies ? prof->time_ns / prof->copies : 0;
+
+	printf("%8d %6d  %-16s %8" PRIu64 " %10" PRIu64 " %8.2f %8.2f %10.2f %8.2f\n",
+	       pipeline_id, comp_id, name, prof->copies, prof->time_ns / 1000,
+	       avg_ns / 1000.0, prof->peak_ns / 1000.0, mcycles, mcps);
+
+	if (csv)
+		fprintf(csv, "%d,%d,%d,%s,%" PRIu64 ",%" PRIu64 ",%.3f,%.3f,%.3f,%.3f\n",
+			run, pipeline_id, comp_id, name, prof->copies, prof->time_ns / 1000,
+			avg_ns / 1000.0, prof->peak_ns / 1000.0, mcycles, mcps);
+
+	if (json) {
+		fprintf(json, "{\"id\":%d,\"name\":\"%s\",\"copies\":%" PRIu64 ",",
+			comp_id, name, prof->copies);
+		fprintf(json, "\"time_us\":%" PRIu64 ",\"avg_us\":%.3f,\"peak_us\":%.3f,",
+			prof->time_ns / 1000, avg_ns / 1000.0, prof->peak_ns / 1000.0);
+		fprintf(json, "\"mcycles\":%.3f,\"mcps\":%.3f}", mcycles, mcps);
+	}
+}
+
+/*
+ * Print copy() cost of each component and pipeline run by this thread.
+ * The optional profile file gets the same as CSV, or as one JSON object
+ * per run if the file name ends with .json. Pipeline totals have
+ * component id -1.
+ */
+static void test_pipeline_get_comp_stats(struct pipeline_thread_data *ptdata, double audio_time)
+{
+	struct testbench_prm *tp = ptdata->tp;
+	struct tb_comp_profile pipe_prof;
+	struct tb_comp_profile comp_prof;
+	struct ipc_comp_dev *icd;
+	struct list_item *clist;
+	struct comp_dev *cd;
+	const char *ext;
+	const char *name;
+	FILE *csv = NULL;
+	FILE *json = NULL;
+	FILE *file = NULL;
+	bool first;
+	int i;
+
+	if (tp->profile_file) {
+		/* the first run creates the file, next runs append to it */
+		file = fopen(tp->profile_file, ptdata->count ? "a" : "w");
+		if (!file) {
+			fprintf(stderr, "error: opening profile file %s - %s\n",
+				tp->profile_file, strerror(errno));
+		} else {
+			ext = strrchr(tp->profile_file, '.');
+			if (ext && !strcmp(ext, ".json"))
+				json = file;
+			else
+				csv = file;
+		}
+	}
+
+	if (csv && !ptdata->count)
+		fprintf(csv, "run,pipeline,comp,name,copies,time_us,avg_us,peak_us,mcycles,mcps\n");
+
+	if (json)
+		fprintf(json, "{\"run\":%d,\"audio_s\":%.6f,\"pipelines\":[",
+			ptdata->count, audio_time);
+
+	printf("Component copy() profile for %.3f s of audio:\n", audio_time);
+	printf("%8s %6s  %-16s %8s %10s %8s %8s %10s %8s\n", "pipeline", "comp", "name",
+	       "copies", "total us", "avg us", "peak us", "Mcycles", "MCPS");
+
+	for (i = 0; i < tp->pipeline_num; i++) {
+		memset(&pipe_prof, 0, sizeof(pipe_prof));
+		first = true;
+		if (json)
+			fprintf(json, "%s{\"id\":%d,\"components\":[", i ? "," : "",
+				tp->pipelines[i]);
+
+		list_for_item(clist, &sof_get()->ipc->comp_list) {
+			icd = container_of(clist, struct ipc_comp_dev, list);
+			if (icd->type != COMP_TYPE_COMPONENT)
+				continue;
+
+			cd = icd->cd;
+			if (!cd->pipeline || cd->pipeline->pipeline_id != tp->pipelines[i] ||
+			    cd->ipc_config.core != ptdata->core_id)
+				continue;
+
+			name = cd->drv->tctx ? cd->drv->tctx->uuid_p->name : "unknown";
+			memset(&comp_prof, 0, sizeof(comp_prof));
+			test_profile_add(&comp_prof, &cd->copy_stats);
+			test_profile_add(&pipe_prof, &cd->copy_stats);
+			if (json && !first)
+				fprintf(json, ",");
+
+			test_profile_print(csv, json, ptdata->count, tp->pipelines[i],
+					   cd->ipc_config.id, name, &comp_prof, audio_time);
+			first = false;
+		}
+
+		if (json)
+			fprintf(json, "],\"total\":");
+
+		test_profile_print(csv, json, ptdata->count, tp->pipelines[i], -1, "total",
+				   &pipe_prof, audio_time);
+		if (json)
+			fprintf(json, "}");
+	}
+
+	printf("\n");
+	if (json)
+		fprintf(json, "]}\n");
+
+	if (file)
+		fclose(file);
+}
+
 static int parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 {
 	int option = 0;
 	int ret = 0;
 
-	while ((option = getopt(argc, argv, "hdqi:o:t:b:a:r:R:c:n:C:P:Vp:T:D:")) != -1) {
+	while ((option = getopt(argc, argv, "hdqi:o:t:b:a:r:R:c:n:C:P:Vp:T:D:B:j:M:")) != -1) {
 		switch (option) {
 		/* input sample file */
 		case 'i':
@@ -487,6 +650,21 @@ static int parse_input_args(int argc, char **argv, struct testbench_prm *tp)
 			tp->pipeline_duration_ms = atoi(optarg);
 			break;
 
+		/* batch mode job manifest */
+		case 'B':
+			tp->batch_file = strdup(optarg);
+			break;
+
+		/* number of batch mode workers */
+		case 'j':
+			tp->batch_workers = atoi(optarg);
+			break;
+
+		/* component profile output file */
+		case 'M':
+			tp->profile_file = strdup(optarg);
+			break;
+
 		/* print usage */
 		default:
 			fprintf(stderr, "unknown option %c\n", option);
@@ -649,7 +827,6 @@ static int test_pipeline_load(struct pipeline_thread_data *ptdata, struct tplg_c
 	memset(ctx, 0, sizeof(*ctx));
 	ctx->comp_id = 1000 * ptdata->core_id;
 	ctx->core_id = ptdata->core_id;
-	ctx->file = tp->file;
 	ctx->sof = sof_get();
 	ctx->tp = tp;
 	ctx->tplg_file = tp->tplg_file;
@@ -737,6 +914,8 @@ static void test_pipeline_stats(struct pipeline_thread_data *ptdata,
 	printf("Output sample (frame) count: %d (%d)\n", n_out, n_out / ctx->channels_out);
 	printf("Total execution time: %zu us, %.2f x realtime\n\n",
 	       delta, (double)((double)n_out / ctx->channels_out / ctx->fs_out) * 1000000 / delta);
+
+	test_pipeline_get_comp_stats(ptdata, (double)n_out / ctx->channels_out / ctx->fs_out);
 }
 
 /*
@@ -751,7 +930,7 @@ static void *pipline_test(void *data)
 	struct tplg_context ctx;
 	struct timespec ts;
 	struct timespec td0, td1;
-	int err;
+	int err = 0;
 	int nsleep_time;
 	int nsleep_limit;
 	uint64_t delta;
@@ -844,9 +1023,320 @@ static void *pipline_test(void *data)
 		dp_count++;
 	}
 
+	ptdata->err = err;
 	return NULL;
 }
 
+/* free the file names and other allocated testbench parameters */
+static void test_prm_free(struct testbench_prm *tp)
+{
+	int i;
+
+	free(tp->bits_in);
+	free(tp->tplg_file);
+	for (i = 0; i < tp->output_file_num; i++)
+		free(tp->output_file[i]);
+
+	for (i = 0; i < tp->input_file_num; i++)
+		free(tp->input_file[i]);
+
+	free(tp->pipeline_string);
+	free(tp->profile_file);
+}
+
+/*
+ * Parse one batch manifest line into job parameters. The line has the
+ * command line options of a single run, e.g.
+ * "-t eq.tplg -i in.raw -o out.raw -r 48000". Options that are not on
+ * the line are taken from the testbench command line.
+ */
+static int parse_batch_job(char *line, struct testbench_prm *job,
+			   const struct testbench_prm *tp)
+{
+	char *argv[BATCH_MAX_ARGS + 1];
+	char *line_token = NULL;
+	char *token;
+	int argc = 0;
+	int option;
+	int ret = 0;
+
+	/* start from command line parameters, files are per job */
+	*job = *tp;
+	memset(job->input_file, 0, sizeof(job->input_file));
+	memset(job->output_file, 0, sizeof(job->output_file));
+	job->input_file_num = 0;
+	job->output_file_num = 0;
+	job->tplg_file = tp->tplg_file ? strdup(tp->tplg_file) : NULL;
+	job->bits_in = tp->bits_in ? strdup(tp->bits_in) : NULL;
+	job->batch_file = NULL;
+	job->profile_file = NULL;
+	job->pipeline_string = calloc(1, DEBUG_MSG_LEN);
+	if (!job->pipeline_string)
+		return -ENOMEM;
+
+	argv[argc++] = "job";
+	token = strtok_r(line, " \t\r\n", &line_token);
+	while (token) {
+		if (argc == BATCH_MAX_ARGS) {
+			fprintf(stderr, "error: max job argument number is %d\n",
+				BATCH_MAX_ARGS - 1);
+			return -EINVAL;
+		}
+
+		argv[argc++] = token;
+		token = strtok_r(NULL, " \t\r\n", &line_token);
+	}
+	argv[argc] = NULL;
+
+	/* reset getopt() for the new argument vector */
+	optind = 0;
+	while ((option = getopt(argc, argv, "i:o:t:b:r:R:c:n:p:C:M:")) != -1) {
+		switch (option) {
+		case 'i':
+			ret = parse_input_files(optarg, job);
+			break;
+		case 'o':
+			ret = parse_output_files(optarg, job);
+			break;
+		case 't':
+			free(job->tplg_file);
+			job->tplg_file = strdup(optarg);
+			break;
+		case 'b':
+			free(job->bits_in);
+			job->bits_in = strdup(optarg);
+			job->cmd_frame_fmt = find_format(job->bits_in);
+			break;
+		case 'r':
+			job->cmd_fs_in = atoi(optarg);
+			break;
+		case 'R':
+			job->cmd_fs_out = atoi(optarg);
+			break;
+		case 'c':
+			job->cmd_channels_in = atoi(optarg);
+			break;
+		case 'n':
+			job->cmd_channels_out = atoi(optarg);
+			break;
+		case 'p':
+			ret = parse_pipelines(optarg, job);
+			break;
+		case 'C':
+			job->copy_iterations = atoi(optarg);
+			job->copy_check = true;
+			break;
+		case 'M':
+			free(job->profile_file);
+			job->profile_file = strdup(optarg);
+			break;
+		default:
+			return -EINVAL;
+		}
+
+		if (ret < 0)
+			return ret;
+	}
+
+	if (optind < argc) {
+		fprintf(stderr, "error: unexpected job argument %s\n", argv[optind]);
+		return -EINVAL;
+	}
+
+	if (!job->tplg_file || !job->input_file_num || !job->output_file_num ||
+	    !job->bits_in) {
+		fprintf(stderr, "error: job needs -t, -i, -o and -b\n");
+		return -EINVAL;
+	}
+
+	if (!job->cmd_channels_out)
+		job->cmd_channels_out = job->cmd_channels_in;
+
+	return 0;
+}
+
+/* read all jobs from the batch manifest, empty and # comment lines are skipped */
+static int parse_batch_file(struct tb_batch *batch, const struct testbench_prm *tp)
+{
+	struct testbench_prm *jobs;
+	FILE *file;
+	char *line = NULL;
+	char *start;
+	size_t line_size = 0;
+	int line_num = 0;
+	int ret = 0;
+
+	file = fopen(tp->batch_file, "r");
+	if (!file) {
+		fprintf(stderr, "error: opening batch file %s: %s\n",
+			tp->batch_file, strerror(errno));
+		return -errno;
+	}
+
+	while (getline(&line, &line_size, file) > 0) {
+		line_num++;
+		start = line + strspn(line, " \t\r\n");
+		if (!*start || *start == '#')
+			continue;
+
+		jobs = realloc(batch->jobs, sizeof(*jobs) * (batch->num_jobs + 1));
+		if (!jobs) {
+			ret = -ENOMEM;
+			break;
+		}
+		batch->jobs = jobs;
+
+		ret = parse_batch_job(start, &jobs[batch->num_jobs], tp);
+		if (ret < 0) {
+			fprintf(stderr, "error: %s:%d: invalid job\n",
+				tp->batch_file, line_num);
+			test_prm_free(&jobs[batch->num_jobs]);
+			break;
+		}
+
+		batch->num_jobs++;
+	}
+
+	free(line);
+	fclose(file);
+	return ret;
+}
+
+/*
+ * Run one batch job in a child process. The child inherits the initialized
+ * firmware and the loaded component libraries, so only the topology of the
+ * job is loaded and no state is left behind for the next job.
+ */
+static pid_t batch_fork(struct tb_batch *batch, int job, int worker)
+{
+	struct pipeline_thread_data ptdata;
+	const char *host_core_env;
+	char host_core[16];
+	long cpus;
+	pid_t pid;
+
+	/* don't let the child inherit and print again buffered output */
+	fflush(stdout);
+	fflush(stderr);
+
+	pid = fork();
+	if (pid < 0)
+		fprintf(stderr, "error: can't fork batch job %d %s\n", job, strerror(errno));
+	if (pid)
+		return pid;
+
+	/* each worker slot runs its LL scheduler thread on its own host core */
+	host_core_env = getenv("SOF_HOST_CORE0");
+	cpus = MAX(sysconf(_SC_NPROCESSORS_ONLN), 1);
+	snprintf(host_core, sizeof(host_core), "%ld",
+		 ((host_core_env ? atoi(host_core_env) : 0) + worker) % cpus);
+	setenv("SOF_HOST_CORE0", host_core, 1);
+
+	ptdata.tp = &batch->jobs[job];
+	ptdata.core_id = 0;
+	ptdata.count = job;
+	ptdata.err = 0;
+	pipline_test(&ptdata);
+
+	exit(ptdata.err < 0 ? EXIT_FAILURE : EXIT_SUCCESS);
+}
+
+/*
+ * Run the jobs of the batch manifest with at most batch_workers jobs at
+ * a time. The firmware is initialized and the component libraries are
+ * loaded once and each job is then started with fork() instead of a new
+ * testbench process.
+ */
+static int test_batch(struct testbench_prm *tp)
+{
+	struct tb_batch batch = {0};
+	struct tb_batch_slot *slots;
+	struct timespec td0, td1;
+	uint64_t delta;
+	pid_t pid;
+	int status;
+	int workers;
+	int next_job = 0;
+	int running = 0;
+	int failed = 0;
+	int ret;
+	int i;
+
+	ret = parse_batch_file(&batch, tp);
+	if (ret < 0)
+		goto out;
+
+	workers = tp->batch_workers;
+	if (workers < 1)
+		workers = sysconf(_SC_NPROCESSORS_ONLN);
+	workers = MAX(MIN(workers, batch.num_jobs), 1);
+
+	slots = calloc(workers, sizeof(*slots));
+	if (!slots) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	register_all_comps();
+
+	clock_gettime(CLOCK_MONOTONIC, &td0);
+	while (next_job < batch.num_jobs || running) {
+		/* start jobs in the free worker slots */
+		for (i = 0; i < workers && next_job < batch.num_jobs; i++) {
+			if (slots[i].pid > 0)
+				continue;
+
+			slots[i].job = next_job++;
+			slots[i].pid = batch_fork(&batch, slots[i].job, i);
+			if (slots[i].pid > 0)
+				running++;
+			else
+				failed++;
+		}
+
+		if (!running)
+			continue;
+
+		pid = wait(&status);
+		if (pid < 0) {
+			fprintf(stderr, "error: batch wait %s\n", strerror(errno));
+			ret = -errno;
+			break;
+		}
+
+		for (i = 0; i < workers; i++) {
+			if (slots[i].pid != pid)
+				continue;
+
+			slots[i].pid = 0;
+			running--;
+			if (!WIFEXITED(status) || WEXITSTATUS(status) != EXIT_SUCCESS) {
+				fprintf(stderr, "error: batch job %d failed, status 0x%x\n",
+					slots[i].job, status);
+				failed++;
+			}
+			break;
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &td1);
+
+	delta = (td1.tv_sec - td0.tv_sec) * 1000000;
+	delta += (td1.tv_nsec - td0.tv_nsec) / 1000;
+	printf("Batch: %d jobs, %d failed, %d workers, total execution time %zu us\n",
+	       batch.num_jobs, failed, workers, delta);
+
+	if (failed)
+		ret = -EINVAL;
+
+	free(slots);
+out:
+	for (i = 0; i < batch.num_jobs; i++)
+		test_prm_free(&batch.jobs[i]);
+
+	free(batch.jobs);
+	return ret;
+}
+
 static struct testbench_prm tp;
 
 int main(int argc, char **argv)
@@ -887,6 +1377,23 @@ int main(int argc, char **argv)
 	if (err < 0)
 		goto out;
 
+	if (tp.quiet)
+		tb_enable_trace(false); /* reduce trace output */
+	else
+		tb_enable_trace(true);
+
+	/* batch mode runs the jobs from the manifest and its own checks */
+	if (tp.batch_file) {
+		if (tb_setup(sof_get(), &tp) < 0) {
+			fprintf(stderr, "error: pipeline init\n");
+			exit(EXIT_FAILURE);
+		}
+
+		err = test_batch(&tp);
+		tb_free(sof_get());
+		goto out;
+	}
+
 	if (!tp.cmd_channels_out)
 		tp.cmd_channels_out = tp.cmd_channels_in;
 
@@ -925,11 +1432,6 @@ int main(int argc, char **argv)
 			tp.num_vcores = 1;
 	}
 
-	if (tp.quiet)
-		tb_enable_trace(false); /* reduce trace output */
-	else
-		tb_enable_trace(true);
-
 	/* initialize ipc and scheduler */
 	if (tb_setup(sof_get(), &tp) < 0) {
 		fprintf(stderr, "error: pipeline init\n");
@@ -959,15 +1461,8 @@ join:
 
 out:
 	/* free all other data */
-	free(tp.bits_in);
-	free(tp.tplg_file);
-	for (i = 0; i < tp.output_file_num; i++)
-		free(tp.output_file[i]);
-
-	for (i = 0; i < tp.input_file_num; i++)
-		free(tp.input_file[i]);
-
-	free(tp.pipeline_string);
+	test_prm_free(&tp);
+	free(tp.batch_file);
 
 #ifdef TESTBENCH_CACHE_CHECK
 	_cache_free_all();
@@ -979,5 +1474,5 @@ out:
 			dlclose(lib_table[i].handle);
 	}
 
-	return EXIT_SUCCESS;
+	return err < 0 ? EXIT_FAILURE : EXIT_SUCCESS;
 }
@@ -94,6 +94,35 @@ void register_comp(int comp_type, struct sof_ipc_comp_ext *comp_ext)
 
 }
 
+/*
+ * Register all component drivers that have a loadable library. Used by
+ * batch mode to load the libraries once before the jobs are forked.
+ * Libraries that fail to load are skipped, register_comp() reports the
+ * error if a topology later needs them.
+ */
+void register_all_comps(void)
+{
+	int i;
+
+	if (!lib_table[0].register_drv) {
+		sys_comp_file_init();
+		lib_table[0].register_drv = 1;
+	}
+
+	for (i = 1; i < NUM_WIDGETS_SUPPORTED; i++) {
+		if (lib_table[i].register_drv)
+			continue;
+
+		lib_table[i].handle = dlopen(lib_table[i].library_name, RTLD_LAZY);
+		if (!lib_table[i].handle) {
+			debug_print("skipped shared lib that failed to load\n");
+			continue;
+		}
+
+		lib_table[i].register_drv = 1;
+	}
+}
+
 int find_widget(struct comp_info *temp_comp_list, int count, char *name)
 {
 	return 0;
@@ -149,11 +178,6 @@ int tplg_register_buffer(struct tplg_context *ctx)
 	if (ret < 0)
 		return ret;
 
-	if (tplg_create_controls(ctx->widget->num_kcontrols, ctx->file, NULL, 0) < 0) {
-		fprintf(stderr, "error: loading controls\n");
-		return -EINVAL;
-	}
-
 	/* create buffer component */
 	if (ipc_buffer_new(sof->ipc, &buffer) < 0) {
 		fprintf(stderr, "error: buffer new\n");
@@ -165,7 +189,7 @@ int tplg_register_buffer(struct tplg_context *ctx)
 
 /* load pipeline graph DAPM widget*/
 int tplg_register_graph(void *dev, struct comp_info *temp_comp_list,
-			char *pipeline_string, FILE *file,
+			char *pipeline_string, struct snd_soc_tplg_dapm_graph_elem *routes,
 			int count, int num_comps, int pipeline_id)
 {
 	struct sof_ipc_pipe_comp_connect connection;
@@ -175,7 +199,7 @@ int tplg_register_graph(void *dev, struct comp_info *temp_comp_list,
 
 	for (i = 0; i < count; i++) {
 		ret = tplg_create_graph(num_comps, pipeline_id, temp_comp_list,
-				      pipeline_string, &connection, file, i,
+				      pipeline_string, &connection, &routes[i], i,
 				      count);
 		if (ret < 0)
 			return ret;
@@ -257,18 +281,12 @@ int tplg_register_pipeline(struct tplg_context *ctx)
 {
 	struct sof *sof = ctx->sof;
 	struct sof_ipc_pipe_new pipeline = {0};
-	FILE *file = ctx->file;
 	int ret;
 
 	ret = tplg_create_pipeline(ctx, &pipeline);
 	if (ret < 0)
 		return ret;
 
-	if (tplg_create_controls(ctx->widget->num_kcontrols, file, NULL, 0) < 0) {
-		fprintf(stderr, "error: loading controls\n");
-		return -EINVAL;
-	}
-
 	pipeline.sched_id = ctx->sched_id;
 
 	/* Create pipeline */
@@ -310,7 +328,7 @@ int load_process(struct tplg_context *ctx)
 
 	/* Get control into ctl and priv_data */
 	for (i = 0; i < widget->num_kcontrols; i++) {
-		ret = tplg_create_single_control(&ctl, &priv_data, ctx->file);
+		ret = tplg_create_single_control(ctx, i, &ctl, &priv_data);
 
 		if (ret < 0) {
 			fprintf(stderr, "error: failed control load\n");
@@ -321,8 +339,6 @@ int load_process(struct tplg_context *ctx)
 		if (priv_data)
 			ret = tplg_process_append_data(&process_ipc, process, ctl, priv_data);
 
-		free(ctl);
-		free(priv_data);
 		if (ret) {
 			fprintf(stderr, "error: private data append failed\n");
 			free(process_ipc);
@@ -404,21 +420,6 @@ int load_widget(struct tplg_context *ctx)
 		return -EINVAL;
 	}
 
-	/* allocate memory for widget */
-	ctx->widget_size = sizeof(struct snd_soc_tplg_dapm_widget);
-	ctx->widget = malloc(ctx->widget_size);
-	if (!ctx->widget) {
-		fprintf(stderr, "error: mem alloc\n");
-		return -errno;
-	}
-
-	/* read widget data */
-	ret = fread(ctx->widget, ctx->widget_size, 1, ctx->file);
-	if (ret != 1) {
-		ret = -EINVAL;
-		goto exit;
-	}
-
 	/*
 	 * create a list with all widget info
 	 * containing mapping between component names and ids
@@ -521,27 +522,13 @@ int load_widget(struct tplg_context *ctx)
 		break;
 	/* unsupported widgets */
 	default:
-		if (fseek(ctx->file, ctx->widget->priv.size, SEEK_CUR)) {
-			fprintf(stderr, "error: fseek unsupported widget\n");
-			ret = -errno;
-			goto exit;
-		}
-
 		printf("info: Widget type not supported %d\n", ctx->widget->id);
-		ret = tplg_create_controls(ctx->widget->num_kcontrols, ctx->file, NULL, 0);
-		if (ret < 0) {
-			fprintf(stderr, "error: loading controls\n");
-			goto exit;
-		}
-		ret = 0;
 		break;
 	}
 
 	ret = 1;
 
 exit:
-	/* free allocated widget data */
-	free(ctx->widget);
 	return ret;
 }
 
@@ -551,39 +538,15 @@ static int tplg_load_fileread(struct tplg_context *ctx,
 {
 	struct snd_soc_tplg_vendor_array *array = NULL;
 	size_t total_array_size = 0;
-	size_t read_size;
-	FILE *file = ctx->file;
 	int size = ctx->widget->priv.size;
 	int comp_id = ctx->comp_id;
 	int ret;
 
-	/* allocate memory for vendor tuple array */
-	array = (struct snd_soc_tplg_vendor_array *)malloc(size);
-	if (!array) {
-		fprintf(stderr, "error: mem alloc\n");
-		return -errno;
-	}
+	/* vendor tuple arrays are checked when the topology is indexed */
+	array = (struct snd_soc_tplg_vendor_array *)ctx->widget->priv.data;
 
 	/* read vendor tokens */
 	while (total_array_size < size) {
-		read_size = sizeof(struct snd_soc_tplg_vendor_array);
-		ret = fread(array, read_size, 1, file);
-		if (ret != 1) {
-			fprintf(stderr,
-				"error: fread failed during load_fileread\n");
-			free(array);
-			return -EINVAL;
-		}
-
-		if (!is_valid_priv_size(total_array_size, size, array)) {
-			fprintf(stderr, "error: filewrite array size mismatch for widget size %d\n",
-				size);
-			free(array);
-			return -EINVAL;
-		}
-
-		tplg_read_array(array, file);
-
 		/* parse comp tokens */
 		ret = sof_parse_tokens(&fileread->config, comp_tokens,
 				       ARRAY_SIZE(comp_tokens), array,
@@ -591,14 +554,14 @@ static int tplg_load_fileread(struct tplg_context *ctx,
 		if (ret != 0) {
 			fprintf(stderr, "error: parse comp tokens %d\n",
 				size);
-			free(array);
 			return -EINVAL;
 		}
 
 		total_array_size += array->size;
-	}
 
-	free(array);
+		/* read next array */
+		array = MOVE_POINTER_BY_BYTES(array, array->size);
+	}
 
 	/* configure fileread */
 	fileread->mode = FILE_READ;
@@ -618,50 +581,29 @@ static int tplg_load_filewrite(struct tplg_context *ctx,
 			       struct sof_ipc_comp_file *filewrite)
 {
 	struct snd_soc_tplg_vendor_array *array = NULL;
-	size_t read_size;
 	size_t total_array_size = 0;
-	FILE *file = ctx->file;
 	int size = ctx->widget->priv.size;
 	int comp_id = ctx->comp_id;
 	int ret;
 
-	/* allocate memory for vendor tuple array */
-	array = (struct snd_soc_tplg_vendor_array *)malloc(size);
-	if (!array) {
-		fprintf(stderr, "error: mem alloc\n");
-		return -errno;
-	}
+	/* vendor tuple arrays are checked when the topology is indexed */
+	array = (struct snd_soc_tplg_vendor_array *)ctx->widget->priv.data;
 
 	/* read vendor tokens */
 	while (total_array_size < size) {
-		read_size = sizeof(struct snd_soc_tplg_vendor_array);
-		ret = fread(array, read_size, 1, file);
-		if (ret != 1) {
-			free(array);
-			return -EINVAL;
-		}
-
-		if (!is_valid_priv_size(total_array_size, size, array)) {
-			fprintf(stderr, "error: filewrite array size mismatch\n");
-			free(array);
-			return -EINVAL;
-		}
-
-		tplg_read_array(array, file);
-
 		ret = sof_parse_tokens(&filewrite->config, comp_tokens,
 				       ARRAY_SIZE(comp_tokens), array,
 				       array->size);
 		if (ret != 0) {
 			fprintf(stderr, "error: parse filewrite tokens %d\n",
 				size);
-			free(array);
 			return -EINVAL;
 		}
 		total_array_size += array->size;
-	}
 
-	free(array);
+		/* read next array */
+		array = MOVE_POINTER_BY_BYTES(array, array->size);
+	}
 
 	/* configure filewrite */
 	filewrite->comp.core = ctx->core_id;
@@ -679,7 +621,6 @@ static int load_fileread(struct tplg_context *ctx, int dir)
 {
 	struct sof *sof = ctx->sof;
 	struct testbench_prm *tp = ctx->tp;
-	FILE *file = ctx->file;
 	struct sof_ipc_comp_file fileread = {0};
 	int ret;
 
@@ -689,11 +630,6 @@ static int load_fileread(struct tplg_context *ctx, int dir)
 	if (ret < 0)
 		return ret;
 
-	if (tplg_create_controls(ctx->widget->num_kcontrols, file, NULL, 0) < 0) {
-		fprintf(stderr, "error: loading controls\n");
-		return -EINVAL;
-	}
-
 	/* configure fileread */
 	fileread.fn = strdup(tp->input_file[tp->input_file_index]);
 	if (tp->input_file_index == 0)
@@ -729,7 +665,6 @@ static int load_filewrite(struct tplg_context *ctx, int dir)
 {
 	struct sof *sof = ctx->sof;
 	struct testbench_prm *tp = ctx->tp;
-	FILE *file = ctx->file;
 	struct sof_ipc_comp_file filewrite = {0};
 	int ret;
 
@@ -737,11 +672,6 @@ static int load_filewrite(struct tplg_context *ctx, int dir)
 	if (ret < 0)
 		return ret;
 
-	if (tplg_create_controls(ctx->widget->num_kcontrols, file, NULL, 0) < 0) {
-		fprintf(stderr, "error: loading controls\n");
-		return -EINVAL;
-	}
-
 	/* configure filewrite (multiple output files are supported.) */
 	if (!tp->output_file[tp->output_file_index]) {
 		fprintf(stderr, "error: output[%d] file name is null\n",
@@ -790,73 +720,32 @@ int load_dai_in_out(struct tplg_context *ctx, int dir)
 		return load_fileread(ctx, dir);
 }
 
-static int get_next_hdr(struct tplg_context *ctx, struct snd_soc_tplg_hdr *hdr, size_t file_size)
-{
-	if (fseek(ctx->file, hdr->payload_size, SEEK_CUR)) {
-		fprintf(stderr, "error: fseek payload size\n");
-		return -errno;
-	}
-
-	if (ftell(ctx->file) == file_size)
-		return 0;
-
-	return 1;
-}
-
 /* parse topology file and set up pipeline */
 int parse_topology(struct tplg_context *ctx)
 {
 	struct snd_soc_tplg_hdr *hdr;
 	struct testbench_prm *tp = ctx->tp;
 	struct comp_info *comp_list_realloc = NULL;
+	struct tplg_block *block;
 	char message[DEBUG_MSG_LEN];
 	int i;
-	int next;
+	int b;
 	int ret = 0;
-	size_t file_size;
 	size_t size;
 	bool pipeline_match;
 
 	/* initialize output file index */
 	tp->output_file_index = 0;
 
-	/* open topology file */
-	ctx->file = fopen(ctx->tplg_file, "rb");
-	if (!ctx->file) {
-		fprintf(stderr, "error: opening file %s\n", ctx->tplg_file);
-		fprintf(stderr, "error: %s\n", strerror(errno));
-		return -errno;
-	}
-	tp->file = ctx->file; /* duplicated until we can merge tp with ctx */
-
-	/* file size */
-	if (fseek(ctx->file, 0, SEEK_END)) {
-		fprintf(stderr, "error: seek to end of topology\n");
-		fclose(ctx->file);
-		return -errno;
-	}
-	file_size = ftell(ctx->file);
-	if (fseek(ctx->file, 0, SEEK_SET)) {
-		fprintf(stderr, "error: seek to beginning of topology\n");
-		fclose(ctx->file);
-		return -errno;
-	}
-
-	/* allocate memory */
-	size = sizeof(struct snd_soc_tplg_hdr);
-	hdr = (struct snd_soc_tplg_hdr *)malloc(size);
-	if (!hdr) {
-		fprintf(stderr, "error: mem alloc\n");
-		fclose(ctx->file);
-		return -errno;
-	}
+	/* map and index the topology file */
+	ret = tplg_map_open(ctx);
+	if (ret < 0)
+		return ret;
 
 	debug_print("topology parsing start\n");
-	while (1) {
-		/* read topology header */
-		ret = fread(hdr, sizeof(struct snd_soc_tplg_hdr), 1, ctx->file);
-		if (ret != 1)
-			goto out;
+	for (b = 0; b < ctx->map.num_blocks; b++) {
+		block = &ctx->map.blocks[b];
+		hdr = block->hdr;
 
 		sprintf(message, "type: %x, size: 0x%x count: %d index: %d\n",
 			hdr->type, hdr->payload_size, hdr->count, hdr->index);
@@ -876,14 +765,7 @@ int parse_topology(struct tplg_context *ctx)
 		if (!pipeline_match) {
 			sprintf(message, "skipped pipeline %d\n", hdr->index);
 			debug_print(message);
-			next = get_next_hdr(ctx, hdr, file_size);
-			if (next < 0)
-				goto out;
-			else if (next > 0)
-				continue;
-			else
-				goto finish;
-
+			continue;
 		}
 
 		/* parse header and load the next block based on type */
@@ -916,9 +798,9 @@ int parse_topology(struct tplg_context *ctx)
 			for (i = (ctx->info_elems - hdr->count); i < ctx->info_elems; i++)
 				ctx->info[i].name = NULL;
 
-			for (ctx->info_index = (ctx->info_elems - hdr->count);
-			     ctx->info_index < ctx->info_elems;
-			     ctx->info_index++) {
+			for (i = 0; i < hdr->count; i++) {
+				ctx->info_index = ctx->info_elems - hdr->count + i;
+				tplg_map_widget(ctx, block->first + i);
 				ret = load_widget(ctx);
 				if (ret < 0) {
 					printf("error: loading widget\n");
@@ -926,29 +808,23 @@ int parse_topology(struct tplg_context *ctx)
 				} else if (ret > 0)
 					ctx->comp_id++;
 			}
+			ret = 0;
 			break;
 
 		/* set up component connections from pipeline graph */
 		case SND_SOC_TPLG_TYPE_DAPM_GRAPH:
 			if (tplg_register_graph(ctx->sof, ctx->info,
 						tp->pipeline_string,
-						tp->file, hdr->count,
+						block->payload, hdr->count,
 						ctx->comp_id,
 						hdr->index) < 0) {
 				fprintf(stderr, "error: pipeline graph\n");
 				ret = -EINVAL;
 				goto out;
 			}
-			if (ftell(ctx->file) == file_size)
-				goto finish;
 			break;
 
 		default:
-			next = get_next_hdr(ctx, hdr, file_size);
-			if (next < 0)
-				goto out;
-			else if (next == 0)
-				goto finish;
 			break;
 		}
 	}
@@ -957,12 +833,10 @@ finish:
 
 out:
 	/* free all data */
-	free(hdr);
-
 	for (i = 0; i < ctx->info_elems; i++)
 		free(ctx->info[i].name);
 
 	free(ctx->info);
-	fclose(ctx->file);
+	tplg_map_close(ctx);
 	return ret;
 }
@@ -42,45 +42,19 @@ int tplg_create_asrc(struct tplg_context *ctx, struct sof_ipc_comp_asrc *asrc,
 		     size_t max_comp_size)
 {
 	struct snd_soc_tplg_vendor_array *array = NULL;
-	size_t total_array_size = 0, read_size;
-	FILE *file = ctx->file;
+	size_t total_array_size = 0;
 	int ret, comp_id = ctx->comp_id;
-	int size = ctx->widget_size;
+	int size = ctx->widget->priv.size;
 	char uuid[UUID_SIZE];
 
-	/* allocate memory for vendor tuple array */
-	array = (struct snd_soc_tplg_vendor_array *)malloc(size);
-	if (!array) {
-		fprintf(stderr, "error: mem alloc for asrc vendor array\n");
-		return -errno;
-	}
+	/* vendor tuple arrays are checked when the topology is indexed */
+	array = (struct snd_soc_tplg_vendor_array *)ctx->widget->priv.data;
 
 	if (max_comp_size < sizeof(struct sof_ipc_comp_asrc) + UUID_SIZE)
 		return -EINVAL;
 
 	/* read vendor tokens */
 	while (total_array_size < size) {
-		read_size = sizeof(struct snd_soc_tplg_vendor_array);
-		ret = fread(array, read_size, 1, file);
-		if (ret != 1) {
-			free(MOVE_POINTER_BY_BYTES(array, -total_array_size));
-			return -EINVAL;
-		}
-
-		/* check for array size mismatch */
-		if (!is_valid_priv_size(total_array_size, size, array)) {
-			fprintf(stderr, "error: load asrc array size mismatch\n");
-			free(MOVE_POINTER_BY_BYTES(array, -total_array_size));
-			return -EINVAL;
-		}
-
-		ret = tplg_read_array(array, file);
-		if (ret) {
-			fprintf(stderr, "error: read array fail\n");
-			free(MOVE_POINTER_BY_BYTES(array, -total_array_size));
-			return ret;
-		}
-
 		/* parse comp tokens */
 		ret = sof_parse_tokens(&asrc->config, comp_tokens,
 				       ARRAY_SIZE(comp_tokens), array,
@@ -88,7 +62,6 @@ int tplg_create_asrc(struct tplg_context *ctx, struct sof_ipc_comp_asrc *asrc,
 		if (ret != 0) {
 			fprintf(stderr, "error: parse asrc comp_tokens %d\n",
 				size);
-			free(MOVE_POINTER_BY_BYTES(array, -total_array_size));
 			return -EINVAL;
 		}
 
@@ -98,7 +71,6 @@ int tplg_create_asrc(struct tplg_context *ctx, struct sof_ipc_comp_asrc *asrc,
 				       array->size);
 		if (ret != 0) {
 			fprintf(stderr, "error: parse asrc tokens %d\n", size);
-			free(MOVE_POINTER_BY_BYTES(array, -total_array_size));
 			return -EINVAL;
 		}
 
@@ -108,7 +80,6 @@ int tplg_create_asrc(struct tplg_context *ctx, struct sof_ipc_comp_asrc *asrc,
 				       array->size);
 		if (ret != 0) {
 			fprintf(stderr, "error: parse asrc uuid token %d\n", size);
-			free(array);
 			return -EINVAL;
 		}
 
@@ -118,9 +89,6 @@ int tplg_create_asrc(struct tplg_context *ctx, struct sof_ipc_comp_asrc *asrc,
 		array = MOVE_POINTER_BY_BYTES(array, array->size);
 	}
 
-	/* point to the start of array so it gets freed properly */
-	array = MOVE_POINTER_BY_BYTES(array, -total_array_size);
-
 	/* configure asrc */
 	asrc->comp.hdr.cmd = SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_NEW;
 	asrc->comp.id = comp_id;
@@ -131,7 +99,6 @@ int tplg_create_asrc(struct tplg_context *ctx, struct sof_ipc_comp_asrc *asrc,
 	asrc->config.hdr.size = sizeof(struct sof_ipc_comp_config);
 	memcpy(asrc + 1, &uuid, UUID_SIZE);
 
-	free(array);
 	return 0;
 }
 
@@ -146,7 +113,7 @@ int tplg_new_asrc(struct tplg_context *ctx, struct sof_ipc_comp *comp, size_t co
 	if (ret < 0)
 		return ret;
 
-	if (tplg_create_controls(ctx->widget->num_kcontrols, ctx->file, rctl, max_ctl_size) < 0) {
+	if (tplg_create_controls(ctx, rctl, max_ctl_size) < 0) {
 		fprintf(stderr, "error: loading controls\n");
 		return -EINVAL;
 	}
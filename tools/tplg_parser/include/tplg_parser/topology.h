@@ -25,6 +25,7 @@
 struct testbench_prm;
 struct snd_soc_tplg_vendor_array;
 struct snd_soc_tplg_ctl_hdr;
+struct snd_soc_tplg_dapm_graph_elem;
 struct sof_topology_token;
 
 struct comp_info {
@@ -42,6 +43,32 @@ struct frame_types {
 struct sof;
 struct fuzz;
 
+/* topology block, the routes of a graph block are the payload */
+struct tplg_block {
+	struct snd_soc_tplg_hdr *hdr;
+	void *payload;
+	int first;			/* index of the first widget of a widget block */
+};
+
+/* indexed widget and the index of its first kcontrol */
+struct tplg_widget_entry {
+	struct snd_soc_tplg_dapm_widget *widget;
+	int first_ctl;
+};
+
+/* read only mapping of the topology file and its index */
+struct tplg_map {
+	void *data;
+	size_t size;
+
+	struct tplg_block *blocks;
+	int num_blocks;
+	struct tplg_widget_entry *widgets;
+	int num_widgets;
+	struct snd_soc_tplg_ctl_hdr **ctls;
+	int num_ctls;
+};
+
 /*
  * Per topology data.
  *
@@ -60,8 +87,8 @@ struct tplg_context {
 	/* current IPC object and widget */
 	struct snd_soc_tplg_hdr *hdr;
 	struct snd_soc_tplg_dapm_widget *widget;
+	int widget_index;
 	int comp_id;
-	size_t widget_size;
 	int dev_type;
 	int sched_id;
 
@@ -78,7 +105,7 @@ struct tplg_context {
 	enum sof_ipc_frame frame_fmt;
 
 	/* global data */
-	FILE *file;
+	struct tplg_map map;
 	struct testbench_prm *tp;
 	struct sof *sof;
 	const char *tplg_file;
@@ -154,7 +181,10 @@ int tplg_process_append_data(struct sof_ipc_comp_process **process_ipc,
 int tplg_process_init_data(struct sof_ipc_comp_process **process_ipc,
 			     struct sof_ipc_comp_process *process);
 
-int tplg_read_array(struct snd_soc_tplg_vendor_array *array, FILE *file);
+int tplg_map_open(struct tplg_context *ctx);
+void tplg_map_close(struct tplg_context *ctx);
+void tplg_map_widget(struct tplg_context *ctx, int index);
+
 int tplg_create_buffer(struct tplg_context *ctx,
 		     struct sof_ipc_buffer *buffer);
 int tplg_new_buffer(struct tplg_context *ctx, struct sof_ipc_buffer *buffer,
@@ -170,10 +200,10 @@ int tplg_create_pipeline(struct tplg_context *ctx,
 int tplg_new_pipeline(struct tplg_context *ctx, struct sof_ipc_pipe_new *pipeline,
 		struct snd_soc_tplg_ctl_hdr *rctl);
 
-int tplg_create_single_control(struct snd_soc_tplg_ctl_hdr **ctl, char **priv,
-			  FILE *file);
-int tplg_create_controls(int num_kcontrols, FILE *file, struct snd_soc_tplg_ctl_hdr *rctl,
-		size_t max_ctl_size);
+int tplg_create_single_control(struct tplg_context *ctx, int index,
+			       struct snd_soc_tplg_ctl_hdr **ctl, char **priv);
+int tplg_create_controls(struct tplg_context *ctx, struct snd_soc_tplg_ctl_hdr *rctl,
+			 size_t max_ctl_size);
 
 int tplg_create_src(struct tplg_context *ctx,
 		  struct sof_ipc_comp_src *src, size_t max_comp_size);
@@ -195,7 +225,8 @@ int tplg_new_process(struct tplg_context *ctx, struct sof_ipc_comp *comp, size_t
 
 int tplg_create_graph(int num_comps, int pipeline_id,
 		    struct comp_info *temp_comp_list, char *pipeline_string,
-		    struct sof_ipc_pipe_comp_connect *connection, FILE *file,
+		    struct sof_ipc_pipe_comp_connect *connection,
+		    struct snd_soc_tplg_dapm_graph_elem *graph_elem,
 		    int route_num, int count);
 
 int tplg_new_pga(struct tplg_context *ctx, struct sof_ipc_comp *comp, size_t comp_size,
@@ -216,7 +247,7 @@ int tplg_new_mixer(struct tplg_context *ctx, struct sof_ipc_comp *comp, size_t c
 		struct snd_soc_tplg_ctl_hdr *rctl, size_t max_ctl_size);
 
 int tplg_register_graph(void *dev, struct comp_info *temp_comp_list,
-			char *pipeline_string, FILE *file,
+			char *pipeline_string, struct snd_soc_tplg_dapm_graph_elem *routes,
 			int count, int num_comps, int pipeline_id);
 int load_process(struct tplg_context *ctx);
 int load_widget(struct tplg_context *ctx);
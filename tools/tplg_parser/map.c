@@ -0,0 +1,366 @@
+// SPDX-License-Identifier: BSD-3-Clause
+//
+// Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+/*
+ * Topology file mapping.
+ *
+ * The topology file is mapped read only and walked once to index the block
+ * headers, the DAPM widgets and their kcontrols. All sizes and vendor tuple
+ * arrays are validated here so the tplg_create_*() functions can parse the
+ * widgets in place without copying or further bounds checks.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <ipc/topology.h>
+#include <tplg_parser/topology.h>
+#include <tplg_parser/tokens.h>
+
+/* remaining bytes from ptr to end, 0 if ptr is past end */
+static size_t tplg_map_avail(const void *ptr, const void *end)
+{
+	return ptr < end ? (const uint8_t *)end - (const uint8_t *)ptr : 0;
+}
+
+static bool tplg_map_valid_name(const char *name)
+{
+	return strnlen(name, SNDRV_CTL_ELEM_ID_NAME_MAXLEN) < SNDRV_CTL_ELEM_ID_NAME_MAXLEN;
+}
+
+/* check the vendor tuple arrays of the widget private data */
+static int tplg_map_arrays(struct snd_soc_tplg_dapm_widget *widget)
+{
+	struct snd_soc_tplg_vendor_array *array;
+	size_t size = widget->priv.size;
+	size_t parsed_size = 0;
+
+	array = (struct snd_soc_tplg_vendor_array *)widget->priv.data;
+	while (parsed_size < size) {
+		if (size - parsed_size < sizeof(*array) || array->size < sizeof(*array) ||
+		    array->size > size - parsed_size) {
+			fprintf(stderr, "error: widget %s array size mismatch\n", widget->name);
+			return -EINVAL;
+		}
+
+		switch (array->type) {
+		case SND_SOC_TPLG_TUPLE_TYPE_UUID:
+		case SND_SOC_TPLG_TUPLE_TYPE_STRING:
+		case SND_SOC_TPLG_TUPLE_TYPE_BOOL:
+		case SND_SOC_TPLG_TUPLE_TYPE_BYTE:
+		case SND_SOC_TPLG_TUPLE_TYPE_WORD:
+		case SND_SOC_TPLG_TUPLE_TYPE_SHORT:
+			break;
+		default:
+			fprintf(stderr, "error: unknown token type %d\n", array->type);
+			return -EINVAL;
+		}
+
+		if (!is_valid_priv_size(parsed_size, size, array)) {
+			fprintf(stderr, "error: widget %s array elems mismatch\n", widget->name);
+			return -EINVAL;
+		}
+
+		parsed_size += array->size;
+		array = MOVE_POINTER_BY_BYTES(array, array->size);
+	}
+
+	return 0;
+}
+
+/* index the kcontrols following a widget and get their total size */
+static int tplg_map_controls(struct tplg_map *map, struct snd_soc_tplg_dapm_widget *widget,
+			     void *ptr, void *end, size_t *ctl_size)
+{
+	struct snd_soc_tplg_ctl_hdr **ctls;
+	struct snd_soc_tplg_ctl_hdr *ctl_hdr;
+	struct snd_soc_tplg_mixer_control *mixer_ctl;
+	struct snd_soc_tplg_enum_control *enum_ctl;
+	struct snd_soc_tplg_bytes_control *bytes_ctl;
+	size_t total_size = 0;
+	size_t size;
+	int j;
+
+	*ctl_size = 0;
+	if (!widget->num_kcontrols)
+		return 0;
+
+	if (widget->num_kcontrols > tplg_map_avail(ptr, end) / sizeof(*ctl_hdr)) {
+		fprintf(stderr, "error: widget %s has too many kcontrols\n", widget->name);
+		return -EINVAL;
+	}
+
+	ctls = realloc(map->ctls, sizeof(*ctls) * (map->num_ctls + widget->num_kcontrols));
+	if (!ctls) {
+		fprintf(stderr, "error: mem alloc\n");
+		return -ENOMEM;
+	}
+	map->ctls = ctls;
+
+	for (j = 0; j < widget->num_kcontrols; j++) {
+		ctl_hdr = MOVE_POINTER_BY_BYTES((struct snd_soc_tplg_ctl_hdr *)ptr, total_size);
+		if (tplg_map_avail(ctl_hdr, end) < sizeof(*ctl_hdr))
+			goto err;
+
+		/* control size is the type specific struct followed by its private data */
+		switch (ctl_hdr->ops.info) {
+		case SND_SOC_TPLG_CTL_VOLSW:
+		case SND_SOC_TPLG_CTL_STROBE:
+		case SND_SOC_TPLG_CTL_VOLSW_SX:
+		case SND_SOC_TPLG_CTL_VOLSW_XR_SX:
+		case SND_SOC_TPLG_CTL_RANGE:
+		case SND_SOC_TPLG_DAPM_CTL_VOLSW:
+			mixer_ctl = (struct snd_soc_tplg_mixer_control *)ctl_hdr;
+			size = sizeof(*mixer_ctl);
+			if (tplg_map_avail(ctl_hdr, end) < size)
+				goto err;
+			size += mixer_ctl->priv.size;
+			break;
+
+		case SND_SOC_TPLG_CTL_ENUM:
+		case SND_SOC_TPLG_CTL_ENUM_VALUE:
+		case SND_SOC_TPLG_DAPM_CTL_ENUM_DOUBLE:
+		case SND_SOC_TPLG_DAPM_CTL_ENUM_VIRT:
+		case SND_SOC_TPLG_DAPM_CTL_ENUM_VALUE:
+			enum_ctl = (struct snd_soc_tplg_enum_control *)ctl_hdr;
+			size = sizeof(*enum_ctl);
+			if (tplg_map_avail(ctl_hdr, end) < size)
+				goto err;
+			size += enum_ctl->priv.size;
+			break;
+
+		case SND_SOC_TPLG_CTL_BYTES:
+			bytes_ctl = (struct snd_soc_tplg_bytes_control *)ctl_hdr;
+			size = sizeof(*bytes_ctl);
+			if (tplg_map_avail(ctl_hdr, end) < size)
+				goto err;
+			size += bytes_ctl->priv.size;
+			break;
+
+		default:
+			fprintf(stderr, "error: widget %s control type %d not supported\n",
+				widget->name, ctl_hdr->ops.info);
+			return -EINVAL;
+		}
+
+		/* the header is copied by ctl_hdr->size for the callers */
+		if (size > tplg_map_avail(ctl_hdr, end) || ctl_hdr->size > size)
+			goto err;
+
+		map->ctls[map->num_ctls++] = ctl_hdr;
+		total_size += size;
+	}
+
+	*ctl_size = total_size;
+	return 0;
+
+err:
+	fprintf(stderr, "error: widget %s control size mismatch\n", widget->name);
+	return -EINVAL;
+}
+
+/* index the widgets of a widget block */
+static int tplg_map_widgets(struct tplg_map *map, struct tplg_block *block)
+{
+	struct tplg_widget_entry *widgets;
+	struct snd_soc_tplg_dapm_widget *widget;
+	struct snd_soc_tplg_hdr *hdr = block->hdr;
+	void *end = MOVE_POINTER_BY_BYTES(block->payload, hdr->payload_size);
+	void *ptr = block->payload;
+	size_t ctl_size;
+	int ret;
+	int i;
+
+	if (hdr->count > hdr->payload_size / sizeof(*widget)) {
+		fprintf(stderr, "error: too many widgets in block %d\n", hdr->index);
+		return -EINVAL;
+	}
+
+	widgets = realloc(map->widgets, sizeof(*widgets) * (map->num_widgets + hdr->count));
+	if (!widgets) {
+		fprintf(stderr, "error: mem alloc\n");
+		return -ENOMEM;
+	}
+	map->widgets = widgets;
+	block->first = map->num_widgets;
+
+	for (i = 0; i < hdr->count; i++) {
+		widget = ptr;
+		if (tplg_map_avail(widget, end) < sizeof(*widget) ||
+		    widget->priv.size > tplg_map_avail(widget, end) - sizeof(*widget)) {
+			fprintf(stderr, "error: widget size mismatch in block %d\n", hdr->index);
+			return -EINVAL;
+		}
+
+		if (!tplg_map_valid_name(widget->name) || !tplg_map_valid_name(widget->sname)) {
+			fprintf(stderr, "error: invalid widget name in block %d\n", hdr->index);
+			return -EINVAL;
+		}
+
+		ret = tplg_map_arrays(widget);
+		if (ret < 0)
+			return ret;
+
+		map->widgets[map->num_widgets].widget = widget;
+		map->widgets[map->num_widgets].first_ctl = map->num_ctls;
+		map->num_widgets++;
+
+		/* kcontrols follow the widget private data */
+		ptr = MOVE_POINTER_BY_BYTES(ptr, sizeof(*widget) + widget->priv.size);
+		ret = tplg_map_controls(map, widget, ptr, end, &ctl_size);
+		if (ret < 0)
+			return ret;
+
+		ptr = MOVE_POINTER_BY_BYTES(ptr, ctl_size);
+	}
+
+	return 0;
+}
+
+/* check the routes of a graph block */
+static int tplg_map_graph(struct tplg_block *block)
+{
+	struct snd_soc_tplg_dapm_graph_elem *graph_elem = block->payload;
+	struct snd_soc_tplg_hdr *hdr = block->hdr;
+	int i;
+
+	if (hdr->count > hdr->payload_size / sizeof(*graph_elem)) {
+		fprintf(stderr, "error: too many routes in block %d\n", hdr->index);
+		return -EINVAL;
+	}
+
+	for (i = 0; i < hdr->count; i++) {
+		if (!tplg_map_valid_name(graph_elem[i].source) ||
+		    !tplg_map_valid_name(graph_elem[i].control) ||
+		    !tplg_map_valid_name(graph_elem[i].sink)) {
+			fprintf(stderr, "error: invalid route name in block %d\n", hdr->index);
+			return -EINVAL;
+		}
+	}
+
+	return 0;
+}
+
+static int tplg_map_index(struct tplg_map *map)
+{
+	struct tplg_block *blocks;
+	struct tplg_block *block;
+	struct snd_soc_tplg_hdr *hdr;
+	void *end = MOVE_POINTER_BY_BYTES(map->data, map->size);
+	void *ptr = map->data;
+	int ret;
+
+	while (ptr < end) {
+		hdr = ptr;
+		if (tplg_map_avail(hdr, end) < sizeof(*hdr) ||
+		    hdr->payload_size > tplg_map_avail(hdr, end) - sizeof(*hdr)) {
+			fprintf(stderr, "error: topology block %d is truncated\n", map->num_blocks);
+			return -EINVAL;
+		}
+
+		blocks = realloc(map->blocks, sizeof(*blocks) * (map->num_blocks + 1));
+		if (!blocks) {
+			fprintf(stderr, "error: mem alloc\n");
+			return -ENOMEM;
+		}
+		map->blocks = blocks;
+
+		block = &map->blocks[map->num_blocks++];
+		block->hdr = hdr;
+		block->payload = hdr + 1;
+		block->first = 0;
+
+		switch (hdr->type) {
+		case SND_SOC_TPLG_TYPE_DAPM_WIDGET:
+			ret = tplg_map_widgets(map, block);
+			break;
+		case SND_SOC_TPLG_TYPE_DAPM_GRAPH:
+			ret = tplg_map_graph(block);
+			break;
+		default:
+			ret = 0;
+			break;
+		}
+
+		if (ret < 0)
+			return ret;
+
+		ptr = MOVE_POINTER_BY_BYTES(block->payload, hdr->payload_size);
+	}
+
+	return 0;
+}
+
+/* map the topology file and index it */
+int tplg_map_open(struct tplg_context *ctx)
+{
+	struct tplg_map *map = &ctx->map;
+	struct stat st;
+	int ret = 0;
+	int fd;
+
+	memset(map, 0, sizeof(*map));
+
+	fd = open(ctx->tplg_file, O_RDONLY);
+	if (fd < 0) {
+		fprintf(stderr, "error: opening file %s\n", ctx->tplg_file);
+		fprintf(stderr, "error: %s\n", strerror(errno));
+		return -errno;
+	}
+
+	if (fstat(fd, &st) < 0) {
+		fprintf(stderr, "error: stat of topology %s\n", ctx->tplg_file);
+		ret = -errno;
+		goto out;
+	}
+
+	/* an empty file has no blocks */
+	map->size = st.st_size;
+	if (map->size) {
+		map->data = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (map->data == MAP_FAILED) {
+			fprintf(stderr, "error: mmap of topology %s\n", ctx->tplg_file);
+			ret = -errno;
+			map->data = NULL;
+			map->size = 0;
+			goto out;
+		}
+	}
+
+	ret = tplg_map_index(map);
+	if (ret < 0)
+		tplg_map_close(ctx);
+
+out:
+	close(fd);
+	return ret;
+}
+
+void tplg_map_close(struct tplg_context *ctx)
+{
+	struct tplg_map *map = &ctx->map;
+
+	if (map->data)
+		munmap(map->data, map->size);
+
+	free(map->blocks);
+	free(map->widgets);
+	free(map->ctls);
+	memset(map, 0, sizeof(*map));
+	ctx->widget = NULL;
+}
+
+/* make the indexed widget the current one */
+void tplg_map_widget(struct tplg_context *ctx, int index)
+{
+	ctx->widget_index = index;
+	ctx->widget = ctx->map.widgets[index].widget;
+}
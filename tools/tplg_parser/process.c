@@ -32,42 +32,15 @@ int tplg_create_process(struct tplg_context *ctx,
 {
 	struct snd_soc_tplg_vendor_array *array = NULL;
 	size_t total_array_size = 0;
-	size_t read_size;
-	FILE *file = ctx->file;
 	int size = ctx->widget->priv.size;
 	int comp_id = ctx->comp_id;
 	int ret;
 
-	/* allocate memory for vendor tuple array */
-	array = (struct snd_soc_tplg_vendor_array *)malloc(size);
-	if (!array) {
-		fprintf(stderr, "error: mem alloc for asrc vendor array\n");
-		return -errno;
-	}
+	/* vendor tuple arrays are checked when the topology is indexed */
+	array = (struct snd_soc_tplg_vendor_array *)ctx->widget->priv.data;
 
 	/* read vendor tokens */
 	while (total_array_size < size) {
-		read_size = sizeof(struct snd_soc_tplg_vendor_array);
-		ret = fread(array, read_size, 1, file);
-		if (ret != 1) {
-			free(MOVE_POINTER_BY_BYTES(array, -total_array_size));
-			return -EINVAL;
-		}
-
-		/* check for array size mismatch */
-		if (!is_valid_priv_size(total_array_size, size, array)) {
-			fprintf(stderr, "error: load process array size mismatch\n");
-			free(MOVE_POINTER_BY_BYTES(array, -total_array_size));
-			return -EINVAL;
-		}
-
-		ret = tplg_read_array(array, file);
-		if (ret) {
-			fprintf(stderr, "error: read array fail\n");
-			free(MOVE_POINTER_BY_BYTES(array, -total_array_size));
-			return ret;
-		}
-
 		/* parse comp tokens */
 		ret = sof_parse_tokens(&process->config, comp_tokens,
 				       ARRAY_SIZE(comp_tokens), array,
@@ -75,7 +48,6 @@ int tplg_create_process(struct tplg_context *ctx,
 		if (ret != 0) {
 			fprintf(stderr, "error: parse process comp_tokens %d\n",
 				size);
-			free(MOVE_POINTER_BY_BYTES(array, -total_array_size));
 			return -EINVAL;
 		}
 
@@ -86,7 +58,6 @@ int tplg_create_process(struct tplg_context *ctx,
 		if (ret != 0) {
 			fprintf(stderr, "error: parse process tokens %d\n",
 				size);
-			free(MOVE_POINTER_BY_BYTES(array, -total_array_size));
 			return -EINVAL;
 		}
 
@@ -98,7 +69,6 @@ int tplg_create_process(struct tplg_context *ctx,
 		if (ret != 0) {
 			fprintf(stderr, "error: parse comp extended tokens %d\n",
 				size);
-			free(MOVE_POINTER_BY_BYTES(array, -total_array_size));
 			return -EINVAL;
 		}
 
@@ -108,9 +78,6 @@ int tplg_create_process(struct tplg_context *ctx,
 		array = MOVE_POINTER_BY_BYTES(array, array->size);
 	}
 
-	/* point to the start of array so it gets freed properly */
-	array = MOVE_POINTER_BY_BYTES(array, -total_array_size);
-
 	/* configure asrc */
 	process->comp.hdr.cmd = SOF_IPC_GLB_TPLG_MSG | SOF_IPC_TPLG_COMP_NEW;
 	process->comp.id = comp_id;
@@ -121,7 +88,6 @@ int tplg_create_process(struct tplg_context *ctx,
 	process->comp.ext_data_length = UUID_SIZE;
 	memcpy(process + 1, comp_ext, UUID_SIZE);
 
-	free(array);
 	return 0;
 }
 
@@ -196,7 +162,7 @@ int tplg_new_process(struct tplg_context *ctx, struct sof_ipc_comp *comp, size_t
 
 	/* Get control into ctl and priv_data */
 	for (i = 0; i < widget->num_kcontrols; i++) {
-		ret = tplg_create_single_control(&ctl, &priv_data, ctx->file);
+		ret = tplg_create_single_control(ctx, i, &ctl, &priv_data);
 
 		if (ret < 0) {
 			fprintf(stderr, "error: failed control load\n");
@@ -207,8 +173,6 @@ int tplg_new_process(struct tplg_context *ctx, struct sof_ipc_comp *comp, size_t
 		if (priv_data)
 			ret = tplg_process_append_data(&process_ipc, process, ctl, priv_data);
 
-		free(ctl);
-		free(priv_data);
 		if (ret) {
 			fprintf(stderr, "error: private data append failed\n");
 			free(process_ipc);
@@ -0,0 +1,37 @@
+% example_src_blob - export an SRC coefficients blob
+%
+% Packs the conversions from 44.1 kHz and 96 kHz to 48 kHz and back for
+% a firmware without built-in SRC coefficients (CONFIG_COMP_SRC_COEF_BLOB)
+% or to add conversions to a built-in set. The coefficients type must
+% match the firmware, int16 for the tiny set and the generic C filter
+% core of non-library builds, otherwise int32.
+
+% SPDX-License-Identifier: BSD-3-Clause
+%
+% Copyright (c) 2022, Intel Corporation. All rights reserved.
+
+% Set the parameters here
+tplg_fn = '../../topology/topology1/m4/src_coef_44k1_96k_48k.m4'; % Control Bytes File
+% Use those files with sof-ctl to update the component's configuration
+blob_fn = '../../ctl/src_coef_44k1_96k_48k.blob'; % Blob binary file
+alsa_fn = '../../ctl/src_coef_44k1_96k_48k.txt'; % ALSA CSV format file
+
+fs1 = [44.1e3 48e3 96e3];
+fs2 = [44.1e3 48e3 96e3];
+fsm = [0 1 0; ...
+       1 0 1; ...
+       0 1 0; ...
+      ];
+
+cfg.ctype = 'int32';
+cfg.quality = 1.0;
+cfg.speed = 0;
+cfg.gain = -1;
+
+blob8 = src_blob(fs1, fs2, fsm, cfg);
+
+addpath ./../common
+tplg_write(tplg_fn, blob8, 'SRC_COEF');
+blob_write(blob_fn, blob8);
+alsactl_write(alsa_fn, blob8);
+rmpath ./../common
@@ -0,0 +1,176 @@
+function blob8 = src_blob(fs_in, fs_out, fs_inout, cfg)
+
+% src_blob - pack SRC conversions into a coefficients blob
+%
+% blob8 = src_blob(fs_in, fs_out <, fs_inout, <cfg>>)
+%
+% fs_in     - vector of input sample rates (M)
+% fs_out    - vector of output sample rates (N)
+% fs_inout  - matrix of conversions to pack (MxN),
+%             0 = not packed, 1 = packed
+% cfg       - configuration struct with fields
+%   ctype   - coefficient type, 'int16' or 'int32', must match the
+%             firmware filter core
+%   quality - quality factor, usually 1.0
+%   speed   - optimize speed, gives higher RAM size, usually 0
+%   gain    - overal filter gain, defaults to -1 dB if empty
+%   endian  - 'little' or 'big', defaults to 'little'
+%
+% The conversions are designed like in src_generate() but without the
+% iteration of stopband attenuation against the THD+N target, so the
+% quality of a conversion is set with cfg.quality only. Conversions with
+% equal input and output rate are not packed, the firmware passes them
+% through.
+%
+% The blob format is defined in sof/src/include/user/src.h.
+%
+
+% SPDX-License-Identifier: BSD-3-Clause
+%
+% Copyright (c) 2022, Intel Corporation. All rights reserved.
+
+if (nargin < 2) || (nargin > 4)
+	error('Incorrect arguments for function!');
+end
+if nargin < 4
+	cfg.ctype = 'int32';
+	cfg.quality = 1.0;
+	cfg.speed = 0;
+	cfg.gain = -1;
+end
+if nargin < 3
+	fs_inout = ones(length(fs_in), length(fs_out));
+end
+if ~isfield(cfg, 'endian')
+	cfg.endian = 'little';
+end
+
+sio = size(fs_inout);
+if (length(fs_in) ~= sio(1)) ||  (length(fs_out) ~= sio(2))
+	error('Sample rates in/out matrix size mismatch!');
+end
+
+switch cfg.ctype
+	case 'int16'
+		coef_bits = 16;
+	case 'int32'
+		coef_bits = 32;
+	otherwise
+		error('Request for incorrect coefficient type');
+end
+
+%% Shift values for little/big endian
+switch lower(cfg.endian)
+	case 'little'
+		sh16 = [0 -8];
+		sh32 = [0 -8 -16 -24];
+	case 'big'
+		sh16 = [-8 0];
+		sh32 = [-24 -16 -8 0];
+	otherwise
+		error('Unknown endiannes');
+end
+
+%% Design and pack the conversions
+data8 = [];
+num_conversions = 0;
+for b = 1:length(fs_out)
+	for a = 1:length(fs_in)
+		fs1 = fs_in(a);
+		fs2 = fs_out(b);
+		if fs_inout(a,b) < eps || abs(fs1 - fs2) < 1
+			continue;
+		end
+
+		[l1, m1, l2, m2] = src_factor2_lm(fs1, fs2);
+		if cfg.speed && max(l1 * l2, m1 * m2) < 30
+			l1 = l1 * l2;
+			l2 = 1;
+			m1 = m1 * m2;
+			m2 = 1;
+		end
+		fs3 = fs1 * l1 / m1;
+		cnv1 = src_param(fs1, fs3, coef_bits, cfg.quality, cfg.gain);
+		cnv2 = src_param(fs3, fs2, coef_bits, cfg.quality, cfg.gain);
+		if (fs2 < fs1)
+			f_pb = fs2 * cnv2.c_pb;
+			cnv1.c_pb = f_pb / min(fs1, fs3);
+		end
+		if (fs2 > fs1)
+			f_pb = fs1 * cnv1.c_pb;
+			cnv2.c_pb = f_pb / min(fs2, fs3);
+		end
+
+		stages = { src_get(cnv1) src_get(cnv2) };
+		stages8 = [];
+		num_stages = 0;
+		for i = 1:2
+			if stages{i}.active
+				stages8 = [stages8 pack_stage(stages{i}, coef_bits, sh16, sh32)];
+				num_stages = num_stages + 1;
+			end
+		end
+
+		fprintf(1, 'Conversion %d -> %d Hz, %d stages, %d bytes\n', ...
+			fs1, fs2, num_stages, length(stages8));
+
+		% struct sof_src_conversion
+		h32 = [24 + length(stages8) fs1 fs2];
+		conv8 = [w32b(h32, sh32) w16b([num_stages 0], sh16) w32b([0 0], sh32)];
+		data8 = [data8 conv8 stages8];
+		num_conversions = num_conversions + 1;
+	end
+end
+
+if num_conversions < 1
+	error('No conversions to pack');
+end
+
+%% struct sof_src_config
+data_size = 24 + length(data8);
+config8 = [w32b(data_size, sh32) w16b([num_conversions coef_bits], sh16) ...
+	   w32b([0 0 0 0], sh32)];
+
+%% Insert ABI header
+[abi_bytes, nbytes_abi] = src_get_abi(data_size);
+blob8 = uint8([abi_bytes(:)' config8 data8]);
+
+fprintf('Blob size is %d bytes.\n', length(blob8));
+
+end
+
+%% Helper functions
+
+function stage8 = pack_stage(src, coef_bits, sh16, sh32)
+
+% struct sof_src_stage, the coefficients are 64 bit aligned since
+% filter_length is a multiple of four and the header is 40 bytes.
+cint = src_coef_quant(src, coef_bits);
+if coef_bits == 16
+	coef8 = w16b(cint, sh16);
+else
+	coef8 = w32b(cint, sh32);
+end
+
+h32 = [40 + length(coef8) src.idm src.odm src.num_of_subfilters ...
+       src.subfilter_length src.filter_length src.blk_in src.blk_out ...
+       src.halfband src.shift];
+stage8 = [w32b(h32, sh32) coef8];
+
+end
+
+function bytes = w16b(words, sh)
+u = double(typecast(int16(words(:)'), 'uint16'));
+bytes = uint8(zeros(1, 2 * length(u)));
+bytes(1:2:end) = bitand(bitshift(u, sh(1)), 255);
+bytes(2:2:end) = bitand(bitshift(u, sh(2)), 255);
+end
+
+function bytes = w32b(words, sh)
+u = double(typecast(int32(words(:)'), 'uint32'));
+bytes = uint8(zeros(1, 4 * length(u)));
+bytes(1:4:end) = bitand(bitshift(u, sh(1)), 255);
+bytes(2:4:end) = bitand(bitshift(u, sh(2)), 255);
+bytes(3:4:end) = bitand(bitshift(u, sh(3)), 255);
+bytes(4:4:end) = bitand(bitshift(u, sh(4)), 255);
+end
@@ -0,0 +1,26 @@
+function [bytes, nbytes] = src_get_abi(setsize)
+
+%% Return current SOF ABI header
+%
+% [bytes, nbytes] = src_get_abi(setsize)
+%
+
+% SPDX-License-Identifier: BSD-3-Clause
+%
+% Copyright(c) 2022 Intel Corporation. All rights reserved.
+
+%% Use sof-ctl to write ABI header into a file
+abifn = 'src_get_abi.bin';
+cmd = sprintf('sof-ctl -g %d -b -o %s > /dev/null', setsize, abifn);
+system(cmd);
+
+%% Read file and delete it
+fh = fopen(abifn, 'r');
+if fh < 0
+	error("Failed to get ABI header. Is sof-ctl installed?");
+end
+[bytes, nbytes] = fread(fh, inf, 'uint8');
+fclose(fh);
+delete(abifn);
+
+end
@@ -25,6 +25,9 @@ struct dma_sg_config;
 struct mm_info {
 	uint32_t used;
 	uint32_t free;
+	uint32_t alloc_count;	/* number of successful allocations */
+	uint32_t fail_count;	/* number of failed allocations */
+	uint32_t free_max;	/* largest contiguous free space, set by heap_info() */
 };
 
 struct block_hdr {
@@ -40,6 +43,7 @@ struct block_map {
 	uint16_t first_free;	/* index of first free block */
 	struct block_hdr *block;	/* base block header */
 	uint32_t base;		/* base address of space */
+	uint32_t *free_map;	/* bitmap of free blocks, set up by init_heap() */
 };
 
 #define BLOCK_DEF(sz, cnt, hdr) \
@@ -59,6 +63,14 @@ struct mm_heap {
 	struct mm_info info;
 };
 
+#if CONFIG_CORE_COUNT > 1
+#define MM_HEAP_INDEX_SIZE (PLATFORM_HEAP_SYSTEM_RUNTIME + PLATFORM_HEAP_RUNTIME + \
+			    PLATFORM_HEAP_RUNTIME_SHARED + PLATFORM_HEAP_BUFFER)
+#else
+#define MM_HEAP_INDEX_SIZE (PLATFORM_HEAP_SYSTEM_RUNTIME + PLATFORM_HEAP_RUNTIME + \
+			    PLATFORM_HEAP_BUFFER)
+#endif
+
 /* heap block memory map */
 struct mm {
 	/* system heap - used during init cannot be freed */
@@ -76,6 +88,10 @@ struct mm {
 	/* general component buffer heap */
 	struct mm_heap buffer[PLATFORM_HEAP_BUFFER];
 
+	/* heaps with block maps sorted by address, used to look up rfree() */
+	struct mm_heap *heap_index[MM_HEAP_INDEX_SIZE];
+	uint32_t heap_index_count;
+
 	struct mm_info total;
 	uint32_t heap_trace_updated;	/* updates that can be presented */
 	struct k_spinlock lock;	/* all allocs and frees are atomic */
@@ -95,7 +111,8 @@ void heap_trace_all(int force);
 void heap_trace(struct mm_heap *heap, int size);
 
 #if CONFIG_DEBUG_MEMORY_USAGE_SCAN
-/** Fetch runtime information about heap, like used and free memory space
+/** Fetch runtime information about heap, like used and free memory space,
+ * allocation counters and the largest contiguous free space
  * @param zone to check, see enum mem_zone.
  * @param index heap index, eg. cpu core index for any *SYS* zone
  * @param out output variable